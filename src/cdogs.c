@@ -82,8 +82,10 @@
 #include <cdogs/pickup.h>
 #include <cdogs/pics.h>
 #include <cdogs/player_template.h>
+#include <cdogs/replay.h>
 #include <cdogs/sounds.h>
 #include <cdogs/SDL_JoystickButtonNames/SDL_joystickbuttonnames.h>
+#include <cdogs/thread_pool.h>
 #include <cdogs/triggers.h>
 #include <cdogs/utils.h>
 
@@ -104,11 +106,14 @@ int main(int argc, char *argv[])
 #endif
 	int err = 0;
 	const char *loadCampaign = NULL;
+	bool isDedicated = false;
+	bool isBake = false;
 	ENetAddress connectAddr;
 	memset(&connectAddr, 0, sizeof connectAddr);
 
 	srand((unsigned int)time(NULL));
 	LogInit();
+	ReplayInit(&gReplay);
 
 	PrintTitle();
 
@@ -157,13 +162,27 @@ int main(int argc, char *argv[])
 	char buf[CDOGS_PATH_MAX];
 	ProcessCommandLine(buf, argc, argv);
 	LOG(LM_MAIN, LL_INFO, "Command line (%d args):%s", argc, buf);
-	if (!ParseArgs(argc, argv, &connectAddr, &loadCampaign))
+	if (!ParseArgs(
+		argc, argv, &connectAddr, &loadCampaign, &isDedicated, &isBake))
 	{
 		goto bail;
 	}
+	if (isDedicated)
+	{
+		if (loadCampaign == NULL)
+		{
+			printf("Dedicated server needs a campaign to run\n");
+			goto bail;
+		}
+		ConfigGet(&gConfig, "StartServer")->u.Bool.Value = true;
+	}
+	// Dedicated servers, replays and baking run without video, sound or input
+	const bool isHeadless =
+		isDedicated || gReplay.Mode == REPLAY_MODE_PLAY || isBake;
 
 #ifndef __EMSCRIPTEN__
-	const int sdlFlags =
+	const int sdlFlags = isHeadless ?
+		SDL_INIT_TIMER | SDL_INIT_EVENTS :
 		SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_HAPTIC |
 		SDL_INIT_GAMECONTROLLER;
 #else
@@ -188,20 +207,25 @@ int main(int argc, char *argv[])
 	LOG(LM_MAIN, LL_INFO, "data dir(%s)", buf);
 	LOG(LM_MAIN, LL_INFO, "config dir(%s)", GetConfigFilePath(""));
 
-	SoundInitialize(&gSoundDevice, "sounds");
-	if (!gSoundDevice.isInitialised)
+	if (!isHeadless)
 	{
-		LOG(LM_MAIN, LL_ERROR, "Sound initialization failed!");
-	}
+		SoundInitialize(&gSoundDevice, "sounds");
+		if (!gSoundDevice.isInitialised)
+		{
+			LOG(LM_MAIN, LL_ERROR, "Sound initialization failed!");
+		}
 
-	LoadSongs();
+		LoadSongs();
 
-	MusicPlayMenu(&gSoundDevice);
+		MusicPlayMenu(&gSoundDevice);
+	}
 
 	EventInit(&gEventHandlers, NULL, NULL, true);
 	NetServerInit(&gNetServer);
+	NetStringsInit(&gNetStrings);
 	PicManagerInit(&gPicManager);
 	GraphicsInit(&gGraphicsDevice, &gConfig);
+	gGraphicsDevice.cachedConfig.IsHeadless = isHeadless;
 	GraphicsInitialize(&gGraphicsDevice);
 	if (!gGraphicsDevice.IsInitialized)
 	{
@@ -216,6 +240,12 @@ int main(int argc, char *argv[])
 		err = EXIT_FAILURE;
 		goto bail;
 	}
+	if (isBake)
+	{
+		err = PicManagerBake(&gPicManager, "graphics") ?
+			EXIT_SUCCESS : EXIT_FAILURE;
+		goto bail;
+	}
 	FontLoadFromJSON(&gFont, "graphics/font.png", "graphics/font.json");
 	PicManagerLoad(&gPicManager, "graphics");
 	CharSpriteClassesInit(&gCharSpriteClasses);
@@ -235,6 +265,7 @@ int main(int argc, char *argv[])
 	MapObjectsInit(
 		&gMapObjects, "data/map_objects.json", &gAmmo, &gGunDescriptions);
 	CollisionSystemInit(&gCollisionSystem);
+	ThreadPoolInit(&gThreadPool, "Worker");
 	CampaignInit(&gCampaign);
 	PlayerDataInit(&gPlayerDatas);
 
@@ -264,15 +295,35 @@ int main(int argc, char *argv[])
 			printf("Failed to connect\n");
 		}
 	}
-	if (!gCampaign.IsLoaded)
+	if (isDedicated)
+	{
+		if (gCampaign.IsLoaded)
+		{
+			LoopRunnerPush(&l, ScreenDedicatedServer());
+		}
+		else
+		{
+			err = EXIT_FAILURE;
+		}
+	}
+	else if (gReplay.Mode == REPLAY_MODE_PLAY)
+	{
+		LoopRunnerPush(&l, ScreenReplay());
+	}
+	else if (!gCampaign.IsLoaded)
 	{
 		LoopRunnerPush(&l, MainMenu(&gGraphicsDevice, &l));
 	}
 	LOG(LM_MAIN, LL_INFO, "Starting game");
 	LoopRunnerRun(&l);
 	LoopRunnerTerminate(&l);
+	if (gReplay.Mode == REPLAY_MODE_PLAY && gReplay.Desyncs > 0)
+	{
+		err = EXIT_FAILURE;
+	}
 
 bail:
+	ReplayTerminate(&gReplay);
 	NetServerTerminate(&gNetServer);
 	MapTerminate(&gMap);
 	PlayerDataTerminate(&gPlayerDatas);
@@ -285,11 +336,13 @@ bail:
 	CharacterClassesTerminate(&gCharacterClasses);
 	MissionOptionsTerminate(&gMission);
 	NetClientTerminate(&gNetClient);
+	NetStringsTerminate(&gNetStrings);
 	atexit(enet_deinitialize);
 	EventTerminate(&gEventHandlers);
 	GraphicsTerminate(&gGraphicsDevice);
 	CampaignTerminate(&gCampaign);
 	CollisionSystemTerminate(&gCollisionSystem);
+	ThreadPoolTerminate(&gThreadPool);
 
 	CharSpriteClassesTerminate(&gCharSpriteClasses);
 	PicManagerTerminate(&gPicManager);
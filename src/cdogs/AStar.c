@@ -549,3 +549,300 @@ void *ASPathGetNode(ASPath path, size_t idx)
 {
     return (path && idx < path->count)? (path->nodeKeys + (idx * path->nodeSize)) : NULL;
 }
+
+float ASPathGetCost(ASPath path)
+{
+    return path? path->cost : INFINITY;
+}
+
+ASPath ASPathCreateFromNodes(const void *nodes, size_t nodeSize, size_t count, float cost)
+{
+    ASPath path;
+    CMALLOC(path, sizeof(struct __ASPath) + (count * nodeSize));
+    path->nodeSize = nodeSize;
+    path->count = count;
+    path->cost = cost;
+    memcpy(path->nodeKeys, nodes, count * nodeSize);
+    return path;
+}
+
+/********************************************/
+
+typedef struct {
+    unsigned generation;                // search this record was last touched by
+    int8_t walkable;                    // -1 if not checked yet
+    unsigned isOpen:1;
+    unsigned isClosed:1;
+    float cost;
+    float rank;
+    int parentIndex;                    // -1 for the start
+    int openIndex;
+} GridNodeRecord;
+
+struct __ASGrid {
+    int width;
+    int height;
+    unsigned generation;
+    GridNodeRecord *nodeRecords;        // by tile index
+    int *openNodes;                     // binary heap of tile indexes, sorted by nodeRecords[i].rank
+    int openNodesCount;
+};
+
+ASGrid ASGridCreate(int width, int height)
+{
+    ASGrid grid;
+    CCALLOC(grid, sizeof(struct __ASGrid));
+    grid->width = width;
+    grid->height = height;
+    CCALLOC(grid->nodeRecords, width * height * sizeof(GridNodeRecord));
+    CCALLOC(grid->openNodes, width * height * sizeof(int));
+    return grid;
+}
+
+void ASGridDestroy(ASGrid grid)
+{
+    if (grid) {
+        CFREE(grid->nodeRecords);
+        CFREE(grid->openNodes);
+        CFREE(grid);
+    }
+}
+
+static GridNodeRecord *GridGetRecord(ASGrid grid, int idx)
+{
+    GridNodeRecord *record = &grid->nodeRecords[idx];
+    if (record->generation != grid->generation) {
+        memset(record, 0, sizeof *record);
+        record->generation = grid->generation;
+        record->walkable = -1;
+        record->parentIndex = -1;
+    }
+    return record;
+}
+
+static int GridIsWalkable(ASGrid grid, const ASGridSource *source, void *context, int x, int y)
+{
+    GridNodeRecord *record;
+    if (x < 0 || x >= grid->width || y < 0 || y >= grid->height) {
+        return 0;
+    }
+    record = GridGetRecord(grid, y * grid->width + x);
+    if (record->walkable < 0) {
+        record->walkable = source->isWalkable(x, y, context) ? 1 : 0;
+    }
+    return record->walkable;
+}
+
+static void GridSwapOpenNodes(ASGrid grid, int index1, int index2)
+{
+    const int tempNodeIndex = grid->openNodes[index1];
+    grid->openNodes[index1] = grid->openNodes[index2];
+    grid->openNodes[index2] = tempNodeIndex;
+    grid->nodeRecords[grid->openNodes[index1]].openIndex = index1;
+    grid->nodeRecords[grid->openNodes[index2]].openIndex = index2;
+}
+
+static float GridOpenNodeRank(ASGrid grid, int openIndex)
+{
+    return grid->nodeRecords[grid->openNodes[openIndex]].rank;
+}
+
+static void GridSiftUp(ASGrid grid, int idx)
+{
+    while (idx > 0) {
+        const int parentIndex = (idx - 1) / 2;
+        if (GridOpenNodeRank(grid, parentIndex) <= GridOpenNodeRank(grid, idx)) {
+            break;
+        }
+        GridSwapOpenNodes(grid, parentIndex, idx);
+        idx = parentIndex;
+    }
+}
+
+static void GridSiftDown(ASGrid grid, int idx)
+{
+    for (;;) {
+        const int leftIndex = (2 * idx) + 1;
+        const int rightIndex = (2 * idx) + 2;
+        int smallestIndex = idx;
+        if (leftIndex < grid->openNodesCount && GridOpenNodeRank(grid, leftIndex) < GridOpenNodeRank(grid, smallestIndex)) {
+            smallestIndex = leftIndex;
+        }
+        if (rightIndex < grid->openNodesCount && GridOpenNodeRank(grid, rightIndex) < GridOpenNodeRank(grid, smallestIndex)) {
+            smallestIndex = rightIndex;
+        }
+        if (smallestIndex == idx) {
+            break;
+        }
+        GridSwapOpenNodes(grid, smallestIndex, idx);
+        idx = smallestIndex;
+    }
+}
+
+static int GridPopOpenNode(ASGrid grid)
+{
+    const int idx = grid->openNodes[0];
+    grid->nodeRecords[idx].isOpen = 0;
+    grid->openNodesCount--;
+    if (grid->openNodesCount > 0) {
+        grid->openNodes[0] = grid->openNodes[grid->openNodesCount];
+        grid->nodeRecords[grid->openNodes[0]].openIndex = 0;
+        GridSiftDown(grid, 0);
+    }
+    return idx;
+}
+
+static void GridOpenNode(ASGrid grid, int idx, float cost, float rank, int parentIndex)
+{
+    GridNodeRecord *record = &grid->nodeRecords[idx];
+    record->cost = cost;
+    record->rank = rank;
+    record->parentIndex = parentIndex;
+    if (record->isOpen) {
+        // lower cost for a node already in the open set
+        GridSiftUp(grid, record->openIndex);
+    } else {
+        record->isOpen = 1;
+        record->openIndex = grid->openNodesCount;
+        grid->openNodes[grid->openNodesCount] = idx;
+        grid->openNodesCount++;
+        GridSiftUp(grid, record->openIndex);
+    }
+}
+
+static float GridHeuristic(const ASGridSource *source, int x, int y, int goalX, int goalY)
+{
+    // Every move covers at most one tile of the larger axis distance, so
+    // this never overestimates
+    const int dx = abs(x - goalX);
+    const int dy = abs(y - goalY);
+    float minCost = source->costX;
+    if (source->costY < minCost) {
+        minCost = source->costY;
+    }
+    if (source->costDiagonal < minCost) {
+        minCost = source->costDiagonal;
+    }
+    return minCost * (float)(dx > dy ? dx : dy);
+}
+
+// search from the start until the goal is reached, or the whole reachable
+// area if goalIndex is -1; returns whether the goal was reached
+static int GridSearch(ASGrid grid, const ASGridSource *source, void *context, int startIndex, int goalIndex)
+{
+    const int goalX = goalIndex >= 0 ? goalIndex % grid->width : 0;
+    const int goalY = goalIndex >= 0 ? goalIndex / grid->width : 0;
+
+    // start a new search; on wrapping, the stamps need clearing after all
+    grid->generation++;
+    if (grid->generation == 0) {
+        memset(grid->nodeRecords, 0, grid->width * grid->height * sizeof(GridNodeRecord));
+        grid->generation = 1;
+    }
+    grid->openNodesCount = 0;
+
+    GridGetRecord(grid, startIndex);
+    GridOpenNode(grid, startIndex, 0, goalIndex >= 0 ? GridHeuristic(source, startIndex % grid->width, startIndex / grid->width, goalX, goalY) : 0, -1);
+
+    // perform the A* algorithm
+    while (grid->openNodesCount > 0) {
+        const int current = GridPopOpenNode(grid);
+        const int x = current % grid->width;
+        const int y = current / grid->width;
+        GridNodeRecord *record = &grid->nodeRecords[current];
+        int dx, dy;
+        record->isClosed = 1;
+        if (current == goalIndex) {
+            return 1;
+        }
+
+        for (dy = -1; dy <= 1; dy++) {
+            for (dx = -1; dx <= 1; dx++) {
+                const int nx = x + dx;
+                const int ny = y + dy;
+                float cost;
+                GridNodeRecord *neighbor;
+                if ((dx == 0 && dy == 0) || !GridIsWalkable(grid, source, context, nx, ny)) {
+                    continue;
+                }
+                if (dx != 0 && dy != 0) {
+                    if (!GridIsWalkable(grid, source, context, x, ny) || !GridIsWalkable(grid, source, context, nx, y)) {
+                        continue;
+                    }
+                    cost = source->costDiagonal;
+                } else if (dx != 0) {
+                    cost = source->costX;
+                } else {
+                    cost = source->costY;
+                }
+                cost += record->cost;
+                neighbor = &grid->nodeRecords[ny * grid->width + nx];
+                // the heuristic is consistent, so closed nodes are final
+                if (neighbor->isClosed || (neighbor->isOpen && cost >= neighbor->cost)) {
+                    continue;
+                }
+                GridOpenNode(grid, ny * grid->width + nx, cost, cost + (goalIndex >= 0 ? GridHeuristic(source, nx, ny, goalX, goalY) : 0), current);
+            }
+        }
+    }
+    return 0;
+}
+
+ASPath ASGridPathCreate(ASGrid grid, const ASGridSource *source, void *context, int startX, int startY, int goalX, int goalY)
+{
+    int goalIndex;
+    ASPath path = NULL;
+    if (!grid || !source || !source->isWalkable ||
+        startX < 0 || startX >= grid->width || startY < 0 || startY >= grid->height ||
+        goalX < 0 || goalX >= grid->width || goalY < 0 || goalY >= grid->height) {
+        return NULL;
+    }
+    goalIndex = goalY * grid->width + goalX;
+
+    if (GridSearch(grid, source, context, startY * grid->width + startX, goalIndex)) {
+        size_t count = 0;
+        size_t i;
+        int n = goalIndex;
+        while (n >= 0) {
+            count++;
+            n = grid->nodeRecords[n].parentIndex;
+        }
+
+        CMALLOC(path, sizeof(struct __ASPath) + (count * 2 * sizeof(int)));
+        path->nodeSize = 2 * sizeof(int);
+        path->count = count;
+        path->cost = grid->nodeRecords[goalIndex].cost;
+
+        n = goalIndex;
+        for (i = count; i > 0; i--) {
+            int *node = (int *)(path->nodeKeys + ((i - 1) * path->nodeSize));
+            node[0] = n % grid->width;
+            node[1] = n / grid->width;
+            n = grid->nodeRecords[n].parentIndex;
+        }
+    }
+
+    return path;
+}
+
+void ASGridSearchAll(ASGrid grid, const ASGridSource *source, void *context, int startX, int startY)
+{
+    if (!grid || !source || !source->isWalkable ||
+        startX < 0 || startX >= grid->width || startY < 0 || startY >= grid->height) {
+        return;
+    }
+    GridSearch(grid, source, context, startY * grid->width + startX, -1);
+}
+
+float ASGridGetCost(ASGrid grid, int x, int y)
+{
+    const GridNodeRecord *record;
+    if (x < 0 || x >= grid->width || y < 0 || y >= grid->height) {
+        return -1;
+    }
+    record = &grid->nodeRecords[y * grid->width + x];
+    if (record->generation != grid->generation || !record->isClosed) {
+        return -1;
+    }
+    return record->cost;
+}
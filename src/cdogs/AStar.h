@@ -66,4 +66,41 @@ size_t ASPathGetCount(ASPath path);
 // returns a pointer to the given node in the path
 void *ASPathGetNode(ASPath path, size_t index);
 
+// the total cost of the edges in the path
+float ASPathGetCost(ASPath path);
+
+// create a path from an array of count nodes, each nodeSize bytes; for joining paths
+ASPath ASPathCreateFromNodes(const void *nodes, size_t nodeSize, size_t count, float cost);
+
+// Specialised A* for 8-connected grids
+// Instead of looking nodes up by key, the grid keeps a node record per tile,
+// and an open set big enough for every tile, all reused between searches.
+// Records are stamped with the search they were last touched by, so they
+// don't need clearing, and a search makes no allocations except the path.
+// Diagonal moves are only allowed if both axis-aligned neighbours are
+// walkable, so paths don't cut corners.
+// The nodes in the resulting paths are pairs of ints: x, y
+
+typedef struct __ASGrid *ASGrid;
+
+typedef struct {
+    int     (*isWalkable)(int x, int y, void *context);    // whether a tile can be entered; called at most once per tile per search
+    float   costX;                                          // cost of moving one tile horizontally
+    float   costY;                                          // cost of moving one tile vertically
+    float   costDiagonal;                                   // cost of moving one tile diagonally
+} ASGridSource;
+
+ASGrid ASGridCreate(int width, int height);
+void ASGridDestroy(ASGrid grid);
+
+// returns NULL if there is no path from start to goal
+ASPath ASGridPathCreate(ASGrid grid, const ASGridSource *source, void *context, int startX, int startY, int goalX, int goalY);
+
+// find the costs from start to every tile that can be reached (Dijkstra)
+void ASGridSearchAll(ASGrid grid, const ASGridSource *source, void *context, int startX, int startY);
+
+// the cost to a tile found by the last search, or -1 if it wasn't reached
+// (for ASGridPathCreate, only tiles that were closed before the goal count)
+float ASGridGetCost(ASGrid grid, int x, int y);
+
 #endif
@@ -66,6 +66,8 @@
 #include "events.h"
 #include "game_events.h"
 #include "log.h"
+#include "net_client.h"
+#include "net_server.h"
 #include "pic_manager.h"
 #include "sounds.h"
 #include "defs.h"
@@ -75,6 +77,7 @@
 #include "triggers.h"
 #include "mission.h"
 #include "game.h"
+#include "uid_map.h"
 #include "utils.h"
 
 #define FOOTSTEP_DISTANCE_PLUS 250
@@ -97,6 +100,7 @@ CArray gPlayerIds;
 
 CArray gActors;
 static unsigned int sActorUIDs = 0;
+static UIDMap sActorUIDMap;
 
 
 void ActorSetState(TActor *actor, const ActorAnimation state)
@@ -401,12 +405,91 @@ static struct vec2 GetConstrainedPos(
 	return from;
 }
 
+static void AckMove(TActor *a, const uint32_t seq, const struct vec2 pos);
 void ActorMove(const NActorMove am)
 {
 	TActor *a = ActorGetByUID(am.UID);
 	if (a == NULL || !a->isInUse) return;
-	a->Pos = NetToVec2(am.Pos);
+	const struct vec2 pos = NetToVec2(am.Pos);
 	a->MoveVel = NetToVec2(am.MoveVel);
+	if (gCampaign.IsClient && !ActorIsLocalPlayer(a->uid))
+	{
+		// Remote actors are shown interpolated; see ActorUpdatePosition
+		NetInterpAdd(&a->Interp, gMission.time, pos);
+		return;
+	}
+	if (!gCampaign.IsClient && a->PlayerUID >= 0 &&
+		!ActorIsLocalPlayer(a->uid))
+	{
+		AckMove(a, am.Seq, pos);
+		return;
+	}
+	a->Pos = pos;
+	OnMove(a);
+}
+// Client moves are accepted only as far as an actor could have moved since
+// its last accepted move, and are walked in short steps from where the
+// server has it, so they can't jump through walls
+#define ACTOR_MOVE_MAX_SPEED 4.0f	// per tick; allows for slides
+#define ACTOR_MOVE_MAX_TICKS FPS_FRAMELIMIT
+#define ACTOR_MOVE_STEP 4.0f
+static struct vec2 ConstrainClientMove(const TActor *a, const struct vec2 to);
+// Accept as much of a client's move as is valid, and tell the client where
+// its actor ended up, so it can correct its prediction
+static void AckMove(TActor *a, const uint32_t seq, const struct vec2 pos)
+{
+	const struct vec2 constrained = ConstrainClientMove(a, pos);
+	if (!svec2_is_nearly_equal(constrained, pos, EPSILON_POS))
+	{
+		LOG(LM_ACTOR, LL_DEBUG,
+			"constrain move uid(%d) seq(%u) (%f, %f) to (%f, %f)",
+			a->uid, seq, pos.x, pos.y, constrained.x, constrained.y);
+	}
+	a->MoveAckTime = gMission.time;
+	if (!svec2_is_nearly_equal(constrained, a->Pos, EPSILON_POS))
+	{
+		a->Pos = constrained;
+		OnMove(a);
+	}
+	NActorMoveAck ack = NActorMoveAck_init_default;
+	ack.UID = a->uid;
+	ack.Seq = seq;
+	ack.Pos = Vec2ToNet(a->Pos);
+	NetServerSendMsg(
+		&gNetServer, a->PlayerUID / MAX_LOCAL_PLAYERS - 1,
+		GAME_EVENT_ACTOR_MOVE_ACK, &ack);
+}
+static struct vec2 ConstrainClientMove(const TActor *a, const struct vec2 to)
+{
+	const int ticks =
+		CLAMP(gMission.time - a->MoveAckTime, 1, ACTOR_MOVE_MAX_TICKS);
+	const float maxDistance = ACTOR_MOVE_MAX_SPEED * ticks;
+	struct vec2 d = svec2_subtract(to, a->Pos);
+	float distance = svec2_length(d);
+	if (distance > maxDistance)
+	{
+		d = svec2_scale(d, maxDistance / distance);
+		distance = maxDistance;
+	}
+	const int steps = MAX(1, (int)ceilf(distance / ACTOR_MOVE_STEP));
+	const struct vec2 step = svec2_scale(d, 1.0f / steps);
+	struct vec2 pos = a->Pos;
+	for (int i = 0; i < steps; i++)
+	{
+		pos = GetConstrainedPos(
+			&gMap, pos, svec2_add(pos, step), a->tileItem.size);
+	}
+	return pos;
+}
+void ActorReplayMoves(TActor *a, struct vec2 pos, const NetPrediction *p)
+{
+	for (int i = 0; i < NetPredictionNumTicks(p); i++)
+	{
+		const struct vec2 delta = NetPredictionGetTick(p, i)->Delta;
+		pos = GetConstrainedPos(
+			&gMap, pos, svec2_add(pos, delta), a->tileItem.size);
+	}
+	a->Pos = pos;
 	OnMove(a);
 }
 static void CheckTrigger(const struct vec2i tilePos, const bool showLocked);
@@ -707,6 +790,19 @@ int ActorTryShoot(TActor *actor, int cmd)
 }
 
 static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks);
+// Number the next move sent, and remember it if we are predicting
+static uint32_t NextMoveSeq(TActor *a)
+{
+	a->MoveSeq++;
+	NetPrediction *p =
+		gCampaign.IsClient ?
+		NetClientGetPrediction(&gNetClient, a->PlayerUID, a->uid) : NULL;
+	if (p != NULL)
+	{
+		NetPredictionAddMove(p, a->MoveSeq, a->Pos);
+	}
+	return a->MoveSeq;
+}
 void CommandActor(TActor * actor, int cmd, int ticks)
 {
 	if (actor->confused)
@@ -822,6 +918,7 @@ static bool ActorTryMove(TActor *actor, int cmd, int hasShot, int ticks)
 		e.u.ActorMove.UID = actor->uid;
 		e.u.ActorMove.Pos = Vec2ToNet(actor->Pos);
 		e.u.ActorMove.MoveVel = Vec2ToNet(actor->MoveVel);
+		e.u.ActorMove.Seq = NextMoveSeq(actor);
 		GameEventsEnqueue(&gGameEvents, e);
 	}
 
@@ -858,7 +955,33 @@ void SlideActor(TActor *actor, int cmd)
 }
 
 static void ActorUpdatePosition(TActor *actor, int ticks);
+static void RefreshNetMove(TActor *a);
 static void ActorDie(TActor *actor);
+// Moves are sent on a sequenced, unreliable channel and only when commands
+// change, so a lost move would leave the actor stale on remote machines.
+// The server corrects this with snapshots; clients periodically resend the
+// latest move for their players, staggered by UID to spread them over ticks.
+#define ACTOR_MOVE_REFRESH_TICKS FPS_FRAMELIMIT
+static void RefreshNetMove(TActor *a)
+{
+	if (!gCampaign.IsClient || !ActorIsLocalPlayer(a->uid) ||
+		(gMission.time + a->uid) % ACTOR_MOVE_REFRESH_TICKS != 0)
+	{
+		return;
+	}
+	// Send directly instead of via game events, so we don't apply them locally
+	NActorMove am = NActorMove_init_default;
+	am.UID = a->uid;
+	am.Pos = Vec2ToNet(a->Pos);
+	am.MoveVel = Vec2ToNet(a->MoveVel);
+	am.Seq = NextMoveSeq(a);
+	NetClientSendMsg(&gNetClient, GAME_EVENT_ACTOR_MOVE, &am);
+	NActorDir ad = NActorDir_init_default;
+	ad.UID = a->uid;
+	ad.Dir = (int32_t)a->direction;
+	NetClientSendMsg(&gNetClient, GAME_EVENT_ACTOR_DIR, &ad);
+}
+
 void UpdateAllActors(int ticks)
 {
 	CA_FOREACH(TActor, actor, gActors)
@@ -876,6 +999,7 @@ void UpdateAllActors(int ticks)
 			}
 			continue;
 		}
+		RefreshNetMove(actor);
 		// Find actors that are on the same team and colliding,
 		// and repel them
 		if (!gCampaign.IsClient &&
@@ -929,6 +1053,18 @@ void UpdateAllActors(int ticks)
 static void CheckManualPickups(TActor *a);
 static void ActorUpdatePosition(TActor *actor, int ticks)
 {
+	if (gCampaign.IsClient && !ActorIsLocalPlayer(actor->uid))
+	{
+		struct vec2 pos;
+		if (NetInterpGet(
+				&actor->Interp, gMission.time - NET_INTERP_DELAY_TICKS, &pos) &&
+			!svec2_is_nearly_equal(actor->Pos, pos, EPSILON_POS))
+		{
+			actor->Pos = pos;
+			OnMove(actor);
+		}
+		return;
+	}
 	struct vec2 newPos = svec2_add(actor->Pos, actor->MoveVel);
 	if (!svec2_is_zero(actor->tileItem.Vel))
 	{
@@ -960,6 +1096,15 @@ static void ActorUpdatePosition(TActor *actor, int ticks)
 		}
 	}
 
+	NetPrediction *p =
+		gCampaign.IsClient ?
+		NetClientGetPrediction(&gNetClient, actor->PlayerUID, actor->uid) :
+		NULL;
+	if (p != NULL)
+	{
+		NetPredictionAddTick(
+			p, actor->MoveSeq, svec2_subtract(newPos, actor->Pos));
+	}
 	if (!svec2_is_nearly_equal(actor->Pos, newPos, EPSILON_POS))
 	{
 		TryMoveActor(actor, newPos);
@@ -1131,6 +1276,7 @@ void ActorsInit(void)
 	CArrayInit(&gActors, sizeof(TActor));
 	CArrayReserve(&gActors, 64);
 	sActorUIDs = 0;
+	UIDMapInit(&sActorUIDMap);
 }
 void ActorsTerminate(void)
 {
@@ -1139,6 +1285,7 @@ void ActorsTerminate(void)
 		ActorDestroy(a);
 	CA_FOREACH_END()
 	CArrayTerminate(&gActors);
+	UIDMapTerminate(&sActorUIDMap);
 }
 int ActorsGetNextUID(void)
 {
@@ -1177,6 +1324,7 @@ TActor *ActorAdd(NActorAdd aa)
 	TActor *actor = CArrayGet(&gActors, id);
 	memset(actor, 0, sizeof *actor);
 	actor->uid = aa.UID;
+	UIDMapSet(&sActorUIDMap, aa.UID, id);
 	LOG(LM_ACTOR, LL_DEBUG,
 		"add actor uid(%d) playerUID(%d)", actor->uid, aa.PlayerUID);
 	CArrayInit(&actor->guns, sizeof(Weapon));
@@ -1293,13 +1441,8 @@ void ActorDestroy(TActor *a)
 
 TActor *ActorGetByUID(const int uid)
 {
-	CA_FOREACH(TActor, a, gActors)
-		if (a->uid == uid)
-		{
-			return a;
-		}
-	CA_FOREACH_END()
-	return NULL;
+	const int id = UIDMapGet(&sActorUIDMap, uid);
+	return id >= 0 ? CArrayGet(&gActors, id) : NULL;
 }
 
 const Character *ActorGetCharacter(const TActor *a)
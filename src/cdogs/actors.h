@@ -53,6 +53,7 @@
 #include "emitter.h"
 #include "grafx.h"
 #include "mathc/mathc.h"
+#include "net_predict.h"
 #include "player.h"
 #include "weapon.h"
 
@@ -106,6 +107,12 @@ typedef struct Actor
 	// Whether the player ran into something whilst trying to move
 	// In this situation, we interrupt dead reckoning and resend the position
 	bool hasCollided;
+	// Sequence number of the last move sent
+	uint32_t MoveSeq;
+	// Mission time of the last client move accepted, on the server
+	int MoveAckTime;
+	// Positions received from the server, for remote actors on clients
+	NetInterp Interp;
 	// Whether the last special command was performed with a direction
 	// This differentiates between a special command and weapon switch
 	bool specialCmdDir;
@@ -174,6 +181,9 @@ void ActorSetState(TActor *actor, const ActorAnimation state);
 void UpdateActorState(TActor * actor, int ticks);
 bool TryMoveActor(TActor *actor, struct vec2 pos);
 void ActorMove(const NActorMove am);
+// Move a predicted actor to a corrected position, then replay the movement
+// made since
+void ActorReplayMoves(TActor *a, struct vec2 pos, const NetPrediction *p);
 void CommandActor(TActor *actor, int cmd, int ticks);
 void SlideActor(TActor *actor, int cmd);
 void UpdateAllActors(int ticks);
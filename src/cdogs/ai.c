@@ -61,9 +61,11 @@
 #include "game_events.h"
 #include "gamedata.h"
 #include "handle_game_events.h"
+#include "los.h"
 #include "mission.h"
 #include "net_util.h"
 #include "sys_specifics.h"
+#include "thread_pool.h"
 #include "utils.h"
 
 static int gBaddieCount = 0;
@@ -189,29 +191,30 @@ static bool IsDirectionOK(const TActor *a, const int dir)
 static int BrightWalk(TActor * actor, int roll)
 {
 	const CharBot *bot = ActorGetCharacter(actor)->bot;
-	if (!!(actor->flags & FLAGS_VISIBLE) && roll < bot->probabilityToTrack)
+	if (!!(actor->aiContext->Flags & FLAGS_VISIBLE) &&
+		roll < bot->probabilityToTrack)
 	{
-		actor->flags &= ~FLAGS_DETOURING;
+		actor->aiContext->Flags &= ~FLAGS_DETOURING;
 		return AIHuntClosest(actor);
 	}
 
-	if (actor->flags & FLAGS_TRYRIGHT)
+	if (actor->aiContext->Flags & FLAGS_TRYRIGHT)
 	{
-		if (IsDirectionOK(actor, (actor->direction + 7) % 8))
+		if (IsDirectionOK(actor, (actor->aiContext->Direction + 7) % 8))
 		{
-			actor->direction = (actor->direction + 7) % 8;
+			actor->aiContext->Direction = (actor->aiContext->Direction + 7) % 8;
 			actor->turns--;
 			if (actor->turns == 0)
 			{
-				actor->flags &= ~FLAGS_DETOURING;
+				actor->aiContext->Flags &= ~FLAGS_DETOURING;
 			}
 		}
-		else if (!IsDirectionOK(actor, actor->direction))
+		else if (!IsDirectionOK(actor, actor->aiContext->Direction))
 		{
-			actor->direction = (actor->direction + 1) % 8;
+			actor->aiContext->Direction = (actor->aiContext->Direction + 1) % 8;
 			actor->turns++;
 			if (actor->turns == 4) {
-				actor->flags &=
+				actor->aiContext->Flags &=
 				    ~(FLAGS_DETOURING | FLAGS_TRYRIGHT);
 				actor->turns = 0;
 			}
@@ -219,35 +222,35 @@ static int BrightWalk(TActor * actor, int roll)
 	}
 	else
 	{
-		if (IsDirectionOK(actor, (actor->direction + 1) % 8))
+		if (IsDirectionOK(actor, (actor->aiContext->Direction + 1) % 8))
 		{
-			actor->direction = (actor->direction + 1) % 8;
+			actor->aiContext->Direction = (actor->aiContext->Direction + 1) % 8;
 			actor->turns--;
 			if (actor->turns == 0)
-				actor->flags &= ~FLAGS_DETOURING;
+				actor->aiContext->Flags &= ~FLAGS_DETOURING;
 		}
-		else if (!IsDirectionOK(actor, actor->direction))
+		else if (!IsDirectionOK(actor, actor->aiContext->Direction))
 		{
-			actor->direction = (actor->direction + 7) % 8;
+			actor->aiContext->Direction = (actor->aiContext->Direction + 7) % 8;
 			actor->turns++;
 			if (actor->turns == 4) {
-				actor->flags &=
+				actor->aiContext->Flags &=
 				    ~(FLAGS_DETOURING | FLAGS_TRYRIGHT);
 				actor->turns = 0;
 			}
 		}
 	}
-	return DirectionToCmd(actor->direction);
+	return DirectionToCmd(actor->aiContext->Direction);
 }
 
 static int WillFire(TActor * actor, int roll)
 {
 	const CharBot *bot = ActorGetCharacter(actor)->bot;
-	if ((actor->flags & FLAGS_VISIBLE) != 0 &&
+	if ((actor->aiContext->Flags & FLAGS_VISIBLE) != 0 &&
 		ActorCanFire(actor) &&
 		roll < bot->probabilityToShoot)
 	{
-		if ((actor->flags & FLAGS_GOOD_GUY) != 0)
+		if ((actor->aiContext->Flags & FLAGS_GOOD_GUY) != 0)
 			return 1;	//!FacingPlayer( actor);
 		else if (sAreGoodGuysPresent)
 		{
@@ -255,7 +258,7 @@ static int WillFire(TActor * actor, int roll)
 		}
 		else
 		{
-			return IsFacingPlayer(actor, actor->direction);
+			return IsFacingPlayer(actor, actor->aiContext->Direction);
 		}
 	}
 	return 0;
@@ -263,13 +266,13 @@ static int WillFire(TActor * actor, int roll)
 
 void Detour(TActor * actor)
 {
-	actor->flags |= FLAGS_DETOURING;
+	actor->aiContext->Flags |= FLAGS_DETOURING;
 	actor->turns = 1;
-	if (actor->flags & FLAGS_TRYRIGHT)
-		actor->direction =
+	if (actor->aiContext->Flags & FLAGS_TRYRIGHT)
+		actor->aiContext->Direction =
 		    (CmdToDirection(actor->lastCmd) + 1) % 8;
 	else
-		actor->direction =
+		actor->aiContext->Direction =
 		    (CmdToDirection(actor->lastCmd) + 7) % 8;
 }
 
@@ -290,8 +293,49 @@ static bool DidPlayerShoot(void)
 	return false;
 }
 
-static int Follow(TActor *a);
-static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit);
+// Below this many AI, deciding on the worker threads isn't worth the wakeup
+#define AI_THREAD_MIN_ACTORS 32
+typedef struct
+{
+	int ticks;
+	int delayModifier;
+	int rollLimit;
+	CArray actors;	// of TActor *
+	CArray background;	// of TActor *
+} AIThinkData;
+static AIThinkData sThink;
+
+// AI level of detail: AI in sight of or near a player decide on every AI
+// update, the rest less often, staggered by UID so that they don't all
+// decide on the same update. Those decisions are also capped per update by
+// Game.AIBudget; AI that are put off go first next time.
+typedef enum
+{
+	AI_LOD_NEAR,
+	AI_LOD_MID,
+	AI_LOD_FAR
+} AILOD;
+// AI updates between decisions, by AILOD
+static const int sLODPeriods[] = { 1, 2, 4 };
+static AILOD GetLOD(const TActor *a)
+{
+	if (LOSTileIsVisible(&gMap, Vec2ToTile(a->Pos)) ||
+		IsCloseToPlayer(a->Pos, 16 * TILE_WIDTH))
+	{
+		return AI_LOD_NEAR;
+	}
+	// Within the distance that AI fall asleep at
+	if (IsCloseToPlayer(a->Pos, 40 * TILE_WIDTH))
+	{
+		return AI_LOD_MID;
+	}
+	return AI_LOD_FAR;
+}
+
+static void AddThinker(TActor *a);
+static void Think(void *data, const int index);
+static void Wait(TActor *a, const int ticks);
+static int CompareWait(const void *v1, const void *v2);
 int AICommand(const int ticks)
 {
 	int count = 0;
@@ -322,27 +366,145 @@ int AICommand(const int ticks)
 		break;
 	}
 
+	// Decide every AI's command from the same world state, then apply them
+	// in actor order. Each AI only writes to its context and draws from its
+	// own random stream while deciding, so the result doesn't depend on how
+	// the decisions are spread over threads.
+	// Followers and rescued AI share the path caches, so decide them here.
+	if (sThink.actors.elemSize == 0)
+	{
+		CArrayInit(&sThink.actors, sizeof(TActor *));
+		CArrayInit(&sThink.background, sizeof(TActor *));
+	}
+	CArrayClear(&sThink.actors);
+	CArrayClear(&sThink.background);
+	sThink.ticks = ticks;
+	sThink.delayModifier = delayModifier;
+	sThink.rollLimit = rollLimit;
+	const int update = gMission.time / AI_UPDATE_TICKS;
 	CA_FOREACH(TActor, actor, gActors)
 		if (!actor->isInUse || actor->PlayerUID >= 0 || actor->dead)
 		{
 			continue;
 		}
-		int cmd = 0;
-		if (!(actor->flags & FLAGS_PRISONER))
+		if (actor->flags & FLAGS_PRISONER)
 		{
-			if (actor->flags & (FLAGS_VICTIM | FLAGS_GOOD_GUY))
-			{
-				sAreGoodGuysPresent = true;
-			}
-			cmd = GetCmd(actor, delayModifier, rollLimit);
-			actor->aiContext->Delay = MAX(0, actor->aiContext->Delay - ticks);
+			actor->aiContext->LastCmd = 0;
+			continue;
 		}
-		CommandActor(actor, cmd, ticks);
-		actor->aiContext->LastCmd = cmd;
+		if (actor->flags & (FLAGS_VICTIM | FLAGS_GOOD_GUY))
+		{
+			sAreGoodGuysPresent = true;
+		}
+		const AILOD lod = GetLOD(actor);
+		if (lod == AI_LOD_NEAR)
+		{
+			actor->aiContext->ThinkWait = 0;
+			AddThinker(actor);
+		}
+		else if (actor->aiContext->ThinkWait > 0 ||
+			(update + actor->uid) % sLODPeriods[lod] == 0)
+		{
+			CArrayPushBack(&sThink.background, &actor);
+		}
+		else
+		{
+			Wait(actor, ticks);
+		}
+	CA_FOREACH_END()
+	const int budget = ConfigGetInt(&gConfig, "Game.AIBudget");
+	if (budget > 0 && (int)sThink.background.size > budget)
+	{
+		qsort(
+			sThink.background.data, sThink.background.size,
+			sThink.background.elemSize, CompareWait);
+	}
+	CA_FOREACH(TActor *, actor, sThink.background)
+		if (budget > 0 && _ca_index >= budget)
+		{
+			(*actor)->aiContext->ThinkWait++;
+			Wait(*actor, ticks);
+			continue;
+		}
+		(*actor)->aiContext->ThinkWait = 0;
+		AddThinker(*actor);
+	CA_FOREACH_END()
+
+	if ((int)sThink.actors.size >= AI_THREAD_MIN_ACTORS)
+	{
+		ThreadPoolRun(
+			&gThreadPool, Think, sThink.actors.data,
+			(int)sThink.actors.size);
+	}
+	else
+	{
+		for (int i = 0; i < (int)sThink.actors.size; i++)
+		{
+			Think(sThink.actors.data, i);
+		}
+	}
+
+	CA_FOREACH(TActor, actor, gActors)
+		if (!actor->isInUse || actor->PlayerUID >= 0 || actor->dead)
+		{
+			continue;
+		}
+		AIContext *c = actor->aiContext;
+		if (c->HasDecided)
+		{
+			actor->flags = c->Flags;
+			actor->direction = c->Direction;
+			c->HasDecided = false;
+		}
+		CommandActor(actor, c->LastCmd, ticks);
 		count++;
 	CA_FOREACH_END()
 	return count;
 }
+static bool UsesPathfinding(const TActor *a);
+static void AddThinker(TActor *a)
+{
+	if (UsesPathfinding(a))
+	{
+		Think(&a, 0);
+	}
+	else
+	{
+		CArrayPushBack(&sThink.actors, &a);
+	}
+}
+static void Wait(TActor *a, const int ticks)
+{
+	// Carry on with the last command, as in AICommandLast
+	a->aiContext->Delay = MAX(0, a->aiContext->Delay - ticks);
+}
+static int CompareWait(const void *v1, const void *v2)
+{
+	const TActor *a1 = *(const TActor * const *)v1;
+	const TActor *a2 = *(const TActor * const *)v2;
+	// Longest wait first, then in actor order
+	if (a1->aiContext->ThinkWait != a2->aiContext->ThinkWait)
+	{
+		return a2->aiContext->ThinkWait - a1->aiContext->ThinkWait;
+	}
+	return a1 < a2 ? -1 : 1;
+}
+static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit);
+static void Think(void *data, const int index)
+{
+	TActor *actor = ((TActor **)data)[index];
+	AIContext *c = actor->aiContext;
+	c->Flags = actor->flags;
+	c->Direction = actor->direction;
+	c->LastCmd = GetCmd(actor, sThink.delayModifier, sThink.rollLimit);
+	c->Delay = MAX(0, c->Delay - sThink.ticks);
+	c->HasDecided = true;
+}
+static bool UsesPathfinding(const TActor *a)
+{
+	return a->flags & (FLAGS_FOLLOWER | FLAGS_RESCUED);
+}
+static int Follow(TActor *a);
 static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 {
 	const CharBot *bot = ActorGetCharacter(actor)->bot;
@@ -350,16 +512,18 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 	int cmd = 0;
 
 	// Wake up if it can see a player
-	if ((actor->flags & FLAGS_SLEEPING) && actor->aiContext->Delay == 0)
+	if ((actor->aiContext->Flags & FLAGS_SLEEPING) &&
+		actor->aiContext->Delay == 0)
 	{
 		if (CanSeeAPlayer(actor))
 		{
-			actor->flags &= ~FLAGS_SLEEPING;
+			actor->aiContext->Flags &= ~FLAGS_SLEEPING;
 			ActorSetAIState(actor, AI_STATE_NONE);
 		}
 		actor->aiContext->Delay = bot->actionDelay * delayModifier;
 		// Randomly change direction
-		int newDir = (int)actor->direction + ((rand() % 2) * 2 - 1);
+		int newDir = (int)actor->aiContext->Direction +
+			((AIContextRand(actor->aiContext) % 2) * 2 - 1);
 		if (newDir < (int)DIRECTION_UP)
 		{
 			newDir = (int)DIRECTION_UPLEFT;
@@ -371,34 +535,34 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 		cmd = DirectionToCmd((int)newDir);
 	}
 	// Go to sleep if the player's too far away
-	if (!(actor->flags & FLAGS_SLEEPING) &&
+	if (!(actor->aiContext->Flags & FLAGS_SLEEPING) &&
 		actor->aiContext->Delay == 0 &&
-		!(actor->flags & FLAGS_AWAKEALWAYS))
+		!(actor->aiContext->Flags & FLAGS_AWAKEALWAYS))
 	{
 		if (!IsCloseToPlayer(actor->Pos, 40 * 16))
 		{
-			actor->flags |= FLAGS_SLEEPING;
+			actor->aiContext->Flags |= FLAGS_SLEEPING;
 			ActorSetAIState(actor, AI_STATE_IDLE);
 		}
 	}
 
-	if (actor->flags & FLAGS_SLEEPING)
+	if (actor->aiContext->Flags & FLAGS_SLEEPING)
 	{
 		return cmd;
 	}
 
 	bool bypass = false;
-	const int roll = rand() % rollLimit;
-	if (actor->flags & FLAGS_FOLLOWER)
+	const int roll = AIContextRand(actor->aiContext) % rollLimit;
+	if (actor->aiContext->Flags & FLAGS_FOLLOWER)
 	{
 		cmd = Follow(actor);
 	}
-	else if (!!(actor->flags & FLAGS_SNEAKY) &&
-		!!(actor->flags & FLAGS_VISIBLE) &&
+	else if (!!(actor->aiContext->Flags & FLAGS_SNEAKY) &&
+		!!(actor->aiContext->Flags & FLAGS_VISIBLE) &&
 		DidPlayerShoot())
 	{
 		cmd = AIHuntClosest(actor) | CMD_BUTTON1;
-		if (actor->flags & FLAGS_RUNS_AWAY)
+		if (actor->aiContext->Flags & FLAGS_RUNS_AWAY)
 		{
 			// Turn back and shoot for running away characters
 			cmd = AIReverseDirection(cmd);
@@ -406,12 +570,12 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 		bypass = true;
 		ActorSetAIState(actor, AI_STATE_HUNT);
 	}
-	else if (actor->flags & FLAGS_DETOURING)
+	else if (actor->aiContext->Flags & FLAGS_DETOURING)
 	{
 		cmd = BrightWalk(actor, roll);
 		ActorSetAIState(actor, AI_STATE_TRACK);
 	}
-	else if (actor->flags & FLAGS_RESCUED)
+	else if (actor->aiContext->Flags & FLAGS_RESCUED)
 	{
 		// If we haven't completed all objectives, act as follower
 		if (!CanCompleteMission(&gMission))
@@ -438,7 +602,7 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 		}
 		else if (roll < bot->probabilityToMove)
 		{
-			cmd = DirectionToCmd(rand() & 7);
+			cmd = DirectionToCmd(AIContextRand(actor->aiContext) & 7);
 			ActorSetAIState(actor, AI_STATE_TRACK);
 		}
 		actor->aiContext->Delay = bot->actionDelay * delayModifier;
@@ -448,14 +612,15 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 		if (WillFire(actor, roll))
 		{
 			cmd |= CMD_BUTTON1;
-			if (!!(actor->flags & FLAGS_FOLLOWER) &&
-				(actor->flags & FLAGS_GOOD_GUY))
+			if (!!(actor->aiContext->Flags & FLAGS_FOLLOWER) &&
+				(actor->aiContext->Flags & FLAGS_GOOD_GUY))
 			{
 				// Shoot in a random direction away
 				for (int j = 0; j < 10; j++)
 				{
 					direction_e d =
-						(direction_e)(rand() % DIRECTION_COUNT);
+						(direction_e)(AIContextRand(actor->aiContext) %
+						DIRECTION_COUNT);
 					if (!IsFacingPlayer(actor, d))
 					{
 						cmd = DirectionToCmd(d) | CMD_BUTTON1;
@@ -463,7 +628,7 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 					}
 				}
 			}
-			if (actor->flags & FLAGS_RUNS_AWAY)
+			if (actor->aiContext->Flags & FLAGS_RUNS_AWAY)
 			{
 				// Turn back and shoot for running away characters
 				cmd |= AIReverseDirection(AIHuntClosest(actor));
@@ -472,13 +637,13 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 		}
 		else
 		{
-			if ((actor->flags & FLAGS_VISIBLE) == 0)
+			if ((actor->aiContext->Flags & FLAGS_VISIBLE) == 0)
 			{
 				// I think this is some hack to make sure invisible enemies don't fire so much
 				ActorGetGun(actor)->lock = 40;
 			}
 			if (cmd && !IsDirectionOK(actor, CmdToDirection(cmd)) &&
-				(actor->flags & FLAGS_DETOURING) == 0)
+				(actor->aiContext->Flags & FLAGS_DETOURING) == 0)
 			{
 				Detour(actor);
 				cmd = 0;
@@ -497,8 +662,8 @@ static int Follow(TActor *a)
 	if (CharacterIsPrisoner(store, ch) && CanCompleteMission(&gMission) &&
 		MapIsTileInExit(&gMap, &a->tileItem))
 	{
-		a->flags &= ~FLAGS_FOLLOWER;
-		a->flags |= FLAGS_RESCUED;
+		a->aiContext->Flags &= ~FLAGS_FOLLOWER;
+		a->aiContext->Flags |= FLAGS_RESCUED;
 		return 0;
 	}
 	else if (IsCloseToPlayer(a->Pos, 32))
@@ -509,7 +674,9 @@ static int Follow(TActor *a)
 	else
 	{
 		ActorSetAIState(a, AI_STATE_FOLLOW);
-		return AIGoto(a, AIGetClosestPlayerPos(a->Pos), true);
+		const TActor *player = AIGetClosestPlayer(a->Pos);
+		if (player == NULL) return 0;
+		return AIGotoPlayer(a, player);
 	}
 }
 
@@ -50,6 +50,9 @@
 
 #include "actors.h"
 
+// Ticks between AI decisions
+#define AI_UPDATE_TICKS 4
+
 void InitializeBadGuys(void);
 void CreateEnemies(void);
 // Returns number of random enemies
@@ -27,6 +27,8 @@
 */
 #include "ai_context.h"
 
+#include <stdlib.h>
+
 
 AIContext *AIContextNew(void)
 {
@@ -36,6 +38,10 @@ AIContext *AIContextNew(void)
 	c->ChatterCounter = 2;
 	c->EnemyId = -1;
 	c->GunRangeScalar = 1.0;
+	// Seed from the game's stream; AI are created on the main thread in a
+	// fixed order so this is deterministic
+	c->RandState = (uint32_t)rand() * 2654435761u;
+	if (c->RandState == 0) c->RandState = 1;
 	return c;
 }
 void AIContextDestroy(AIContext *c)
@@ -47,6 +53,17 @@ void AIContextDestroy(AIContext *c)
 	CFREE(c);
 }
 
+int AIContextRand(AIContext *c)
+{
+	// xorshift32
+	uint32_t x = c->RandState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	c->RandState = x;
+	return (int)(x & AI_RAND_MAX);
+}
+
 const char *AIStateGetChatterText(const AIState s)
 {
 	switch (s)
@@ -27,7 +27,10 @@
 */
 #pragma once
 
+#include <stdint.h>
+
 #include "config.h"
+#include "defs.h"
 #include "objective.h"
 #include "path_cache.h"
 #include "vector.h"
@@ -107,10 +110,24 @@ typedef struct
 	int EnemyId;
 	double GunRangeScalar;
 	int OnGunId;
+	// Own random stream, so that AI can decide in parallel and still
+	// reproduce exactly
+	uint32_t RandState;
+	// AI updates that a due decision has been put off, by the AI budget
+	int ThinkWait;
+	// The actor's flags and direction as changed while deciding; other AI
+	// read the actor's own while deciding in parallel, so these are only
+	// applied to it afterwards
+	int Flags;
+	direction_e Direction;
+	bool HasDecided;
 } AIContext;
 
 AIContext *AIContextNew(void);
 void AIContextDestroy(AIContext *c);
+// Random number in [0, AI_RAND_MAX]; use instead of rand() for decisions
+int AIContextRand(AIContext *c);
+#define AI_RAND_MAX 0x7fffffff
 
 const char *AIStateGetChatterText(const AIState s);
 bool AIContextShowChatter(const AIContext *c, const AIChatterFrequency f);
@@ -112,7 +112,8 @@ int AICoopGetCmd(TActor *actor, const int ticks)
 }
 
 static int SmartGoto(
-	TActor *actor, const struct vec2 pos, const float minDistance2);
+	TActor *actor, const struct vec2 pos, const TActor *player,
+	const float minDistance2);
 static bool TryCompleteNearbyObjective(
 	TActor *actor, const TActor *closestPlayer,
 	const float distanceTooFarFromPlayer, int *cmdOut);
@@ -261,7 +262,8 @@ static int AICoopGetCmdNormal(TActor *actor)
 	if (closestPlayer && minDistance2 > SQUARED(distanceTooFarFromPlayer*16))
 	{
 		ActorSetAIState(actor, AI_STATE_FOLLOW);
-		return SmartGoto(actor, closestPlayer->Pos, minDistance2);
+		return SmartGoto(
+			actor, closestPlayer->Pos, closestPlayer, minDistance2);
 	}
 
 	// Check if closest enemy is close enough, and visible
@@ -306,7 +308,8 @@ static int AICoopGetCmdNormal(TActor *actor)
 		if (minDistance2 > SQUARED(2*16))
 		{
 			ActorSetAIState(actor, AI_STATE_FOLLOW);
-			return SmartGoto(actor, closestPlayer->Pos, minDistance2);
+			return SmartGoto(
+				actor, closestPlayer->Pos, closestPlayer, minDistance2);
 		}
 		else if (minDistance2 < SQUARED(4*16/3))
 		{
@@ -325,10 +328,13 @@ static int AICoopGetCmdNormal(TActor *actor)
 // - If clear path, slide
 // - If non-dangerous object blocking, shoot at it
 // - If stuck for a long time, pathfind around obstructing object
+// If going to a player, pass them in to use their flow field
 static int SmartGoto(
-	TActor *actor, const struct vec2 pos, const float minDistance2)
+	TActor *actor, const struct vec2 pos, const TActor *player,
+	const float minDistance2)
 {
-	int cmd = AIGoto(actor, pos, true);
+	int cmd = player != NULL ?
+		AIGotoPlayer(actor, player) : AIGoto(actor, pos, true);
 	// Try to slide if there is a clear path and we are far enough away
 	if (CMD_HAS_DIRECTION(cmd) &&
 		AIHasClearPath(actor->Pos, pos, !actor->aiContext->IsStuckTooLong) &&
@@ -806,7 +812,7 @@ static int GotoObjective(TActor *actor, const float objDistance2)
 		svec2_distance_squared(actor->Pos, goal) > SQUARED(3 * 16) ||
 		!AIHasClearShot(actor->Pos, goal))
 	{
-		cmd = SmartGoto(actor, goal, objDistance2);
+		cmd = SmartGoto(actor, goal, NULL, objDistance2);
 	}
 	else if (isDestruction && ActorGetGun(actor)->lock <= 0)
 	{
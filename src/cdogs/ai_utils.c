@@ -52,6 +52,7 @@
 
 #include "algorithms.h"
 #include "collision/collision.h"
+#include "flow_field.h"
 #include "gamedata.h"
 #include "map.h"
 #include "objs.h"
@@ -617,6 +618,31 @@ int AIGoto(const TActor *actor, const struct vec2 p, const bool ignoreObjects)
 		return AStarFollow(c, currentTile, &actor->tileItem, actor->Pos);
 	}
 }
+int AIGotoPlayer(const TActor *actor, const TActor *player)
+{
+	const struct vec2i currentTile = Vec2ToTile(actor->Pos);
+	const struct vec2i goalTile = Vec2ToTile(player->Pos);
+	if (svec2i_is_equal(currentTile, goalTile) ||
+		AIHasClearPath(actor->Pos, player->Pos, true))
+	{
+		return AIGotoDirect(actor->Pos, player->Pos);
+	}
+	const FlowField *f = FlowFieldsGet(&gFlowFields, player->uid, goalTile);
+	struct vec2i next;
+	if (!FlowFieldNextTile(f, &gMap, currentTile, &next))
+	{
+		// We may be somewhere the field doesn't reach, like next to an
+		// explosive; fall back to A*
+		return AIGoto(actor, player->Pos, true);
+	}
+	// Make sure the actor is fully within the current tile before moving
+	// to the next, otherwise it may get stuck at corners
+	if (!IsTileItemInsideTile(&actor->tileItem, currentTile))
+	{
+		next = currentTile;
+	}
+	return AIGotoDirect(actor->Pos, Vec2CenterOfTile(next));
+}
 
 // Hunt moves an Actor towards a target, using the most efficient direction.
 // That is, given the following octant:
@@ -73,6 +73,10 @@ bool AIIsInLine(const struct vec2i tile, const struct vec2i tileStart, const str
 // destroyObjects - if true, ignore obstructing objects
 //                - if false, will pathfind around them
 int AIGoto(const TActor *actor, const struct vec2 p, const bool ignoreObjects);
+// Go towards a player, using the flow field towards them
+// Cheaper than AIGoto when many AI are after the same player, as they all
+// share the one field
+int AIGotoPlayer(const TActor *actor, const TActor *player);
 int AIGotoDirect(const struct vec2 a, const struct vec2 p);
 int AIHunt(const TActor *actor, const struct vec2 targetPos);
 int AIAttack(const TActor *a, const struct vec2 targetPos);
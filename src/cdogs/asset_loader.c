@@ -0,0 +1,121 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "asset_loader.h"
+
+#include <string.h>
+
+#include <SDL_cpuinfo.h>
+#include <SDL_thread.h>
+
+#include "log.h"
+#include "utils.h"
+
+
+void AssetLoaderInit(AssetLoader *al)
+{
+	memset(al, 0, sizeof *al);
+	CArrayInit(&al->jobs, sizeof(AssetLoaderJob));
+	al->StartTicks = SDL_GetTicks();
+}
+void AssetLoaderTerminate(AssetLoader *al)
+{
+	CA_FOREACH(AssetLoaderJob, job, al->jobs)
+		CFREE(job->Path);
+		CFREE(job->Name);
+	CA_FOREACH_END()
+	CArrayTerminate(&al->jobs);
+}
+
+void AssetLoaderAdd(AssetLoader *al, const char *path, const char *name)
+{
+	AssetLoaderJob job;
+	CSTRDUP(job.Path, path);
+	CSTRDUP(job.Name, name);
+	job.Result = NULL;
+	CArrayPushBack(&al->jobs, &job);
+}
+
+static int LoadJobs(void *data);
+void AssetLoaderRun(AssetLoader *al, AssetLoadFunc load)
+{
+	al->ScanTicks = SDL_GetTicks();
+	al->load = load;
+	SDL_AtomicSet(&al->next, 0);
+
+#ifdef __EMSCRIPTEN__
+	// No threads
+	al->NumThreads = 1;
+#else
+	al->NumThreads = MIN(
+		MIN(SDL_GetCPUCount(), ASSET_LOADER_MAX_THREADS),
+		(int)al->jobs.size);
+#endif
+	al->NumThreads = MAX(al->NumThreads, 1);
+	// The main thread loads too, so start one fewer worker
+	SDL_Thread *threads[ASSET_LOADER_MAX_THREADS];
+	int numWorkers = 0;
+	for (int i = 1; i < al->NumThreads; i++)
+	{
+		threads[numWorkers] = SDL_CreateThread(LoadJobs, "AssetLoader", al);
+		if (threads[numWorkers] == NULL)
+		{
+			LOG(LM_MAIN, LL_WARN, "cannot create asset loader thread: %s",
+				SDL_GetError());
+			break;
+		}
+		numWorkers++;
+	}
+	al->NumThreads = numWorkers + 1;
+	LoadJobs(al);
+	for (int i = 0; i < numWorkers; i++)
+	{
+		SDL_WaitThread(threads[i], NULL);
+	}
+
+	al->LoadTicks = SDL_GetTicks();
+}
+static int LoadJobs(void *data)
+{
+	AssetLoader *al = data;
+	for (;;)
+	{
+		const int i = SDL_AtomicAdd(&al->next, 1);
+		if (i >= (int)al->jobs.size) break;
+		AssetLoaderJob *job = CArrayGet(&al->jobs, i);
+		job->Result = al->load(job->Path, job->Name);
+	}
+	return 0;
+}
+
+void AssetLoaderLogTimes(const AssetLoader *al, const char *type)
+{
+	LOG(LM_MAIN, LL_INFO,
+		"loaded %d %s on %d threads: find %dms, load %dms, add %dms",
+		(int)al->jobs.size, type, al->NumThreads,
+		(int)(al->ScanTicks - al->StartTicks),
+		(int)(al->LoadTicks - al->ScanTicks),
+		(int)(SDL_GetTicks() - al->LoadTicks));
+}
@@ -0,0 +1,70 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <SDL_atomic.h>
+#include <SDL_timer.h>
+
+#include "c_array.h"
+
+// Load assets on a pool of worker threads.
+// Files are first gathered on the main thread with AssetLoaderAdd, then
+// AssetLoaderRun decodes them in parallel. The results are left in the
+// jobs, in the order they were added, for the caller to insert into its
+// containers on the main thread; the load function must therefore not
+// touch any shared state.
+
+#define ASSET_LOADER_MAX_THREADS 16
+
+typedef struct
+{
+	char *Path;
+	char *Name;
+	void *Result;	// NULL if the load failed
+} AssetLoaderJob;
+
+// Load the file at path; runs on a worker thread
+typedef void *(*AssetLoadFunc)(const char *path, const char *name);
+
+typedef struct
+{
+	CArray jobs;	// of AssetLoaderJob
+	AssetLoadFunc load;
+	SDL_atomic_t next;	// index of the next job to load
+	int NumThreads;
+	// Timings of the load phases
+	Uint32 StartTicks;
+	Uint32 ScanTicks;
+	Uint32 LoadTicks;
+} AssetLoader;
+
+void AssetLoaderInit(AssetLoader *al);
+void AssetLoaderTerminate(AssetLoader *al);
+void AssetLoaderAdd(AssetLoader *al, const char *path, const char *name);
+void AssetLoaderRun(AssetLoader *al, AssetLoadFunc load);
+// Log the time spent finding, loading and then adding the assets;
+// call after the results have been added
+void AssetLoaderLogTimes(const AssetLoader *al, const char *type);
@@ -331,13 +331,9 @@ void AutomapDraw(int flags, bool showExit)
 	struct vec2i pos = svec2i_add(mapCenter, svec2i_scale(centerOn, -MAP_FACTOR));
 
 	// Draw faded green overlay
-	for (int y = 0; y < gGraphicsDevice.cachedConfig.Res.y; y++)
-	{
-		for (int x = 0; x < gGraphicsDevice.cachedConfig.Res.x; x++)
-		{
-			DrawPointMask(&gGraphicsDevice, svec2i(x, y), mask);
-		}
-	}
+	DrawRectangleMask(
+		&gGraphicsDevice, svec2i_zero(), gGraphicsDevice.cachedConfig.Res,
+		mask);
 
 	DrawMap(&gMap, mapCenter, centerOn, gMap.Size, MAP_FACTOR, flags);
 	DrawObjectivesAndKeys(&gMap, pos, MAP_FACTOR, flags);
@@ -53,9 +53,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdio.h>
 
 #include <SDL.h>
 
+#include "blit_kernels.h"
+#include "char_pic_cache.h"
 #include "config.h"
 #include "log.h"
 
@@ -76,9 +79,18 @@ color_t *CharColorGetByType(CharColors *c, const CharColorType t)
 }
 
 
+static bool BatchHighlight(
+	GraphicsDevice *g, const Pic *pic, const struct vec2i pos,
+	const color_t color);
 void BlitPicHighlight(
 	GraphicsDevice *g, const Pic *pic, const struct vec2i pos, const color_t color)
 {
+	if (BatchHighlight(g, pic, pos, color))
+	{
+		return;
+	}
+	RenderBatchSoftware(&g->batch);
+	const int stride = PIC_STRIDE(pic);
 	// Draw highlight around the picture
 	int i;
 	for (i = -1; i < pic->size.y + 1; i++)
@@ -111,7 +123,7 @@ void BlitPicHighlight(
 			bool isLeftOrRightEdge = j == -1 || j == pic->size.x;
 			bool isPixelEmpty =
 				isTopOrBottomEdge || isLeftOrRightEdge ||
-				!PIXEL2COLOR(*(pic->Data + j + i * pic->size.x)).a;
+				!PIXEL2COLOR(*(pic->Data + j + i * stride)).a;
 			if (isPixelEmpty &&
 				PicPxIsEdge(pic, svec2i(j, i), !isPixelEmpty))
 			{
@@ -129,7 +141,9 @@ void BlitBackground(
 	GraphicsDevice *device,
 	const Pic *pic, struct vec2i pos, const HSV *tint, const bool isTransparent)
 {
-	Uint32 *current = pic->Data;
+	// Tints what has already been drawn
+	RenderBatchSoftware(&device->batch);
+	const int stride = PIC_STRIDE(pic);
 	pos = svec2i_add(pos, pic->offset);
 	for (int i = 0; i < pic->size.y; i++)
 	{
@@ -140,10 +154,10 @@ void BlitBackground(
 		}
 		if (yoff < device->clipping.top)
 		{
-			current += pic->size.x;
 			continue;
 		}
 		yoff *= device->cachedConfig.Res.x;
+		const Uint32 *current = pic->Data + i * stride;
 		for (int j = 0; j < pic->size.x; j++)
 		{
 			int xoff = j + pos.x;
@@ -154,7 +168,6 @@ void BlitBackground(
 			}
 			if (xoff > device->clipping.right)
 			{
-				current += pic->size.x - j;
 				break;
 			}
 			if ((isTransparent && *current) ||  !isTransparent)
@@ -176,47 +189,135 @@ void BlitBackground(
 	}
 }
 
-void Blit(GraphicsDevice *device, const Pic *pic, struct vec2i pos)
+// A pic clipped to the device's clipping rectangle
+typedef struct
 {
-	Uint32 *current = pic->Data;
-	pos = svec2i_add(pos, pic->offset);
-	for (int i = 0; i < pic->size.y; i++)
+	const Uint32 *src;
+	Uint32 *dst;
+	struct vec2i size;
+	int srcStride;
+	int dstStride;
+	struct vec2i srcPos;
+	struct vec2i dstPos;
+} BlitRect;
+static bool BlitClip(
+	BlitRect *r, const GraphicsDevice *g, const Pic *pic,
+	const struct vec2i pos)
+{
+	const int left = MAX(pos.x, g->clipping.left);
+	const int right = MIN(pos.x + pic->size.x - 1, g->clipping.right);
+	const int top = MAX(pos.y, g->clipping.top);
+	const int bottom = MIN(pos.y + pic->size.y - 1, g->clipping.bottom);
+	if (left > right || top > bottom || pic->Data == NULL)
 	{
-		int yoff = i + pos.y;
-		if (yoff > device->clipping.bottom)
-		{
-			break;
-		}
-		if (yoff < device->clipping.top)
-		{
-			current += pic->size.x;
-			continue;
-		}
-		yoff *= device->cachedConfig.Res.x;
-		for (int j = 0; j < pic->size.x; j++)
+		return false;
+	}
+	r->size = svec2i(right - left + 1, bottom - top + 1);
+	r->srcStride = PIC_STRIDE(pic);
+	r->dstStride = g->cachedConfig.Res.x;
+	r->srcPos = svec2i(left - pos.x, top - pos.y);
+	r->dstPos = svec2i(left, top);
+	r->src = pic->Data + r->srcPos.y * r->srcStride + r->srcPos.x;
+	r->dst = g->buf + top * r->dstStride + left;
+	return true;
+}
+// Queue a clipped pic for the texture renderer
+static bool BatchPic(
+	GraphicsDevice *g, const Pic *pic, const BlitRect *r, const color_t mod,
+	const SDL_BlendMode blend)
+{
+	const SDL_Rect src = { r->srcPos.x, r->srcPos.y, r->size.x, r->size.y };
+	const SDL_Rect dst = { r->dstPos.x, r->dstPos.y, r->size.x, r->size.y };
+	return RenderBatchPic(&g->batch, pic, src, dst, mod, blend);
+}
+static const Pic *GetHighlightPic(GraphicsDevice *g, const Pic *pic);
+static bool BatchHighlight(
+	GraphicsDevice *g, const Pic *pic, const struct vec2i pos,
+	const color_t color)
+{
+	if (!RenderBatchIsEnabled(&g->batch) || pic->Data == NULL)
+	{
+		return false;
+	}
+	const Pic *highlight = GetHighlightPic(g, pic);
+	BlitRect r;
+	if (highlight == NULL)
+	{
+		return false;
+	}
+	if (!BlitClip(&r, g, highlight, svec2i_add(pos, highlight->offset)))
+	{
+		return true;
+	}
+	return BatchPic(g, highlight, &r, color, SDL_BLENDMODE_BLEND);
+}
+// White outline of a pic, to be coloured when drawn
+static const Pic *GetHighlightPic(GraphicsDevice *g, const Pic *pic)
+{
+	char key[64];
+	sprintf(key, "highlight/%p", (const void *)pic->Data);
+	const Pic *highlight = RenderBatchGetPic(&g->batch, key);
+	if (highlight != NULL)
+	{
+		return highlight;
+	}
+	const int stride = PIC_STRIDE(pic);
+	Pic h = picNone;
+	h.size = svec2i_add(pic->size, svec2i(2, 2));
+	h.offset = svec2i_subtract(pic->offset, svec2i(1, 1));
+	CCALLOC(h.Data, h.size.x * h.size.y * sizeof *h.Data);
+	for (int i = -1; i < pic->size.y + 1; i++)
+	{
+		for (int j = -1; j < pic->size.x + 1; j++)
 		{
-			Uint32 *target;
-			int xoff = j + pos.x;
-			if (xoff < device->clipping.left)
-			{
-				current++;
-				continue;
-			}
-			if (xoff > device->clipping.right)
-			{
-				current += pic->size.x - j;
-				break;
-			}
-			if ((*current & device->Format->Amask) == 0)
+			// Same as BlitPicHighlight
+			const bool isTopOrBottomEdge = i == -1 || i == pic->size.y;
+			const bool isLeftOrRightEdge = j == -1 || j == pic->size.x;
+			const bool isPixelEmpty =
+				isTopOrBottomEdge || isLeftOrRightEdge ||
+				!PIXEL2COLOR(*(pic->Data + j + i * stride)).a;
+			if (isPixelEmpty &&
+				PicPxIsEdge(pic, svec2i(j, i), !isPixelEmpty))
 			{
-				current++;
-				continue;
+				h.Data[(j + 1) + (i + 1) * h.size.x] = COLOR2PIXEL(colorWhite);
 			}
-			target = device->buf + yoff + xoff;
-			*target = *current;
-			current++;
 		}
 	}
+	return RenderBatchAddPic(&g->batch, key, &h);
+}
+static void BlitRows(
+	const BlitRect *r, const BlitSpanFunc f, const BlitSpanParams *p)
+{
+	const Uint32 *src = r->src;
+	Uint32 *dst = r->dst;
+	for (int i = 0; i < r->size.y; i++)
+	{
+		f(dst, src, r->size.x, p);
+		src += r->srcStride;
+		dst += r->dstStride;
+	}
+}
+static void BlitSpanParamsInit(BlitSpanParams *p, const GraphicsDevice *g)
+{
+	memset(p, 0, sizeof *p);
+	p->Amask = g->Format->Amask;
+	p->Ashift = g->Format->Ashift;
+}
+
+void Blit(GraphicsDevice *device, const Pic *pic, struct vec2i pos)
+{
+	BlitRect r;
+	if (!BlitClip(&r, device, pic, svec2i_add(pos, pic->offset)))
+	{
+		return;
+	}
+	if (BatchPic(device, pic, &r, colorWhite, SDL_BLENDMODE_BLEND))
+	{
+		return;
+	}
+	BlitSpanParams p;
+	BlitSpanParamsInit(&p, device);
+	BlitRows(&r, gBlitKernels->Copy, &p);
 }
 
 Uint32 PixelMult(const Uint32 p, const Uint32 m)
@@ -234,54 +335,29 @@ void BlitMasked(
 	color_t mask,
 	int isTransparent)
 {
-	Uint32 *current = pic->Data;
-	if (current == NULL)
+	if (pic->Data == NULL)
 	{
 		CASSERT(false, "unexpected NULL pic data");
 		return;
 	}
-	const Uint32 maskPixel = COLOR2PIXEL(mask);
-	int i;
-	pos = svec2i_add(pos, pic->offset);
-	for (i = 0; i < pic->size.y; i++)
+	BlitRect r;
+	if (!BlitClip(&r, device, pic, svec2i_add(pos, pic->offset)))
 	{
-		int yoff = i + pos.y;
-		if (yoff > device->clipping.bottom)
-		{
-			break;
-		}
-		if (yoff < device->clipping.top)
-		{
-			current += pic->size.x;
-			continue;
-		}
-		yoff *= device->cachedConfig.Res.x;
-		for (int j = 0; j < pic->size.x; j++)
-		{
-			Uint32 *target;
-			int xoff = j + pos.x;
-			if (xoff < device->clipping.left)
-			{
-				current++;
-				continue;
-			}
-			if (xoff > device->clipping.right)
-			{
-				current += pic->size.x - j;
-				break;
-			}
-			if (isTransparent &&
-				((*current & device->Format->Amask) >> device->Format->Ashift) < 3)
-			{
-				current++;
-				continue;
-			}
-			target = device->buf + yoff + xoff;
-			*target = PixelMult(*current, maskPixel);
-			*target |= device->Format->Amask;
-			current++;
-		}
+		return;
+	}
+	color_t mod = mask;
+	mod.a = 255;
+	if (BatchPic(
+			device, pic, &r, mod,
+			isTransparent ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE))
+	{
+		return;
 	}
+	BlitSpanParams p;
+	BlitSpanParamsInit(&p, device);
+	p.Mask = COLOR2PIXEL(mask);
+	p.IsTransparent = isTransparent;
+	BlitRows(&r, gBlitKernels->Masked, &p);
 }
 void BlitCharMultichannel(
 	GraphicsDevice *device,
@@ -289,48 +365,34 @@ void BlitCharMultichannel(
 	const struct vec2i pos,
 	const CharColors *masks)
 {
-	Uint32 *current = pic->Data;
-	struct vec2i v = svec2i_add(pos, pic->offset);
-	for (int i = 0; i < pic->size.y; i++)
+	BlitRect r;
+	if (!BlitClip(&r, device, pic, svec2i_add(pos, pic->offset)))
 	{
-		int yoff = i + v.y;
-		if (yoff > device->clipping.bottom)
-		{
-			break;
-		}
-		if (yoff < device->clipping.top)
-		{
-			current += pic->size.x;
-			continue;
-		}
-		yoff *= device->cachedConfig.Res.x;
-		for (int j = 0; j < pic->size.x; j++)
+		return;
+	}
+	BlitSpanParams p;
+	BlitSpanParamsInit(&p, device);
+	for (int i = 0; i < 6; i++)
+	{
+		p.ChannelMasks[i] = COLOR2PIXEL(
+			CharColorsGetChannelMask(masks, (uint8_t)(255 - i)));
+	}
+	// Draw the pre-coloured pic if possible
+	const Pic *coloured = CharPicCacheGet(&gCharPicCache, pic, &p);
+	if (coloured != NULL)
+	{
+		if (BatchPic(device, coloured, &r, colorWhite, SDL_BLENDMODE_BLEND))
 		{
-			Uint32 *target;
-			const int xoff = j + v.x;
-			if (xoff < device->clipping.left)
-			{
-				current++;
-				continue;
-			}
-			if (xoff > device->clipping.right)
-			{
-				current += pic->size.x - j;
-				break;
-			}
-			if (*current == 0)
-			{
-				current++;
-				continue;
-			}
-			target = device->buf + yoff + xoff;
-			const color_t color = PIXEL2COLOR(*current);
-			*target = PixelMult(
-				*current,
-				COLOR2PIXEL(CharColorsGetChannelMask(masks, color.a)));
-			current++;
+			return;
 		}
+		// The coloured pic has its own layout; it is not in the atlas
+		r.srcStride = PIC_STRIDE(coloured);
+		r.src = coloured->Data + r.srcPos.y * r.srcStride + r.srcPos.x;
+		BlitRows(&r, gBlitKernels->Copy, &p);
+		return;
 	}
+	RenderBatchSoftware(&device->batch);
+	BlitRows(&r, gBlitKernels->Multichannel, &p);
 }
 color_t CharColorsGetChannelMask(
 	const CharColors *c, const uint8_t alpha)
@@ -351,57 +413,41 @@ color_t CharColorsGetChannelMask(
 void BlitBlend(
 	GraphicsDevice *g, const Pic *pic, struct vec2i pos, const color_t blend)
 {
-	Uint32 *current = pic->Data;
-	pos = svec2i_add(pos, pic->offset);
-	for (int i = 0; i < pic->size.y; i++)
+	BlitRect r;
+	if (!BlitClip(&r, g, pic, svec2i_add(pos, pic->offset)))
 	{
-		int yoff = i + pos.y;
-		if (yoff > g->clipping.bottom)
-		{
-			break;
-		}
-		if (yoff < g->clipping.top)
-		{
-			current += pic->size.x;
-			continue;
-		}
-		yoff *= g->cachedConfig.Res.x;
-		for (int j = 0; j < pic->size.x; j++)
-		{
-			int xoff = j + pos.x;
-			if (xoff < g->clipping.left)
-			{
-				current++;
-				continue;
-			}
-			if (xoff > g->clipping.right)
-			{
-				current += pic->size.x - j;
-				break;
-			}
-			if (*current == 0)
-			{
-				current++;
-				continue;
-			}
-			Uint32 *target = g->buf + yoff + xoff;
-			const color_t currentColor = PIXEL2COLOR(*current);
-			color_t blendedColor = ColorMult(
-				currentColor, blend);
-			blendedColor.a = blend.a;
-			const color_t targetColor = PIXEL2COLOR(*target);
-			blendedColor = ColorAlphaBlend(targetColor, blendedColor);
-			*target = COLOR2PIXEL(blendedColor);
-			current++;
-		}
+		return;
 	}
+	if (BatchPic(g, pic, &r, blend, SDL_BLENDMODE_BLEND))
+	{
+		return;
+	}
+	BlitSpanParams p;
+	BlitSpanParamsInit(&p, g);
+	p.Mask = COLOR2PIXEL(blend);
+	BlitRows(&r, gBlitKernels->Blend, &p);
 }
 
 void BlitClearBuf(GraphicsDevice *g)
 {
+	if (RenderBatchIsEnabled(&g->batch))
+	{
+		// The buffer is only used if the layer falls back to software
+		RenderBatchClear(&g->batch);
+		return;
+	}
 	memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
 }
 void BlitUpdateFromBuf(GraphicsDevice *g, SDL_Texture *t)
 {
+	if (g->cachedConfig.IsHeadless)
+	{
+		return;
+	}
+	if (RenderBatchIsEnabled(&g->batch))
+	{
+		RenderBatchFlush(&g->batch, t);
+		return;
+	}
 	SDL_UpdateTexture(t, NULL, g->buf, g->cachedConfig.Res.x * sizeof(Uint32));
 }
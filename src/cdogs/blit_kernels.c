@@ -0,0 +1,530 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "blit_kernels.h"
+
+#include <SDL_cpuinfo.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIT_HAS_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define BLIT_HAS_AVX2
+#include <immintrin.h>
+#endif
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLIT_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef __GNUC__
+#define BLIT_AVX2 __attribute__((target("avx2")))
+#else
+#define BLIT_AVX2
+#endif
+
+
+// Scalar kernels; also used for the leftover pixels of SIMD kernels
+
+// floor(x / 255) for x <= 255 * 255, without dividing
+#define DIV255(_x) (((_x) + 1 + ((_x) >> 8)) >> 8)
+
+static Uint32 MulPixel(const Uint32 a, const Uint32 b)
+{
+	Uint32 out = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		const Uint32 x = ((a >> shift) & 0xFF) * ((b >> shift) & 0xFF);
+		out |= DIV255(x) << shift;
+	}
+	return out;
+}
+static Uint32 BlendPixel(const Uint32 t, const Uint32 s, const Uint32 alpha)
+{
+	Uint32 out = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		const Uint32 x =
+			((t >> shift) & 0xFF) * (255 - alpha) +
+			((s >> shift) & 0xFF) * alpha;
+		out |= DIV255(x) << shift;
+	}
+	return out;
+}
+
+static void CopyScalar(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	for (int i = 0; i < n; i++)
+	{
+		if (src[i] & p->Amask)
+		{
+			dst[i] = src[i];
+		}
+	}
+}
+static void MaskedScalar(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	for (int i = 0; i < n; i++)
+	{
+		if (p->IsTransparent && ((src[i] & p->Amask) >> p->Ashift) < 3)
+		{
+			continue;
+		}
+		dst[i] = MulPixel(src[i], p->Mask) | p->Amask;
+	}
+}
+static void MultichannelScalar(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	for (int i = 0; i < n; i++)
+	{
+		if (src[i] == 0)
+		{
+			continue;
+		}
+		const Uint32 channel = 255 - ((src[i] & p->Amask) >> p->Ashift);
+		// Unknown channels are left as is
+		const Uint32 mask = channel < 6 ? p->ChannelMasks[channel] : 0xFFFFFFFF;
+		dst[i] = MulPixel(src[i], mask);
+	}
+}
+static void BlendScalar(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const Uint32 alpha = (p->Mask & p->Amask) >> p->Ashift;
+	for (int i = 0; i < n; i++)
+	{
+		if (src[i] == 0)
+		{
+			continue;
+		}
+		dst[i] = BlendPixel(dst[i], MulPixel(src[i], p->Mask), alpha) |
+			p->Amask;
+	}
+}
+static const BlitKernels kernelsScalar = {
+	"scalar", CopyScalar, MaskedScalar, MultichannelScalar, BlendScalar
+};
+
+
+#ifdef BLIT_HAS_SSE2
+
+static __m128i SelectSSE2(const __m128i m, const __m128i a, const __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+static __m128i Div255SSE2(const __m128i x)
+{
+	const __m128i one = _mm_set1_epi16(1);
+	return _mm_srli_epi16(
+		_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+}
+static __m128i MulSSE2(const __m128i a, const __m128i b)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = _mm_mullo_epi16(
+		_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+	const __m128i hi = _mm_mullo_epi16(
+		_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+	return _mm_packus_epi16(Div255SSE2(lo), Div255SSE2(hi));
+}
+static __m128i AlphaSSE2(const __m128i s, const BlitSpanParams *p)
+{
+	return _mm_srl_epi32(
+		_mm_and_si128(s, _mm_set1_epi32((int)p->Amask)),
+		_mm_cvtsi32_si128(p->Ashift));
+}
+
+static void CopySSE2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m128i amask = _mm_set1_epi32((int)p->Amask);
+	const __m128i zero = _mm_setzero_si128();
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		const __m128i skip = _mm_cmpeq_epi32(_mm_and_si128(s, amask), zero);
+		_mm_storeu_si128((__m128i *)(dst + i), SelectSSE2(skip, d, s));
+	}
+	CopyScalar(dst + i, src + i, n - i, p);
+}
+static void MaskedSSE2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m128i amask = _mm_set1_epi32((int)p->Amask);
+	const __m128i mask = _mm_set1_epi32((int)p->Mask);
+	const __m128i three = _mm_set1_epi32(3);
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		const __m128i skip = p->IsTransparent ?
+			_mm_cmplt_epi32(AlphaSSE2(s, p), three) : _mm_setzero_si128();
+		const __m128i out = _mm_or_si128(MulSSE2(s, mask), amask);
+		_mm_storeu_si128((__m128i *)(dst + i), SelectSSE2(skip, d, out));
+	}
+	MaskedScalar(dst + i, src + i, n - i, p);
+}
+static void MultichannelSSE2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i white = _mm_set1_epi32(-1);
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		const __m128i alpha = AlphaSSE2(s, p);
+		__m128i mask = white;
+		for (int c = 0; c < 6; c++)
+		{
+			const __m128i isChannel =
+				_mm_cmpeq_epi32(alpha, _mm_set1_epi32(255 - c));
+			mask = SelectSSE2(
+				isChannel, _mm_set1_epi32((int)p->ChannelMasks[c]), mask);
+		}
+		const __m128i skip = _mm_cmpeq_epi32(s, zero);
+		_mm_storeu_si128(
+			(__m128i *)(dst + i), SelectSSE2(skip, d, MulSSE2(s, mask)));
+	}
+	MultichannelScalar(dst + i, src + i, n - i, p);
+}
+static void BlendSSE2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i amask = _mm_set1_epi32((int)p->Amask);
+	const __m128i mask = _mm_set1_epi32((int)p->Mask);
+	const int alpha = (int)((p->Mask & p->Amask) >> p->Ashift);
+	const __m128i a = _mm_set1_epi16((short)alpha);
+	const __m128i invA = _mm_set1_epi16((short)(255 - alpha));
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		const __m128i m = MulSSE2(s, mask);
+		const __m128i lo = _mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), invA),
+			_mm_mullo_epi16(_mm_unpacklo_epi8(m, zero), a));
+		const __m128i hi = _mm_add_epi16(
+			_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), invA),
+			_mm_mullo_epi16(_mm_unpackhi_epi8(m, zero), a));
+		const __m128i out = _mm_or_si128(
+			_mm_packus_epi16(Div255SSE2(lo), Div255SSE2(hi)), amask);
+		const __m128i skip = _mm_cmpeq_epi32(s, zero);
+		_mm_storeu_si128((__m128i *)(dst + i), SelectSSE2(skip, d, out));
+	}
+	BlendScalar(dst + i, src + i, n - i, p);
+}
+static const BlitKernels kernelsSSE2 = {
+	"SSE2", CopySSE2, MaskedSSE2, MultichannelSSE2, BlendSSE2
+};
+
+#endif
+
+
+#ifdef BLIT_HAS_AVX2
+
+BLIT_AVX2 static __m256i SelectAVX2(
+	const __m256i m, const __m256i a, const __m256i b)
+{
+	return _mm256_or_si256(_mm256_and_si256(m, a), _mm256_andnot_si256(m, b));
+}
+BLIT_AVX2 static __m256i Div255AVX2(const __m256i x)
+{
+	const __m256i one = _mm256_set1_epi16(1);
+	return _mm256_srli_epi16(
+		_mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)),
+		8);
+}
+BLIT_AVX2 static __m256i MulAVX2(const __m256i a, const __m256i b)
+{
+	// Unpack and pack work within 128-bit lanes, so the order is kept
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i lo = _mm256_mullo_epi16(
+		_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+	const __m256i hi = _mm256_mullo_epi16(
+		_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+	return _mm256_packus_epi16(Div255AVX2(lo), Div255AVX2(hi));
+}
+BLIT_AVX2 static __m256i AlphaAVX2(const __m256i s, const BlitSpanParams *p)
+{
+	return _mm256_srl_epi32(
+		_mm256_and_si256(s, _mm256_set1_epi32((int)p->Amask)),
+		_mm_cvtsi32_si128(p->Ashift));
+}
+
+BLIT_AVX2 static void CopyAVX2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m256i amask = _mm256_set1_epi32((int)p->Amask);
+	const __m256i zero = _mm256_setzero_si256();
+	int i;
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+		const __m256i skip =
+			_mm256_cmpeq_epi32(_mm256_and_si256(s, amask), zero);
+		_mm256_storeu_si256((__m256i *)(dst + i), SelectAVX2(skip, d, s));
+	}
+	CopyScalar(dst + i, src + i, n - i, p);
+}
+BLIT_AVX2 static void MaskedAVX2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m256i amask = _mm256_set1_epi32((int)p->Amask);
+	const __m256i mask = _mm256_set1_epi32((int)p->Mask);
+	const __m256i three = _mm256_set1_epi32(3);
+	int i;
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+		const __m256i skip = p->IsTransparent ?
+			_mm256_cmpgt_epi32(three, AlphaAVX2(s, p)) :
+			_mm256_setzero_si256();
+		const __m256i out = _mm256_or_si256(MulAVX2(s, mask), amask);
+		_mm256_storeu_si256((__m256i *)(dst + i), SelectAVX2(skip, d, out));
+	}
+	MaskedScalar(dst + i, src + i, n - i, p);
+}
+BLIT_AVX2 static void MultichannelAVX2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i white = _mm256_set1_epi32(-1);
+	int i;
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+		const __m256i alpha = AlphaAVX2(s, p);
+		__m256i mask = white;
+		for (int c = 0; c < 6; c++)
+		{
+			const __m256i isChannel =
+				_mm256_cmpeq_epi32(alpha, _mm256_set1_epi32(255 - c));
+			mask = SelectAVX2(
+				isChannel, _mm256_set1_epi32((int)p->ChannelMasks[c]), mask);
+		}
+		const __m256i skip = _mm256_cmpeq_epi32(s, zero);
+		_mm256_storeu_si256(
+			(__m256i *)(dst + i), SelectAVX2(skip, d, MulAVX2(s, mask)));
+	}
+	MultichannelScalar(dst + i, src + i, n - i, p);
+}
+BLIT_AVX2 static void BlendAVX2(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i amask = _mm256_set1_epi32((int)p->Amask);
+	const __m256i mask = _mm256_set1_epi32((int)p->Mask);
+	const int alpha = (int)((p->Mask & p->Amask) >> p->Ashift);
+	const __m256i a = _mm256_set1_epi16((short)alpha);
+	const __m256i invA = _mm256_set1_epi16((short)(255 - alpha));
+	int i;
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+		const __m256i m = MulAVX2(s, mask);
+		const __m256i lo = _mm256_add_epi16(
+			_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), invA),
+			_mm256_mullo_epi16(_mm256_unpacklo_epi8(m, zero), a));
+		const __m256i hi = _mm256_add_epi16(
+			_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), invA),
+			_mm256_mullo_epi16(_mm256_unpackhi_epi8(m, zero), a));
+		const __m256i out = _mm256_or_si256(
+			_mm256_packus_epi16(Div255AVX2(lo), Div255AVX2(hi)), amask);
+		const __m256i skip = _mm256_cmpeq_epi32(s, zero);
+		_mm256_storeu_si256((__m256i *)(dst + i), SelectAVX2(skip, d, out));
+	}
+	BlendScalar(dst + i, src + i, n - i, p);
+}
+static const BlitKernels kernelsAVX2 = {
+	"AVX2", CopyAVX2, MaskedAVX2, MultichannelAVX2, BlendAVX2
+};
+
+#endif
+
+
+#ifdef BLIT_HAS_NEON
+
+static uint8x8_t Div255NEON(const uint16x8_t x)
+{
+	return vshrn_n_u16(
+		vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+static uint32x4_t MulNEON(const uint32x4_t a, const uint32x4_t b)
+{
+	const uint8x16_t a8 = vreinterpretq_u8_u32(a);
+	const uint8x16_t b8 = vreinterpretq_u8_u32(b);
+	const uint16x8_t lo = vmull_u8(vget_low_u8(a8), vget_low_u8(b8));
+	const uint16x8_t hi = vmull_u8(vget_high_u8(a8), vget_high_u8(b8));
+	return vreinterpretq_u32_u8(
+		vcombine_u8(Div255NEON(lo), Div255NEON(hi)));
+}
+static uint32x4_t AlphaNEON(const uint32x4_t s, const BlitSpanParams *p)
+{
+	return vshlq_u32(
+		vandq_u32(s, vdupq_n_u32(p->Amask)), vdupq_n_s32(-p->Ashift));
+}
+
+static void CopyNEON(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const uint32x4_t amask = vdupq_n_u32(p->Amask);
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const uint32x4_t s = vld1q_u32(src + i);
+		const uint32x4_t d = vld1q_u32(dst + i);
+		const uint32x4_t skip = vceqq_u32(vandq_u32(s, amask), vdupq_n_u32(0));
+		vst1q_u32(dst + i, vbslq_u32(skip, d, s));
+	}
+	CopyScalar(dst + i, src + i, n - i, p);
+}
+static void MaskedNEON(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const uint32x4_t amask = vdupq_n_u32(p->Amask);
+	const uint32x4_t mask = vdupq_n_u32(p->Mask);
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const uint32x4_t s = vld1q_u32(src + i);
+		const uint32x4_t d = vld1q_u32(dst + i);
+		const uint32x4_t skip = p->IsTransparent ?
+			vcltq_u32(AlphaNEON(s, p), vdupq_n_u32(3)) : vdupq_n_u32(0);
+		const uint32x4_t out = vorrq_u32(MulNEON(s, mask), amask);
+		vst1q_u32(dst + i, vbslq_u32(skip, d, out));
+	}
+	MaskedScalar(dst + i, src + i, n - i, p);
+}
+static void MultichannelNEON(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const uint32x4_t s = vld1q_u32(src + i);
+		const uint32x4_t d = vld1q_u32(dst + i);
+		const uint32x4_t alpha = AlphaNEON(s, p);
+		uint32x4_t mask = vdupq_n_u32(0xFFFFFFFF);
+		for (int c = 0; c < 6; c++)
+		{
+			const uint32x4_t isChannel =
+				vceqq_u32(alpha, vdupq_n_u32(255 - c));
+			mask = vbslq_u32(
+				isChannel, vdupq_n_u32(p->ChannelMasks[c]), mask);
+		}
+		const uint32x4_t skip = vceqq_u32(s, vdupq_n_u32(0));
+		vst1q_u32(dst + i, vbslq_u32(skip, d, MulNEON(s, mask)));
+	}
+	MultichannelScalar(dst + i, src + i, n - i, p);
+}
+static void BlendNEON(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p)
+{
+	const uint32x4_t amask = vdupq_n_u32(p->Amask);
+	const uint32x4_t mask = vdupq_n_u32(p->Mask);
+	const Uint32 alpha = (p->Mask & p->Amask) >> p->Ashift;
+	const uint8x8_t a = vdup_n_u8((uint8_t)alpha);
+	const uint8x8_t invA = vdup_n_u8((uint8_t)(255 - alpha));
+	int i;
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		const uint32x4_t s = vld1q_u32(src + i);
+		const uint32x4_t d = vld1q_u32(dst + i);
+		const uint8x16_t d8 = vreinterpretq_u8_u32(d);
+		const uint8x16_t m8 = vreinterpretq_u8_u32(MulNEON(s, mask));
+		const uint16x8_t lo = vmlal_u8(
+			vmull_u8(vget_low_u8(d8), invA), vget_low_u8(m8), a);
+		const uint16x8_t hi = vmlal_u8(
+			vmull_u8(vget_high_u8(d8), invA), vget_high_u8(m8), a);
+		const uint32x4_t out = vorrq_u32(
+			vreinterpretq_u32_u8(vcombine_u8(Div255NEON(lo), Div255NEON(hi))),
+			amask);
+		const uint32x4_t skip = vceqq_u32(s, vdupq_n_u32(0));
+		vst1q_u32(dst + i, vbslq_u32(skip, d, out));
+	}
+	BlendScalar(dst + i, src + i, n - i, p);
+}
+static const BlitKernels kernelsNEON = {
+	"NEON", CopyNEON, MaskedNEON, MultichannelNEON, BlendNEON
+};
+
+#endif
+
+
+const BlitKernels *gBlitKernels = &kernelsScalar;
+
+void BlitKernelsInit(void)
+{
+	// Prefer the widest
+	for (int t = BLIT_KERNELS_COUNT - 1; t >= 0; t--)
+	{
+		const BlitKernels *k = BlitKernelsGet((BlitKernelsType)t);
+		if (k != NULL)
+		{
+			gBlitKernels = k;
+			break;
+		}
+	}
+}
+
+const BlitKernels *BlitKernelsGet(const BlitKernelsType t)
+{
+	switch (t)
+	{
+	case BLIT_KERNELS_SCALAR:
+		return &kernelsScalar;
+#ifdef BLIT_HAS_SSE2
+	case BLIT_KERNELS_SSE2:
+		return SDL_HasSSE2() ? &kernelsSSE2 : NULL;
+#endif
+#ifdef BLIT_HAS_AVX2
+	case BLIT_KERNELS_AVX2:
+		return SDL_HasAVX2() ? &kernelsAVX2 : NULL;
+#endif
+#ifdef BLIT_HAS_NEON
+	case BLIT_KERNELS_NEON:
+		// Only built if the target always has NEON
+		return &kernelsNEON;
+#endif
+	default:
+		return NULL;
+	}
+}
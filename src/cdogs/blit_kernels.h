@@ -0,0 +1,80 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_stdinc.h>
+
+// Inner loops of the software blitter.
+// Each kernel draws one row ("span") of an already clipped pic, so the
+// kernels only deal with pixels; there are SIMD versions which process
+// 4-8 pixels at a time, picked at runtime by CPU features. All versions
+// must produce exactly the same pixels as the scalar ones.
+
+typedef enum
+{
+	BLIT_KERNELS_SCALAR,
+	BLIT_KERNELS_SSE2,
+	BLIT_KERNELS_AVX2,
+	BLIT_KERNELS_NEON,
+	BLIT_KERNELS_COUNT
+} BlitKernelsType;
+
+typedef struct
+{
+	Uint32 Amask;
+	int Ashift;
+	// Masked: the mask; Blend: the blend colour, with its alpha
+	Uint32 Mask;
+	// Masked: skip nearly transparent pixels (alpha < 3)
+	bool IsTransparent;
+	// Multichannel: masks by 255 - alpha, i.e. white, skin, arms, body,
+	// legs, hair
+	Uint32 ChannelMasks[6];
+} BlitSpanParams;
+
+typedef void (*BlitSpanFunc)(
+	Uint32 *dst, const Uint32 *src, const int n, const BlitSpanParams *p);
+typedef struct
+{
+	const char *Name;
+	// Copy pixels that have any alpha
+	BlitSpanFunc Copy;
+	// Multiply by mask, with full alpha
+	BlitSpanFunc Masked;
+	// Multiply non-empty pixels by the channel mask given by their alpha
+	BlitSpanFunc Multichannel;
+	// Multiply non-empty pixels by mask, then alpha blend with mask alpha
+	BlitSpanFunc Blend;
+} BlitKernels;
+
+extern const BlitKernels *gBlitKernels;
+
+// Pick the fastest kernels for this CPU
+void BlitKernelsInit(void);
+// Get a set of kernels, or NULL if not supported by this build or CPU
+const BlitKernels *BlitKernelsGet(const BlitKernelsType t);
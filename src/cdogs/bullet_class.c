@@ -52,9 +52,11 @@
 #include <math.h>
 
 #include "ai_utils.h"
+#include "class_index.h"
 #include "collision/collision.h"
 #include "draw/drawtools.h"
 #include "game_events.h"
+#include "json_stream.h"
 #include "json_utils.h"
 #include "log.h"
 #include "net_util.h"
@@ -66,25 +68,23 @@ BulletClasses gBulletClasses;
 #define SPECIAL_LOCK 12
 
 
-// TODO: use map structure?
 BulletClass *StrBulletClass(const char *s)
 {
 	if (s == NULL || strlen(s) == 0)
 	{
 		return NULL;
 	}
-	CA_FOREACH(BulletClass, b, gBulletClasses.CustomClasses)
-		if (strcmp(s, b->Name) == 0)
-		{
-			return b;
-		}
-	CA_FOREACH_END()
-	CA_FOREACH(BulletClass, b, gBulletClasses.Classes)
-		if (strcmp(s, b->Name) == 0)
-		{
-			return b;
-		}
-	CA_FOREACH_END()
+	// Custom classes take precedence
+	const CArray *arrays[] =
+	{
+		&gBulletClasses.CustomClasses, &gBulletClasses.Classes, NULL
+	};
+	BulletClass *b = ClassIndexGet(
+		&gBulletClasses.index, arrays, offsetof(BulletClass, Name), s);
+	if (b != NULL)
+	{
+		return b;
+	}
 	CASSERT(false, "cannot parse bullet name");
 	return NULL;
 }
@@ -566,35 +566,67 @@ void BulletInitialize(BulletClasses *bullets)
 	CArrayInit(&bullets->CustomClasses, sizeof(BulletClass));
 }
 static void BulletClassFree(BulletClass *b);
-void BulletLoadJSON(
-	BulletClasses *bullets, CArray *classes, json_t *bulletNode)
+typedef struct
+{
+	BulletClasses *bullets;
+	CArray *classes;
+	int version;	// 0 until the header is loaded
+} BulletsStream;
+static bool LoadBulletElement(json_t *root, json_t **node, void *data);
+static bool LoadBulletsHeader(BulletsStream *bs, json_t *root);
+bool BulletLoadJSON(
+	BulletClasses *bullets, CArray *classes, const char *filename)
+{
+	LOG(LM_MAP, LL_DEBUG, "loading bullets %s", filename);
+	ClassIndexReset(&gBulletClasses.index);
+	BulletsStream bs = { bullets, classes, 0 };
+	JSONStream s;
+	JSONStreamInit(&s);
+	JSONStreamAddArray(&s, "Bullets", LoadBulletElement, &bs);
+	bool res = JSONStreamParseFile(&s, filename);
+	if (res && bs.version == 0)
+	{
+		// No bullets
+		res = LoadBulletsHeader(&bs, s.root);
+	}
+	JSONStreamTerminate(&s);
+	return res;
+}
+static bool LoadBulletElement(json_t *root, json_t **node, void *data)
 {
-	LOG(LM_MAP, LL_DEBUG, "loading bullets");
-	int version;
-	LoadInt(&version, bulletNode, "Version");
-	if (version > VERSION || version <= 0)
+	BulletsStream *bs = data;
+	if (bs->version == 0 && !LoadBulletsHeader(bs, root))
+	{
+		return false;
+	}
+	BulletClass b;
+	LoadBullet(&b, *node, &bs->bullets->Default, bs->version);
+	// Keep the node for loading weapons; see BulletLoadWeapons
+	*node = NULL;
+	CArrayPushBack(bs->classes, &b);
+	return true;
+}
+static bool LoadBulletsHeader(BulletsStream *bs, json_t *root)
+{
+	LoadInt(&bs->version, root, "Version");
+	if (bs->version > VERSION || bs->version <= 0)
 	{
 		CASSERT(false, "cannot read bullets file version");
-		return;
+		bs->version = 0;
+		return false;
 	}
 
 	// Defaults
-	json_t *defaultNode = json_find_first_label(bulletNode, "DefaultBullet");
+	json_t *defaultNode = json_find_first_label(root, "DefaultBullet");
 	if (defaultNode != NULL)
 	{
-		BulletClassFree(&bullets->Default);
-		LoadBullet(&bullets->Default, defaultNode->child, NULL, version);
-	}
-
-	json_t *bulletsNode = json_find_first_label(bulletNode, "Bullets")->child;
-	for (json_t *child = bulletsNode->child; child; child = child->next)
-	{
-		BulletClass b;
-		LoadBullet(&b, child, &bullets->Default, version);
-		CArrayPushBack(classes, &b);
+		BulletClass *d = &bs->bullets->Default;
+		BulletClassFree(d);
+		LoadBullet(d, defaultNode->child, NULL, bs->version);
+		// Part of the root, which is about to be freed
+		d->node = NULL;
 	}
-
-	bullets->root = bulletNode;
+	return true;
 }
 static void LoadHitsound(
 	char **hitsound, json_t *node, const char *name, const int version);
@@ -791,7 +823,6 @@ void BulletLoadWeapons(BulletClasses *bullets)
 {
 	BulletClassesLoadWeapons(&bullets->Classes);
 	BulletClassesLoadWeapons(&bullets->CustomClasses);
-	json_free_value(&bullets->root);
 }
 static void BulletClassesLoadWeapons(CArray *classes)
 {
@@ -814,7 +845,7 @@ static void BulletClassesLoadWeapons(CArray *classes)
 		LoadBulletGuns(&b->HitGuns, b->node, "HitGuns");
 		LoadBulletGuns(&b->ProximityGuns, b->node, "ProximityGuns");
 
-		b->node = NULL;
+		json_free_value(&b->node);
 	}
 }
 void BulletTerminate(BulletClasses *bullets)
@@ -827,6 +858,7 @@ void BulletTerminate(BulletClasses *bullets)
 }
 void BulletClassesClear(CArray *classes)
 {
+	ClassIndexReset(&gBulletClasses.index);
 	for (int i = 0; i < (int)classes->size; i++)
 	{
 		BulletClassFree(CArrayGet(classes, i));
@@ -843,34 +875,15 @@ static void BulletClassFree(BulletClass *b)
 	CArrayTerminate(&b->HitGuns);
 	CArrayTerminate(&b->Falling.DropGuns);
 	CArrayTerminate(&b->ProximityGuns);
+	json_free_value(&b->node);
 }
 
 void BulletAdd(const NAddBullet add)
 {
 	const struct vec2 pos = NetToVec2(add.MuzzlePos);
 
-	// Find an empty slot in mobobj list
-	TMobileObject *obj = NULL;
 	int i;
-	for (i = 0; i < (int)gMobObjs.size; i++)
-	{
-		TMobileObject *m = CArrayGet(&gMobObjs, i);
-		if (!m->isInUse)
-		{
-			obj = m;
-			break;
-		}
-	}
-	if (obj == NULL)
-	{
-		TMobileObject m;
-		memset(&m, 0, sizeof m);
-		CArrayPushBack(&gMobObjs, &m);
-		i = (int)gMobObjs.size - 1;
-		obj = CArrayGet(&gMobObjs, i);
-	}
-	memset(obj, 0, sizeof *obj);
-	obj->UID = add.UID;
+	TMobileObject *obj = MobObjAdd(add.UID, &i);
 	obj->bulletClass = StrBulletClass(add.BulletClass);
 	TileItemInit(
 		&obj->tileItem, i, KIND_MOBILEOBJECT, obj->bulletClass->Size, 0);
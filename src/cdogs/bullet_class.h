@@ -98,7 +98,7 @@ typedef struct
 	CArray HitGuns;	// of const GunDescription *
 	CArray ProximityGuns;	// of const GunDescription *
 
-	// Temporary JSON object for two-step bullet loading
+	// Temporary JSON object for two-step bullet loading; owned
 	json_t *node;
 } BulletClass;
 typedef struct
@@ -106,15 +106,16 @@ typedef struct
 	CArray Classes;	// of BulletClass
 	BulletClass Default;
 	CArray CustomClasses;	// of BulletClass
-	json_t *root;
+	map_t index;	// name -> BulletClass *; built on demand
 } BulletClasses;
 extern BulletClasses gBulletClasses;
 
 BulletClass *StrBulletClass(const char *s);
 
 void BulletInitialize(BulletClasses *bullets);
-void BulletLoadJSON(
-	BulletClasses *bullets, CArray *classes, json_t *bulletNode);
+// Stream the bullets in a file into classes
+bool BulletLoadJSON(
+	BulletClasses *bullets, CArray *classes, const char *filename);
 // 2-step initialisation since bullet and weapon reference each other
 void BulletLoadWeapons(BulletClasses *bullets);
 void BulletClassesClear(CArray *classes);
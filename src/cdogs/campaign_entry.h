@@ -43,4 +43,8 @@ void CampaignEntryInit(CampaignEntry *entry, const char *title, GameMode mode);
 void CampaignEntryCopy(CampaignEntry *dst, CampaignEntry *src);
 bool CampaignEntryTryLoad(
 	CampaignEntry *entry, const char *path, GameMode mode);
+// Init from the title and number of missions scanned from a campaign file
+void CampaignEntryInitScanned(
+	CampaignEntry *entry, const char *path, const char *title,
+	const int numMissions, GameMode mode);
 void CampaignEntryTerminate(CampaignEntry *entry);
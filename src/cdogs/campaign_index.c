@@ -0,0 +1,253 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "campaign_index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <json/json.h>
+#include <tinydir/tinydir.h>
+
+#include "json_utils.h"
+#include "log.h"
+#include "utils.h"
+
+
+void CampaignIndexInit(CampaignIndex *ci)
+{
+	memset(ci, 0, sizeof *ci);
+	ci->entries = hashmap_new();
+}
+static void EntryDestroy(any_t data);
+void CampaignIndexTerminate(CampaignIndex *ci)
+{
+	hashmap_destroy(ci->entries, EntryDestroy);
+	memset(ci, 0, sizeof *ci);
+}
+static void EntryDestroy(any_t data)
+{
+	CampaignIndexEntry *e = data;
+	CFREE(e->Path);
+	CFREE(e->Title);
+	CFREE(e);
+}
+
+static long long LoadLongLong(json_t *node, const char *name);
+void CampaignIndexLoad(CampaignIndex *ci, const char *filename)
+{
+	json_t *root = NULL;
+	FILE *f = fopen(filename, "r");
+	if (f == NULL)
+	{
+		// No index yet
+		goto bail;
+	}
+	if (json_stream_parse(f, &root) != JSON_OK)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Error parsing campaign index '%s'", filename);
+		goto bail;
+	}
+	int version = 0;
+	LoadInt(&version, root, "Version");
+	if (version != CAMPAIGN_INDEX_VERSION ||
+		json_find_first_label(root, "Campaigns") == NULL)
+	{
+		goto bail;
+	}
+	for (json_t *child =
+		json_find_first_label(root, "Campaigns")->child->child;
+		child != NULL;
+		child = child->next)
+	{
+		char *path = NULL;
+		LoadStr(&path, child, "Path");
+		if (path == NULL) continue;
+		char *title = NULL;
+		LoadStr(&title, child, "Title");
+		int numMissions = -1;
+		LoadInt(&numMissions, child, "Missions");
+		CampaignIndexSet(
+			ci, path,
+			LoadLongLong(child, "MTime"), LoadLongLong(child, "Size"),
+			numMissions >= 0 ? title : NULL, numMissions);
+		// Not used until the file is found again
+		CampaignIndexEntry *e;
+		if (hashmap_get(ci->entries, path, (any_t *)&e) == MAP_OK)
+		{
+			e->IsUsed = false;
+		}
+		CFREE(path);
+		CFREE(title);
+	}
+	ci->IsDirty = false;
+	LOG(LM_MAIN, LL_DEBUG, "loaded campaign index %s (%d entries)",
+		filename, hashmap_length(ci->entries));
+
+bail:
+	json_free_value(&root);
+	if (f != NULL)
+	{
+		fclose(f);
+	}
+}
+static long long LoadLongLong(json_t *node, const char *name)
+{
+	if (!TryLoadValue(&node, name))
+	{
+		return 0;
+	}
+	return strtoll(node->text, NULL, 10);
+}
+
+static int CheckUnused(any_t data, any_t item);
+static int AddEntryNode(any_t data, any_t item);
+void CampaignIndexSave(CampaignIndex *ci, const char *filename)
+{
+	// Also save to prune entries for files that no longer exist
+	hashmap_iterate(ci->entries, CheckUnused, &ci->IsDirty);
+	if (!ci->IsDirty)
+	{
+		return;
+	}
+	json_t *root = json_new_object();
+	AddIntPair(root, "Version", CAMPAIGN_INDEX_VERSION);
+	json_t *campaigns = json_new_array();
+	hashmap_iterate(ci->entries, AddEntryNode, campaigns);
+	json_insert_pair_into_object(root, "Campaigns", campaigns);
+	if (TrySaveJSONFile(root, filename))
+	{
+		ci->IsDirty = false;
+	}
+	json_free_value(&root);
+}
+static int CheckUnused(any_t data, any_t item)
+{
+	const CampaignIndexEntry *e = item;
+	if (!e->IsUsed)
+	{
+		*(bool *)data = true;
+	}
+	return MAP_OK;
+}
+static void AddLongLongPair(json_t *parent, const char *name, long long n);
+static int AddEntryNode(any_t data, any_t item)
+{
+	json_t *campaigns = data;
+	const CampaignIndexEntry *e = item;
+	if (!e->IsUsed)
+	{
+		return MAP_OK;
+	}
+	json_t *node = json_new_object();
+	AddStringPair(node, "Path", e->Path);
+	AddLongLongPair(node, "MTime", e->MTime);
+	AddLongLongPair(node, "Size", e->Size);
+	AddStringPair(node, "Title", e->Title);
+	AddIntPair(node, "Missions", e->NumMissions);
+	json_insert_child(campaigns, node);
+	return MAP_OK;
+}
+static void AddLongLongPair(json_t *parent, const char *name, long long n)
+{
+	char buf[32];
+	sprintf(buf, "%lld", n);
+	json_insert_pair_into_object(parent, name, json_new_number(buf));
+}
+
+bool CampaignIndexStat(const char *path, long long *mtime, long long *size)
+{
+	// Archives are dirs; use the campaign file inside, as editing it
+	// doesn't change the dir
+	char buf[CDOGS_PATH_MAX];
+	const char *ext = StrGetFileExt(path);
+	if (strcmp(ext, "cdogscpn") == 0 || strcmp(ext, "CDOGSCPN") == 0)
+	{
+		sprintf(buf, "%s/campaign.json", path);
+	}
+	else
+	{
+		strcpy(buf, path);
+	}
+	tinydir_file file;
+	if (tinydir_file_open(&file, buf) == -1)
+	{
+		return false;
+	}
+	*mtime = (long long)file._s.st_mtime;
+	*size = (long long)file._s.st_size;
+	return true;
+}
+
+const CampaignIndexEntry *CampaignIndexGet(
+	CampaignIndex *ci, const char *path,
+	const long long mtime, const long long size)
+{
+	CampaignIndexEntry *e;
+	if (hashmap_get(ci->entries, path, (any_t *)&e) != MAP_OK)
+	{
+		return NULL;
+	}
+	e->IsUsed = true;
+	if (e->MTime != mtime || e->Size != size)
+	{
+		return NULL;
+	}
+	return e;
+}
+
+void CampaignIndexSet(
+	CampaignIndex *ci, const char *path,
+	const long long mtime, const long long size,
+	const char *title, const int numMissions)
+{
+	CampaignIndexEntry *e;
+	if (hashmap_get(ci->entries, path, (any_t *)&e) == MAP_OK)
+	{
+		CFREE(e->Title);
+	}
+	else
+	{
+		CCALLOC(e, sizeof *e);
+		CSTRDUP(e->Path, path);
+		if (hashmap_put(ci->entries, path, e) != MAP_OK)
+		{
+			LOG(LM_MAIN, LL_ERROR, "failed to add campaign index %s", path);
+			EntryDestroy(e);
+			return;
+		}
+	}
+	e->MTime = mtime;
+	e->Size = size;
+	e->Title = NULL;
+	if (title != NULL)
+	{
+		CSTRDUP(e->Title, title);
+	}
+	e->NumMissions = numMissions;
+	e->IsUsed = true;
+	ci->IsDirty = true;
+}
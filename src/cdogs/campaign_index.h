@@ -0,0 +1,71 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "c_hashmap/hashmap.h"
+
+// Cache of campaign scan results, saved between runs, so that listing the
+// campaigns only needs to parse files that are new or have changed.
+// Entries are keyed by path and checked against the file's mtime and size.
+
+#define CAMPAIGN_INDEX_FILE "campaign_index.json"
+#define CAMPAIGN_INDEX_VERSION 1
+
+typedef struct
+{
+	char *Path;
+	long long MTime;
+	long long Size;
+	char *Title;
+	int NumMissions;	// -1 if the file is not a campaign
+	bool IsUsed;	// whether the file still exists; unused entries are pruned
+} CampaignIndexEntry;
+
+typedef struct
+{
+	map_t entries;	// of CampaignIndexEntry
+	bool IsDirty;
+} CampaignIndex;
+
+void CampaignIndexInit(CampaignIndex *ci);
+void CampaignIndexTerminate(CampaignIndex *ci);
+void CampaignIndexLoad(CampaignIndex *ci, const char *filename);
+// Save if any entries have been added, changed or not used
+void CampaignIndexSave(CampaignIndex *ci, const char *filename);
+
+// Get the modified time and size of a campaign file or archive, to check
+// whether the cached scan is still current
+bool CampaignIndexStat(const char *path, long long *mtime, long long *size);
+// Get the scan result for a campaign file, or NULL if it is new or changed
+const CampaignIndexEntry *CampaignIndexGet(
+	CampaignIndex *ci, const char *path,
+	const long long mtime, const long long size);
+void CampaignIndexSet(
+	CampaignIndex *ci, const char *path,
+	const long long mtime, const long long size,
+	const char *title, const int numMissions);
@@ -32,6 +32,8 @@
 
 #include <tinydir/tinydir.h>
 
+#include <cdogs/asset_loader.h>
+#include <cdogs/campaign_index.h>
 #include <cdogs/files.h>
 #include <cdogs/log.h>
 #include <cdogs/map_new.h>
@@ -84,34 +86,76 @@ void CampaignSettingTerminate(CampaignSetting *setting)
 
 static void CampaignListInit(campaign_list_t *list);
 static void CampaignListTerminate(campaign_list_t *list);
+static void ScanCampaignsFromFolder(
+	CampaignIndex *ci, AssetLoader *al, const char *path);
+static void *ScanCampaign(const char *path, const char *name);
 static void LoadCampaignsFromFolder(
-	campaign_list_t *list, const char *name, const char *path,
-	const GameMode mode);
+	CampaignIndex *ci, campaign_list_t *list, const char *name,
+	const char *path, const GameMode mode);
 static void LoadQuickPlayEntry(CampaignEntry *entry);
 
+typedef struct
+{
+	char *Title;
+	int NumMissions;
+} CampaignScan;
+
 void LoadAllCampaigns(custom_campaigns_t *campaigns)
 {
-	char buf[CDOGS_PATH_MAX];
+	char campaignsPath[CDOGS_PATH_MAX];
+	char dogfightsPath[CDOGS_PATH_MAX];
+	GetDataFilePath(campaignsPath, CDOGS_CAMPAIGN_DIR);
+	GetDataFilePath(dogfightsPath, CDOGS_DOGFIGHT_DIR);
 
 	CampaignListInit(&campaigns->campaignList);
 	CampaignListInit(&campaigns->dogfightList);
 
-	GetDataFilePath(buf, CDOGS_CAMPAIGN_DIR);
-	LOG(LM_MAIN, LL_INFO, "Load campaigns from dir %s...", buf);
+	// Only scan campaigns that are not in the index or have changed since,
+	// in parallel
+	CampaignIndex ci;
+	CampaignIndexInit(&ci);
+	CampaignIndexLoad(&ci, GetConfigFilePath(CAMPAIGN_INDEX_FILE));
+	AssetLoader al;
+	AssetLoaderInit(&al);
+	ScanCampaignsFromFolder(&ci, &al, campaignsPath);
+	ScanCampaignsFromFolder(&ci, &al, dogfightsPath);
+	AssetLoaderRun(&al, ScanCampaign);
+	CA_FOREACH(const AssetLoaderJob, job, al.jobs)
+		long long mtime, size;
+		if (!CampaignIndexStat(job->Path, &mtime, &size)) continue;
+		const CampaignScan *scan = job->Result;
+		if (scan == NULL)
+		{
+			CampaignIndexSet(&ci, job->Path, mtime, size, NULL, -1);
+			continue;
+		}
+		CampaignIndexSet(
+			&ci, job->Path, mtime, size, scan->Title, scan->NumMissions);
+		CFREE(scan->Title);
+		CFREE(job->Result);
+	CA_FOREACH_END()
+
+	LOG(LM_MAIN, LL_INFO, "Load campaigns from dir %s...", campaignsPath);
 	LoadCampaignsFromFolder(
+		&ci,
 		&campaigns->campaignList,
 		"",
-		buf,
+		campaignsPath,
 		GAME_MODE_NORMAL);
 
-	GetDataFilePath(buf, CDOGS_DOGFIGHT_DIR);
-	LOG(LM_MAIN, LL_INFO, "Load dogfights from dir %s...", buf);
+	LOG(LM_MAIN, LL_INFO, "Load dogfights from dir %s...", dogfightsPath);
 	LoadCampaignsFromFolder(
+		&ci,
 		&campaigns->dogfightList,
 		"",
-		buf,
+		dogfightsPath,
 		GAME_MODE_DOGFIGHT);
 
+	AssetLoaderLogTimes(&al, "changed campaigns");
+	AssetLoaderTerminate(&al);
+	CampaignIndexSave(&ci, GetConfigFilePath(CAMPAIGN_INDEX_FILE));
+	CampaignIndexTerminate(&ci);
+
 	LOG(LM_MAIN, LL_INFO, "Load quick play...");
 	LoadQuickPlayEntry(&campaigns->quickPlayEntry);
 }
@@ -152,9 +196,71 @@ static void LoadQuickPlayEntry(CampaignEntry *entry)
 	entry->Mode = GAME_MODE_QUICK_PLAY;
 }
 
+static bool IsCampaignFile(const tinydir_file *file);
+static bool IsSubFolder(const tinydir_file *file);
+static void ScanCampaignsFromFolder(
+	CampaignIndex *ci, AssetLoader *al, const char *path)
+{
+	tinydir_dir dir;
+	if (tinydir_open(&dir, path) == -1)
+	{
+		return;
+	}
+	for (; dir.has_next; tinydir_next(&dir))
+	{
+		tinydir_file file;
+		if (tinydir_readfile(&dir, &file) == -1)
+		{
+			continue;
+		}
+		if (IsCampaignFile(&file))
+		{
+			long long mtime, size;
+			if (CampaignIndexStat(file.path, &mtime, &size) &&
+				CampaignIndexGet(ci, file.path, mtime, size) == NULL)
+			{
+				AssetLoaderAdd(al, file.path, file.name);
+			}
+		}
+		else if (IsSubFolder(&file))
+		{
+			ScanCampaignsFromFolder(ci, al, file.path);
+		}
+	}
+	tinydir_close(&dir);
+}
+static bool IsArchive(const tinydir_file *file)
+{
+	return strcmp(file->extension, "cdogscpn") == 0 ||
+		strcmp(file->extension, "CDOGSCPN") == 0;
+}
+static bool IsCampaignFile(const tinydir_file *file)
+{
+	// Ignore campaigns that start with a ~
+	// These are autosaved
+	return (file->is_reg || IsArchive(file)) && file->name[0] != '~';
+}
+static bool IsSubFolder(const tinydir_file *file)
+{
+	return file->is_dir && !IsArchive(file) &&
+		strcmp(file->name, ".") != 0 && strcmp(file->name, "..") != 0;
+}
+static void *ScanCampaign(const char *path, const char *name)
+{
+	UNUSED(name);
+	CampaignScan *scan;
+	CMALLOC(scan, sizeof *scan);
+	if (MapNewScan(path, &scan->Title, &scan->NumMissions) != 0)
+	{
+		CFREE(scan);
+		return NULL;
+	}
+	return scan;
+}
+
 static void LoadCampaignsFromFolder(
-	campaign_list_t *list, const char *name, const char *path,
-	const GameMode mode)
+	CampaignIndex *ci, campaign_list_t *list, const char *name,
+	const char *path, const GameMode mode)
 {
 	tinydir_dir dir;
 	int i;
@@ -171,28 +277,35 @@ static void LoadCampaignsFromFolder(
 		tinydir_file file;
 		tinydir_readfile_n(&dir, &file, i);
 
-		// Ignore campaigns that start with a ~
-		// These are autosaved
-
-		const bool isArchive =
-			strcmp(file.extension, "cdogscpn") == 0 ||
-			strcmp(file.extension, "CDOGSCPN") == 0;
-		if (file.is_dir && !isArchive &&
-			strcmp(file.name, ".") != 0 && strcmp(file.name, "..") != 0)
-		{
-			campaign_list_t subFolder;
-			CampaignListInit(&subFolder);
-			LoadCampaignsFromFolder(&subFolder, file.name, file.path, mode);
-			CArrayPushBack(&list->subFolders, &subFolder);
-		}
-		else if ((file.is_reg || isArchive) && file.name[0] != '~')
+		if (IsCampaignFile(&file))
 		{
 			CampaignEntry entry;
-			if (CampaignEntryTryLoad(&entry, file.path, mode))
+			long long mtime, size;
+			const CampaignIndexEntry *e =
+				CampaignIndexStat(file.path, &mtime, &size) ?
+				CampaignIndexGet(ci, file.path, mtime, size) : NULL;
+			if (e != NULL)
+			{
+				if (e->NumMissions >= 0)
+				{
+					CampaignEntryInitScanned(
+						&entry, file.path, e->Title, e->NumMissions, mode);
+					CArrayPushBack(&list->list, &entry);
+				}
+			}
+			else if (CampaignEntryTryLoad(&entry, file.path, mode))
 			{
 				CArrayPushBack(&list->list, &entry);
 			}
 		}
+		else if (IsSubFolder(&file))
+		{
+			campaign_list_t subFolder;
+			CampaignListInit(&subFolder);
+			LoadCampaignsFromFolder(
+				ci, &subFolder, file.name, file.path, mode);
+			CArrayPushBack(&list->subFolders, &subFolder);
+		}
 	}
 
 	tinydir_close(&dir);
@@ -0,0 +1,178 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "char_pic_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utils.h"
+
+#define KEY_SIZE 128
+
+struct CharPicCacheEntry
+{
+	char Key[KEY_SIZE];
+	Pic Pic;
+	CharPicCacheEntry *prev;
+	CharPicCacheEntry *next;
+};
+
+CharPicCache gCharPicCache;
+
+
+void CharPicCacheInit(CharPicCache *c, const int maxPixels)
+{
+	memset(c, 0, sizeof *c);
+	c->entries = hashmap_new();
+	c->MaxPixels = maxPixels;
+}
+void CharPicCacheTerminate(CharPicCache *c)
+{
+	CharPicCacheClear(c);
+	hashmap_free(c->entries);
+	memset(c, 0, sizeof *c);
+}
+static void EntryFree(CharPicCache *c, CharPicCacheEntry *e);
+void CharPicCacheClear(CharPicCache *c)
+{
+	if (c->entries == NULL)
+	{
+		return;
+	}
+	for (CharPicCacheEntry *e = c->head; e != NULL;)
+	{
+		CharPicCacheEntry *next = e->next;
+		EntryFree(c, e);
+		e = next;
+	}
+	hashmap_free(c->entries);
+	c->entries = hashmap_new();
+	c->head = c->tail = NULL;
+	c->NumPixels = 0;
+}
+static void EntryFree(CharPicCache *c, CharPicCacheEntry *e)
+{
+	if (c->PicFreeFunc != NULL)
+	{
+		c->PicFreeFunc(&e->Pic);
+	}
+	CFREE(e->Pic.Data);
+	CFREE(e);
+}
+
+static void Unlink(CharPicCache *c, CharPicCacheEntry *e);
+static void PushFront(CharPicCache *c, CharPicCacheEntry *e);
+static void Evict(CharPicCache *c, const int numPixels);
+const Pic *CharPicCacheGet(
+	CharPicCache *c, const Pic *pic, const BlitSpanParams *p)
+{
+	const int numPixels = pic->size.x * pic->size.y;
+	if (c->entries == NULL || pic->Data == NULL || numPixels <= 0 ||
+		numPixels > c->MaxPixels)
+	{
+		return NULL;
+	}
+	// Coloured pixels are drawn if they have alpha; masks without alpha
+	// would make them disappear
+	for (int i = 0; i < 6; i++)
+	{
+		if ((p->ChannelMasks[i] & p->Amask) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	char key[KEY_SIZE];
+	const Uint32 *m = p->ChannelMasks;
+	sprintf(key, "%p/%p/%08x%08x%08x%08x%08x%08x",
+		(const void *)pic, (const void *)pic->Data,
+		m[0], m[1], m[2], m[3], m[4], m[5]);
+	CharPicCacheEntry *e;
+	if (hashmap_get(c->entries, key, (any_t *)&e) == MAP_OK)
+	{
+		Unlink(c, e);
+		PushFront(c, e);
+		c->Hits++;
+		return &e->Pic;
+	}
+	c->Misses++;
+
+	Evict(c, numPixels);
+	CCALLOC(e, sizeof *e);
+	strcpy(e->Key, key);
+	e->Pic.size = pic->size;
+	e->Pic.offset = pic->offset;
+	CCALLOC(e->Pic.Data, numPixels * sizeof *e->Pic.Data);
+	const int stride = PIC_STRIDE(pic);
+	if (stride == pic->size.x)
+	{
+		// Rows are contiguous, so colour it as one span
+		gBlitKernels->Multichannel(e->Pic.Data, pic->Data, numPixels, p);
+	}
+	else
+	{
+		for (int y = 0; y < pic->size.y; y++)
+		{
+			gBlitKernels->Multichannel(
+				e->Pic.Data + y * pic->size.x, pic->Data + y * stride,
+				pic->size.x, p);
+		}
+	}
+	if (hashmap_put(c->entries, e->Key, e) != MAP_OK)
+	{
+		EntryFree(c, e);
+		return NULL;
+	}
+	PushFront(c, e);
+	c->NumPixels += numPixels;
+	return &e->Pic;
+}
+static void Unlink(CharPicCache *c, CharPicCacheEntry *e)
+{
+	if (e->prev != NULL) e->prev->next = e->next;
+	else c->head = e->next;
+	if (e->next != NULL) e->next->prev = e->prev;
+	else c->tail = e->prev;
+	e->prev = e->next = NULL;
+}
+static void PushFront(CharPicCache *c, CharPicCacheEntry *e)
+{
+	e->next = c->head;
+	if (c->head != NULL) c->head->prev = e;
+	c->head = e;
+	if (c->tail == NULL) c->tail = e;
+}
+static void Evict(CharPicCache *c, const int numPixels)
+{
+	while (c->tail != NULL && c->NumPixels + numPixels > c->MaxPixels)
+	{
+		CharPicCacheEntry *e = c->tail;
+		Unlink(c, e);
+		hashmap_remove(c->entries, e->Key);
+		c->NumPixels -= e->Pic.size.x * e->Pic.size.y;
+		EntryFree(c, e);
+	}
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "blit_kernels.h"
+#include "c_hashmap/hashmap.h"
+#include "pic.h"
+
+// Cache of character sprites, pre-multiplied by character colours.
+// Colouring a character sprite is a multiply per pixel, by a mask chosen
+// by the pixel's alpha channel; since character colours rarely change,
+// the coloured sprites are cached so that drawing them is a plain copy.
+// Entries are keyed by the pic and its channel masks, so changing colours
+// just uses new entries; old ones are evicted when the cache is full,
+// least recently used first.
+// The pics must outlive their entries; clear the cache when freeing pics.
+
+// Default size of the cache, in pixels
+#define CHAR_PIC_CACHE_MAX_PIXELS (1024 * 1024)
+
+typedef struct CharPicCacheEntry CharPicCacheEntry;
+typedef struct
+{
+	map_t entries;	// of CharPicCacheEntry *
+	// Most and least recently used
+	CharPicCacheEntry *head;
+	CharPicCacheEntry *tail;
+	int NumPixels;
+	int MaxPixels;
+	int Hits;
+	int Misses;
+	// Optional; called before a cached pic is freed
+	void (*PicFreeFunc)(const Pic *pic);
+} CharPicCache;
+extern CharPicCache gCharPicCache;
+
+void CharPicCacheInit(CharPicCache *c, const int maxPixels);
+void CharPicCacheTerminate(CharPicCache *c);
+void CharPicCacheClear(CharPicCache *c);
+// Get the pic coloured by the multichannel masks in p, or NULL if it
+// cannot be cached
+const Pic *CharPicCacheGet(
+	CharPicCache *c, const Pic *pic, const BlitSpanParams *p);
@@ -28,6 +28,7 @@
 */
 #include "character_class.h"
 
+#include "json_stream.h"
 #include "json_utils.h"
 #include "log.h"
 
@@ -123,47 +124,58 @@ void CharacterClassesInitialize(CharacterClasses *c, const char *filename)
 
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, filename);
-	FILE *f = fopen(buf, "r");
-	json_t *root = NULL;
-	if (f == NULL)
+	if (!CharacterClassesLoadJSON(&c->Classes, buf))
 	{
 		LOG(LM_MAIN, LL_ERROR, "cannot load characters file %s", buf);
-		goto bail;
 	}
-	enum json_error e = json_stream_parse(f, &root);
-	if (e != JSON_OK)
-	{
-		LOG(LM_MAIN, LL_ERROR, "error parsing characters file %s", buf);
-		goto bail;
-	}
-	CharacterClassesLoadJSON(&c->Classes, root);
-
-bail:
-	if (f != NULL)
+}
+typedef struct
+{
+	CArray *classes;
+	int version;	// 0 until checked
+} CharacterClassesStream;
+static bool LoadCharacterClassElement(
+	json_t *root, json_t **node, void *data);
+static bool CheckVersion(CharacterClassesStream *cs, json_t *root);
+bool CharacterClassesLoadJSON(CArray *classes, const char *filename)
+{
+	CharacterClassesStream cs = { classes, 0 };
+	JSONStream s;
+	JSONStreamInit(&s);
+	JSONStreamAddArray(&s, "Characters", LoadCharacterClassElement, &cs);
+	bool res = JSONStreamParseFile(&s, filename);
+	if (res && cs.version == 0)
 	{
-		fclose(f);
+		res = CheckVersion(&cs, s.root);
 	}
-	json_free_value(&root);
+	JSONStreamTerminate(&s);
+	return res;
 }
 static void LoadCharacterClass(CharacterClass *c, json_t *node);
-void CharacterClassesLoadJSON(CArray *classes, json_t *root)
+static bool LoadCharacterClassElement(
+	json_t *root, json_t **node, void *data)
 {
-	int version;
-	LoadInt(&version, root, "Version");
-	if (version > VERSION || version <= 0)
+	CharacterClassesStream *cs = data;
+	if (cs->version == 0 && !CheckVersion(cs, root))
 	{
-		LOG(LM_MAIN, LL_ERROR,
-			"Cannot read character file version: %d", version);
-		return;
+		return false;
 	}
-
-	json_t *charactersNode = json_find_first_label(root, "Characters")->child;
-	for (json_t *child = charactersNode->child; child; child = child->next)
+	CharacterClass cc;
+	LoadCharacterClass(&cc, *node);
+	CArrayPushBack(cs->classes, &cc);
+	return true;
+}
+static bool CheckVersion(CharacterClassesStream *cs, json_t *root)
+{
+	LoadInt(&cs->version, root, "Version");
+	if (cs->version > VERSION || cs->version <= 0)
 	{
-		CharacterClass cc;
-		LoadCharacterClass(&cc, child);
-		CArrayPushBack(classes, &cc);
+		LOG(LM_MAIN, LL_ERROR,
+			"Cannot read character file version: %d", cs->version);
+		cs->version = 0;
+		return false;
 	}
+	return true;
 }
 static void LoadCharacterClass(CharacterClass *c, json_t *node)
 {
@@ -58,6 +58,7 @@ const CharacterClass *IndexCharacterClass(const int i);
 int CharacterClassIndex(const CharacterClass *c);
 
 void CharacterClassesInitialize(CharacterClasses *c, const char *filename);
-void CharacterClassesLoadJSON(CArray *classes, json_t *root);
+// Stream the character classes in a file into classes
+bool CharacterClassesLoadJSON(CArray *classes, const char *filename);
 void CharacterClassesClear(CArray *classes);
 void CharacterClassesTerminate(CharacterClasses *c);
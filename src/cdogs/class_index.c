@@ -0,0 +1,71 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "class_index.h"
+
+
+void ClassIndexReset(map_t *index)
+{
+	if (*index != NULL)
+	{
+		hashmap_free(*index);
+		*index = NULL;
+	}
+}
+
+static void IndexAdd(
+	map_t index, const CArray *classes, const size_t nameOffset);
+void *ClassIndexGet(
+	map_t *index, const CArray **arrays, const size_t nameOffset,
+	const char *name)
+{
+	if (*index == NULL)
+	{
+		*index = hashmap_new();
+		for (const CArray **a = arrays; *a != NULL; a++)
+		{
+			IndexAdd(*index, *a, nameOffset);
+		}
+	}
+	any_t c;
+	if (hashmap_get(*index, name, &c) != MAP_OK)
+	{
+		return NULL;
+	}
+	return c;
+}
+static void IndexAdd(
+	map_t index, const CArray *classes, const size_t nameOffset)
+{
+	CA_FOREACH(char, c, *classes)
+		const char *name = *(const char **)(c + nameOffset);
+		any_t existing;
+		// Earlier arrays take precedence
+		if (hashmap_get(index, name, &existing) != MAP_OK)
+		{
+			hashmap_put(index, name, (any_t)c);
+		}
+	CA_FOREACH_END()
+}
@@ -49,82 +49,16 @@
 #include "collision.h"
 
 #include "actors.h"
-#include "algorithms.h"
 #include "config.h"
 #include "minkowski_hex.h"
 #include "objs.h"
 
 
-static void TileCacheInit(CArray *tc)
-{
-	CArrayInit(tc, sizeof(struct vec2i));
-}
-static void TileCacheReset(CArray *tc)
-{
-	CArrayClear(tc);
-}
-static void TileCacheTerminate(CArray *tc)
-{
-	CArrayTerminate(tc);
-}
-static void TileCacheAddImpl(
-	CArray *tc, const struct vec2i v, const bool addAdjacents);
-static void TileCacheAdd(CArray *tc, const struct vec2i v)
-{
-	TileCacheAddImpl(tc, v, true);
-}
-static void TileCacheAddImpl(
-	CArray *tc, const struct vec2i v, const bool addAdjacents)
-{
-	if (!MapIsTileIn(&gMap, v))
-	{
-		return;
-	}
-	// Add tile in y/x order
-	CA_FOREACH(const struct vec2i, t, *tc)
-		if (t->y > v.y || (t->y == v.y && t->x > v.x))
-		{
-			CArrayInsert(tc, _ca_index, &v);
-			break;
-		}
-		else if (svec2i_is_equal(*t, v))
-		{
-			// Don't add the same tile twice
-			return;
-		}
-	CA_FOREACH_END()
-	CArrayPushBack(tc, &v);
-
-	// Also add the adjacencies for the tile
-	if (addAdjacents)
-	{
-		struct vec2i dv;
-		for (dv.y = -1; dv.y <= 1; dv.y++)
-		{
-			for (dv.x = -1; dv.x <= 1; dv.x++)
-			{
-				if (svec2i_is_zero(dv))
-				{
-					continue;
-				}
-				const struct vec2i dtv = svec2i_add(v, dv);
-				if (!MapIsTileIn(&gMap, dtv))
-				{
-					continue;
-				}
-				TileCacheAddImpl(tc, dtv, false);
-			}
-		}
-	}
-}
-
-
 CollisionSystem gCollisionSystem;
 
 void CollisionSystemInit(CollisionSystem *cs)
 {
 	CollisionSystemReset(cs);
-	TileCacheInit(&cs->tileCache);
 }
 void CollisionSystemReset(CollisionSystem *cs)
 {
@@ -132,7 +66,7 @@ void CollisionSystemReset(CollisionSystem *cs)
 }
 void CollisionSystemTerminate(CollisionSystem *cs)
 {
-	TileCacheTerminate(&cs->tileCache);
+	UNUSED(cs);
 }
 
 CollisionTeam CalcCollisionTeam(const bool isActor, const TActor *actor)
@@ -289,7 +223,6 @@ static bool CollisionIsOnSameTeam(
 static bool CheckParams(
 	const CollisionParams params, const TTileItem *a, const TTileItem *b);
 
-static void AddPosToTileCache(void *data, struct vec2i pos);
 static bool CheckOverlaps(
 	const TTileItem *item, const struct vec2 pos, const struct vec2 vel,
 	const struct vec2i size,
@@ -301,30 +234,39 @@ void OverlapTileItems(
 	const CollisionParams params, CollideItemFunc func, void *data,
 	CheckWallFunc checkWallFunc, CollideWallFunc wallFunc, void *wallData)
 {
-	TileCacheReset(&gCollisionSystem.tileCache);
-	// Add all the tiles along the motion path
-	AlgoLineDrawData drawData;
-	drawData.Draw = AddPosToTileCache;
-	drawData.data = &gCollisionSystem.tileCache;
-	BresenhamLineDraw(
-		svec2i_assign_vec2(pos), svec2i_assign_vec2(svec2_add(pos, item->Vel)), &drawData);
-
-	// Check collisions with all tiles in the cache
-	CA_FOREACH(const struct vec2i, dtv, gCollisionSystem.tileCache)
-		if (!CheckOverlaps(
-			item, pos, item->Vel, size, params, func, data,
-			checkWallFunc, wallFunc, wallData,
-			*dtv))
+	// Check collisions with all tiles in the swept AABB of the item, in y/x
+	// order
+	struct vec2i tMin, tMax;
+	SweptAABBToTiles(&gMap, pos, item->Vel, size, &tMin, &tMax);
+	struct vec2i tv;
+	for (tv.y = tMin.y; tv.y <= tMax.y; tv.y++)
+	{
+		for (tv.x = tMin.x; tv.x <= tMax.x; tv.x++)
 		{
-			return;
+			if (!CheckOverlaps(
+				item, pos, item->Vel, size, params, func, data,
+				checkWallFunc, wallFunc, wallData, tv))
+			{
+				return;
+			}
 		}
-	CA_FOREACH_END()
+	}
 }
-static void AddPosToTileCache(void *data, struct vec2i pos)
+void SweptAABBToTiles(
+	const Map *map, const struct vec2 pos, const struct vec2 vel,
+	const struct vec2i size, struct vec2i *tMin, struct vec2i *tMax)
 {
-	CArray *tileCache = data;
-	const struct vec2i tv = Vec2iToTile(pos);
-	TileCacheAdd(tileCache, tv);
+	const struct vec2 end = svec2_add(pos, vel);
+	const struct vec2 half = svec2(size.x / 2.0f, size.y / 2.0f);
+	const struct vec2i t1 = Vec2ToTile(svec2(
+		MIN(pos.x, end.x) - half.x, MIN(pos.y, end.y) - half.y));
+	const struct vec2i t2 = Vec2ToTile(svec2(
+		MAX(pos.x, end.x) + half.x, MAX(pos.y, end.y) + half.y));
+	// Things are stored in the tile of their centre, so also include the
+	// adjacent tiles to catch things that extend into the swept area
+	*tMin = svec2i(MAX(t1.x - 1, 0), MAX(t1.y - 1, 0));
+	*tMax = svec2i(
+		MIN(t2.x + 1, map->Size.x - 1), MIN(t2.y + 1, map->Size.y - 1));
 }
 static bool CheckOverlaps(
 	const TTileItem *item, const struct vec2 pos, const struct vec2 vel,
@@ -54,8 +54,6 @@
 typedef struct
 {
 	AllyCollision allyCollision;
-	// Cache of tiles to check for potential collisions, of tile coords
-	CArray tileCache;	// of struct vec2i
 } CollisionSystem;
 
 extern CollisionSystem gCollisionSystem;
@@ -111,6 +109,11 @@ void OverlapTileItems(
 	const TTileItem *item, const struct vec2 pos, const struct vec2i size,
 	const CollisionParams params, CollideItemFunc func, void *data,
 	CheckWallFunc checkWallFunc, CollideWallFunc wallFunc, void *wallData);
+// Get the range of tiles (inclusive) whose things could collide with an item
+// moving from pos by vel; clamped to the map
+void SweptAABBToTiles(
+	const Map *map, const struct vec2 pos, const struct vec2 vel,
+	const struct vec2i size, struct vec2i *tMin, struct vec2i *tMax);
 // Get the first TTileItem that overlaps
 TTileItem *OverlapGetFirstItem(
 	const TTileItem *item, const struct vec2 pos, const struct vec2i size,
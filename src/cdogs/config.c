@@ -114,6 +114,38 @@ int StrScaleMode(const char *s)
 	S2T(SCALE_MODE_BILINEAR, "Bilinear");
 	return SCALE_MODE_NN;
 }
+const char *RendererTypeStr(int r)
+{
+	switch (r)
+	{
+		T2S(RENDERER_SOFTWARE, "Software");
+		T2S(RENDERER_TEXTURE, "Texture");
+	default:
+		return "";
+	}
+}
+int StrRendererType(const char *s)
+{
+	S2T(RENDERER_SOFTWARE, "Software");
+	S2T(RENDERER_TEXTURE, "Texture");
+	return RENDERER_SOFTWARE;
+}
+const char *FOVTypeStr(int f)
+{
+	switch (f)
+	{
+		T2S(FOV_RAYCAST, "Raycast");
+		T2S(FOV_SHADOWCAST, "Shadowcast");
+	default:
+		return "";
+	}
+}
+int StrFOVType(const char *s)
+{
+	S2T(FOV_RAYCAST, "Raycast");
+	S2T(FOV_SHADOWCAST, "Shadowcast");
+	return FOV_RAYCAST;
+}
 const char *GoreAmountStr(int g)
 {
 	switch (g)
@@ -312,21 +344,23 @@ int ConfigGetVersion(FILE *f)
 	return ConfigGetJSONVersion(f);
 }
 
+// Reentrant (no strtok) since AI threads read the config
 Config *ConfigGet(Config *c, const char *name)
 {
-	char *nameCopy;
-	CSTRDUP(nameCopy, name);
-	char *pch = strtok(nameCopy, ".");
-	while (pch != NULL)
+	const char *pch = name;
+	while (*pch != '\0')
 	{
+		const char *end = strchr(pch, '.');
+		const size_t len = end != NULL ? (size_t)(end - pch) : strlen(pch);
 		if (c->Type != CONFIG_TYPE_GROUP)
 		{
 			CASSERT(false, "Invalid config type");
-			goto bail;
+			break;
 		}
 		bool found = false;
 		CA_FOREACH(Config, child, c->u.Group)
-			if (strcmp(child->Name, pch) == 0)
+			if (strncmp(child->Name, pch, len) == 0 &&
+				child->Name[len] == '\0')
 			{
 				c = child;
 				found = true;
@@ -336,12 +370,11 @@ Config *ConfigGet(Config *c, const char *name)
 		if (!found)
 		{
 			CASSERT(false, "Config not found");
-			goto bail;
+			break;
 		}
-		pch = strtok(NULL, ".");
+		if (end == NULL) break;
+		pch = end + 1;
 	}
-bail:
-	CFREE(nameCopy);
 	return c;
 }
 
@@ -582,6 +615,13 @@ Config ConfigDefault(void)
 	ConfigGroupAdd(&game, ConfigNewBool("Fog", true));
 	ConfigGroupAdd(&game,
 		ConfigNewInt("SightRange", 15, 8, 40, 1, NULL, NULL));
+	ConfigGroupAdd(&game, ConfigNewEnum(
+		"FOV", FOV_RAYCAST, FOV_RAYCAST, FOV_SHADOWCAST,
+		StrFOVType, FOVTypeStr));
+	// Most decisions per AI update for AI away from the players; 0 for no
+	// limit
+	ConfigGroupAdd(&game,
+		ConfigNewInt("AIBudget", 32, 0, 512, 8, NULL, NULL));
 	ConfigGroupAdd(&game, ConfigNewEnum(
 		"FireMoveStyle", FIREMOVE_STOP, FIREMOVE_STOP, FIREMOVE_STRAFE,
 		StrFireMoveStyle, FireMoveStyleStr));
@@ -636,6 +676,9 @@ Config ConfigDefault(void)
 	ConfigGroupAdd(&gfx, ConfigNewEnum(
 		"ScaleMode", SCALE_MODE_NN, SCALE_MODE_NN, SCALE_MODE_BILINEAR,
 		StrScaleMode, ScaleModeStr));
+	ConfigGroupAdd(&gfx, ConfigNewEnum(
+		"Renderer", RENDERER_SOFTWARE, RENDERER_SOFTWARE, RENDERER_TEXTURE,
+		StrRendererType, RendererTypeStr));
 	ConfigGroupAdd(&gfx, ConfigNewBool("Shadows", true));
 	ConfigGroupAdd(&gfx, ConfigNewEnum(
 		"Gore", GORE_LOW, GORE_NONE, GORE_HIGH, StrGoreAmount, GoreAmountStr));
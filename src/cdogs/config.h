@@ -73,6 +73,22 @@ typedef enum
 const char *ScaleModeStr(int q);
 int StrScaleMode(const char *str);
 
+typedef enum
+{
+	RENDERER_SOFTWARE,
+	RENDERER_TEXTURE
+} RendererType;
+const char *RendererTypeStr(int r);
+int StrRendererType(const char *s);
+
+typedef enum
+{
+	FOV_RAYCAST,
+	FOV_SHADOWCAST
+} FOVType;
+const char *FOVTypeStr(int f);
+int StrFOVType(const char *s);
+
 typedef enum
 {
 	GORE_NONE,
@@ -71,6 +71,13 @@ void Draw_Point(const int x, const int y, color_t c)
 	{
 		return;
 	}
+	const SDL_Rect r = { x, y, 1, 1 };
+	if (RenderBatchRect(
+			&gGraphicsDevice.batch, r, c,
+			c.a == 255 ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND))
+	{
+		return;
+	}
 	if (c.a == 255)
 	{
 		screen[idx] = COLOR2PIXEL(c);
@@ -174,6 +181,11 @@ void DrawPointMask(GraphicsDevice *g, struct vec2i pos, color_t mask)
 	{
 		return;
 	}
+	const SDL_Rect r = { pos.x, pos.y, 1, 1 };
+	if (RenderBatchRect(&g->batch, r, mask, SDL_BLENDMODE_MOD))
+	{
+		return;
+	}
 	const int idx = PixelIndex(
 		pos.x, pos.y, g->cachedConfig.Res.x, g->cachedConfig.Res.y);
 	Uint32 *screen = g->buf;
@@ -195,6 +207,8 @@ void DrawPointTint(GraphicsDevice *device, struct vec2i pos, HSV tint)
 	{
 		return;
 	}
+	// Tints what has already been drawn
+	RenderBatchSoftware(&device->batch);
 	c = PIXEL2COLOR(screen[idx]);
 	c = ColorTint(c, tint);
 	screen[idx] = COLOR2PIXEL(c);
@@ -208,6 +222,24 @@ void DrawRectangle(
 	{
 		flags &= ~DRAW_FLAG_ROUNDED;
 	}
+	if (flags == 0)
+	{
+		const int left = MAX(pos.x, device->clipping.left);
+		const int right = MIN(pos.x + size.x - 1, device->clipping.right);
+		const int top = MAX(pos.y, device->clipping.top);
+		const int bottom = MIN(pos.y + size.y - 1, device->clipping.bottom);
+		if (left > right || top > bottom)
+		{
+			return;
+		}
+		const SDL_Rect r = { left, top, right - left + 1, bottom - top + 1 };
+		if (RenderBatchRect(
+				&device->batch, r, color,
+				color.a == 255 ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND))
+		{
+			return;
+		}
+	}
 	for (y = MAX(pos.y, device->clipping.top);
 		y < MIN(pos.y + size.y, device->clipping.bottom + 1);
 		y++)
@@ -241,8 +273,41 @@ void DrawRectangle(
 	}
 }
 
+void DrawRectangleMask(
+	GraphicsDevice *g, const struct vec2i pos, const struct vec2i size,
+	const color_t mask)
+{
+	const int left = MAX(pos.x, g->clipping.left);
+	const int right = MIN(pos.x + size.x - 1, g->clipping.right);
+	const int top = MAX(pos.y, g->clipping.top);
+	const int bottom = MIN(pos.y + size.y - 1, g->clipping.bottom);
+	if (left > right || top > bottom)
+	{
+		return;
+	}
+	const SDL_Rect r = { left, top, right - left + 1, bottom - top + 1 };
+	if (RenderBatchRect(&g->batch, r, mask, SDL_BLENDMODE_MOD))
+	{
+		return;
+	}
+	for (int y = top; y <= bottom; y++)
+	{
+		for (int x = left; x <= right; x++)
+		{
+			DrawPointMask(g, svec2i(x, y), mask);
+		}
+	}
+}
+
 void DrawCross(GraphicsDevice *device, int x, int y, color_t color)
 {
+	const SDL_Rect h = { x - 1, y, 3, 1 };
+	const SDL_Rect v = { x, y - 1, 1, 3 };
+	if (RenderBatchRect(&device->batch, h, color, SDL_BLENDMODE_NONE))
+	{
+		RenderBatchRect(&device->batch, v, color, SDL_BLENDMODE_NONE);
+		return;
+	}
 	Uint32 *screen = device->buf;
 	const Uint32 pixel = COLOR2PIXEL(color);
 	screen += x;
@@ -254,12 +319,18 @@ void DrawCross(GraphicsDevice *device, int x, int y, color_t color)
 	*(screen + gGraphicsDevice.cachedConfig.Res.x) = pixel;
 }
 
+static bool BatchShadow(
+	GraphicsDevice *g, const struct vec2i pos, const struct vec2i size);
 void DrawShadow(GraphicsDevice *device, struct vec2i pos, struct vec2i size)
 {
 	if (!ConfigGetBool(&gConfig, "Graphics.Shadows"))
 	{
 		return;
 	}
+	if (BatchShadow(device, pos, size))
+	{
+		return;
+	}
 	struct vec2i drawPos;
 	for (drawPos.y = pos.y - size.y; drawPos.y < pos.y + size.y; drawPos.y++)
 	{
@@ -296,3 +367,66 @@ void DrawShadow(GraphicsDevice *device, struct vec2i pos, struct vec2i size)
 		}
 	}
 }
+static const Pic *GetShadowPic(GraphicsDevice *g, const struct vec2i size);
+static bool BatchShadow(
+	GraphicsDevice *g, const struct vec2i pos, const struct vec2i size)
+{
+	if (!RenderBatchIsEnabled(&g->batch) || size.x <= 0 || size.y <= 0)
+	{
+		return false;
+	}
+	const Pic *pic = GetShadowPic(g, size);
+	if (pic == NULL)
+	{
+		return false;
+	}
+	// Same clipping as DrawShadow
+	const struct vec2i origin = svec2i_subtract(pos, size);
+	const int left = MAX(origin.x, g->clipping.left);
+	const int right = MIN(pos.x + size.x, g->clipping.right);
+	const int top = MAX(origin.y, g->clipping.top);
+	const int bottom = MIN(pos.y + size.y, g->clipping.bottom);
+	if (left >= right || top >= bottom)
+	{
+		return true;
+	}
+	const SDL_Rect src =
+	{
+		left - origin.x, top - origin.y, right - left, bottom - top
+	};
+	const SDL_Rect dst = { left, top, right - left, bottom - top };
+	// The tint only scales value, which is the same as multiplying
+	return RenderBatchPic(
+		&g->batch, pic, src, dst, colorWhite, SDL_BLENDMODE_MOD);
+}
+static const Pic *GetShadowPic(GraphicsDevice *g, const struct vec2i size)
+{
+	char key[64];
+	sprintf(key, "shadow/%dx%d", size.x, size.y);
+	const Pic *shadow = RenderBatchGetPic(&g->batch, key);
+	if (shadow != NULL)
+	{
+		return shadow;
+	}
+	Pic p = picNone;
+	p.size = svec2i_scale(size, 2);
+	p.offset = svec2i_zero();
+	CMALLOC(p.Data, p.size.x * p.size.y * sizeof *p.Data);
+	for (int y = 0; y < p.size.y; y++)
+	{
+		for (int x = 0; x < p.size.x; x++)
+		{
+			// Same as DrawShadow, relative to the centre
+			const struct vec2i scaledPos = svec2i(
+				x - size.x, (y - size.y) * size.x / size.y);
+			const int distance2 =
+				svec2i_distance_squared(scaledPos, svec2i_zero());
+			const double v =
+				CLAMP(distance2 * 1.0 / (size.x*size.x), 0.0, 1.0);
+			const uint8_t value = (uint8_t)(v * 255);
+			const color_t c = { value, value, value, 255 };
+			p.Data[x + y * p.size.x] = COLOR2PIXEL(c);
+		}
+	}
+	return RenderBatchAddPic(&g->batch, key, &p);
+}
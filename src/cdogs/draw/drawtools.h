@@ -73,6 +73,10 @@ typedef enum
 } DrawFlags;
 void DrawRectangle(
 	GraphicsDevice *device, struct vec2i pos, struct vec2i size, color_t color, int flags);
+// Multiply what has been drawn in a rectangle by a colour
+void DrawRectangleMask(
+	GraphicsDevice *g, const struct vec2i pos, const struct vec2i size,
+	const color_t mask);
 
 //  *
 // ***
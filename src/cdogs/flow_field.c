@@ -0,0 +1,217 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "flow_field.h"
+
+#include <string.h>
+
+FlowFields gFlowFields;
+
+
+void FlowFieldsInit(FlowFields *ff, Map *m, TileSelectFunc isTileOk)
+{
+	CArrayInit(&ff->fields, sizeof(FlowField));
+	CArrayInit(&ff->queue, sizeof(struct vec2i));
+	CArrayInit(&ff->walkable, sizeof(bool));
+	ff->WalkableDirty = true;
+	ff->map = m;
+	ff->IsTileOk = isTileOk;
+}
+void FlowFieldsTerminate(FlowFields *ff)
+{
+	CA_FOREACH(FlowField, f, ff->fields)
+		CArrayTerminate(&f->Dist);
+	CA_FOREACH_END()
+	CArrayTerminate(&ff->fields);
+	CArrayTerminate(&ff->queue);
+	CArrayTerminate(&ff->walkable);
+}
+
+void FlowFieldsClear(FlowFields *ff)
+{
+	CA_FOREACH(FlowField, f, ff->fields)
+		f->Dirty = true;
+	CA_FOREACH_END()
+	ff->WalkableDirty = true;
+}
+
+static void FlowFieldCalc(FlowFields *ff, FlowField *f);
+const FlowField *FlowFieldsGet(
+	FlowFields *ff, const int uid, const struct vec2i goal)
+{
+	FlowField *field = NULL;
+	CA_FOREACH(FlowField, f, ff->fields)
+		if (f->UID == uid)
+		{
+			field = f;
+			break;
+		}
+	CA_FOREACH_END()
+	if (field == NULL)
+	{
+		FlowField f;
+		memset(&f, 0, sizeof f);
+		f.UID = uid;
+		f.Dirty = true;
+		CArrayInit(&f.Dist, sizeof(uint16_t));
+		CArrayPushBack(&ff->fields, &f);
+		field = CArrayGet(&ff->fields, ff->fields.size - 1);
+	}
+	if (field->Dirty || !svec2i_is_equal(field->Goal, goal))
+	{
+		field->Goal = goal;
+		FlowFieldCalc(ff, field);
+		field->Dirty = false;
+	}
+	return field;
+}
+static bool IsWalkable(
+	const CArray *walkable, const Map *m, const struct vec2i pos);
+static void UpdateWalkable(FlowFields *ff);
+static void FlowFieldCalc(FlowFields *ff, FlowField *f)
+{
+	const Map *m = ff->map;
+	const int size = m->Size.x * m->Size.y;
+	const uint16_t unreachable = FLOW_FIELD_UNREACHABLE;
+	CArrayClear(&f->Dist);
+	CArrayResize(&f->Dist, size, &unreachable);
+	uint16_t *dist = f->Dist.data;
+	if (f->Goal.x < 0 || f->Goal.x >= m->Size.x ||
+		f->Goal.y < 0 || f->Goal.y >= m->Size.y)
+	{
+		return;
+	}
+
+	UpdateWalkable(ff);
+
+	// Breadth-first search out from the goal
+	// The goal is always included, in case the actor is standing somewhere
+	// AI would rather not, like next to an explosive
+	CArrayClear(&ff->queue);
+	CArrayPushBack(&ff->queue, &f->Goal);
+	dist[f->Goal.y * m->Size.x + f->Goal.x] = 0;
+	struct vec2i v;
+	for (size_t i = 0; i < ff->queue.size; i++)
+	{
+		const struct vec2i p = *(const struct vec2i *)CArrayGet(&ff->queue, i);
+		const uint16_t d = dist[p.y * m->Size.x + p.x];
+		for (v.y = p.y - 1; v.y <= p.y + 1; v.y++)
+		{
+			for (v.x = p.x - 1; v.x <= p.x + 1; v.x++)
+			{
+				if (!IsWalkable(&ff->walkable, m, v) ||
+					dist[v.y * m->Size.x + v.x] != unreachable)
+				{
+					continue;
+				}
+				// Don't cut corners when moving diagonally, same as A*
+				if (!IsWalkable(&ff->walkable, m, svec2i(p.x, v.y)) ||
+					!IsWalkable(&ff->walkable, m, svec2i(v.x, p.y)))
+				{
+					continue;
+				}
+				dist[v.y * m->Size.x + v.x] = (uint16_t)(d + 1);
+				CArrayPushBack(&ff->queue, &v);
+			}
+		}
+	}
+}
+static void UpdateWalkable(FlowFields *ff)
+{
+	// Check each tile once, and share the results between the fields until
+	// the map changes; the tile checks are the expensive part
+	if (!ff->WalkableDirty) return;
+	CArrayClear(&ff->walkable);
+	struct vec2i v;
+	for (v.y = 0; v.y < ff->map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < ff->map->Size.x; v.x++)
+		{
+			const bool isWalkable = ff->IsTileOk(ff->map, v);
+			CArrayPushBack(&ff->walkable, &isWalkable);
+		}
+	}
+	ff->WalkableDirty = false;
+}
+static bool IsWalkable(
+	const CArray *walkable, const Map *m, const struct vec2i pos)
+{
+	if (pos.x < 0 || pos.x >= m->Size.x || pos.y < 0 || pos.y >= m->Size.y)
+	{
+		return false;
+	}
+	return *(const bool *)CArrayGet(walkable, pos.y * m->Size.x + pos.x);
+}
+
+static uint16_t GetDist(
+	const FlowField *f, const Map *m, const struct vec2i pos);
+bool FlowFieldNextTile(
+	const FlowField *f, const Map *m, const struct vec2i from,
+	struct vec2i *next)
+{
+	uint16_t minDist = GetDist(f, m, from);
+	if (minDist == 0 || minDist == FLOW_FIELD_UNREACHABLE)
+	{
+		return false;
+	}
+	// Try the axes first, so that they are preferred over diagonals
+	static const struct vec2i dirs[] =
+	{
+		{ 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 },
+		{ 1, -1 }, { 1, 1 }, { -1, 1 }, { -1, -1 }
+	};
+	bool found = false;
+	for (int i = 0; i < 8; i++)
+	{
+		const struct vec2i v = svec2i_add(from, dirs[i]);
+		const uint16_t d = GetDist(f, m, v);
+		if (d >= minDist)
+		{
+			continue;
+		}
+		// Only unreachable tiles can be unwalkable, so check that the
+		// corners are reachable for diagonals
+		if (dirs[i].x != 0 && dirs[i].y != 0 &&
+			(GetDist(f, m, svec2i(from.x, v.y)) == FLOW_FIELD_UNREACHABLE ||
+			GetDist(f, m, svec2i(v.x, from.y)) == FLOW_FIELD_UNREACHABLE))
+		{
+			continue;
+		}
+		minDist = d;
+		*next = v;
+		found = true;
+	}
+	return found;
+}
+static uint16_t GetDist(
+	const FlowField *f, const Map *m, const struct vec2i pos)
+{
+	if (pos.x < 0 || pos.x >= m->Size.x || pos.y < 0 || pos.y >= m->Size.y ||
+		f->Dist.size == 0)
+	{
+		return FLOW_FIELD_UNREACHABLE;
+	}
+	return *(const uint16_t *)CArrayGet(&f->Dist, pos.y * m->Size.x + pos.x);
+}
@@ -0,0 +1,81 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "c_array.h"
+#include "map.h"
+#include "vector.h"
+
+// Flow fields: distance maps from a goal tile to every tile that can walk to
+// it. Any number of AI can head towards the same goal by stepping to the
+// neighbouring tile with the lowest distance, without pathfinding each.
+// Used for AI going towards players; one field per player, recalculated
+// when they cross into another tile.
+
+#define FLOW_FIELD_UNREACHABLE UINT16_MAX
+
+typedef struct
+{
+	int UID;	// of the actor being headed towards
+	struct vec2i Goal;
+	bool Dirty;
+	CArray Dist;	// of uint16_t, tiles from the goal, by tile
+} FlowField;
+
+typedef struct
+{
+	CArray fields;	// of FlowField
+	CArray queue;	// of struct vec2i, scratch for building the fields
+	CArray walkable;	// of bool, by tile
+	bool WalkableDirty;
+	Map *map;
+	TileSelectFunc IsTileOk;
+} FlowFields;
+
+// Note: lifetime managed by Map
+extern FlowFields gFlowFields;
+
+void FlowFieldsInit(FlowFields *ff, Map *m, TileSelectFunc isTileOk);
+void FlowFieldsTerminate(FlowFields *ff);
+
+// Mark all fields, and which tiles are walkable, for recalculation
+// This is done when the underlying map changes, changing paths
+// e.g. keys
+void FlowFieldsClear(FlowFields *ff);
+
+// Get the field towards an actor, which is currently at goal
+// The field is recalculated if the goal has changed since it was last used
+const FlowField *FlowFieldsGet(
+	FlowFields *ff, const int uid, const struct vec2i goal);
+
+// Find the next tile to walk to from a tile, towards the field's goal
+// Returns false if the goal cannot be reached or we are already there
+bool FlowFieldNextTile(
+	const FlowField *f, const Map *m, const struct vec2i from,
+	struct vec2i *next);
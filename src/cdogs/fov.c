@@ -0,0 +1,230 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "fov.h"
+
+#include "algorithms.h"
+
+
+void FOVMapInit(FOVMap *m, const struct vec2i size)
+{
+	m->Size = size;
+	m->Stride = (size.x + 31) / 32;
+	CArrayInit(&m->Bits, sizeof(uint32_t));
+	const uint32_t zero = 0;
+	CArrayResize(&m->Bits, m->Stride * size.y, &zero);
+}
+void FOVMapTerminate(FOVMap *m)
+{
+	CArrayTerminate(&m->Bits);
+}
+static bool FOVMapIsIn(const FOVMap *m, const struct vec2i pos);
+void FOVMapSet(FOVMap *m, const struct vec2i pos, const bool isBlocked)
+{
+	if (!FOVMapIsIn(m, pos)) return;
+	uint32_t *word = CArrayGet(&m->Bits, pos.y * m->Stride + pos.x / 32);
+	const uint32_t bit = 1u << (pos.x % 32);
+	if (isBlocked)
+	{
+		*word |= bit;
+	}
+	else
+	{
+		*word &= ~bit;
+	}
+}
+bool FOVMapIsBlocked(const FOVMap *m, const struct vec2i pos)
+{
+	if (!FOVMapIsIn(m, pos)) return true;
+	const uint32_t *word = CArrayGet(&m->Bits, pos.y * m->Stride + pos.x / 32);
+	return (*word >> (pos.x % 32)) & 1;
+}
+static bool FOVMapIsIn(const FOVMap *m, const struct vec2i pos)
+{
+	return pos.x >= 0 && pos.x < m->Size.x && pos.y >= 0 && pos.y < m->Size.y;
+}
+
+typedef struct
+{
+	const FOVMap *Map;
+	struct vec2i Center;
+	int SightRange2;
+	FOVSetVisibleFunc SetVisible;
+	void *data;
+} FOVData;
+static void Raycast(FOVData *data, const int sightRange);
+static void Shadowcast(const FOVData *data, const int sightRange);
+void FOVCalc(
+	const FOVType type, const FOVMap *m, const struct vec2i pos,
+	const int sightRange, FOVSetVisibleFunc setVisible, void *data)
+{
+	if (sightRange <= 0) return;
+	FOVData fData;
+	fData.Map = m;
+	fData.Center = pos;
+	fData.SightRange2 = sightRange * sightRange;
+	fData.SetVisible = setVisible;
+	fData.data = data;
+	switch (type)
+	{
+	case FOV_SHADOWCAST:
+		Shadowcast(&fData, sightRange);
+		break;
+	default:
+		Raycast(&fData, sightRange);
+		break;
+	}
+}
+
+static bool IsNextTileBlockedAndSetVisibility(void *data, struct vec2i pos);
+static void Raycast(FOVData *data, const int sightRange)
+{
+	// Perform LOS by casting rays from the centre to the edges, terminating
+	// whenever an obstruction or out-of-range is reached.
+	const struct vec2i pos = data->Center;
+
+	// Limit the perimeter to the sight range
+	const struct vec2i origin = svec2i(pos.x - sightRange, pos.y - sightRange);
+	const struct vec2i perimSize = svec2i_scale(svec2i_subtract(pos, origin), 2);
+
+	// Start from the top-left cell, and proceed clockwise around
+	struct vec2i end = origin;
+	HasClearLineData lineData;
+	lineData.IsBlocked = IsNextTileBlockedAndSetVisibility;
+	lineData.data = data;
+	// Top edge
+	for (; end.x < origin.x + perimSize.x; end.x++)
+	{
+		HasClearLineJMRaytrace(pos, end, &lineData);
+	}
+	// right edge
+	for (; end.y < origin.y + perimSize.y; end.y++)
+	{
+		HasClearLineJMRaytrace(pos, end, &lineData);
+	}
+	// bottom edge
+	for (; end.x > origin.x; end.x--)
+	{
+		HasClearLineJMRaytrace(pos, end, &lineData);
+	}
+	// left edge
+	for (; end.y > origin.y; end.y--)
+	{
+		HasClearLineJMRaytrace(pos, end, &lineData);
+	}
+}
+static bool IsNextTileBlockedAndSetVisibility(void *data, struct vec2i pos)
+{
+	const FOVData *fData = data;
+	// Check sight range
+	if (svec2i_distance_squared(fData->Center, pos) >= fData->SightRange2)
+	{
+		return true;
+	}
+	// Check map range
+	if (!FOVMapIsIn(fData->Map, pos)) return true;
+	if (!svec2i_is_equal(fData->Center, pos))
+	{
+		fData->SetVisible(fData->data, pos);
+	}
+	// Check if this tile is an obstruction
+	return FOVMapIsBlocked(fData->Map, pos);
+}
+
+// Transforms from octant-relative (column, row) to map offsets
+static const int octants[8][4] =
+{
+	{ 1, 0, 0, 1 }, { 0, 1, 1, 0 }, { 0, -1, 1, 0 }, { -1, 0, 0, 1 },
+	{ -1, 0, 0, -1 }, { 0, -1, -1, 0 }, { 0, 1, -1, 0 }, { 1, 0, 0, -1 }
+};
+static void CastLight(
+	const FOVData *data, const int *octant, const int row,
+	double startSlope, const double endSlope, const int sightRange);
+static void Shadowcast(const FOVData *data, const int sightRange)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		CastLight(data, octants[i], 1, 1.0, 0.0, sightRange);
+	}
+}
+// Scan an octant outwards from row, between the slopes (column / row,
+// from 1 at the diagonal to 0 at the axis), recursing into the parts left
+// open by blocking tiles
+static void CastLight(
+	const FOVData *data, const int *octant, const int row,
+	double startSlope, const double endSlope, const int sightRange)
+{
+	if (startSlope < endSlope) return;
+	double nextStartSlope = startSlope;
+	for (int dist = row; dist <= sightRange; dist++)
+	{
+		bool isBlocked = false;
+		for (int col = dist; col >= 0; col--)
+		{
+			// Slopes of the tile's corners
+			const double leftSlope = (col + 0.5) / (dist - 0.5);
+			const double rightSlope = (col - 0.5) / (dist + 0.5);
+			if (rightSlope > startSlope) continue;
+			if (leftSlope < endSlope) break;
+
+			const struct vec2i pos = svec2i(
+				data->Center.x + col * octant[0] + dist * octant[1],
+				data->Center.y + col * octant[2] + dist * octant[3]);
+			const bool isTileBlocked = FOVMapIsBlocked(data->Map, pos);
+			// Blocking tiles are seen if any part is lit, others only if
+			// their centre is, so that sight is symmetric
+			const double centreSlope = (double)col / dist;
+			const bool isLit = isTileBlocked ||
+				(centreSlope <= startSlope && centreSlope >= endSlope);
+			if (isLit && col * col + dist * dist < data->SightRange2 &&
+				FOVMapIsIn(data->Map, pos))
+			{
+				data->SetVisible(data->data, pos);
+			}
+			if (isBlocked)
+			{
+				if (isTileBlocked)
+				{
+					nextStartSlope = rightSlope;
+				}
+				else
+				{
+					isBlocked = false;
+					startSlope = nextStartSlope;
+				}
+			}
+			else if (isTileBlocked && dist < sightRange)
+			{
+				// Scan the rows beyond the open part before this tile
+				isBlocked = true;
+				CastLight(
+					data, octant, dist + 1, startSlope, leftSlope,
+					sightRange);
+				nextStartSlope = rightSlope;
+			}
+		}
+		if (isBlocked) break;
+	}
+}
@@ -0,0 +1,63 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "c_array.h"
+#include "config.h"
+#include "vector.h"
+
+// Field of view: which tiles can be seen from a tile, given the tiles that
+// block sight.
+// - Raycast: a ray is cast to each tile on the perimeter of the sight
+//   range; tiles near the centre are visited by many rays
+// - Shadowcast: recursive shadowcasting; each octant is scanned row by row
+//   outwards, skipping the ranges shadowed by blocking tiles, so each tile
+//   is visited about once
+
+// Tiles that block sight, packed one bit per tile
+typedef struct
+{
+	struct vec2i Size;
+	int Stride;	// words per row
+	CArray Bits;	// of uint32_t
+} FOVMap;
+
+void FOVMapInit(FOVMap *m, const struct vec2i size);
+void FOVMapTerminate(FOVMap *m);
+void FOVMapSet(FOVMap *m, const struct vec2i pos, const bool isBlocked);
+// Tiles outside the map block sight
+bool FOVMapIsBlocked(const FOVMap *m, const struct vec2i pos);
+
+typedef void (*FOVSetVisibleFunc)(void *data, const struct vec2i pos);
+// Find the tiles in the map visible from pos, within the sight range
+// (exclusive), and call setVisible for each. The blocking tiles that are
+// seen are visible too. The centre tile itself is not included.
+void FOVCalc(
+	const FOVType type, const FOVMap *m, const struct vec2i pos,
+	const int sightRange, FOVSetVisibleFunc setVisible, void *data);
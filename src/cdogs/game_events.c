@@ -51,67 +51,71 @@ void GameEventsTerminate(CArray *store)
 // Array indexed by GameEvent
 static GameEventEntry sGameEventEntries[] =
 {
-	{ GAME_EVENT_NONE, false, false, false, false, NULL },
-
-	{ GAME_EVENT_CLIENT_CONNECT, false, false, false, false, NULL },
-	{ GAME_EVENT_CLIENT_ID, false, false, false, false, NClientId_fields },
-	{ GAME_EVENT_CAMPAIGN_DEF, false, false, false, false, NCampaignDef_fields },
-	{ GAME_EVENT_PLAYER_DATA, true, false, true, false, NPlayerData_fields },
-	{ GAME_EVENT_PLAYER_REMOVE, true, false, true, false, NPlayerRemove_fields },
-	{ GAME_EVENT_TILE_SET, true, false, true, true, NTileSet_fields },
-	{ GAME_EVENT_MAP_OBJECT_ADD, true, false, true, true, NMapObjectAdd_fields },
-	{ GAME_EVENT_MAP_OBJECT_DAMAGE, true, false, true, true, NMapObjectDamage_fields },
-	{ GAME_EVENT_MAP_OBJECT_REMOVE, true, false, true, true, NMapObjectRemove_fields },
-	{ GAME_EVENT_CLIENT_READY, false, false, false, false, NULL },
-	{ GAME_EVENT_NET_GAME_START, false, false, false, false, NULL },
-
-	{ GAME_EVENT_CONFIG, true, false, true, false, NConfig_fields },
-	{ GAME_EVENT_SCORE, true, true, true, true, NScore_fields },
-	{ GAME_EVENT_SOUND_AT, true, false, true, true, NSound_fields },
-	{ GAME_EVENT_SCREEN_SHAKE, false, false, true, true, NULL },
-	{ GAME_EVENT_SET_MESSAGE, false, false, true, true, NULL },
-
-	{ GAME_EVENT_GAME_START, true, false, true, true, NULL },
-	{ GAME_EVENT_GAME_BEGIN, true, false, true, true, NGameBegin_fields },
-
-	{ GAME_EVENT_ACTOR_ADD, true, false, true, true, NActorAdd_fields },
-	{ GAME_EVENT_ACTOR_MOVE, true, true, true, true, NActorMove_fields },
-	{ GAME_EVENT_ACTOR_STATE, true, true, true, true, NActorState_fields },
-	{ GAME_EVENT_ACTOR_DIR, true, true, true, true, NActorDir_fields },
-	{ GAME_EVENT_ACTOR_SLIDE, true, true, true, true, NActorSlide_fields },
-	{ GAME_EVENT_ACTOR_IMPULSE, true, false, true, true, NActorImpulse_fields },
-	{ GAME_EVENT_ACTOR_SWITCH_GUN, true, true, true, true, NActorSwitchGun_fields },
-	{ GAME_EVENT_ACTOR_PICKUP_ALL, false, true, true, true, NActorPickupAll_fields },
-	{ GAME_EVENT_ACTOR_REPLACE_GUN, true, false, true, true, NActorReplaceGun_fields },
-	{ GAME_EVENT_ACTOR_HEAL, true, false, true, true, NActorHeal_fields },
-	{ GAME_EVENT_ACTOR_HIT, true, false, true, true, NActorHit_fields },
-	{ GAME_EVENT_ACTOR_ADD_AMMO, true, false, true, true, NActorAddAmmo_fields },
-	{ GAME_EVENT_ACTOR_USE_AMMO, true, true, true, true, NActorUseAmmo_fields },
-	{ GAME_EVENT_ACTOR_DIE, true, false, true, true, NActorDie_fields },
-	{ GAME_EVENT_ACTOR_MELEE, true, true, true, true, NActorMelee_fields },
-
-	{ GAME_EVENT_ADD_PICKUP, true, false, true, true, NAddPickup_fields },
-	{ GAME_EVENT_REMOVE_PICKUP, true, false, true, true, NRemovePickup_fields },
-
-	{ GAME_EVENT_BULLET_BOUNCE, true, false, true, true, NBulletBounce_fields },
-	{ GAME_EVENT_REMOVE_BULLET, true, false, true, true, NRemoveBullet_fields },
-	{ GAME_EVENT_PARTICLE_REMOVE, false, false, true, true, NULL },
-	{ GAME_EVENT_GUN_FIRE, true, true, true, true, NGunFire_fields },
-	{ GAME_EVENT_GUN_RELOAD, true, true, true, true, NGunReload_fields },
-	{ GAME_EVENT_GUN_STATE, true, true, true, true, NGunState_fields },
-	{ GAME_EVENT_ADD_BULLET, true, false, true, true, NAddBullet_fields },
-	{ GAME_EVENT_ADD_PARTICLE, false, false, true, true, NULL },
-	{ GAME_EVENT_TRIGGER, true, false, true, true, NTrigger_fields },
-	{ GAME_EVENT_EXPLORE_TILES, true, false, true, true, NExploreTiles_fields },
-	{ GAME_EVENT_RESCUE_CHARACTER, true, false, true, true, NRescueCharacter_fields },
-	{ GAME_EVENT_OBJECTIVE_UPDATE, true, false, true, true, NObjectiveUpdate_fields },
-	{ GAME_EVENT_ADD_KEYS, true, false, true, true, NAddKeys_fields },
-
-	{ GAME_EVENT_MISSION_COMPLETE, true, false, true, true, NMissionComplete_fields },
-
-	{ GAME_EVENT_MISSION_INCOMPLETE, true, false, true, true, NULL },
-	{ GAME_EVENT_MISSION_PICKUP, true, false, true, true, NULL },
-	{ GAME_EVENT_MISSION_END, true, false, true, true, NMissionEnd_fields }
+	{ GAME_EVENT_NONE, false, false, false, false, NULL, NET_DELIVERY_RELIABLE },
+
+	{ GAME_EVENT_CLIENT_CONNECT, false, false, false, false, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_CLIENT_ID, false, false, false, false, NClientId_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_CAMPAIGN_DEF, false, false, false, false, NCampaignDef_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_STRING_DEF, false, false, false, false, NStringDef_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_PLAYER_DATA, true, false, true, false, NPlayerData_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_PLAYER_REMOVE, true, false, true, false, NPlayerRemove_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_TILE_SET, true, false, true, true, NTileSet_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_MAP_OBJECT_ADD, true, false, true, true, NMapObjectAdd_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_MAP_OBJECT_DAMAGE, true, false, true, true, NMapObjectDamage_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_MAP_OBJECT_REMOVE, true, false, true, true, NMapObjectRemove_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_CLIENT_READY, false, false, false, false, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_NET_GAME_START, false, false, false, false, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_SNAPSHOT, false, false, false, false, NSnapshot_fields, NET_DELIVERY_SEQUENCED },
+	{ GAME_EVENT_SNAPSHOT_ACK, false, false, false, false, NSnapshotAck_fields, NET_DELIVERY_SEQUENCED },
+
+	{ GAME_EVENT_CONFIG, true, false, true, false, NConfig_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_SCORE, true, true, true, true, NScore_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_SOUND_AT, true, false, true, true, NSound_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_SCREEN_SHAKE, false, false, true, true, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_SET_MESSAGE, false, false, true, true, NULL, NET_DELIVERY_RELIABLE },
+
+	{ GAME_EVENT_GAME_START, true, false, true, true, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_GAME_BEGIN, true, false, true, true, NGameBegin_fields, NET_DELIVERY_RELIABLE },
+
+	{ GAME_EVENT_ACTOR_ADD, true, false, true, true, NActorAdd_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_MOVE, false, true, true, true, NActorMove_fields, NET_DELIVERY_SEQUENCED },
+	{ GAME_EVENT_ACTOR_MOVE_ACK, false, false, false, false, NActorMoveAck_fields, NET_DELIVERY_SEQUENCED },
+	{ GAME_EVENT_ACTOR_STATE, false, true, true, true, NActorState_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_DIR, false, true, true, true, NActorDir_fields, NET_DELIVERY_SEQUENCED },
+	{ GAME_EVENT_ACTOR_SLIDE, true, true, true, true, NActorSlide_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_IMPULSE, true, false, true, true, NActorImpulse_fields, NET_DELIVERY_UNSEQUENCED },
+	{ GAME_EVENT_ACTOR_SWITCH_GUN, true, true, true, true, NActorSwitchGun_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_PICKUP_ALL, false, true, true, true, NActorPickupAll_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_REPLACE_GUN, true, false, true, true, NActorReplaceGun_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_HEAL, true, false, true, true, NActorHeal_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_HIT, true, false, true, true, NActorHit_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_ADD_AMMO, true, false, true, true, NActorAddAmmo_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_USE_AMMO, true, true, true, true, NActorUseAmmo_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_DIE, true, false, true, true, NActorDie_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ACTOR_MELEE, true, true, true, true, NActorMelee_fields, NET_DELIVERY_RELIABLE },
+
+	{ GAME_EVENT_ADD_PICKUP, true, false, true, true, NAddPickup_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_REMOVE_PICKUP, true, false, true, true, NRemovePickup_fields, NET_DELIVERY_RELIABLE },
+
+	{ GAME_EVENT_BULLET_BOUNCE, true, false, true, true, NBulletBounce_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_REMOVE_BULLET, true, false, true, true, NRemoveBullet_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_PARTICLE_REMOVE, false, false, true, true, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_GUN_FIRE, true, true, true, true, NGunFire_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_GUN_RELOAD, true, true, true, true, NGunReload_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_GUN_STATE, true, true, true, true, NGunState_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ADD_BULLET, true, false, true, true, NAddBullet_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ADD_PARTICLE, false, false, true, true, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_TRIGGER, true, false, true, true, NTrigger_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_EXPLORE_TILES, true, false, true, true, NExploreTiles_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_RESCUE_CHARACTER, true, false, true, true, NRescueCharacter_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_OBJECTIVE_UPDATE, true, false, true, true, NObjectiveUpdate_fields, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_ADD_KEYS, true, false, true, true, NAddKeys_fields, NET_DELIVERY_RELIABLE },
+
+	{ GAME_EVENT_MISSION_COMPLETE, true, false, true, true, NMissionComplete_fields, NET_DELIVERY_RELIABLE },
+
+	{ GAME_EVENT_MISSION_INCOMPLETE, true, false, true, true, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_MISSION_PICKUP, true, false, true, true, NULL, NET_DELIVERY_RELIABLE },
+	{ GAME_EVENT_MISSION_END, true, false, true, true, NMissionEnd_fields, NET_DELIVERY_RELIABLE }
 };
 GameEventEntry GameEventGetEntry(const GameEventType e)
 {
@@ -45,6 +45,7 @@ typedef enum
 	GAME_EVENT_CLIENT_CONNECT,
 	GAME_EVENT_CLIENT_ID,
 	GAME_EVENT_CAMPAIGN_DEF,
+	GAME_EVENT_STRING_DEF,
 	GAME_EVENT_PLAYER_DATA,
 	GAME_EVENT_PLAYER_REMOVE,
 	GAME_EVENT_TILE_SET,
@@ -53,6 +54,9 @@ typedef enum
 	GAME_EVENT_MAP_OBJECT_REMOVE,
 	GAME_EVENT_CLIENT_READY,
 	GAME_EVENT_NET_GAME_START,
+	// World state sync; see net_snapshot.h
+	GAME_EVENT_SNAPSHOT,
+	GAME_EVENT_SNAPSHOT_ACK,
 
 	GAME_EVENT_CONFIG,
 	GAME_EVENT_SCORE,
@@ -67,6 +71,8 @@ typedef enum
 
 	GAME_EVENT_ACTOR_ADD,
 	GAME_EVENT_ACTOR_MOVE,
+	// Server response to client moves; see net_predict.h
+	GAME_EVENT_ACTOR_MOVE_ACK,
 	GAME_EVENT_ACTOR_STATE,
 	GAME_EVENT_ACTOR_DIR,
 	GAME_EVENT_ACTOR_SLIDE,
@@ -105,9 +111,24 @@ typedef enum
 	GAME_EVENT_MISSION_INCOMPLETE,
 	// In pickup area
 	GAME_EVENT_MISSION_PICKUP,
-	GAME_EVENT_MISSION_END
+	GAME_EVENT_MISSION_END,
+
+	GAME_EVENT_COUNT
 } GameEventType;
 
+// How net messages are delivered; each has its own channel
+typedef enum
+{
+	// Reliable and ordered
+	NET_DELIVERY_RELIABLE,
+	// Unreliable; older messages are dropped if newer ones arrive first.
+	// For state that is superseded by later updates, like positions
+	NET_DELIVERY_SEQUENCED,
+	// Unreliable and unordered
+	NET_DELIVERY_UNSEQUENCED,
+	NET_DELIVERY_COUNT
+} NetDelivery;
+
 // Which game events should be passed along to server or client
 typedef struct
 {
@@ -121,6 +142,7 @@ typedef struct
 	// Whether to broadcast these events only after game start
 	bool GameStart;
 	const pb_field_t *Fields;
+	NetDelivery Delivery;
 } GameEventEntry;
 GameEventEntry GameEventGetEntry(const GameEventType e);
 
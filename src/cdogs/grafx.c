@@ -62,6 +62,7 @@
 #include <SDL_mouse.h>
 
 #include "blit.h"
+#include "blit_kernels.h"
 #include "config.h"
 #include "defs.h"
 #include "draw/drawtools.h"
@@ -146,6 +147,8 @@ void GraphicsInit(GraphicsDevice *device, Config *c)
 	AddGraphicsMode(device, 400, 300);
 	AddGraphicsMode(device, 640, 480);
 	GraphicsConfigSetFromConfig(&device->cachedConfig, c);
+	BlitKernelsInit();
+	LOG(LM_GFX, LL_INFO, "blitter: %s", gBlitKernels->Name);
 }
 
 static void AddSupportedGraphicsModes(GraphicsDevice *device)
@@ -184,6 +187,23 @@ void GraphicsInitialize(GraphicsDevice *g)
 		return;
 	}
 
+	if (g->cachedConfig.IsHeadless)
+	{
+		// Only the pixel format (for loading pics) and the software buffer
+		// are needed; nothing is ever presented
+		if (g->Format == NULL)
+		{
+			g->Format = SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888);
+		}
+		CFREE(g->buf);
+		CCALLOC(g->buf, GraphicsGetMemSize(&g->cachedConfig));
+		GraphicsSetBlitClip(
+			g, 0, 0, g->cachedConfig.Res.x - 1, g->cachedConfig.Res.y - 1);
+		g->IsInitialized = true;
+		g->cachedConfig.RestartFlags = 0;
+		return;
+	}
+
 	if (!g->IsWindowInitialized)
 	{
 		char buf[CDOGS_PATH_MAX];
@@ -206,6 +226,17 @@ void GraphicsInitialize(GraphicsDevice *g)
 	const bool initBrightness =
 		!!(g->cachedConfig.RestartFlags &
 		(RESTART_RESOLUTION | RESTART_SCALE_MODE | RESTART_BRIGHTNESS));
+	// The editor draws to the buffer directly, and pic textures belong to
+	// the game window's renderer
+	const bool useTextures =
+		g->cachedConfig.Renderer == RENDERER_TEXTURE &&
+		!g->cachedConfig.IsEditor && !g->cachedConfig.SecondWindow;
+
+	if (initTextures)
+	{
+		// Its textures are about to be destroyed
+		RenderBatchTerminate(&g->batch);
+	}
 
 	if (initRenderer)
 	{
@@ -230,6 +261,13 @@ void GraphicsInitialize(GraphicsDevice *g)
 		WindowContextDestroy(&g->secondWindow);
 		SDL_FreeFormat(g->Format);
 
+#ifdef SDL_HINT_RENDER_BATCHING
+		if (useTextures)
+		{
+			SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+		}
+#endif
+
 		char title[32];
 		sprintf(title, "C-Dogs SDL %s%s",
 			g->cachedConfig.IsEditor ? "Editor " : "",
@@ -288,8 +326,22 @@ void GraphicsInitialize(GraphicsDevice *g)
 
 		CFREE(g->buf);
 		CCALLOC(g->buf, GraphicsGetMemSize(&g->cachedConfig));
+		if (useTextures &&
+			!RenderBatchInit(
+				&g->batch, g->gameWindow.renderer, g->buf, svec2i(w, h)))
+		{
+			LOG(LM_GFX, LL_WARN, "cannot use texture renderer");
+		}
+		// Layers are render targets for the texture renderer
+		const bool isBatched = RenderBatchIsEnabled(&g->batch);
+		LOG(LM_GFX, LL_INFO, "renderer: %s",
+			RendererTypeStr(isBatched ? RENDERER_TEXTURE : RENDERER_SOFTWARE));
+		const SDL_TextureAccess staticAccess =
+			isBatched ? SDL_TEXTUREACCESS_TARGET : SDL_TEXTUREACCESS_STATIC;
+		const SDL_TextureAccess streamingAccess =
+			isBatched ? SDL_TEXTUREACCESS_TARGET : SDL_TEXTUREACCESS_STREAMING;
 		g->bkg = WindowContextCreateTexture(
-			&g->gameWindow, SDL_TEXTUREACCESS_STATIC, svec2i(w, h),
+			&g->gameWindow, staticAccess, svec2i(w, h),
 			SDL_BLENDMODE_NONE, 255);
 		if (g->bkg == NULL)
 		{
@@ -298,7 +350,7 @@ void GraphicsInitialize(GraphicsDevice *g)
 		if (g->cachedConfig.SecondWindow)
 		{
 			g->bkg2 = WindowContextCreateTexture(
-				&g->secondWindow, SDL_TEXTUREACCESS_STATIC, svec2i(w, h),
+				&g->secondWindow, staticAccess, svec2i(w, h),
 				SDL_BLENDMODE_NONE, 255);
 			if (g->bkg2 == NULL)
 			{
@@ -307,7 +359,7 @@ void GraphicsInitialize(GraphicsDevice *g)
 		}
 
 		g->screen = WindowContextCreateTexture(
-			&g->gameWindow, SDL_TEXTUREACCESS_STREAMING, svec2i(w, h),
+			&g->gameWindow, streamingAccess, svec2i(w, h),
 			SDL_BLENDMODE_BLEND, 255);
 		if (g->screen == NULL)
 		{
@@ -315,7 +367,7 @@ void GraphicsInitialize(GraphicsDevice *g)
 		}
 
 		g->hud = WindowContextCreateTexture(
-			&g->gameWindow, SDL_TEXTUREACCESS_STREAMING, svec2i(w, h),
+			&g->gameWindow, streamingAccess, svec2i(w, h),
 			SDL_BLENDMODE_BLEND, 255);
 		if (g->hud == NULL)
 		{
@@ -327,7 +379,7 @@ void GraphicsInitialize(GraphicsDevice *g)
 		if (g->cachedConfig.SecondWindow)
 		{
 			g->hud2 = WindowContextCreateTexture(
-				&g->secondWindow, SDL_TEXTUREACCESS_STREAMING, svec2i(w, h),
+				&g->secondWindow, streamingAccess, svec2i(w, h),
 				SDL_BLENDMODE_BLEND, 255);
 			if (g->hud2 == NULL)
 			{
@@ -350,13 +402,16 @@ void GraphicsInitialize(GraphicsDevice *g)
 		const Uint8 alpha =
 			(Uint8)(brightness > 0 ? brightness : -brightness) * 13;
 		g->brightnessOverlay = WindowContextCreateTexture(
-			&g->gameWindow, SDL_TEXTUREACCESS_STATIC, svec2i(w, h),
-			SDL_BLENDMODE_BLEND, alpha);
+			&g->gameWindow,
+			RenderBatchIsEnabled(&g->batch) ?
+			SDL_TEXTUREACCESS_TARGET : SDL_TEXTUREACCESS_STATIC,
+			svec2i(w, h), SDL_BLENDMODE_BLEND, alpha);
 		if (g->brightnessOverlay == NULL)
 		{
 			return;
 		}
 		const color_t overlayColour = brightness > 0 ? colorWhite : colorBlack;
+		BlitClearBuf(g);
 		DrawRectangle(g, svec2i_zero(), g->cachedConfig.Res, overlayColour, 0);
 		BlitUpdateFromBuf(g, g->brightnessOverlay);
 		g->cachedConfig.Brightness = brightness;
@@ -372,6 +427,7 @@ void GraphicsTerminate(GraphicsDevice *g)
 {
 	CArrayTerminate(&g->validModes);
 	SDL_FreeSurface(g->icon);
+	RenderBatchTerminate(&g->batch);
 	WindowContextDestroy(&g->gameWindow);
 	WindowContextDestroy(&g->secondWindow);
 	SDL_FreeFormat(g->Format);
@@ -425,6 +481,13 @@ void GraphicsConfigSetFromConfig(GraphicsConfig *gc, Config *c)
 		(ScaleMode)ConfigGetEnum(c, "Graphics.ScaleMode"),
 		ConfigGetInt(c, "Graphics.Brightness"),
 		ConfigGetBool(c, "Graphics.SecondWindow"));
+	const RendererType renderer =
+		(RendererType)ConfigGetEnum(c, "Graphics.Renderer");
+	if (gc->Renderer != renderer)
+	{
+		gc->Renderer = renderer;
+		gc->RestartFlags |= RESTART_RESOLUTION;
+	}
 }
 
 char *GrafxGetModeStr(void)
@@ -55,6 +55,7 @@
 #include "c_array.h"
 #include "color.h"
 #include "config.h"
+#include "render_batch.h"
 #include "sys_specifics.h"
 #include "window_context.h"
 
@@ -72,6 +73,9 @@ typedef struct
 	int Brightness;
 	bool SecondWindow;
 	bool IsEditor;
+	RendererType Renderer;
+	// No window, renderer or textures; for dedicated servers
+	bool IsHeadless;
 
 	int RestartFlags;
 } GraphicsConfig;
@@ -103,6 +107,8 @@ typedef struct
 	SDL_Texture *bkg;
 	SDL_Texture *bkg2;
 	SDL_Texture *brightnessOverlay;
+	// Texture renderer; disabled when using the software renderer
+	RenderBatch batch;
 } GraphicsDevice;
 
 extern GraphicsDevice gGraphicsDevice;
@@ -97,7 +97,7 @@ static void DrawBackground(
 
 void GrafxRedrawBackground(GraphicsDevice *g, const struct vec2 pos)
 {
-	memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
+	BlitClearBuf(g);
 	DrawBuffer buffer;
 	DrawBufferInit(&buffer, svec2i(X_TILES, Y_TILES), g);
 	const HSV tint = {
@@ -31,8 +31,10 @@
 #include "ai_utils.h"
 #include "damage.h"
 #include "events.h"
+#include "flow_field.h"
 #include "game_events.h"
 #include "joystick.h"
+#include "los.h"
 #include "net_server.h"
 #include "objs.h"
 #include "particle.h"
@@ -89,6 +91,15 @@ static void HandleGameEvent(
 			for (int i = 0; i <= e.u.TileSet.RunLength; i++)
 			{
 				Tile *t = MapGetTile(&gMap, pos);
+				if ((t->flags ^ e.u.TileSet.Flags) & MAPTILE_NO_SEE)
+				{
+					LOSInvalidate(&gMap.LOS, pos);
+				}
+				if ((t->flags ^ e.u.TileSet.Flags) &
+					(MAPTILE_NO_WALK | MAPTILE_OFFSET_PIC))
+				{
+					PathCacheInvalidateTile(&gPathCache, pos);
+				}
 				t->flags = e.u.TileSet.Flags;
 				t->pic = PicManagerGetNamedPic(
 					&gPicManager, e.u.TileSet.PicName);
@@ -198,7 +209,8 @@ static void HandleGameEvent(
 	case GAME_EVENT_ACTOR_DIR:
 		{
 			TActor *a = ActorGetByUID(e.u.ActorDir.UID);
-			if (!a->isInUse) break;
+			// Unreliable; may arrive before the actor is added
+			if (a == NULL || !a->isInUse) break;
 			a->direction = (direction_e)e.u.ActorDir.Dir;
 		}
 		break;
@@ -218,7 +230,8 @@ static void HandleGameEvent(
 	case GAME_EVENT_ACTOR_IMPULSE:
 		{
 			TActor *a = ActorGetByUID(e.u.ActorImpulse.UID);
-			if (!a->isInUse) break;
+			// Unreliable; may arrive before the actor is added
+			if (a == NULL || !a->isInUse) break;
 			a->tileItem.Vel =
 				svec2_add(a->tileItem.Vel, NetToVec2(e.u.ActorImpulse.Vel));
 			const struct vec2 pos = NetToVec2(e.u.ActorImpulse.Pos);
@@ -639,7 +652,9 @@ static void HandleGameEvent(
 			}
 
 			// Clear cache since we may now have new paths
+			PathCacheInvalidateDoors(&gPathCache);
 			PathCacheClear(&gPathCache);
+			FlowFieldsClear(&gFlowFields);
 		}
 		break;
 	case GAME_EVENT_MISSION_COMPLETE:
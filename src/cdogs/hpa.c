@@ -0,0 +1,608 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "hpa.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "utils.h"
+
+// Runs of entrance tiles at least this long get a node at each end,
+// instead of one in the middle
+#define HPA_ENTRANCE_SPLIT 6
+
+typedef struct
+{
+	float Rank;
+	float Cost;
+	int Node;
+} HPAOpenNode;
+
+// Up, right, down, left
+static const struct vec2i dirs[4] =
+{
+	{ 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 }
+};
+
+
+void HPAGraphInit(
+	HPAGraph *g, const struct vec2i size, const ASGridSource *source,
+	void *context)
+{
+	memset(g, 0, sizeof *g);
+	g->Size = size;
+	g->ClustersSize = svec2i(
+		(size.x + HPA_CLUSTER_SIZE - 1) / HPA_CLUSTER_SIZE,
+		(size.y + HPA_CLUSTER_SIZE - 1) / HPA_CLUSTER_SIZE);
+	g->Source = *source;
+	g->context = context;
+	CArrayInit(&g->Clusters, sizeof(HPACluster));
+	struct vec2i v;
+	for (v.y = 0; v.y < g->ClustersSize.y; v.y++)
+	{
+		for (v.x = 0; v.x < g->ClustersSize.x; v.x++)
+		{
+			HPACluster c;
+			memset(&c, 0, sizeof c);
+			c.Origin = svec2i_scale(v, HPA_CLUSTER_SIZE);
+			c.Size = svec2i(
+				MIN(HPA_CLUSTER_SIZE, size.x - c.Origin.x),
+				MIN(HPA_CLUSTER_SIZE, size.y - c.Origin.y));
+			c.Dirty = true;
+			CArrayInit(&c.Entrances, sizeof(struct vec2i));
+			CArrayInit(&c.Costs, sizeof(float));
+			CArrayPushBack(&g->Clusters, &c);
+		}
+	}
+	CArrayInit(&g->Nodes, sizeof(HPANode));
+	g->NodesDirty = true;
+	g->ClusterGrid = ASGridCreate(HPA_CLUSTER_SIZE, HPA_CLUSTER_SIZE);
+	CArrayInit(&g->Costs, sizeof(float));
+	CArrayInit(&g->Parents, sizeof(int));
+	CArrayInit(&g->Open, sizeof(HPAOpenNode));
+	CArrayInit(&g->StartCosts, sizeof(float));
+	CArrayInit(&g->GoalCosts, sizeof(float));
+	CArrayInit(&g->PathNodes, sizeof(struct vec2i));
+}
+void HPAGraphTerminate(HPAGraph *g)
+{
+	CA_FOREACH(HPACluster, c, g->Clusters)
+		CArrayTerminate(&c->Entrances);
+		CArrayTerminate(&c->Costs);
+	CA_FOREACH_END()
+	CArrayTerminate(&g->Clusters);
+	CArrayTerminate(&g->Nodes);
+	ASGridDestroy(g->ClusterGrid);
+	CArrayTerminate(&g->Costs);
+	CArrayTerminate(&g->Parents);
+	CArrayTerminate(&g->Open);
+	CArrayTerminate(&g->StartCosts);
+	CArrayTerminate(&g->GoalCosts);
+	CArrayTerminate(&g->PathNodes);
+	memset(g, 0, sizeof *g);
+}
+
+static void MarkClusterDirty(HPAGraph *g, const struct vec2i cluster);
+void HPAGraphInvalidate(HPAGraph *g, const struct vec2i pos)
+{
+	if (pos.x < 0 || pos.x >= g->Size.x || pos.y < 0 || pos.y >= g->Size.y)
+	{
+		return;
+	}
+	const struct vec2i cluster = svec2i(
+		pos.x / HPA_CLUSTER_SIZE, pos.y / HPA_CLUSTER_SIZE);
+	MarkClusterDirty(g, cluster);
+	// The entrances on a border depend on the tiles on both sides of it
+	const struct vec2i inCluster = svec2i(
+		pos.x % HPA_CLUSTER_SIZE, pos.y % HPA_CLUSTER_SIZE);
+	if (inCluster.x == 0)
+	{
+		MarkClusterDirty(g, svec2i(cluster.x - 1, cluster.y));
+	}
+	if (inCluster.x == HPA_CLUSTER_SIZE - 1)
+	{
+		MarkClusterDirty(g, svec2i(cluster.x + 1, cluster.y));
+	}
+	if (inCluster.y == 0)
+	{
+		MarkClusterDirty(g, svec2i(cluster.x, cluster.y - 1));
+	}
+	if (inCluster.y == HPA_CLUSTER_SIZE - 1)
+	{
+		MarkClusterDirty(g, svec2i(cluster.x, cluster.y + 1));
+	}
+}
+static void MarkClusterDirty(HPAGraph *g, const struct vec2i cluster)
+{
+	if (cluster.x < 0 || cluster.x >= g->ClustersSize.x ||
+		cluster.y < 0 || cluster.y >= g->ClustersSize.y)
+	{
+		return;
+	}
+	HPACluster *c = CArrayGet(
+		&g->Clusters, cluster.y * g->ClustersSize.x + cluster.x);
+	c->Dirty = true;
+}
+void HPAGraphInvalidateAll(HPAGraph *g)
+{
+	CA_FOREACH(HPACluster, c, g->Clusters)
+		c->Dirty = true;
+	CA_FOREACH_END()
+}
+
+static bool IsWalkable(const HPAGraph *g, const struct vec2i pos)
+{
+	if (pos.x < 0 || pos.x >= g->Size.x || pos.y < 0 || pos.y >= g->Size.y)
+	{
+		return false;
+	}
+	return g->Source.isWalkable(pos.x, pos.y, g->context);
+}
+static int GetClusterIndex(const HPAGraph *g, const struct vec2i pos)
+{
+	return (pos.y / HPA_CLUSTER_SIZE) * g->ClustersSize.x +
+		pos.x / HPA_CLUSTER_SIZE;
+}
+
+typedef struct
+{
+	const HPAGraph *Graph;
+	const HPACluster *Cluster;
+} ClusterSearch;
+static int IsWalkableInCluster(int x, int y, void *context)
+{
+	const ClusterSearch *cs = context;
+	if (x >= cs->Cluster->Size.x || y >= cs->Cluster->Size.y)
+	{
+		return 0;
+	}
+	return IsWalkable(
+		cs->Graph, svec2i_add(cs->Cluster->Origin, svec2i(x, y)));
+}
+// Find a path that stays within a cluster; its nodes are relative to the
+// cluster's origin
+static ASPath ClusterPathCreate(
+	HPAGraph *g, const HPACluster *c, const struct vec2i from,
+	const struct vec2i to)
+{
+	ClusterSearch cs = { g, c };
+	ASGridSource source = g->Source;
+	source.isWalkable = IsWalkableInCluster;
+	const struct vec2i f = svec2i_subtract(from, c->Origin);
+	const struct vec2i t = svec2i_subtract(to, c->Origin);
+	return ASGridPathCreate(g->ClusterGrid, &source, &cs, f.x, f.y, t.x, t.y);
+}
+// Find the costs from a tile to the rest of its cluster, staying within it
+static void ClusterSearchAll(
+	HPAGraph *g, const HPACluster *c, const struct vec2i from)
+{
+	ClusterSearch cs = { g, c };
+	ASGridSource source = g->Source;
+	source.isWalkable = IsWalkableInCluster;
+	const struct vec2i f = svec2i_subtract(from, c->Origin);
+	ASGridSearchAll(g->ClusterGrid, &source, &cs, f.x, f.y);
+}
+// Cost to a tile from the last ClusterSearchAll, or -1 if unreachable
+static float ClusterGetCost(
+	const HPAGraph *g, const HPACluster *c, const struct vec2i pos)
+{
+	const struct vec2i p = svec2i_subtract(pos, c->Origin);
+	return ASGridGetCost(g->ClusterGrid, p.x, p.y);
+}
+
+static void AddBorderEntrances(
+	HPAGraph *g, HPACluster *c, const struct vec2i start,
+	const struct vec2i step, const struct vec2i across, const int length);
+static void BuildCluster(HPAGraph *g, HPACluster *c)
+{
+	CArrayClear(&c->Entrances);
+	const struct vec2i bottomLeft = svec2i(
+		c->Origin.x, c->Origin.y + c->Size.y - 1);
+	const struct vec2i topRight = svec2i(
+		c->Origin.x + c->Size.x - 1, c->Origin.y);
+	AddBorderEntrances(
+		g, c, c->Origin, svec2i(1, 0), svec2i(0, -1), c->Size.x);
+	AddBorderEntrances(
+		g, c, bottomLeft, svec2i(1, 0), svec2i(0, 1), c->Size.x);
+	AddBorderEntrances(
+		g, c, c->Origin, svec2i(0, 1), svec2i(-1, 0), c->Size.y);
+	AddBorderEntrances(
+		g, c, topRight, svec2i(0, 1), svec2i(1, 0), c->Size.y);
+
+	// Find the costs between each pair of entrances
+	const int n = (int)c->Entrances.size;
+	const float none = -1;
+	CArrayClear(&c->Costs);
+	CArrayResize(&c->Costs, n * n, &none);
+	float *costs = c->Costs.data;
+	const struct vec2i *entrances = c->Entrances.data;
+	for (int i = 0; i < n; i++)
+	{
+		ClusterSearchAll(g, c, entrances[i]);
+		for (int j = 0; j < n; j++)
+		{
+			costs[i * n + j] = ClusterGetCost(g, c, entrances[j]);
+		}
+	}
+}
+static void AddEntrance(HPACluster *c, const struct vec2i pos);
+static void AddBorderEntrances(
+	HPAGraph *g, HPACluster *c, const struct vec2i start,
+	const struct vec2i step, const struct vec2i across, const int length)
+{
+	// Both clusters scan the border the same way, so they pick entrances
+	// at the same places
+	int runStart = -1;
+	for (int i = 0; i <= length; i++)
+	{
+		const struct vec2i pos = svec2i_add(start, svec2i_scale(step, i));
+		const bool isOpen = i < length && IsWalkable(g, pos) &&
+			IsWalkable(g, svec2i_add(pos, across));
+		if (isOpen && runStart < 0)
+		{
+			runStart = i;
+		}
+		else if (!isOpen && runStart >= 0)
+		{
+			const int runLength = i - runStart;
+			if (runLength < HPA_ENTRANCE_SPLIT)
+			{
+				const int mid = runStart + runLength / 2;
+				AddEntrance(c, svec2i_add(start, svec2i_scale(step, mid)));
+			}
+			else
+			{
+				AddEntrance(
+					c, svec2i_add(start, svec2i_scale(step, runStart)));
+				AddEntrance(c, svec2i_add(start, svec2i_scale(step, i - 1)));
+			}
+			runStart = -1;
+		}
+	}
+}
+static void AddEntrance(HPACluster *c, const struct vec2i pos)
+{
+	// Corner tiles can be entrances on two borders
+	CA_FOREACH(const struct vec2i, e, c->Entrances)
+		if (svec2i_is_equal(*e, pos)) return;
+	CA_FOREACH_END()
+	CArrayPushBack(&c->Entrances, &pos);
+}
+
+static int FindNode(const HPAGraph *g, const struct vec2i pos);
+static void Update(HPAGraph *g)
+{
+	CA_FOREACH(HPACluster, c, g->Clusters)
+		if (!c->Dirty) continue;
+		BuildCluster(g, c);
+		c->Dirty = false;
+		g->NodesDirty = true;
+	CA_FOREACH_END()
+	if (!g->NodesDirty) return;
+
+	// Number the entrances, then link them across the borders
+	CArrayClear(&g->Nodes);
+	CA_FOREACH(HPACluster, c, g->Clusters)
+		c->NodeStart = (int)g->Nodes.size;
+		const int cluster = _ca_index;
+		for (int j = 0; j < (int)c->Entrances.size; j++)
+		{
+			HPANode n;
+			n.Pos = *(const struct vec2i *)CArrayGet(&c->Entrances, j);
+			n.Cluster = cluster;
+			for (int i = 0; i < 4; i++)
+			{
+				n.Links[i] = -1;
+			}
+			CArrayPushBack(&g->Nodes, &n);
+		}
+	CA_FOREACH_END()
+	CA_FOREACH(HPANode, n, g->Nodes)
+		for (int i = 0; i < 4; i++)
+		{
+			const struct vec2i across = svec2i_add(n->Pos, dirs[i]);
+			if (across.x < 0 || across.x >= g->Size.x ||
+				across.y < 0 || across.y >= g->Size.y ||
+				GetClusterIndex(g, across) == n->Cluster)
+			{
+				continue;
+			}
+			n->Links[i] = FindNode(g, across);
+		}
+	CA_FOREACH_END()
+	g->NodesDirty = false;
+}
+static int FindNode(const HPAGraph *g, const struct vec2i pos)
+{
+	const HPACluster *c = CArrayGet(&g->Clusters, GetClusterIndex(g, pos));
+	CA_FOREACH(const struct vec2i, e, c->Entrances)
+		if (svec2i_is_equal(*e, pos)) return c->NodeStart + _ca_index;
+	CA_FOREACH_END()
+	return -1;
+}
+
+typedef struct
+{
+	HPAGraph *Graph;
+	int StartNode;
+	int GoalNode;
+	struct vec2i From;
+	struct vec2i To;
+	int StartCluster;
+	int GoalCluster;
+	float DirectCost;
+} HPASearch;
+static bool Search(HPASearch *s);
+static ASPath Refine(HPASearch *s);
+ASPath HPAPathCreate(
+	HPAGraph *g, const struct vec2i from, const struct vec2i to)
+{
+	if (from.x < 0 || from.x >= g->Size.x || from.y < 0 ||
+		from.y >= g->Size.y || to.x < 0 || to.x >= g->Size.x ||
+		to.y < 0 || to.y >= g->Size.y)
+	{
+		return NULL;
+	}
+	if (svec2i_is_equal(from, to))
+	{
+		return ASPathCreateFromNodes(&from, sizeof from, 1, 0);
+	}
+	Update(g);
+
+	// Connect the start and goal to the entrances of their clusters, and
+	// to each other if they share one
+	HPASearch s;
+	s.Graph = g;
+	s.StartNode = (int)g->Nodes.size;
+	s.GoalNode = s.StartNode + 1;
+	s.From = from;
+	s.To = to;
+	s.StartCluster = GetClusterIndex(g, from);
+	s.GoalCluster = GetClusterIndex(g, to);
+	const HPACluster *sc = CArrayGet(&g->Clusters, s.StartCluster);
+	const HPACluster *gc = CArrayGet(&g->Clusters, s.GoalCluster);
+	// Costs are the same both ways, so search out from both
+	ClusterSearchAll(g, sc, from);
+	CArrayClear(&g->StartCosts);
+	CA_FOREACH(const struct vec2i, e, sc->Entrances)
+		const float cost = ClusterGetCost(g, sc, *e);
+		CArrayPushBack(&g->StartCosts, &cost);
+	CA_FOREACH_END()
+	s.DirectCost = s.StartCluster == s.GoalCluster ?
+		ClusterGetCost(g, sc, to) : -1;
+	ClusterSearchAll(g, gc, to);
+	CArrayClear(&g->GoalCosts);
+	CA_FOREACH(const struct vec2i, e, gc->Entrances)
+		const float cost = ClusterGetCost(g, gc, *e);
+		CArrayPushBack(&g->GoalCosts, &cost);
+	CA_FOREACH_END()
+
+	if (!Search(&s))
+	{
+		return NULL;
+	}
+	return Refine(&s);
+}
+
+static struct vec2i GetNodePos(const HPASearch *s, const int node)
+{
+	if (node == s->StartNode) return s->From;
+	if (node == s->GoalNode) return s->To;
+	return ((const HPANode *)CArrayGet(&s->Graph->Nodes, node))->Pos;
+}
+static float Heuristic(const HPASearch *s, const struct vec2i pos)
+{
+	// Same as the grid search; never overestimates
+	const ASGridSource *src = &s->Graph->Source;
+	const float minCost =
+		MIN(MIN(src->costX, src->costY), src->costDiagonal);
+	const int dx = abs(pos.x - s->To.x);
+	const int dy = abs(pos.y - s->To.y);
+	return minCost * (float)MAX(dx, dy);
+}
+static void PushOpen(CArray *open, const HPAOpenNode n);
+static HPAOpenNode PopOpen(CArray *open);
+static void Relax(
+	HPASearch *s, const int from, const int to, const float edgeCost);
+// A* over the entrances, plus the start and goal
+static bool Search(HPASearch *s)
+{
+	HPAGraph *g = s->Graph;
+	const float inf = INFINITY;
+	const int noParent = -1;
+	CArrayClear(&g->Costs);
+	CArrayResize(&g->Costs, g->Nodes.size + 2, &inf);
+	CArrayClear(&g->Parents);
+	CArrayResize(&g->Parents, g->Nodes.size + 2, &noParent);
+	CArrayClear(&g->Open);
+	float *costs = g->Costs.data;
+	costs[s->StartNode] = 0;
+	const HPAOpenNode start =
+	{
+		Heuristic(s, s->From), 0, s->StartNode
+	};
+	PushOpen(&g->Open, start);
+	while (g->Open.size > 0)
+	{
+		const HPAOpenNode current = PopOpen(&g->Open);
+		// Skip stale entries; nodes are pushed again when their cost drops
+		if (current.Cost > costs[current.Node]) continue;
+		if (current.Node == s->GoalNode) return true;
+
+		if (current.Node == s->StartNode)
+		{
+			const HPACluster *c = CArrayGet(&g->Clusters, s->StartCluster);
+			CA_FOREACH(const float, cost, g->StartCosts)
+				Relax(s, current.Node, c->NodeStart + _ca_index, *cost);
+			CA_FOREACH_END()
+			Relax(s, current.Node, s->GoalNode, s->DirectCost);
+			continue;
+		}
+
+		const HPANode *n = CArrayGet(&g->Nodes, current.Node);
+		const HPACluster *c = CArrayGet(&g->Clusters, n->Cluster);
+		const int numEntrances = (int)c->Entrances.size;
+		const int idx = current.Node - c->NodeStart;
+		const float *clusterCosts = c->Costs.data;
+		for (int i = 0; i < numEntrances; i++)
+		{
+			if (i == idx) continue;
+			Relax(
+				s, current.Node, c->NodeStart + i,
+				clusterCosts[idx * numEntrances + i]);
+		}
+		for (int i = 0; i < 4; i++)
+		{
+			if (n->Links[i] < 0) continue;
+			Relax(
+				s, current.Node, n->Links[i],
+				dirs[i].x != 0 ? g->Source.costX : g->Source.costY);
+		}
+		if (n->Cluster == s->GoalCluster)
+		{
+			Relax(
+				s, current.Node, s->GoalNode,
+				*(const float *)CArrayGet(&g->GoalCosts, idx));
+		}
+	}
+	return false;
+}
+static void Relax(
+	HPASearch *s, const int from, const int to, const float edgeCost)
+{
+	if (edgeCost < 0) return;
+	HPAGraph *g = s->Graph;
+	float *costs = g->Costs.data;
+	const float cost = costs[from] + edgeCost;
+	if (cost >= costs[to]) return;
+	costs[to] = cost;
+	*(int *)CArrayGet(&g->Parents, to) = from;
+	const HPAOpenNode n =
+	{
+		cost + Heuristic(s, GetNodePos(s, to)), cost, to
+	};
+	PushOpen(&g->Open, n);
+}
+static void PushOpen(CArray *open, const HPAOpenNode n)
+{
+	CArrayPushBack(open, &n);
+	HPAOpenNode *nodes = open->data;
+	size_t i = open->size - 1;
+	while (i > 0)
+	{
+		const size_t parent = (i - 1) / 2;
+		if (nodes[parent].Rank <= nodes[i].Rank) break;
+		const HPAOpenNode tmp = nodes[parent];
+		nodes[parent] = nodes[i];
+		nodes[i] = tmp;
+		i = parent;
+	}
+}
+static HPAOpenNode PopOpen(CArray *open)
+{
+	HPAOpenNode *nodes = open->data;
+	const HPAOpenNode top = nodes[0];
+	nodes[0] = nodes[open->size - 1];
+	CArrayDelete(open, open->size - 1);
+	size_t i = 0;
+	for (;;)
+	{
+		const size_t left = 2 * i + 1;
+		const size_t right = 2 * i + 2;
+		size_t smallest = i;
+		if (left < open->size && nodes[left].Rank < nodes[smallest].Rank)
+		{
+			smallest = left;
+		}
+		if (right < open->size && nodes[right].Rank < nodes[smallest].Rank)
+		{
+			smallest = right;
+		}
+		if (smallest == i) break;
+		const HPAOpenNode tmp = nodes[smallest];
+		nodes[smallest] = nodes[i];
+		nodes[i] = tmp;
+		i = smallest;
+	}
+	return top;
+}
+
+// Join up the paths between the nodes that were found
+static bool AppendClusterPath(
+	HPAGraph *g, const HPACluster *c, const struct vec2i from,
+	const struct vec2i to);
+static ASPath Refine(HPASearch *s)
+{
+	HPAGraph *g = s->Graph;
+	// Walk back from the goal; reuse the open set as the list of nodes
+	CArrayClear(&g->Open);
+	for (int node = s->GoalNode; node >= 0;
+		node = *(const int *)CArrayGet(&g->Parents, node))
+	{
+		const HPAOpenNode n = { 0, 0, node };
+		CArrayPushBack(&g->Open, &n);
+	}
+	CArrayClear(&g->PathNodes);
+	CArrayPushBack(&g->PathNodes, &s->From);
+	for (int i = (int)g->Open.size - 1; i > 0; i--)
+	{
+		const int a = ((const HPAOpenNode *)CArrayGet(&g->Open, i))->Node;
+		const int b = ((const HPAOpenNode *)CArrayGet(&g->Open, i - 1))->Node;
+		const struct vec2i posA = GetNodePos(s, a);
+		const struct vec2i posB = GetNodePos(s, b);
+		const int cluster = GetClusterIndex(g, posA);
+		if (cluster != GetClusterIndex(g, posB))
+		{
+			// Link across a border
+			CArrayPushBack(&g->PathNodes, &posB);
+		}
+		else if (!AppendClusterPath(
+			g, CArrayGet(&g->Clusters, cluster), posA, posB))
+		{
+			return NULL;
+		}
+	}
+	return ASPathCreateFromNodes(
+		g->PathNodes.data, sizeof(struct vec2i), g->PathNodes.size,
+		*(const float *)CArrayGet(&g->Costs, s->GoalNode));
+}
+static bool AppendClusterPath(
+	HPAGraph *g, const HPACluster *c, const struct vec2i from,
+	const struct vec2i to)
+{
+	ASPath path = ClusterPathCreate(g, c, from, to);
+	if (path == NULL) return false;
+	// Skip the first node; it's the end of the path so far
+	for (size_t i = 1; i < ASPathGetCount(path); i++)
+	{
+		const int *node = ASPathGetNode(path, i);
+		const struct vec2i pos =
+			svec2i_add(c->Origin, svec2i(node[0], node[1]));
+		CArrayPushBack(&g->PathNodes, &pos);
+	}
+	ASPathDestroy(path);
+	return true;
+}
@@ -0,0 +1,96 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "AStar.h"
+#include "c_array.h"
+#include "vector.h"
+
+// Hierarchical pathfinding (HPA*)
+// The map is split into square clusters. Wherever a run of walkable tiles
+// crosses the border between two clusters, there is an entrance: a node on
+// each side, linked to each other. The costs between the nodes of each
+// cluster are precalculated, which makes a small abstract graph.
+// Long paths are found by searching the abstract graph, then joining short
+// paths within each cluster along the way. Paths are near-optimal.
+// When tiles change, only the clusters around them are rebuilt, the next
+// time a path is found.
+
+#define HPA_CLUSTER_SIZE 16
+
+typedef struct
+{
+	struct vec2i Origin;
+	struct vec2i Size;
+	bool Dirty;
+	CArray Entrances;	// of struct vec2i, tiles of this cluster's nodes
+	CArray Costs;	// of float, between each pair of entrances; < 0 if none
+	int NodeStart;	// index of the first entrance's node
+} HPACluster;
+
+typedef struct
+{
+	struct vec2i Pos;
+	int Cluster;
+	int Links[4];	// linked node across each border (up, right, down, left)
+} HPANode;
+
+typedef struct
+{
+	struct vec2i Size;
+	struct vec2i ClustersSize;
+	ASGridSource Source;
+	void *context;
+	CArray Clusters;	// of HPACluster
+	CArray Nodes;	// of HPANode
+	bool NodesDirty;
+	ASGrid ClusterGrid;	// for searches within a cluster
+	// Scratch for abstract graph searches
+	CArray Costs;	// of float, by node
+	CArray Parents;	// of int, by node
+	CArray Open;	// binary heap of HPAOpenNode
+	CArray StartCosts;	// of float, from the start to its cluster's entrances
+	CArray GoalCosts;	// of float, from the goal's cluster's entrances
+	CArray PathNodes;	// of struct vec2i
+} HPAGraph;
+
+// Tiles are checked using source, which is passed context
+void HPAGraphInit(
+	HPAGraph *g, const struct vec2i size, const ASGridSource *source,
+	void *context);
+void HPAGraphTerminate(HPAGraph *g);
+
+// Mark the clusters affected by a tile changing for rebuilding
+void HPAGraphInvalidate(HPAGraph *g, const struct vec2i pos);
+// Mark every cluster for rebuilding
+void HPAGraphInvalidateAll(HPAGraph *g);
+
+// Find a path, with nodes like struct vec2i
+// Returns NULL if there isn't one
+ASPath HPAPathCreate(
+	HPAGraph *g, const struct vec2i from, const struct vec2i to);
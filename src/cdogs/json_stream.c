@@ -0,0 +1,415 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "json_stream.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "log.h"
+#include "utils.h"
+#include "yajl/api/yajl_parse.h"
+
+// Size of chunks read from files
+#define JSON_STREAM_READ_SIZE 16384
+
+
+void JSONStreamInit(JSONStream *s)
+{
+	memset(s, 0, sizeof *s);
+	CArrayInit(&s->arrays, sizeof(JSONStreamArray));
+	CArrayInit(&s->values, sizeof(JSONStreamValue));
+	CArrayInit(&s->buf, sizeof(char));
+}
+void JSONStreamTerminate(JSONStream *s)
+{
+	CA_FOREACH(JSONStreamArray, a, s->arrays)
+		CFREE(a->Key);
+	CA_FOREACH_END()
+	CArrayTerminate(&s->arrays);
+	CA_FOREACH(JSONStreamValue, v, s->values)
+		CFREE(v->Key);
+	CA_FOREACH_END()
+	CArrayTerminate(&s->values);
+	CArrayTerminate(&s->buf);
+	json_free_value(&s->root);
+	json_free_value(&s->elem);
+	CFREE(s->key);
+	memset(s, 0, sizeof *s);
+}
+
+void JSONStreamAddArray(
+	JSONStream *s, const char *key, JSONStreamElementFunc func, void *data)
+{
+	JSONStreamArray a;
+	CSTRDUP(a.Key, key);
+	a.Func = func;
+	a.Data = data;
+	CArrayPushBack(&s->arrays, &a);
+}
+void JSONStreamAddValue(
+	JSONStream *s, const char *key, JSONStreamValueFunc func, void *data)
+{
+	JSONStreamValue v;
+	CSTRDUP(v.Key, key);
+	v.Func = func;
+	v.Data = data;
+	CArrayPushBack(&s->values, &v);
+}
+
+static yajl_handle StreamAlloc(JSONStream *s);
+static bool StreamEnd(JSONStream *s, yajl_handle h, const char *name);
+bool JSONStreamParseFile(JSONStream *s, const char *filename)
+{
+	bool res = false;
+	yajl_handle h = NULL;
+	FILE *f = fopen(filename, "rb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_DEBUG, "cannot open JSON file %s", filename);
+		goto bail;
+	}
+	h = StreamAlloc(s);
+	unsigned char buf[JSON_STREAM_READ_SIZE];
+	for (;;)
+	{
+		const size_t read = fread(buf, 1, sizeof buf, f);
+		if (read == 0)
+		{
+			break;
+		}
+		if (yajl_parse(h, buf, read) != yajl_status_ok)
+		{
+			break;
+		}
+	}
+	if (ferror(f))
+	{
+		LOG(LM_MAIN, LL_ERROR, "error reading JSON file %s", filename);
+		goto bail;
+	}
+	res = StreamEnd(s, h, filename);
+
+bail:
+	if (h != NULL)
+	{
+		yajl_free(h);
+	}
+	if (f != NULL)
+	{
+		fclose(f);
+	}
+	return res;
+}
+bool JSONStreamParse(JSONStream *s, const char *buf, const size_t len)
+{
+	yajl_handle h = StreamAlloc(s);
+	yajl_parse(h, (const unsigned char *)buf, len);
+	const bool res = StreamEnd(s, h, "buffer");
+	yajl_free(h);
+	return res;
+}
+
+static int OnNull(void *ctx);
+static int OnBoolean(void *ctx, int b);
+static int OnNumber(void *ctx, const char *n, size_t len);
+static int OnString(void *ctx, const unsigned char *str, size_t len);
+static int OnStartMap(void *ctx);
+static int OnMapKey(void *ctx, const unsigned char *key, size_t len);
+static int OnEndMap(void *ctx);
+static int OnStartArray(void *ctx);
+static int OnEndArray(void *ctx);
+static const yajl_callbacks callbacks = {
+	OnNull, OnBoolean, NULL, NULL, OnNumber, OnString,
+	OnStartMap, OnMapKey, OnEndMap, OnStartArray, OnEndArray
+};
+static yajl_handle StreamAlloc(JSONStream *s)
+{
+	json_free_value(&s->root);
+	json_free_value(&s->elem);
+	CFREE(s->key);
+	s->key = NULL;
+	s->cur = NULL;
+	s->array = NULL;
+	s->value = NULL;
+	s->valueDepth = 0;
+	s->isStopped = false;
+	return yajl_alloc(&callbacks, NULL, s);
+}
+static bool StreamEnd(JSONStream *s, yajl_handle h, const char *name)
+{
+	if (s->isStopped)
+	{
+		return false;
+	}
+	if (yajl_complete_parse(h) != yajl_status_ok)
+	{
+		unsigned char *err = yajl_get_error(h, 0, NULL, 0);
+		LOG(LM_MAIN, LL_ERROR, "error parsing JSON %s: %s", name, err);
+		yajl_free_error(h, err);
+		return false;
+	}
+	return s->root != NULL;
+}
+
+// Returns whether the current value is consumed by a value handler
+static bool HandleValue(
+	JSONStream *s, const char *text, const size_t len, const int depth)
+{
+	if (s->value == NULL)
+	{
+		return false;
+	}
+	if (text != NULL)
+	{
+		s->value->Func(text, len, s->value->Data);
+	}
+	s->valueDepth += depth;
+	if (s->valueDepth == 0)
+	{
+		s->value = NULL;
+	}
+	return true;
+}
+
+static bool EndElement(JSONStream *s);
+static int AddNode(JSONStream *s, json_t *node, const bool isContainer)
+{
+	if (node == NULL)
+	{
+		return 0;
+	}
+	if (s->cur == NULL)
+	{
+		if (s->array != NULL)
+		{
+			s->elem = node;
+		}
+		else if (s->root == NULL)
+		{
+			s->root = node;
+		}
+		else
+		{
+			json_free_value(&node);
+			return 0;
+		}
+	}
+	else if (s->cur->type == JSON_OBJECT)
+	{
+		if (s->key == NULL ||
+			json_insert_pair_into_object(s->cur, s->key, node) != JSON_OK)
+		{
+			json_free_value(&node);
+			return 0;
+		}
+		CFREE(s->key);
+		s->key = NULL;
+	}
+	else if (json_insert_child(s->cur, node) != JSON_OK)
+	{
+		json_free_value(&node);
+		return 0;
+	}
+	if (isContainer)
+	{
+		s->cur = node;
+	}
+	else if (s->cur == NULL && s->elem == node)
+	{
+		return EndElement(s);
+	}
+	return 1;
+}
+static int EndContainer(JSONStream *s)
+{
+	json_t *done = s->cur;
+	if (done == NULL)
+	{
+		return 0;
+	}
+	s->cur = done->parent;
+	// Values in objects are children of their labels
+	if (s->cur != NULL && s->cur->type == JSON_STRING)
+	{
+		s->cur = s->cur->parent;
+	}
+	if (done == s->elem)
+	{
+		return EndElement(s);
+	}
+	return 1;
+}
+static bool EndElement(JSONStream *s)
+{
+	if (!s->array->Func(s->root, &s->elem, s->array->Data))
+	{
+		s->isStopped = true;
+	}
+	json_free_value(&s->elem);
+	return !s->isStopped;
+}
+
+static int OnNull(void *ctx)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, NULL, 0, 0)) return 1;
+	return AddNode(s, json_new_null(), false);
+}
+static int OnBoolean(void *ctx, int b)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, NULL, 0, 0)) return 1;
+	return AddNode(s, json_new_bool(b), false);
+}
+static const char *BufCopy(JSONStream *s, const char *text, const size_t len);
+static int OnNumber(void *ctx, const char *n, size_t len)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, n, len, 0)) return 1;
+	return AddNode(s, json_new_number(BufCopy(s, n, len)), false);
+}
+static const char *Escape(JSONStream *s, const char *text, const size_t len);
+static int OnString(void *ctx, const unsigned char *str, size_t len)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, (const char *)str, len, 0)) return 1;
+	// Nodes hold escaped text, as if parsed by json.c
+	return AddNode(s, json_new_string(Escape(s, (const char *)str, len)), false);
+}
+static int OnStartMap(void *ctx)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, NULL, 0, 1)) return 1;
+	return AddNode(s, json_new_object(), true);
+}
+static const JSONStreamValue *FindValue(const JSONStream *s, const char *key);
+static int OnMapKey(void *ctx, const unsigned char *key, size_t len)
+{
+	JSONStream *s = ctx;
+	if (s->value != NULL) return 1;
+	const char *k = BufCopy(s, (const char *)key, len);
+	if (s->elem != NULL && s->cur == s->elem)
+	{
+		s->value = FindValue(s, k);
+		if (s->value != NULL)
+		{
+			s->valueDepth = 0;
+			return 1;
+		}
+	}
+	CFREE(s->key);
+	CSTRDUP(s->key, k);
+	return 1;
+}
+static const JSONStreamValue *FindValue(const JSONStream *s, const char *key)
+{
+	CA_FOREACH(const JSONStreamValue, v, s->values)
+		if (strcmp(v->Key, key) == 0) return v;
+	CA_FOREACH_END()
+	return NULL;
+}
+static int OnEndMap(void *ctx)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, NULL, 0, -1)) return 1;
+	return EndContainer(s);
+}
+static const JSONStreamArray *FindArray(const JSONStream *s, const char *key);
+static int OnStartArray(void *ctx)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, NULL, 0, 1)) return 1;
+	// Start streaming top-level arrays
+	if (s->cur != NULL && s->cur == s->root && s->key != NULL)
+	{
+		s->array = FindArray(s, s->key);
+		if (s->array != NULL)
+		{
+			CFREE(s->key);
+			s->key = NULL;
+			s->cur = NULL;
+			return 1;
+		}
+	}
+	return AddNode(s, json_new_array(), true);
+}
+static const JSONStreamArray *FindArray(const JSONStream *s, const char *key)
+{
+	CA_FOREACH(const JSONStreamArray, a, s->arrays)
+		if (strcmp(a->Key, key) == 0) return a;
+	CA_FOREACH_END()
+	return NULL;
+}
+static int OnEndArray(void *ctx)
+{
+	JSONStream *s = ctx;
+	if (HandleValue(s, NULL, 0, -1)) return 1;
+	if (s->cur == NULL && s->array != NULL)
+	{
+		s->array = NULL;
+		s->cur = s->root;
+		return 1;
+	}
+	return EndContainer(s);
+}
+
+static const char *BufCopy(JSONStream *s, const char *text, const size_t len)
+{
+	CArrayResize(&s->buf, len + 1, NULL);
+	memcpy(s->buf.data, text, len);
+	((char *)s->buf.data)[len] = '\0';
+	return s->buf.data;
+}
+static const char *Escape(JSONStream *s, const char *text, const size_t len)
+{
+	CArrayClear(&s->buf);
+	for (size_t i = 0; i < len; i++)
+	{
+		const char c = text[i];
+		if (c == '\\' || c == '"')
+		{
+			const char esc[2] = { '\\', c };
+			CArrayPushBack(&s->buf, &esc[0]);
+			CArrayPushBack(&s->buf, &esc[1]);
+		}
+		else if (c >= 0 && c < 0x20)
+		{
+			char esc[7];
+			sprintf(esc, "\\u%4.4x", c);
+			for (int j = 0; j < 6; j++)
+			{
+				CArrayPushBack(&s->buf, &esc[j]);
+			}
+		}
+		else
+		{
+			CArrayPushBack(&s->buf, &c);
+		}
+	}
+	const char nul = '\0';
+	CArrayPushBack(&s->buf, &nul);
+	return s->buf.data;
+}
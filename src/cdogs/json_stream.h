@@ -0,0 +1,94 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <json/json.h>
+
+#include "c_array.h"
+
+// Streaming JSON loader, using the yajl callback parser.
+// Large data files are mostly one big array of elements (missions, bullets,
+// guns...), so instead of building the whole document tree, elements of
+// the registered top-level arrays are built one at a time, passed to a
+// callback and then freed. Everything else is built into a (small) root
+// tree, which is passed to the callback too; this means that values like
+// "Version" must come before the arrays in the file.
+// Bulky values inside elements, like static map tiles, can be consumed
+// directly by a value handler, without creating any nodes at all.
+
+// Called with each element of a streamed array. The element is freed
+// afterwards, unless the callback takes it by setting *node to NULL.
+// Return false to stop parsing.
+typedef bool (*JSONStreamElementFunc)(json_t *root, json_t **node, void *data);
+// Called with the text of each number or string in a handled value;
+// strings are not null terminated.
+typedef void (*JSONStreamValueFunc)(const char *text, size_t len, void *data);
+
+typedef struct
+{
+	char *Key;
+	JSONStreamElementFunc Func;
+	void *Data;
+} JSONStreamArray;
+typedef struct
+{
+	char *Key;
+	JSONStreamValueFunc Func;
+	void *Data;
+} JSONStreamValue;
+
+typedef struct
+{
+	json_t *root;
+	CArray arrays;	// of JSONStreamArray
+	CArray values;	// of JSONStreamValue
+
+	// Parse state
+	json_t *cur;	// innermost container being built
+	json_t *elem;	// streamed array element being built
+	const JSONStreamArray *array;	// array being streamed
+	const JSONStreamValue *value;	// value being handled
+	int valueDepth;	// nesting of containers within handled value
+	char *key;	// pending object key
+	bool isStopped;
+	CArray buf;	// of char; null-terminated copies of strings
+} JSONStream;
+
+void JSONStreamInit(JSONStream *s);
+void JSONStreamTerminate(JSONStream *s);
+// Pass each element of the top-level array called key to func
+void JSONStreamAddArray(
+	JSONStream *s, const char *key, JSONStreamElementFunc func, void *data);
+// Pass the numbers and strings of the streamed elements' values called
+// key to func, instead of adding them to the elements
+void JSONStreamAddValue(
+	JSONStream *s, const char *key, JSONStreamValueFunc func, void *data);
+// Parse a file in chunks; the parsed root is kept in s->root
+bool JSONStreamParseFile(JSONStream *s, const char *filename);
+bool JSONStreamParse(JSONStream *s, const char *buf, const size_t len);
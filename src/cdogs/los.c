@@ -27,8 +27,11 @@
 */
 #include "los.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "actors.h"
-#include "algorithms.h"
+#include "fov.h"
 #include "game_events.h"
 #include "net_util.h"
 
@@ -37,6 +40,7 @@ void LOSInit(Map *map, const struct vec2i size)
 {
 	CArrayInit(&map->LOS.LOS, sizeof(bool));
 	CArrayInit(&map->LOS.Explored, sizeof(bool));
+	CArrayInit(&map->LOS.ViewLOS, sizeof(bool));
 	struct vec2i v;
 	for (v.y = 0; v.y < size.y; v.y++)
 	{
@@ -45,20 +49,32 @@ void LOSInit(Map *map, const struct vec2i size)
 			const bool f = false;
 			CArrayPushBack(&map->LOS.LOS, &f);
 			CArrayPushBack(&map->LOS.Explored, &f);
+			CArrayPushBack(&map->LOS.ViewLOS, &f);
 		}
 	}
+	CArrayInit(&map->LOS.ExploredTiles, sizeof(int));
+	CArrayInit(&map->LOS.Views, sizeof(LOSView));
+	FOVMapInit(&map->LOS.Obstructions, size);
+	// Tiles are set after this
+	map->LOS.ObstructionsDirty = true;
 }
 void LOSTerminate(LineOfSight *los)
 {
 	CArrayTerminate(&los->LOS);
 	CArrayTerminate(&los->Explored);
+	CArrayTerminate(&los->ExploredTiles);
+	CA_FOREACH(LOSView, v, los->Views)
+		CArrayTerminate(&v->Tiles);
+	CA_FOREACH_END()
+	CArrayTerminate(&los->Views);
+	CArrayTerminate(&los->ViewLOS);
+	FOVMapTerminate(&los->Obstructions);
 }
 
 // Reset lines of sight by setting all cells to unseen
 void LOSReset(LineOfSight *los)
 {
 	CArrayFillZero(&los->LOS);
-	CArrayFillZero(&los->Explored);
 }
 void LOSSetAllVisible(LineOfSight *los)
 {
@@ -67,25 +83,94 @@ void LOSSetAllVisible(LineOfSight *los)
 	CA_FOREACH_END()
 }
 
+static void CalcView(
+	Map *map, LOSView *v, const struct vec2i pos, const int sightRange,
+	const FOVType fov);
+static void ApplyView(Map *map, const LOSView *v, const bool explore);
+void LOSCalcFrom(Map *map, const struct vec2i pos, const bool explore)
+{
+	LOSView v;
+	memset(&v, 0, sizeof v);
+	v.UID = -1;
+	CArrayInit(&v.Tiles, sizeof(int));
+	CalcView(
+		map, &v, pos, ConfigGetInt(&gConfig, "Game.SightRange"),
+		(FOVType)ConfigGetEnum(&gConfig, "Game.FOV"));
+	ApplyView(map, &v, explore);
+	CArrayTerminate(&v.Tiles);
+}
+static LOSView *GetView(LineOfSight *los, const int uid);
+void LOSCalcFromCached(
+	Map *map, const int uid, const struct vec2i pos, const bool explore)
+{
+	LOSView *v = GetView(&map->LOS, uid);
+	const int sightRange = ConfigGetInt(&gConfig, "Game.SightRange");
+	const FOVType fov = (FOVType)ConfigGetEnum(&gConfig, "Game.FOV");
+	if (v->Dirty || !svec2i_is_equal(v->Pos, pos) ||
+		v->SightRange != sightRange || v->FOV != fov)
+	{
+		CalcView(map, v, pos, sightRange, fov);
+	}
+	ApplyView(map, v, explore);
+}
+static LOSView *GetView(LineOfSight *los, const int uid)
+{
+	CA_FOREACH(LOSView, v, los->Views)
+		if (v->UID == uid)
+		{
+			return v;
+		}
+	CA_FOREACH_END()
+	LOSView v;
+	memset(&v, 0, sizeof v);
+	v.UID = uid;
+	v.Dirty = true;
+	CArrayInit(&v.Tiles, sizeof(int));
+	CArrayPushBack(&los->Views, &v);
+	return CArrayGet(&los->Views, los->Views.size - 1);
+}
+
+void LOSInvalidate(LineOfSight *los, const struct vec2i pos)
+{
+	los->ObstructionsDirty = true;
+	CA_FOREACH(LOSView, v, los->Views)
+		// Obstructions just out of sight are still shown if they are next to
+		// visible tiles, so allow some leeway
+		const int range = v->SightRange + 2;
+		if (svec2i_distance_squared(v->Pos, pos) <= range * range)
+		{
+			v->Dirty = true;
+		}
+	CA_FOREACH_END()
+}
+
 typedef struct
 {
 	Map *Map;
+	LOSView *View;
 	struct vec2i Center;
 	int SightRange2;
-	bool Explore;
 } LOSData;
+static void SetViewVisible(LOSData *data, const struct vec2i pos);
+static void UpdateObstructions(Map *map);
+static void OnFOVVisible(void *data, const struct vec2i pos);
+static void SetObstructionsVisible(LOSData *data);
 // Calculate LOS cells from a certain start position
-// Sight range based on config
-static void SetLOSVisible(Map *map, const struct vec2i pos, const bool explore);
-static bool IsNextTileBlockedAndSetVisibility(void *data, struct vec2i pos);
-static void SetObstructionVisible(
-	Map *map, const struct vec2i pos, const bool explore);
-void LOSCalcFrom(Map *map, const struct vec2i pos, const bool explore)
+static void CalcView(
+	Map *map, LOSView *v, const struct vec2i pos, const int sightRange,
+	const FOVType fov)
 {
-	// Perform LOS by casting rays from the centre to the edges, terminating
-	// whenever an obstruction or out-of-range is reached.
+	CArrayClear(&v->Tiles);
+	v->Pos = pos;
+	v->SightRange = sightRange;
+	v->FOV = fov;
+	v->Dirty = false;
 
-	CArrayFillZero(&map->LOS.Explored);
+	LOSData data;
+	data.Map = map;
+	data.View = v;
+	data.Center = pos;
+	data.SightRange2 = sightRange * sightRange;
 
 	// First mark center tile and all adjacent tiles as visible
 	// +-+-+-+
@@ -100,105 +185,103 @@ void LOSCalcFrom(Map *map, const struct vec2i pos, const bool explore)
 	{
 		for (end.y = pos.y - 1; end.y <= pos.y + 1; end.y++)
 		{
-			SetLOSVisible(map, end, explore);
+			SetViewVisible(&data, end);
 		}
 	}
 
-	const int sightRange = ConfigGetInt(&gConfig, "Game.SightRange");
-	if (sightRange == 0) return;
-
-	// Limit the perimeter to the sight range
-	const struct vec2i origin = svec2i(pos.x - sightRange, pos.y - sightRange);
-	const struct vec2i perimSize = svec2i_scale(svec2i_subtract(pos, origin), 2);
-
-	LOSData data;
-	data.Map = map;
-	data.Center = pos;
-	data.SightRange2 = sightRange * sightRange;
-	data.Explore = explore;
-
-	// Start from the top-left cell, and proceed clockwise around
-	end = origin;
-	HasClearLineData lineData;
-	lineData.IsBlocked = IsNextTileBlockedAndSetVisibility;
-	lineData.data = &data;
-	// Top edge
-	for (; end.x < origin.x + perimSize.x; end.x++)
-	{
-		HasClearLineJMRaytrace(pos, end, &lineData);
-	}
-	// right edge
-	for (; end.y < origin.y + perimSize.y; end.y++)
+	if (sightRange > 0)
 	{
-		HasClearLineJMRaytrace(pos, end, &lineData);
-	}
-	// bottom edge
-	for (; end.x > origin.x; end.x--)
-	{
-		HasClearLineJMRaytrace(pos, end, &lineData);
-	}
-	// left edge
-	for (; end.y > origin.y; end.y--)
-	{
-		HasClearLineJMRaytrace(pos, end, &lineData);
+		UpdateObstructions(map);
+		FOVCalc(
+			fov, &map->LOS.Obstructions, pos, sightRange, OnFOVVisible, &data);
+		SetObstructionsVisible(&data);
 	}
 
-	// Second pass: make any non-visible obstructions that are adjacent to
-	// visible non-obstructions visible too
-	// This is to ensure runs of walls stay visible
-	for (end.y = origin.y; end.y < origin.y + perimSize.y; end.y++)
+	// Clear the scratch LOS for the next view
+	CA_FOREACH(const int, idx, v->Tiles)
+		*((bool *)CArrayGet(&map->LOS.ViewLOS, *idx)) = false;
+	CA_FOREACH_END()
+}
+static void UpdateObstructions(Map *map)
+{
+	if (!map->LOS.ObstructionsDirty) return;
+	struct vec2i pos;
+	for (pos.y = 0; pos.y < map->Size.y; pos.y++)
 	{
-		for (end.x = origin.x; end.x < origin.x + perimSize.x; end.x++)
+		for (pos.x = 0; pos.x < map->Size.x; pos.x++)
 		{
-			const Tile *tile = MapGetTile(map, end);
-			if (!tile || !(tile->flags & MAPTILE_NO_SEE))
-			{
-				continue;
-			}
-			// Check sight range
-			if (svec2i_distance_squared(pos, end) >= data.SightRange2)
-			{
-				continue;
-			}
-			SetObstructionVisible(map, end, explore);
+			const Tile *t = MapGetTile(map, pos);
+			FOVMapSet(
+				&map->LOS.Obstructions, pos, t->flags & MAPTILE_NO_SEE);
 		}
 	}
-
-	// Find all the newly visible tiles and set events for them
-	GameEvent e = GameEventNew(GAME_EVENT_EXPLORE_TILES);
-	e.u.ExploreTiles.Runs_count = 0;
-	e.u.ExploreTiles.Runs[0].Run = 0;
-	bool run = false;
-	for (end.y = 0; end.y < map->Size.y; end.y++)
+	map->LOS.ObstructionsDirty = false;
+}
+static void OnFOVVisible(void *data, const struct vec2i pos)
+{
+	SetViewVisible(data, pos);
+}
+// Second pass: make any non-visible obstructions that are adjacent to
+// visible non-obstructions visible too
+// This is to ensure runs of walls stay visible
+static void SetObstructionsVisible(LOSData *data)
+{
+	const FOVMap *o = &data->Map->LOS.Obstructions;
+	const int numTiles = (int)data->View->Tiles.size;
+	for (int i = 0; i < numTiles; i++)
 	{
-		for (end.x = 0; end.x < map->Size.x; end.x++)
+		const int idx = *(const int *)CArrayGet(&data->View->Tiles, i);
+		const struct vec2i pos =
+			svec2i(idx % data->Map->Size.x, idx / data->Map->Size.x);
+		if (FOVMapIsBlocked(o, pos)) continue;
+		struct vec2i d;
+		for (d.y = -1; d.y < 2; d.y++)
 		{
-			if (LOSAddRun(
-				&e.u.ExploreTiles, &run, end,
-				*((bool *)CArrayGet(&map->LOS.Explored, end.y * map->Size.x + end.x))))
+			for (d.x = -1; d.x < 2; d.x++)
 			{
-				GameEventsEnqueue(&gGameEvents, e);
-				e.u.ExploreTiles.Runs_count = 0;
-				e.u.ExploreTiles.Runs[0].Run = 0;
-				run = false;
+				const struct vec2i n = svec2i_add(pos, d);
+				// Check sight range
+				if (FOVMapIsBlocked(o, n) &&
+					svec2i_distance_squared(data->Center, n) <
+					data->SightRange2)
+				{
+					SetViewVisible(data, n);
+				}
 			}
 		}
 	}
-	if (e.u.ExploreTiles.Runs_count > 0)
-	{
-		GameEventsEnqueue(&gGameEvents, e);
-	}
-	CArrayFillZero(&map->LOS.Explored);
 }
-static void SetLOSVisible(Map *map, const struct vec2i pos, const bool explore)
+static void SetViewVisible(LOSData *data, const struct vec2i pos)
 {
-	const Tile *t = MapGetTile(map, pos);
-	if (t == NULL) return;
-	*((bool *)CArrayGet(&map->LOS.LOS, pos.y * map->Size.x + pos.x)) = true;
+	if (MapGetTile(data->Map, pos) == NULL) return;
+	const int idx = pos.y * data->Map->Size.x + pos.x;
+	bool *l = CArrayGet(&data->Map->LOS.ViewLOS, idx);
+	if (*l) return;
+	*l = true;
+	CArrayPushBack(&data->View->Tiles, &idx);
+}
+static void SetLOSVisible(Map *map, const int idx, const bool explore);
+static void SendExploredTiles(Map *map);
+static void ApplyView(Map *map, const LOSView *v, const bool explore)
+{
+	CA_FOREACH(const int, idx, v->Tiles)
+		SetLOSVisible(map, *idx, explore);
+	CA_FOREACH_END()
+	SendExploredTiles(map);
+}
+static void SetLOSVisible(Map *map, const int idx, const bool explore)
+{
+	const Tile *t = CArrayGet(&map->Tiles, idx);
+	*((bool *)CArrayGet(&map->LOS.LOS, idx)) = true;
 	if (!t->isVisited && explore)
 	{
 		// Cache the newly explored tile
-		*((bool *)CArrayGet(&map->LOS.Explored, pos.y * map->Size.x + pos.x)) = true;
+		bool *e = CArrayGet(&map->LOS.Explored, idx);
+		if (!*e)
+		{
+			*e = true;
+			CArrayPushBack(&map->LOS.ExploredTiles, &idx);
+		}
 	}
 	// Mark any actors on this tile as visible
 	// This affects some AI
@@ -211,40 +294,43 @@ static void SetLOSVisible(Map *map, const struct vec2i pos, const bool explore)
 		}
 	CA_FOREACH_END()
 }
-static bool IsNextTileBlockedAndSetVisibility(void *data, struct vec2i pos)
-{
-	LOSData *lData = data;
-	// Check sight range
-	if (svec2i_distance_squared(lData->Center, pos) >= lData->SightRange2) return true;
-	// Check map range
-	const Tile *t = MapGetTile(lData->Map, pos);
-	if (t == NULL) return true;
-	SetLOSVisible(lData->Map, pos, lData->Explore);
-	// Check if this tile is an obstruction
-	return t->flags & MAPTILE_NO_SEE;
-}
-static bool IsTileVisibleNonObstruction(Map *map, const struct vec2i pos);
-static void SetObstructionVisible(
-	Map *map, const struct vec2i pos, const bool explore)
+static int CompareInts(const void *v1, const void *v2);
+// Set events for the newly explored tiles, in runs of consecutive tiles
+static void SendExploredTiles(Map *map)
 {
-	struct vec2i d;
-	for (d.x = -1; d.x < 2; d.x++)
-	{
-		for (d.y = -1; d.y < 2; d.y++)
+	CArray *tiles = &map->LOS.ExploredTiles;
+	if (tiles->size == 0) return;
+	qsort(tiles->data, tiles->size, tiles->elemSize, CompareInts);
+	GameEvent e = GameEventNew(GAME_EVENT_EXPLORE_TILES);
+	e.u.ExploreTiles.Runs_count = 0;
+	e.u.ExploreTiles.Runs[0].Run = 0;
+	bool run = false;
+	int last = -1;
+	CA_FOREACH(const int, idx, *tiles)
+		*((bool *)CArrayGet(&map->LOS.Explored, *idx)) = false;
+		const struct vec2i tile = svec2i(*idx % map->Size.x, *idx / map->Size.x);
+		if (run && *idx != last + 1 &&
+			LOSAddRun(&e.u.ExploreTiles, &run, tile, false))
 		{
-			if (IsTileVisibleNonObstruction(map, svec2i_add(pos, d)))
-			{
-				SetLOSVisible(map, pos, explore);
-				return;
-			}
+			GameEventsEnqueue(&gGameEvents, e);
+			e.u.ExploreTiles.Runs_count = 0;
+			e.u.ExploreTiles.Runs[0].Run = 0;
+			run = false;
 		}
+		LOSAddRun(&e.u.ExploreTiles, &run, tile, true);
+		last = *idx;
+	CA_FOREACH_END()
+	if (e.u.ExploreTiles.Runs_count > 0)
+	{
+		GameEventsEnqueue(&gGameEvents, e);
 	}
+	CArrayClear(tiles);
 }
-static bool IsTileVisibleNonObstruction(Map *map, const struct vec2i pos)
+static int CompareInts(const void *v1, const void *v2)
 {
-	const Tile *t = MapGetTile(map, pos);
-	if (t == NULL) return false;
-	return !(t->flags & MAPTILE_NO_SEE) && LOSTileIsVisible(map, pos);
+	const int i1 = *(const int *)v1;
+	const int i2 = *(const int *)v2;
+	return i1 < i2 ? -1 : i1 > i2;
 }
 
 bool LOSAddRun(
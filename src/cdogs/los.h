@@ -37,6 +37,13 @@ void LOSTerminate(LineOfSight *los);
 void LOSReset(LineOfSight *los);
 void LOSSetAllVisible(LineOfSight *los);
 void LOSCalcFrom(Map *map, const struct vec2i pos, const bool explore);
+// Calculate LOS for a player, reusing the tiles from last time if it is on
+// the same tile and no obstructions in sight have changed
+void LOSCalcFromCached(
+	Map *map, const int uid, const struct vec2i pos, const bool explore);
+// Recalculate views that may be affected by a tile that has started or
+// stopped blocking sight, such as a door
+void LOSInvalidate(LineOfSight *los, const struct vec2i pos);
 
 // Helper function for populating explore tiles runs
 // Returns true if the runs have filled
@@ -52,11 +52,13 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include "ai_utils.h"
 #include "algorithms.h"
 #include "ammo.h"
 #include "collision/collision.h"
 #include "config.h"
 #include "door.h"
+#include "flow_field.h"
 #include "game_events.h"
 #include "gamedata.h"
 #include "log.h"
@@ -152,7 +154,6 @@ static Tile *MapGetTileOfItem(Map *map, TTileItem *t)
 	return MapGetTile(map, pos);
 }
 
-static void AddItemToTile(TTileItem *t, Tile *tile);
 bool MapTryMoveTileItem(Map *map, TTileItem *t, const struct vec2 pos)
 {
 	// Check if we can move to new position
@@ -177,18 +178,9 @@ bool MapTryMoveTileItem(Map *map, TTileItem *t, const struct vec2 pos)
 	}
 	// ...move and add to new tile
 	t->Pos = pos;
-	AddItemToTile(t, MapGetTile(map, t2));
+	TileAddThing(MapGetTile(map, t2), t);
 	return true;
 }
-static void AddItemToTile(TTileItem *t, Tile *tile)
-{
-	ThingId tid;
-	tid.Id = t->id;
-	tid.Kind = t->kind;
-	CASSERT(tid.Id >= 0, "invalid ThingId");
-	CASSERT(tid.Kind >= 0 && tid.Kind <= KIND_PICKUP, "unknown thing kind");
-	CArrayPushBack(&tile->things, &tid);
-}
 
 void MapRemoveTileItem(Map *map, TTileItem *t)
 {
@@ -196,15 +188,7 @@ void MapRemoveTileItem(Map *map, TTileItem *t)
 	{
 		return;
 	}
-	Tile *tile = MapGetTileOfItem(map, t);
-	CA_FOREACH(ThingId, tid, tile->things)
-		if (tid->Id == t->id && tid->Kind == t->kind)
-		{
-			CArrayDelete(&tile->things, _ca_index);
-			return;
-		}
-	CA_FOREACH_END()
-	CASSERT(false, "Did not find element to delete");
+	TileRemoveThing(MapGetTileOfItem(map, t), t);
 }
 
 struct vec2i MapGetRandomTile(const Map *map)
@@ -667,6 +651,7 @@ void MapTerminate(Map *map)
 	CArrayTerminate(&map->iMap);
 	LOSTerminate(&map->LOS);
 	PathCacheTerminate(&gPathCache);
+	FlowFieldsTerminate(&gFlowFields);
 }
 
 static void DebugPrintMap(const Map *map);
@@ -684,6 +669,7 @@ void MapLoad(
 	LOSInit(map, map->Size);
 	CArrayInit(&map->triggers, sizeof(Trigger *));
 	PathCacheInit(&gPathCache, map);
+	FlowFieldsInit(&gFlowFields, map, IsTileWalkable);
 
 	struct vec2i v;
 	for (v.y = 0; v.y < map->Size.y; v.y++)
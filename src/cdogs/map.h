@@ -51,6 +51,7 @@
 #include <stdbool.h>
 
 #include "campaigns.h"
+#include "fov.h"
 #include "map_object.h"
 #include "mission.h"
 #include "pic.h"
@@ -82,6 +83,18 @@ IMapType StrIMapType(const char *s);
 
 #define MAP_LEAVEFREE       4096
 
+// Tiles visible from a tile, kept until the viewer moves to another tile
+// or an obstruction in sight changes
+typedef struct
+{
+	int UID;	// of the viewing player
+	struct vec2i Pos;
+	int SightRange;
+	FOVType FOV;
+	bool Dirty;
+	CArray Tiles;	// of int, visible tile indices
+} LOSView;
+
 typedef struct
 {
 	// Array of bools to set lines of sight
@@ -89,6 +102,16 @@ typedef struct
 
 	// Array of bools for tracking new tiles in line of sight, for delayed messaging
 	CArray Explored; // of bool
+	// Indices of the tiles set in Explored, which are cleared after use
+	CArray ExploredTiles;	// of int
+
+	// Cached views of each player
+	CArray Views;	// of LOSView
+	// Scratch array of bools for calculating a view, cleared after use
+	CArray ViewLOS;	// of bool
+	// Tiles that block sight; updated before calculating views if dirty
+	FOVMap Obstructions;
+	bool ObstructionsDirty;
 } LineOfSight;
 
 typedef struct
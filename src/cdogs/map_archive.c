@@ -96,19 +96,13 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 		ParticleClassesLoadJSON(&gParticleClasses.CustomClasses, root);
 	}
 
-	root = ReadArchiveJSON(filename, "character_classes.json");
-	if (root != NULL)
-	{
-		CharacterClassesLoadJSON(
-			&gCharacterClasses.CustomClasses, root);
-	}
+	// Note: these files are optional
+	char path[CDOGS_PATH_MAX];
+	sprintf(path, "%s/character_classes.json", filename);
+	CharacterClassesLoadJSON(&gCharacterClasses.CustomClasses, path);
 
-	root = ReadArchiveJSON(filename, "bullets.json");
-	if (root != NULL)
-	{
-		BulletLoadJSON(
-			&gBulletClasses, &gBulletClasses.CustomClasses, root);
-	}
+	sprintf(path, "%s/bullets.json", filename);
+	BulletLoadJSON(&gBulletClasses, &gBulletClasses.CustomClasses, path);
 
 	root = ReadArchiveJSON(filename, "ammo.json");
 	if (root != NULL)
@@ -117,13 +111,8 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 		json_free_value(&root);
 	}
 
-	root = ReadArchiveJSON(filename, "guns.json");
-	if (root != NULL)
-	{
-		WeaponLoadJSON(
-			&gGunDescriptions, &gGunDescriptions.CustomGuns, root);
-		json_free_value(&root);
-	}
+	sprintf(path, "%s/guns.json", filename);
+	WeaponLoadJSON(&gGunDescriptions, &gGunDescriptions.CustomGuns, path);
 
 	BulletLoadWeapons(&gBulletClasses);
 
@@ -147,15 +136,12 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 	MapObjectsLoadAmmoAndGunSpawners(
 		&gMapObjects, &gAmmo, &gGunDescriptions, true);
 
-	root = ReadArchiveJSON(filename, "missions.json");
-	if (root == NULL)
+	sprintf(path, "%s/missions.json", filename);
+	if (!LoadMissionsFile(&c->Missions, path, &version, NULL))
 	{
 		err = -1;
 		goto bail;
 	}
-	LoadMissions(
-		&c->Missions, json_find_first_label(root, "Missions")->child, version);
-	json_free_value(&root);
 
 	// Note: some campaigns don't have characters (e.g. dogfights)
 	root = ReadArchiveJSON(filename, "characters.json");
@@ -194,6 +180,10 @@ bail:
 static void LoadArchiveSounds(
 	SoundDevice *device, const char *archive, const char *dirname)
 {
+	if (!device->isInitialised)
+	{
+		return;
+	}
 	char path[CDOGS_PATH_MAX];
 	sprintf(path, "%s/%s", archive, dirname);
 	SoundLoadDir(device->customSounds, path, NULL);
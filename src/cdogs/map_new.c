@@ -33,6 +33,7 @@
 
 #include "door.h"
 #include "files.h"
+#include "json_stream.h"
 #include "json_utils.h"
 #include "log.h"
 #include "map_archive.h"
@@ -136,20 +137,13 @@ int MapNewLoad(const char *filename, CampaignSetting *c)
 
 	// try to load the new map format
 	json_t *root = NULL;
-	int version;
-	FILE *f = fopen(filename, "r");
-	if (f == NULL)
-	{
-		err = -1;
-		goto bail;
-	}
-	if (json_stream_parse(f, &root) != JSON_OK)
+	int version = 0;
+	if (!LoadMissionsFile(&c->Missions, filename, &version, &root))
 	{
 		printf("Error parsing campaign '%s'\n", filename);
 		err = -1;
 		goto bail;
 	}
-	LoadInt(&version, root, "Version");
 	if (version > 2 || version <= 0)
 	{
 		assert(0 && "not implemented or unknown campaign");
@@ -157,16 +151,99 @@ int MapNewLoad(const char *filename, CampaignSetting *c)
 		goto bail;
 	}
 	MapNewLoadCampaignJSON(root, c);
-	LoadMissions(&c->Missions, json_find_first_label(root, "Missions")->child, version);
 	CharacterLoadJSON(&c->characters, root, version);
 
 bail:
 	json_free_value(&root);
-	if (f != NULL)
+	return err;
+}
+
+typedef struct
+{
+	CArray *missions;
+	int version;
+	CArray tiles;	// of unsigned short
+} MissionsStream;
+static bool LoadMissionElement(json_t *root, json_t **node, void *data);
+static void LoadTiles(const char *text, size_t len, void *data);
+bool LoadMissionsFile(
+	CArray *missions, const char *filename, int *version, json_t **root)
+{
+	MissionsStream ms;
+	ms.missions = missions;
+	ms.version = *version;
+	CArrayInit(&ms.tiles, sizeof(unsigned short));
+	JSONStream s;
+	JSONStreamInit(&s);
+	JSONStreamAddArray(&s, "Missions", LoadMissionElement, &ms);
+	JSONStreamAddValue(&s, "Tiles", LoadTiles, &ms.tiles);
+	bool res = JSONStreamParseFile(&s, filename);
+	if (res && ms.version == 0 &&
+		json_find_first_label(s.root, "Version") != NULL)
+	{
+		// No missions; still need the version
+		LoadInt(&ms.version, s.root, "Version");
+	}
+	res = res && ms.version > 0;
+	if (!res)
+	{
+		LOG(LM_MAP, LL_ERROR, "cannot load missions from %s", filename);
+	}
+	*version = ms.version;
+	if (root != NULL)
+	{
+		*root = s.root;
+		s.root = NULL;
+	}
+	JSONStreamTerminate(&s);
+	CArrayTerminate(&ms.tiles);
+	return res;
+}
+static bool LoadMissionElement(json_t *root, json_t **node, void *data)
+{
+	MissionsStream *ms = data;
+	if (ms->version == 0 && json_find_first_label(root, "Version") != NULL)
 	{
-		fclose(f);
+		LoadInt(&ms->version, root, "Version");
+	}
+	if (ms->version > MAP_VERSION || ms->version <= 0)
+	{
+		LOG(LM_MAP, LL_ERROR, "unknown missions version %d", ms->version);
+		ms->version = 0;
+		return false;
+	}
+	Mission m;
+	if (MissionLoadJSON(&m, *node, ms->version, &ms->tiles))
+	{
+		CArrayPushBack(ms->missions, &m);
+	}
+	CArrayClear(&ms->tiles);
+	return true;
+}
+static void LoadTiles(const char *text, size_t len, void *data)
+{
+	// Numbers, or a CSV string of numbers
+	CArray *tiles = data;
+	unsigned short n = 0;
+	bool hasNumber = false;
+	for (size_t i = 0; i < len; i++)
+	{
+		if (text[i] >= '0' && text[i] <= '9')
+		{
+			n = (unsigned short)(n * 10 + text[i] - '0');
+			hasNumber = true;
+		}
+		else if (text[i] == ',' && hasNumber)
+		{
+			CArrayPushBack(tiles, &n);
+			n = 0;
+			hasNumber = false;
+		}
+	}
+	if (hasNumber)
+	{
+		CArrayPushBack(tiles, &n);
 	}
-	return err;
 }
 
 void MapNewLoadCampaignJSON(json_t *root, CampaignSetting *c)
@@ -186,189 +263,186 @@ static void LoadWeapons(CArray *weapons, json_t *weaponsNode);
 static void LoadRooms(RoomParams *r, json_t *roomsNode);
 static void LoadClassicDoors(Mission *m, json_t *node, char *name);
 static void LoadClassicPillars(Mission *m, json_t *node, char *name);
-static bool TryLoadStaticMap(Mission *m, json_t *node, int version);
-void LoadMissions(CArray *missions, json_t *missionsNode, int version)
+static bool TryLoadStaticMap(
+	Mission *m, json_t *node, const int version, CArray *streamedTiles);
+bool MissionLoadJSON(
+	Mission *m, json_t *node, const int version, CArray *tiles)
 {
-	json_t *child;
-	for (child = missionsNode->child; child; child = child->next)
-	{
-		Mission m;
-		MissionInit(&m);
-		m.Title = GetString(child, "Title");
-		m.Description = GetString(child, "Description");
-		JSON_UTILS_LOAD_ENUM(m.Type, child, "Type", StrMapType);
-		LoadInt(&m.Size.x, child, "Width");
-		LoadInt(&m.Size.y, child, "Height");
-		if (version <= 10)
-		{
-			int style;
-			LoadInt(&style, child, "WallStyle");
-			strcpy(m.WallStyle, IntWallStyle(style));
-			LoadInt(&style, child, "FloorStyle");
-			strcpy(m.FloorStyle, IntFloorStyle(style));
-			LoadInt(&style, child, "RoomStyle");
-			strcpy(m.RoomStyle, IntRoomStyle(style));
-		}
-		else
-		{
-			char *tmp = GetString(child, "WallStyle");
-			strcpy(m.WallStyle, tmp);
-			CFREE(tmp);
-			tmp = GetString(child, "FloorStyle");
-			strcpy(m.FloorStyle, tmp);
-			CFREE(tmp);
-			tmp = GetString(child, "RoomStyle");
-			strcpy(m.RoomStyle, tmp);
-			CFREE(tmp);
-		}
-		if (version <= 9)
-		{
-			int style;
-			LoadInt(&style, child, "ExitStyle");
-			strcpy(m.ExitStyle, IntExitStyle(style));
-		}
-		else
-		{
-			char *tmp = GetString(child, "ExitStyle");
-			strcpy(m.ExitStyle, tmp);
-			CFREE(tmp);
-		}
-		if (version <= 8)
-		{
-			int keyStyle;
-			LoadInt(&keyStyle, child, "KeyStyle");
-			strcpy(m.KeyStyle, IntKeyStyle(keyStyle));
-		}
-		else
-		{
-			char *tmp = GetString(child, "KeyStyle");
-			strcpy(m.KeyStyle, tmp);
-			CFREE(tmp);
-		}
-		if (version <= 5)
-		{
-			int doorStyle;
-			LoadInt(&doorStyle, child, "DoorStyle");
-			strcpy(m.DoorStyle, IntDoorStyle(doorStyle));
-		}
-		else
+	MissionInit(m);
+	m->Title = GetString(node, "Title");
+	m->Description = GetString(node, "Description");
+	JSON_UTILS_LOAD_ENUM(m->Type, node, "Type", StrMapType);
+	LoadInt(&m->Size.x, node, "Width");
+	LoadInt(&m->Size.y, node, "Height");
+	if (version <= 10)
+	{
+		int style;
+		LoadInt(&style, node, "WallStyle");
+		strcpy(m->WallStyle, IntWallStyle(style));
+		LoadInt(&style, node, "FloorStyle");
+		strcpy(m->FloorStyle, IntFloorStyle(style));
+		LoadInt(&style, node, "RoomStyle");
+		strcpy(m->RoomStyle, IntRoomStyle(style));
+	}
+	else
+	{
+		char *tmp = GetString(node, "WallStyle");
+		strcpy(m->WallStyle, tmp);
+		CFREE(tmp);
+		tmp = GetString(node, "FloorStyle");
+		strcpy(m->FloorStyle, tmp);
+		CFREE(tmp);
+		tmp = GetString(node, "RoomStyle");
+		strcpy(m->RoomStyle, tmp);
+		CFREE(tmp);
+	}
+	if (version <= 9)
+	{
+		int style;
+		LoadInt(&style, node, "ExitStyle");
+		strcpy(m->ExitStyle, IntExitStyle(style));
+	}
+	else
+	{
+		char *tmp = GetString(node, "ExitStyle");
+		strcpy(m->ExitStyle, tmp);
+		CFREE(tmp);
+	}
+	if (version <= 8)
+	{
+		int keyStyle;
+		LoadInt(&keyStyle, node, "KeyStyle");
+		strcpy(m->KeyStyle, IntKeyStyle(keyStyle));
+	}
+	else
+	{
+		char *tmp = GetString(node, "KeyStyle");
+		strcpy(m->KeyStyle, tmp);
+		CFREE(tmp);
+	}
+	if (version <= 5)
+	{
+		int doorStyle;
+		LoadInt(&doorStyle, node, "DoorStyle");
+		strcpy(m->DoorStyle, IntDoorStyle(doorStyle));
+	}
+	else
+	{
+		char *tmp = GetString(node, "DoorStyle");
+		strcpy(m->DoorStyle, tmp);
+		CFREE(tmp);
+	}
+	LoadMissionObjectives(
+		&m->Objectives,
+		json_find_first_label(node, "Objectives")->child,
+		version);
+	LoadIntArray(&m->Enemies, node, "Enemies");
+	LoadIntArray(&m->SpecialChars, node, "SpecialChars");
+	if (version <= 3)
+	{
+		CArray items;
+		CArrayInit(&items, sizeof(int));
+		LoadIntArray(&items, node, "Items");
+		CArray densities;
+		CArrayInit(&densities, sizeof(int));
+		LoadIntArray(&densities, node, "ItemDensities");
+		for (int i = 0; i < (int)items.size; i++)
 		{
-			char *tmp = GetString(child, "DoorStyle");
-			strcpy(m.DoorStyle, tmp);
-			CFREE(tmp);
+			MapObjectDensity mod;
+			mod.M = IntMapObject(*(int *)CArrayGet(&items, i));
+			mod.Density = *(int *)CArrayGet(&densities, i);
+			CArrayPushBack(&m->MapObjectDensities, &mod);
 		}
-		LoadMissionObjectives(
-			&m.Objectives,
-			json_find_first_label(child, "Objectives")->child,
-			version);
-		LoadIntArray(&m.Enemies, child, "Enemies");
-		LoadIntArray(&m.SpecialChars, child, "SpecialChars");
-		if (version <= 3)
+	}
+	else
+	{
+		json_t *modsNode =
+			json_find_first_label(node, "MapObjectDensities");
+		if (modsNode && modsNode->child)
 		{
-			CArray items;
-			CArrayInit(&items, sizeof(int));
-			LoadIntArray(&items, child, "Items");
-			CArray densities;
-			CArrayInit(&densities, sizeof(int));
-			LoadIntArray(&densities, child, "ItemDensities");
-			for (int i = 0; i < (int)items.size; i++)
+			modsNode = modsNode->child;
+			for (json_t *modNode = modsNode->child;
+				modNode;
+				modNode = modNode->next)
 			{
 				MapObjectDensity mod;
-				mod.M = IntMapObject(*(int *)CArrayGet(&items, i));
-				mod.Density = *(int *)CArrayGet(&densities, i);
-				CArrayPushBack(&m.MapObjectDensities, &mod);
+				mod.M = StrMapObject(
+					json_find_first_label(modNode, "MapObject")->child->text);
+				LoadInt(&mod.Density, modNode, "Density");
+				CArrayPushBack(&m->MapObjectDensities, &mod);
 			}
 		}
-		else
-		{
-			json_t *modsNode =
-				json_find_first_label(child, "MapObjectDensities");
-			if (modsNode && modsNode->child)
-			{
-				modsNode = modsNode->child;
-				for (json_t *modNode = modsNode->child;
-					modNode;
-					modNode = modNode->next)
-				{
-					MapObjectDensity mod;
-					mod.M = StrMapObject(
-						json_find_first_label(modNode, "MapObject")->child->text);
-					LoadInt(&mod.Density, modNode, "Density");
-					CArrayPushBack(&m.MapObjectDensities, &mod);
-				}
-			}
-		}
-		LoadInt(&m.EnemyDensity, child, "EnemyDensity");
-		LoadWeapons(
-			&m.Weapons, json_find_first_label(child, "Weapons")->child);
-		strcpy(m.Song, json_find_first_label(child, "Song")->child->text);
-		if (version <= 4)
-		{
-			// Load colour indices
-			int wc, fc, rc, ac;
-			LoadInt(&wc, child, "WallColor");
-			LoadInt(&fc, child, "FloorColor");
-			LoadInt(&rc, child, "RoomColor");
-			LoadInt(&ac, child, "AltColor");
-			m.WallMask = RangeToColor(wc);
-			m.FloorMask = RangeToColor(fc);
-			m.RoomMask = RangeToColor(rc);
-			m.AltMask = RangeToColor(ac);
-		}
-		else
+	}
+	LoadInt(&m->EnemyDensity, node, "EnemyDensity");
+	LoadWeapons(
+		&m->Weapons, json_find_first_label(node, "Weapons")->child);
+	strcpy(m->Song, json_find_first_label(node, "Song")->child->text);
+	if (version <= 4)
+	{
+		// Load colour indices
+		int wc, fc, rc, ac;
+		LoadInt(&wc, node, "WallColor");
+		LoadInt(&fc, node, "FloorColor");
+		LoadInt(&rc, node, "RoomColor");
+		LoadInt(&ac, node, "AltColor");
+		m->WallMask = RangeToColor(wc);
+		m->FloorMask = RangeToColor(fc);
+		m->RoomMask = RangeToColor(rc);
+		m->AltMask = RangeToColor(ac);
+	}
+	else
+	{
+		LoadColor(&m->WallMask, node, "WallMask");
+		LoadColor(&m->FloorMask, node, "FloorMask");
+		LoadColor(&m->RoomMask, node, "RoomMask");
+		LoadColor(&m->AltMask, node, "AltMask");
+	}
+	switch (m->Type)
+	{
+	case MAPTYPE_CLASSIC:
+		LoadInt(&m->u.Classic.Walls, node, "Walls");
+		LoadInt(&m->u.Classic.WallLength, node, "WallLength");
+		LoadInt(&m->u.Classic.CorridorWidth, node, "CorridorWidth");
+		LoadRooms(
+			&m->u.Classic.Rooms,
+			json_find_first_label(node, "Rooms")->child);
+		LoadInt(&m->u.Classic.Squares, node, "Squares");
+		LoadClassicDoors(m, node, "Doors");
+		LoadClassicPillars(m, node, "Pillars");
+		break;
+	case MAPTYPE_STATIC:
+		if (!TryLoadStaticMap(m, node, version, tiles))
 		{
-			LoadColor(&m.WallMask, child, "WallMask");
-			LoadColor(&m.FloorMask, child, "FloorMask");
-			LoadColor(&m.RoomMask, child, "RoomMask");
-			LoadColor(&m.AltMask, child, "AltMask");
+			return false;
 		}
-		switch (m.Type)
+		break;
+	case MAPTYPE_CAVE:
 		{
-		case MAPTYPE_CLASSIC:
-			LoadInt(&m.u.Classic.Walls, child, "Walls");
-			LoadInt(&m.u.Classic.WallLength, child, "WallLength");
-			LoadInt(&m.u.Classic.CorridorWidth, child, "CorridorWidth");
-			LoadRooms(
-				&m.u.Classic.Rooms,
-				json_find_first_label(child, "Rooms")->child);
-			LoadInt(&m.u.Classic.Squares, child, "Squares");
-			LoadClassicDoors(&m, child, "Doors");
-			LoadClassicPillars(&m, child, "Pillars");
-			break;
-		case MAPTYPE_STATIC:
-			if (!TryLoadStaticMap(&m, child, version))
+			LoadInt(&m->u.Cave.FillPercent, node, "FillPercent");
+			LoadInt(&m->u.Cave.Repeat, node, "Repeat");
+			LoadInt(&m->u.Cave.R1, node, "R1");
+			LoadInt(&m->u.Cave.R2, node, "R2");
+			json_t *roomsNode = json_find_first_label(node, "Rooms");
+			if (roomsNode != NULL && roomsNode->child != NULL)
 			{
-				continue;
+				LoadRooms(&m->u.Cave.Rooms, roomsNode->child);
 			}
-			break;
-		case MAPTYPE_CAVE:
+			LoadInt(&m->u.Cave.Squares, node, "Squares");
+			if (version < 14)
 			{
-				LoadInt(&m.u.Cave.FillPercent, child, "FillPercent");
-				LoadInt(&m.u.Cave.Repeat, child, "Repeat");
-				LoadInt(&m.u.Cave.R1, child, "R1");
-				LoadInt(&m.u.Cave.R2, child, "R2");
-				json_t *roomsNode = json_find_first_label(child, "Rooms");
-				if (roomsNode != NULL && roomsNode->child != NULL)
-				{
-					LoadRooms(&m.u.Cave.Rooms, roomsNode->child);
-				}
-				LoadInt(&m.u.Cave.Squares, child, "Squares");
-				if (version < 14)
-				{
-					m.u.Cave.DoorsEnabled = true;
-				}
-				else
-				{
-					LoadBool(&m.u.Cave.DoorsEnabled, child, "DoorsEnabled");
-				}
+				m->u.Cave.DoorsEnabled = true;
+			}
+			else
+			{
+				LoadBool(&m->u.Cave.DoorsEnabled, node, "DoorsEnabled");
 			}
-			break;
-		default:
-			assert(0 && "unknown map type");
-			continue;
 		}
-		CArrayPushBack(missions, &m);
+		break;
+	default:
+		assert(0 && "unknown map type");
+		return false;
 	}
+	return true;
 }
 static void LoadStaticItems(
 	Mission *m, json_t *node, const char *name, const int version);
@@ -378,10 +452,17 @@ static void LoadStaticCharacters(Mission *m, json_t *node, char *name);
 static void LoadStaticObjectives(Mission *m, json_t *node, char *name);
 static void LoadStaticKeys(Mission *m, json_t *node, char *name);
 static void LoadStaticExit(Mission *m, json_t *node, char *name);
-static bool TryLoadStaticMap(Mission *m, json_t *node, int version)
+static bool TryLoadStaticMap(
+	Mission *m, json_t *node, const int version, CArray *streamedTiles)
 {
 	CArrayInit(&m->u.Static.Tiles, sizeof(unsigned short));
-	if (version == 1)
+	if (streamedTiles != NULL)
+	{
+		// Already streamed; take them
+		memcpy(&m->u.Static.Tiles, streamedTiles, sizeof *streamedTiles);
+		CArrayInit(streamedTiles, sizeof(unsigned short));
+	}
+	else if (version == 1)
 	{
 		// JSON array
 		json_t *tiles = json_find_first_label(node, "Tiles");
@@ -39,4 +39,12 @@ int MapNewLoad(const char *filename, CampaignSetting *c);
 // Helper methods for loading JSON maps
 int MapNewScanJSON(json_t *root, char **title, int *numMissions);
 void MapNewLoadCampaignJSON(json_t *root, CampaignSetting *c);
-void LoadMissions(CArray *missions, json_t *missionsNode, int version);
+// Stream the missions from a JSON file, without loading the whole file.
+// If *version is 0, it is read from the file. The rest of the file is
+// returned in root, if not NULL.
+bool LoadMissionsFile(
+	CArray *missions, const char *filename, int *version, json_t **root);
+// Load a mission; if tiles is not NULL, they have already been read and
+// are used for static maps instead of the "Tiles" value.
+bool MissionLoadJSON(
+	Mission *m, json_t *node, const int version, CArray *tiles);
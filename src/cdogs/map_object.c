@@ -48,6 +48,7 @@
 */
 #include "map_object.h"
 
+#include "class_index.h"
 #include "json_utils.h"
 #include "log.h"
 #include "map.h"
@@ -98,19 +99,13 @@ MapObject *StrMapObject(const char *s)
 	{
 		return NULL;
 	}
-	CA_FOREACH(MapObject, c, gMapObjects.CustomClasses)
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
-	CA_FOREACH_END()
-	CA_FOREACH(MapObject, c, gMapObjects.Classes)
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
-	CA_FOREACH_END()
-	return NULL;
+	// Custom classes take precedence
+	const CArray *arrays[] =
+	{
+		&gMapObjects.CustomClasses, &gMapObjects.Classes, NULL
+	};
+	return ClassIndexGet(
+		&gMapObjects.index, arrays, offsetof(MapObject, Name), s);
 }
 MapObject *IntMapObject(const int m)
 {
@@ -224,6 +219,7 @@ void MapObjectsInit(
 	CArrayInit(&classes->CustomClasses, sizeof(MapObject));
 	CArrayInit(&classes->Destructibles, sizeof(char *));
 	CArrayInit(&classes->Bloods, sizeof(char *));
+	classes->index = NULL;
 
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, filename);
@@ -256,6 +252,7 @@ static bool TryLoadMapObject(MapObject *m, json_t *node, const int version);
 static void ReloadDestructibles(MapObjects *mo);
 void MapObjectsLoadJSON(CArray *classes, json_t *root)
 {
+	ClassIndexReset(&gMapObjects.index);
 	int version;
 	LoadInt(&version, root, "Version");
 	if (version > VERSION || version <= 0)
@@ -437,6 +434,7 @@ void MapObjectsLoadAmmoAndGunSpawners(
 	MapObjects *classes, const AmmoClasses *ammo, const GunClasses *guns,
 	const bool isCustom)
 {
+	ClassIndexReset(&gMapObjects.index);
 	if (isCustom)
 	{
 		LoadAmmoSpawners(&classes->CustomClasses, &ammo->CustomAmmo);
@@ -506,6 +504,7 @@ static void SetupSpawner(
 
 void MapObjectsClear(CArray *classes)
 {
+	ClassIndexReset(&gMapObjects.index);
 	for (int i = 0; i < (int)classes->size; i++)
 	{
 		MapObject *c = CArrayGet(classes, i);
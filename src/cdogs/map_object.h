@@ -113,6 +113,7 @@ typedef struct
 	CArray Destructibles;	// of char *
 	// Map objects that match "blood%d" - left over when actors die
 	CArray Bloods;	// of char *
+	map_t index;	// name -> MapObject *; built on demand
 } MapObjects;
 extern MapObjects gMapObjects;
 
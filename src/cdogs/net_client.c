@@ -54,7 +54,7 @@ void NetClientInit(NetClient *n)
 	memset(n, 0, sizeof *n);
 	n->ClientId = -1;	// -1 is unset
 	n->scanner = ENET_SOCKET_NULL;
-	n->client = enet_host_create(NULL, 1, 2,
+	n->client = enet_host_create(NULL, 1, NET_CHANNEL_COUNT,
 		57600 / 8 /* 56K modem with 56 Kbps downstream bandwidth */,
 		14400 / 8 /* 56K modem with 14 Kbps upstream bandwidth */);
 	if (n->client == NULL)
@@ -63,6 +63,15 @@ void NetClientInit(NetClient *n)
 	}
 	CArrayInit(&n->ScannedAddrs, sizeof(ScanInfo));
 	CArrayInit(&n->scannedAddrBuf, sizeof(ScanInfo));
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		NetFrameInit(&n->frames[i]);
+	}
+	NetSnapshotRingInit(&n->Snapshots);
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		NetPredictionReset(&n->Predictions[i], -1);
+	}
 }
 void NetClientTerminate(NetClient *n)
 {
@@ -81,6 +90,11 @@ void NetClientTerminate(NetClient *n)
 	}
 	CArrayTerminate(&n->ScannedAddrs);
 	CArrayTerminate(&n->scannedAddrBuf);
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		CArrayTerminate(&n->frames[i]);
+	}
+	NetSnapshotRingTerminate(&n->Snapshots);
 }
 
 static bool TryScanHost(NetClient *n, const enet_uint32 host);
@@ -156,8 +170,8 @@ bool NetClientTryConnect(NetClient *n, const ENetAddress addr)
 	enet_address_get_host_ip(&addr, buf, sizeof buf);
 	LOG(LM_NET, LL_INFO, "Connecting client to %s:%u...", buf, addr.port);
 
-	/* Initiate the connection, allocating the two channels 0 and 1. */
-	n->peer = enet_host_connect(n->client, &addr, 2, 0);
+	/* Initiate the connection, allocating a channel per delivery class. */
+	n->peer = enet_host_connect(n->client, &addr, NET_CHANNEL_COUNT, 0);
 	if (n->peer == NULL)
 	{
 		LOG(LM_NET, LL_WARN, "No server connection found");
@@ -266,6 +280,8 @@ void NetClientDisconnect(NetClient *n)
 		LOG(LM_NET, LL_INFO, "disconnecting peer");
 		enet_peer_disconnect_now(n->peer, 0);
 		n->peer = NULL;
+		// String ids are assigned by the server we were connected to
+		NetStringsClear(&gNetStrings);
 	}
 	// Reset IDs so that when we start a server, we use our own IDs
 	n->ClientId = -1;
@@ -274,6 +290,16 @@ void NetClientDisconnect(NetClient *n)
 	// Also reset the scanned address buffer
 	CArrayClear(&n->ScannedAddrs);
 	CArrayClear(&n->scannedAddrBuf);
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		CArrayClear(&n->frames[i]);
+	}
+	// Snapshot sequences are per connection
+	NetSnapshotRingClear(&n->Snapshots);
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		NetPredictionReset(&n->Predictions[i], -1);
+	}
 }
 
 static void OnReceive(NetClient *n, ENetEvent event);
@@ -369,11 +395,37 @@ static void Scanning(NetClient *n)
 		}
 	}
 }
+static void OnReceiveMsg(NetClient *n, const NetMsg *msg);
 static void OnReceive(NetClient *n, ENetEvent event)
 {
-	const GameEventType msg = (GameEventType)*(uint32_t *)event.packet->data;
-	LOG(LM_NET, LL_TRACE, "recv msg(%u)", msg);
-	const GameEventEntry gee = GameEventGetEntry(msg);
+	// Drop malformed frames whole, rather than handle part of them
+	if (!NetFrameIsValid(event.packet->data, event.packet->dataLength))
+	{
+		LOG(LM_NET, LL_WARN, "dropping malformed net frame (%d bytes)",
+			(int)event.packet->dataLength);
+		enet_packet_destroy(event.packet);
+		return;
+	}
+	size_t offset = 0;
+	NetMsg msg;
+	while (NetFrameRead(
+		event.packet->data, event.packet->dataLength, &offset, &msg))
+	{
+		OnReceiveMsg(n, &msg);
+	}
+	enet_packet_destroy(event.packet);
+}
+static void OnSnapshot(NetClient *n, const NetMsg *msg);
+static void OnActorMoveAck(NetClient *n, const NetMsg *msg);
+static void OnReceiveMsg(NetClient *n, const NetMsg *msg)
+{
+	LOG(LM_NET, LL_TRACE, "recv msg(%d)", msg->Type);
+	if (msg->Type <= GAME_EVENT_NONE || msg->Type >= GAME_EVENT_COUNT)
+	{
+		LOG(LM_NET, LL_WARN, "dropping unknown msg(%d)", msg->Type);
+		return;
+	}
+	const GameEventEntry gee = GameEventGetEntry((GameEventType)msg->Type);
 	if (gee.Enqueue)
 	{
 		if (gee.GameStart && !gMission.HasStarted)
@@ -388,7 +440,11 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			GameEvent e = GameEventNew(gee.Type);
 			if (gee.Fields != NULL)
 			{
-				NetDecode(event.packet, &e.u, gee.Fields);
+				if (!NetDecode(msg, &e.u, gee.Fields) ||
+					!NetMsgExpandStrings(gee.Type, &e.u))
+				{
+					return;
+				}
 			}
 
 			// For actor events, check if UID is not for local player
@@ -444,7 +500,7 @@ static void OnReceive(NetClient *n, ENetEvent event)
 					n->ClientId == -1,
 					"unexpected client ID message, already set");
 				NClientId cid;
-				NetDecode(event.packet, &cid, NClientId_fields);
+				if (!NetDecode(msg, &cid, NClientId_fields)) break;
 				LOG(LM_NET, LL_DEBUG, "recv clientId(%u) uid(%u)",
 					cid.Id, cid.FirstPlayerUID);
 				n->ClientId = (int)cid.Id;
@@ -460,7 +516,11 @@ static void OnReceive(NetClient *n, ENetEvent event)
 			{
 				LOG(LM_NET, LL_DEBUG, "NetClient: received campaign def, loading...");
 				NCampaignDef def;
-				NetDecode(event.packet, &def, NCampaignDef_fields);
+				if (!NetDecode(msg, &def, NCampaignDef_fields))
+				{
+					gCampaign.IsError = true;
+					break;
+				}
 				gCampaign.Entry.Mode = (GameMode)def.GameMode;
 				// Normalise the path
 				char buf[CDOGS_PATH_MAX];
@@ -480,6 +540,18 @@ static void OnReceive(NetClient *n, ENetEvent event)
 				}
 			}
 			break;
+		case GAME_EVENT_STRING_DEF:
+			{
+				NStringDef sd;
+				if (!NetDecode(msg, &sd, NStringDef_fields)) break;
+				LOG(LM_NET, LL_TRACE, "recv string id(%u) name(%s)",
+					sd.Id, sd.Name);
+				if (!NetStringsSet(&gNetStrings, sd.Id, sd.Name))
+				{
+					LOG(LM_NET, LL_WARN, "invalid string id(%u)", sd.Id);
+				}
+			}
+			break;
 		case GAME_EVENT_NET_GAME_START:
 			LOG(LM_NET, LL_DEBUG, "recv game start ready(%s)",
 				n->Ready ? "yes" : "no");
@@ -489,19 +561,129 @@ static void OnReceive(NetClient *n, ENetEvent event)
 				gMission.HasStarted = true;
 			}
 			break;
+		case GAME_EVENT_SNAPSHOT:
+			OnSnapshot(n, msg);
+			break;
+		case GAME_EVENT_ACTOR_MOVE_ACK:
+			OnActorMoveAck(n, msg);
+			break;
 		default:
-			CASSERT(false, "unexpected message type");
+			LOG(LM_NET, LL_WARN, "dropping unexpected msg(%d)", msg->Type);
 			break;
 		}
 	}
-	enet_packet_destroy(event.packet);
 }
 
+static void OnActorMoveAck(NetClient *n, const NetMsg *msg)
+{
+	if (!gMission.HasStarted) return;
+
+	NActorMoveAck ack;
+	if (!NetDecode(msg, &ack, NActorMoveAck_fields)) return;
+	TActor *a = ActorGetByUID((int)ack.UID);
+	if (a == NULL || !a->isInUse) return;
+	NetPrediction *p = NetClientGetPrediction(n, a->PlayerUID, a->uid);
+	if (p == NULL) return;
+	struct vec2 sentPos;
+	if (!NetPredictionAck(p, ack.Seq, &sentPos))
+	{
+		// Too old to replay; the next move will be corrected instead
+		LOG(LM_NET, LL_DEBUG, "recv stale move ack uid(%u) seq(%u)",
+			ack.UID, ack.Seq);
+		return;
+	}
+	const struct vec2 pos = NetToVec2(ack.Pos);
+	if (svec2_is_nearly_equal(pos, sentPos, EPSILON_POS)) return;
+	LOG(LM_NET, LL_DEBUG, "move corrected uid(%u) seq(%u) (%f, %f)",
+		ack.UID, ack.Seq, pos.x, pos.y);
+	ActorReplayMoves(a, pos, p);
+}
+
+NetPrediction *NetClientGetPrediction(
+	NetClient *n, const int playerUID, const int actorUID)
+{
+	const int i = playerUID - n->FirstPlayerUID;
+	if (i < 0 || i >= MAX_LOCAL_PLAYERS)
+	{
+		return NULL;
+	}
+	NetPrediction *p = &n->Predictions[i];
+	if (p->ActorUID != actorUID)
+	{
+		NetPredictionReset(p, actorUID);
+	}
+	return p;
+}
+
+static void OnSnapshot(NetClient *n, const NetMsg *msg)
+{
+	// Ignore until we have the game start state
+	if (!gMission.HasStarted) return;
+
+	NSnapshot s;
+	if (!NetDecode(msg, &s, NSnapshot_fields)) return;
+	// Deltas are always against an older snapshot; anything else is stale
+	// or malformed, and could overwrite its own base
+	if (s.Seq == 0 || (s.BaseSeq != 0 && s.Seq <= s.BaseSeq))
+	{
+		LOG(LM_NET, LL_WARN, "dropping snapshot(%u) with base(%u)",
+			s.Seq, s.BaseSeq);
+		return;
+	}
+	const NetSnapshot *base = NULL;
+	if (s.BaseSeq != 0)
+	{
+		base = NetSnapshotRingGet(&n->Snapshots, s.BaseSeq);
+		if (base == NULL || s.Seq - s.BaseSeq >= NET_SNAPSHOT_RING_SIZE)
+		{
+			LOG(LM_NET, LL_DEBUG, "recv snapshot(%u) with missing base(%u)",
+				s.Seq, s.BaseSeq);
+			return;
+		}
+	}
+	NetSnapshot *snapshot = NetSnapshotRingSlot(&n->Snapshots, s.Seq);
+	CArray changed;
+	CArrayInit(&changed, sizeof(NetEntityState));
+	if (!NetSnapshotDeltaDecode(
+		base, s.Data.bytes, s.Data.size, s.Seq, snapshot, &changed))
+	{
+		LOG(LM_NET, LL_ERROR, "failed to decode snapshot(%u)", s.Seq);
+		NetSnapshotClear(snapshot);
+		CArrayTerminate(&changed);
+		return;
+	}
+	bool complete = true;
+	CA_FOREACH(const NetEntityState, e, changed)
+		complete = NetSnapshotApplyEntity(e) && complete;
+	CA_FOREACH_END()
+	CArrayTerminate(&changed);
+
+	// Only acknowledge once we have all the entities, e.g. if the snapshot
+	// arrived before the entity was added, so that the server resends them
+	if (complete)
+	{
+		NSnapshotAck ack = NSnapshotAck_init_default;
+		ack.Seq = s.Seq;
+		NetClientSendMsg(n, GAME_EVENT_SNAPSHOT_ACK, &ack);
+	}
+}
+
+static void QueueFrame(NetClient *n, const NetDelivery d);
 void NetClientFlush(NetClient *n)
 {
 	if (n->client == NULL) return;
+	for (NetDelivery d = 0; d < NET_DELIVERY_COUNT; d++)
+	{
+		QueueFrame(n, d);
+	}
 	enet_host_flush(n->client);
 }
+static void QueueFrame(NetClient *n, const NetDelivery d)
+{
+	CArray *frame = &n->frames[d];
+	if (frame->size == 0 || !NetClientIsConnected(n)) return;
+	enet_peer_send(n->peer, (enet_uint8)d, NetFrameMakePacket(frame, d));
+}
 
 void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data)
 {
@@ -511,7 +693,12 @@ void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data)
 	}
 
 	LOG(LM_NET, LL_TRACE, "NetClient: send msg type %d", (int)e);
-	enet_peer_send(n->peer, 0, NetEncode(e, data));
+	const NetDelivery d = GameEventGetEntry(e).Delivery;
+	NetFrameAppendMsg(&n->frames[d], e, data);
+	if (n->frames[d].size >= NET_FRAME_MAX_SIZE)
+	{
+		QueueFrame(n, d);
+	}
 }
 
 bool NetClientIsConnected(const NetClient *n)
@@ -30,6 +30,7 @@
 
 #include <time.h>
 
+#include "net_predict.h"
 #include "net_util.h"
 
 // Stored information about game servers scanned
@@ -55,6 +56,12 @@ typedef struct
 	CArray ScannedAddrs;		// of ScanInfo
 	// Buffer of scanned addresses - new ones will be scanned here
 	CArray scannedAddrBuf;	// of ScanInfo
+	// Outgoing messages, sent on flush; one frame per delivery class
+	CArray frames[NET_DELIVERY_COUNT];	// of uint8_t
+	// Received snapshots, kept as delta bases
+	NetSnapshotRing Snapshots;
+	// Movement prediction for local players, by player index
+	NetPrediction Predictions[MAX_LOCAL_PLAYERS];
 } NetClient;
 
 extern NetClient gNetClient;
@@ -72,7 +79,11 @@ bool NetClientTryScanAndConnect(NetClient *n, const enet_uint32 host);
 void NetClientDisconnect(NetClient *n);
 void NetClientPoll(NetClient *n);
 void NetClientFlush(NetClient *n);
-// Send a command to the server
+// Queue a command to be sent to the server on the next flush
 void NetClientSendMsg(NetClient *n, const GameEventType e, const void *data);
+// Get the movement prediction for a local player's actor, or NULL if the
+// player is not local; a new actor starts a new prediction
+NetPrediction *NetClientGetPrediction(
+	NetClient *n, const int playerUID, const int actorUID);
 
 bool NetClientIsConnected(const NetClient *n);
@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_frame.h"
+
+#include "proto/nanopb/pb_decode.h"
+#include "proto/nanopb/pb_encode.h"
+#include "utils.h"
+
+#define VARINT_MAX_SIZE 10
+
+
+void NetFrameInit(CArray *frame)
+{
+	CArrayInit(frame, sizeof(uint8_t));
+}
+
+bool NetFrameAppend(
+	CArray *frame, const int type, const pb_field_t *fields, const void *data)
+{
+	size_t size = 0;
+	if (data != NULL && fields != NULL &&
+		!pb_get_encoded_size(&size, fields, data))
+	{
+		return false;
+	}
+
+	// Encode straight into the end of the frame
+	const size_t start = frame->size;
+	const size_t maxSize = start + 2 * VARINT_MAX_SIZE + size;
+	if (frame->capacity < maxSize)
+	{
+		CArrayReserve(frame, MAX(maxSize, frame->capacity * 2));
+	}
+	pb_ostream_t stream = pb_ostream_from_buffer(
+		(uint8_t *)frame->data + start, maxSize - start);
+	if (!pb_encode_varint(&stream, (uint64_t)type) ||
+		!pb_encode_varint(&stream, (uint64_t)size))
+	{
+		return false;
+	}
+	if (size > 0 && !pb_encode(&stream, fields, data))
+	{
+		return false;
+	}
+	frame->size = start + stream.bytes_written;
+	return true;
+}
+
+bool NetFrameRead(
+	uint8_t *data, const size_t size, size_t *offset, NetMsg *msg)
+{
+	if (*offset >= size)
+	{
+		return false;
+	}
+	pb_istream_t stream = pb_istream_from_buffer(
+		data + *offset, size - *offset);
+	uint64_t type;
+	uint64_t len;
+	if (!pb_decode_varint(&stream, &type) ||
+		!pb_decode_varint(&stream, &len) ||
+		len > stream.bytes_left)
+	{
+		return false;
+	}
+	const size_t header = size - *offset - stream.bytes_left;
+	msg->Type = (int)type;
+	msg->Data = data + *offset + header;
+	msg->Size = (size_t)len;
+	*offset += header + msg->Size;
+	return true;
+}
+bool NetFrameIsValid(uint8_t *data, const size_t size)
+{
+	size_t offset = 0;
+	NetMsg msg;
+	while (NetFrameRead(data, size, &offset, &msg))
+	{
+	}
+	return offset == size;
+}
+
+bool NetMsgDecode(const NetMsg *msg, void *dest, const pb_field_t *fields)
+{
+	pb_istream_t stream = pb_istream_from_buffer(msg->Data, msg->Size);
+	return pb_decode(&stream, fields, dest);
+}
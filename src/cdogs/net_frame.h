@@ -0,0 +1,62 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "c_array.h"
+#include "proto/nanopb/pb.h"
+
+// Net messages are batched into frames, which are sent as one packet.
+// A frame is a stream of messages, each encoded as:
+// [varint message type][varint length][nanopb-encoded message]
+
+// Once a frame reaches this size it is sent, and a new one started;
+// this keeps most frames within a single datagram
+#define NET_FRAME_MAX_SIZE 1200
+
+// A message in a received frame
+typedef struct
+{
+	int Type;
+	uint8_t *Data;
+	size_t Size;
+} NetMsg;
+
+// Frames are CArrays of uint8_t
+void NetFrameInit(CArray *frame);
+bool NetFrameAppend(
+	CArray *frame, const int type, const pb_field_t *fields, const void *data);
+// Read the message at offset, and advance offset to the next message.
+// Returns false at the end of the frame, or if the frame is malformed
+bool NetFrameRead(
+	uint8_t *data, const size_t size, size_t *offset, NetMsg *msg);
+// Whether the frame is a whole number of well-formed messages; check before
+// handling frames from the network
+bool NetFrameIsValid(uint8_t *data, const size_t size);
+bool NetMsgDecode(const NetMsg *msg, void *dest, const pb_field_t *fields);
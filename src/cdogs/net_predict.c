@@ -0,0 +1,159 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_predict.h"
+
+#include <string.h>
+
+
+// Sequence numbers wrap; compare by difference
+static bool SeqBefore(const uint32_t a, const uint32_t b)
+{
+	return (int32_t)(a - b) < 0;
+}
+
+void NetPredictionReset(NetPrediction *p, const int actorUID)
+{
+	memset(p, 0, sizeof *p);
+	p->ActorUID = actorUID;
+}
+
+void NetPredictionAddMove(
+	NetPrediction *p, const uint32_t seq, const struct vec2 pos)
+{
+	if (p->moveCount == NET_PREDICT_MOVES)
+	{
+		p->moveHead = (p->moveHead + 1) % NET_PREDICT_MOVES;
+		p->moveCount--;
+	}
+	NetPredictMove *m =
+		&p->moves[(p->moveHead + p->moveCount) % NET_PREDICT_MOVES];
+	m->Seq = seq;
+	m->Pos = pos;
+	p->moveCount++;
+}
+
+void NetPredictionAddTick(
+	NetPrediction *p, const uint32_t seq, const struct vec2 delta)
+{
+	if (p->tickCount == NET_PREDICT_TICKS)
+	{
+		p->hasOverwritten = true;
+		p->overwrittenSeq = p->ticks[p->tickHead].Seq;
+		p->tickHead = (p->tickHead + 1) % NET_PREDICT_TICKS;
+		p->tickCount--;
+	}
+	NetPredictTick *t =
+		&p->ticks[(p->tickHead + p->tickCount) % NET_PREDICT_TICKS];
+	t->Seq = seq;
+	t->Delta = delta;
+	p->tickCount++;
+}
+
+bool NetPredictionAck(
+	NetPrediction *p, const uint32_t seq, struct vec2 *sentPos)
+{
+	// Drop moves before this one
+	while (p->moveCount > 0 && SeqBefore(p->moves[p->moveHead].Seq, seq))
+	{
+		p->moveHead = (p->moveHead + 1) % NET_PREDICT_MOVES;
+		p->moveCount--;
+	}
+	if (p->moveCount == 0 || p->moves[p->moveHead].Seq != seq)
+	{
+		return false;
+	}
+	*sentPos = p->moves[p->moveHead].Pos;
+
+	// Drop ticks before this move
+	while (p->tickCount > 0 && SeqBefore(p->ticks[p->tickHead].Seq, seq))
+	{
+		p->tickHead = (p->tickHead + 1) % NET_PREDICT_TICKS;
+		p->tickCount--;
+	}
+	// Can't replay if any ticks since this move have been overwritten
+	return !p->hasOverwritten || SeqBefore(p->overwrittenSeq, seq);
+}
+
+int NetPredictionNumTicks(const NetPrediction *p)
+{
+	return p->tickCount;
+}
+const NetPredictTick *NetPredictionGetTick(
+	const NetPrediction *p, const int i)
+{
+	return &p->ticks[(p->tickHead + i) % NET_PREDICT_TICKS];
+}
+
+
+void NetInterpReset(NetInterp *n)
+{
+	memset(n, 0, sizeof *n);
+}
+
+void NetInterpAdd(NetInterp *n, const int tick, const struct vec2 pos)
+{
+	if (n->count == NET_INTERP_SAMPLES)
+	{
+		n->head = (n->head + 1) % NET_INTERP_SAMPLES;
+		n->count--;
+	}
+	NetInterpSample *s =
+		&n->samples[(n->head + n->count) % NET_INTERP_SAMPLES];
+	s->Tick = tick;
+	s->Pos = pos;
+	n->count++;
+}
+
+bool NetInterpGet(const NetInterp *n, const int tick, struct vec2 *pos)
+{
+	if (n->count == 0)
+	{
+		return false;
+	}
+	const NetInterpSample *prev = &n->samples[n->head];
+	if (tick <= prev->Tick)
+	{
+		*pos = prev->Pos;
+		return true;
+	}
+	for (int i = 1; i < n->count; i++)
+	{
+		const NetInterpSample *next =
+			&n->samples[(n->head + i) % NET_INTERP_SAMPLES];
+		if (tick < next->Tick)
+		{
+			const float t =
+				(float)(tick - prev->Tick) / (float)(next->Tick - prev->Tick);
+			*pos = svec2_add(
+				prev->Pos,
+				svec2_scale(svec2_subtract(next->Pos, prev->Pos), t));
+			return true;
+		}
+		prev = next;
+	}
+	*pos = prev->Pos;
+	return true;
+}
@@ -0,0 +1,109 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mathc/mathc.h"
+
+// Client-side prediction of local players.
+// Clients move their own players immediately, and send each move to the
+// server tagged with a sequence number. The server checks the move and
+// acknowledges it with the position it accepted. If that differs from the
+// position the client sent, the client rewinds to the server position and
+// replays the movement it has made since that move.
+
+// Ticks of movement kept for replay; about 1.8s
+#define NET_PREDICT_TICKS 128
+// Sent moves awaiting acknowledgement
+#define NET_PREDICT_MOVES 32
+
+typedef struct
+{
+	uint32_t Seq;	// last move sent before this tick
+	struct vec2 Delta;	// movement attempted this tick
+} NetPredictTick;
+typedef struct
+{
+	uint32_t Seq;
+	struct vec2 Pos;
+} NetPredictMove;
+typedef struct
+{
+	int ActorUID;	// -1 if unused
+	NetPredictTick ticks[NET_PREDICT_TICKS];
+	int tickHead;	// index of oldest
+	int tickCount;
+	// Move of the newest tick that was overwritten
+	bool hasOverwritten;
+	uint32_t overwrittenSeq;
+	NetPredictMove moves[NET_PREDICT_MOVES];
+	int moveHead;
+	int moveCount;
+} NetPrediction;
+
+void NetPredictionReset(NetPrediction *p, const int actorUID);
+void NetPredictionAddMove(
+	NetPrediction *p, const uint32_t seq, const struct vec2 pos);
+void NetPredictionAddTick(
+	NetPrediction *p, const uint32_t seq, const struct vec2 delta);
+// Acknowledge a move; history before it is dropped.
+// Returns false if the move, or the ticks since it, are no longer kept.
+bool NetPredictionAck(
+	NetPrediction *p, const uint32_t seq, struct vec2 *sentPos);
+// Get the ticks since the last acknowledged move, oldest first
+int NetPredictionNumTicks(const NetPrediction *p);
+const NetPredictTick *NetPredictionGetTick(
+	const NetPrediction *p, const int i);
+
+// Interpolation of remote actors.
+// Positions received from the server are buffered, and actors are shown
+// at a fixed delay behind, between the two samples either side, so that
+// they move smoothly despite irregular updates.
+
+#define NET_INTERP_SAMPLES 8
+// A bit over two snapshot intervals, so there is usually a later sample
+#define NET_INTERP_DELAY_TICKS 8
+
+typedef struct
+{
+	int Tick;
+	struct vec2 Pos;
+} NetInterpSample;
+typedef struct
+{
+	NetInterpSample samples[NET_INTERP_SAMPLES];
+	int head;	// index of oldest
+	int count;
+} NetInterp;
+
+void NetInterpReset(NetInterp *n);
+// Samples must be added in tick order
+void NetInterpAdd(NetInterp *n, const int tick, const struct vec2 pos);
+// Get the position at a tick; clamped to the oldest and newest samples.
+// Returns false if there are no samples.
+bool NetInterpGet(const NetInterp *n, const int tick, struct vec2 *pos);
@@ -28,6 +28,7 @@
 */
 #include "net_server.h"
 
+#include <math.h>
 #include <string.h>
 
 #include "proto/nanopb/pb_encode.h"
@@ -41,6 +42,7 @@
 #include "handle_game_events.h"
 #include "log.h"
 #include "los.h"
+#include "objs.h"
 #include "pickup.h"
 #include "player.h"
 #include "sys_config.h"
@@ -48,14 +50,33 @@
 
 NetServer gNetServer;
 
+// Peers are sent positional events within this distance of their players,
+// or the sight range if larger
+#define NET_INTEREST_VIEW_RADIUS 320
+// Extra distance before things are considered out of view, so that things
+// at the edge don't flap in and out
+#define NET_INTEREST_MARGIN (TILE_WIDTH * 4)
+
 
 void NetServerInit(NetServer *n)
 {
 	memset(n, 0, sizeof *n);
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		NetFrameInit(&n->bcastFrames[i]);
+	}
+	NetSnapshotInit(&n->snapshot);
+	NetSnapshotInit(&n->peerSnapshot);
 }
 void NetServerTerminate(NetServer *n)
 {
 	NetServerClose(n);
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		CArrayTerminate(&n->bcastFrames[i]);
+	}
+	NetSnapshotTerminate(&n->snapshot);
+	NetSnapshotTerminate(&n->peerSnapshot);
 }
 void NetServerReset(NetServer *n)
 {
@@ -97,7 +118,8 @@ static ENetHost *HostOpen(void)
 	ENetAddress address;
 	address.host = ENET_HOST_ANY;
 	address.port = ENET_PORT_ANY;
-	ENetHost *host = enet_host_create(&address, NET_SERVER_MAX_CLIENTS, 2, 0, 0);
+	ENetHost *host = enet_host_create(
+		&address, NET_SERVER_MAX_CLIENTS, NET_CHANNEL_COUNT, 0, 0);
 	if (host == NULL)
 	{
 		LOG(LM_NET, LL_ERROR, "cannot create server host");
@@ -142,6 +164,7 @@ static bool ListenSocketTryOpen(ENetSocket *listen)
 	return true;
 }
 
+static void PeerDataTerminate(ENetPeer *peer);
 void NetServerClose(NetServer *n)
 {
 	if (n->server)
@@ -150,10 +173,31 @@ void NetServerClose(NetServer *n)
 		{
 			ENetPeer *peer = n->server->peers + i;
 			enet_peer_disconnect_now(peer, 0);
+			PeerDataTerminate(peer);
 		}
 		enet_host_destroy(n->server);
 	}
 	n->server = NULL;
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		CArrayClear(&n->bcastFrames[i]);
+		n->hasPeerFrames[i] = false;
+	}
+	// String ids are per server session
+	NetStringsClear(&gNetStrings);
+}
+static void PeerDataTerminate(ENetPeer *peer)
+{
+	NetPeerData *data = peer->data;
+	if (data == NULL) return;
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		CArrayTerminate(&data->Frames[i]);
+	}
+	NetSnapshotRingTerminate(&data->Snapshots);
+	UIDMapTerminate(&data->KnownBullets);
+	CFREE(data);
+	peer->data = NULL;
 }
 
 static void PollListener(NetServer *n);
@@ -262,25 +306,54 @@ static void PollListener(NetServer *n)
 		LOG(LM_NET, LL_ERROR, "Failed to reply to scanner");
 	}
 }
-static void OnConnect(NetServer *n, ENetEvent event);
+static void OnReceiveMsg(NetServer *n, ENetPeer *peer, const NetMsg *msg);
 static void OnReceive(NetServer *n, ENetEvent event)
 {
-	const GameEventType msg = (GameEventType)*(uint32_t *)event.packet->data;
+	// Drop malformed frames whole, rather than handle part of them
+	if (!NetFrameIsValid(event.packet->data, event.packet->dataLength))
+	{
+		LOG(LM_NET, LL_WARN, "dropping malformed net frame (%d bytes)",
+			(int)event.packet->dataLength);
+		enet_packet_destroy(event.packet);
+		return;
+	}
+	size_t offset = 0;
+	NetMsg msg;
+	while (NetFrameRead(
+		event.packet->data, event.packet->dataLength, &offset, &msg))
+	{
+		OnReceiveMsg(n, event.peer, &msg);
+	}
+	enet_packet_destroy(event.packet);
+}
+static void OnConnect(NetServer *n, ENetPeer *peer);
+static void OnReceiveMsg(NetServer *n, ENetPeer *peer, const NetMsg *msg)
+{
 	int peerId = -1;
-	if (event.peer->data != NULL)
+	if (peer->data != NULL)
 	{
 		// We may not have assigned peer ID
-		peerId = ((NetPeerData *)event.peer->data)->Id;
+		peerId = ((NetPeerData *)peer->data)->Id;
 		LOG(LM_NET, LL_TRACE, "recv message from peerId(%d) msg(%d)",
-			peerId, (int)msg);
+			peerId, msg->Type);
 	}
-	const GameEventEntry gee = GameEventGetEntry(msg);
+	if (msg->Type <= GAME_EVENT_NONE || msg->Type >= GAME_EVENT_COUNT)
+	{
+		LOG(LM_NET, LL_WARN, "dropping unknown msg(%d)", msg->Type);
+		return;
+	}
+	const GameEventEntry gee = GameEventGetEntry((GameEventType)msg->Type);
 	if (gee.Enqueue)
 	{
 		// Game event message; decode and add to event queue
 		LOG(LM_NET, LL_TRACE, "recv gameEvent(%d)", (int)gee.Type);
 		GameEvent e = GameEventNew(gee.Type);
-		NetDecode(event.packet, &e.u, gee.Fields);
+		if (gee.Fields != NULL &&
+			(!NetDecode(msg, &e.u, gee.Fields) ||
+			!NetMsgExpandStrings(gee.Type, &e.u)))
+		{
+			return;
+		}
 		GameEventsEnqueue(&gGameEvents, e);
 	}
 	else
@@ -288,7 +361,7 @@ static void OnReceive(NetServer *n, ENetEvent event)
 		switch (gee.Type)
 		{
 		case GAME_EVENT_CLIENT_CONNECT:
-			OnConnect(n, event);
+			OnConnect(n, peer);
 			break;
 		case GAME_EVENT_CLIENT_READY:
 			CASSERT(peerId >= 0, "peer id unset");
@@ -341,23 +414,46 @@ static void OnReceive(NetServer *n, ENetEvent event)
 
 			NetServerFlush(n);
 			break;
+		case GAME_EVENT_SNAPSHOT_ACK:
+			if (peer->data != NULL)
+			{
+				NetPeerData *data = peer->data;
+				NSnapshotAck ack;
+				if (!NetDecode(msg, &ack, NSnapshotAck_fields)) break;
+				if (ack.Seq > data->SnapshotAck && ack.Seq <= data->SnapshotSeq)
+				{
+					data->SnapshotAck = ack.Seq;
+				}
+			}
+			break;
 		default:
-			CASSERT(false, "unexpected message type");
+			LOG(LM_NET, LL_WARN, "dropping unexpected msg(%d)", msg->Type);
 			break;
 		}
 	}
-	enet_packet_destroy(event.packet);
 }
-static void OnConnect(NetServer *n, ENetEvent event)
+static void OnConnect(NetServer *n, ENetPeer *peer)
 {
 	char buf[256];
-	enet_address_get_host_ip(&event.peer->address, buf, sizeof buf);
+	enet_address_get_host_ip(&peer->address, buf, sizeof buf);
 	LOG(LM_NET, LL_INFO, "new client connected from %s:%u",
-		buf, event.peer->address.port);
+		buf, peer->address.port);
 	/* Store any relevant client information here. */
-	CMALLOC(event.peer->data, sizeof(NetPeerData));
+	NetPeerData *data;
+	CMALLOC(data, sizeof *data);
 	const int peerId = n->peerId;
-	((NetPeerData *)event.peer->data)->Id = peerId;
+	data->Id = peerId;
+	for (int i = 0; i < NET_DELIVERY_COUNT; i++)
+	{
+		NetFrameInit(&data->Frames[i]);
+	}
+	NetSnapshotRingInit(&data->Snapshots);
+	data->SnapshotsReady = false;
+	data->SnapshotSeq = 0;
+	data->SnapshotAck = 0;
+	data->NumFocus = 0;
+	UIDMapInit(&data->KnownBullets);
+	peer->data = data;
 	n->peerId++;
 
 	// Send the client ID
@@ -372,6 +468,16 @@ static void OnConnect(NetServer *n, ENetEvent event)
 	NCampaignDef def = NMakeCampaignDef(&gCampaign);
 	NetServerSendMsg(n, peerId, GAME_EVENT_CAMPAIGN_DEF, &def);
 
+	// Send the string ids assigned so far; new ones are broadcast as needed
+	LOG(LM_NET, LL_DEBUG, "NetServer: sending %d string ids",
+		(int)gNetStrings.names.size);
+	CA_FOREACH(const char *, name, gNetStrings.names)
+		NStringDef sd = NStringDef_init_default;
+		sd.Id = (uint32_t)_ca_index;
+		strcpy(sd.Name, *name);
+		NetServerSendMsg(n, peerId, GAME_EVENT_STRING_DEF, &sd);
+	CA_FOREACH_END()
+
 	SoundPlay(&gSoundDevice, StrSound("hahaha"));
 	LOG(LM_NET, LL_DEBUG, "NetServer: client connection complete");
 
@@ -383,8 +489,7 @@ static void OnDisconnect(const ENetEvent event)
 	if (event.peer->data != NULL)
 	{
 		peerId = ((NetPeerData *)event.peer->data)->Id;
-		CFREE(event.peer->data);
-		event.peer->data = NULL;
+		PeerDataTerminate(event.peer);
 	}
 	CASSERT(peerId >= 0, "Cannot find disconnected peer id");
 	char buf[256];
@@ -400,16 +505,231 @@ static void OnDisconnect(const ENetEvent event)
 	}
 }
 
+static void QueueBcastFrame(NetServer *n, const NetDelivery d);
+static void QueuePeerFrames(NetServer *n, const NetDelivery d);
 void NetServerFlush(NetServer *n)
 {
 	if (n->server == NULL) return;
+	for (NetDelivery d = 0; d < NET_DELIVERY_COUNT; d++)
+	{
+		QueueBcastFrame(n, d);
+		QueuePeerFrames(n, d);
+	}
 	enet_host_flush(n->server);
 }
+static void QueueBcastFrame(NetServer *n, const NetDelivery d)
+{
+	CArray *frame = &n->bcastFrames[d];
+	if (frame->size == 0) return;
+	enet_host_broadcast(n->server, (enet_uint8)d, NetFrameMakePacket(frame, d));
+}
+static void QueuePeerFrame(ENetPeer *peer, const NetDelivery d)
+{
+	NetPeerData *data = peer->data;
+	CArray *frame = &data->Frames[d];
+	if (frame->size == 0) return;
+	enet_peer_send(peer, (enet_uint8)d, NetFrameMakePacket(frame, d));
+}
+static void QueuePeerFrames(NetServer *n, const NetDelivery d)
+{
+	if (!n->hasPeerFrames[d]) return;
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		if (peer->data != NULL)
+		{
+			QueuePeerFrame(peer, d);
+		}
+	}
+	n->hasPeerFrames[d] = false;
+}
+
+static float InterestRadius(void);
+static bool PeerCanSee(
+	const NetPeerData *data, const struct vec2 pos, const float radius);
+static void UpdatePeerFocus(NetPeerData *data);
+static NAddBullet MakeAddBullet(const TMobileObject *o);
+static void SendPeerMsg(
+	NetServer *n, ENetPeer *peer, const GameEventType e, const void *data);
+static void SendPeerMsgBy(
+	NetServer *n, ENetPeer *peer, const GameEventType e, const void *data,
+	const NetDelivery d);
+void NetServerUpdateInterest(NetServer *n)
+{
+	if (n->server == NULL) return;
+	const float radius = InterestRadius();
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		NetPeerData *data = peer->data;
+		if (data == NULL || !data->SnapshotsReady) continue;
+		UpdatePeerFocus(data);
+		CA_FOREACH(const TMobileObject, o, gMobObjs)
+			if (!o->isInUse) continue;
+			const bool known = UIDMapGet(&data->KnownBullets, o->UID) >= 0;
+			if (!known && PeerCanSee(data, o->Pos, radius))
+			{
+				const NAddBullet ab = MakeAddBullet(o);
+				SendPeerMsg(n, peer, GAME_EVENT_ADD_BULLET, &ab);
+				UIDMapSet(&data->KnownBullets, o->UID, _ca_index);
+			}
+			else if (known &&
+				!PeerCanSee(data, o->Pos, radius + NET_INTEREST_MARGIN))
+			{
+				NRemoveBullet rb = NRemoveBullet_init_default;
+				rb.UID = o->UID;
+				SendPeerMsg(n, peer, GAME_EVENT_REMOVE_BULLET, &rb);
+				UIDMapRemove(&data->KnownBullets, o->UID);
+			}
+		CA_FOREACH_END()
+	}
+}
+static float InterestRadius(void)
+{
+	const float sightRange =
+		(float)ConfigGetInt(&gConfig, "Game.SightRange") * TILE_WIDTH;
+	return MAX(sightRange, NET_INTEREST_VIEW_RADIUS);
+}
+static bool PeerCanSee(
+	const NetPeerData *data, const struct vec2 pos, const float radius)
+{
+	if (data->NumFocus == 0) return true;
+	for (int i = 0; i < data->NumFocus; i++)
+	{
+		if (svec2_distance_squared(data->Focus[i], pos) < radius * radius)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+static void UpdatePeerFocus(NetPeerData *data)
+{
+	data->NumFocus = 0;
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+		// Peers' players have UIDs starting from (id + 1) * MAX_LOCAL_PLAYERS
+		if (p->UID / MAX_LOCAL_PLAYERS != data->Id + 1 || !IsPlayerAlive(p))
+		{
+			continue;
+		}
+		const TActor *a = ActorGetByUID(p->ActorUID);
+		if (a == NULL) continue;
+		data->Focus[data->NumFocus++] = a->Pos;
+	CA_FOREACH_END()
+}
+static NAddBullet MakeAddBullet(const TMobileObject *o)
+{
+	NAddBullet ab = NAddBullet_init_default;
+	ab.UID = o->UID;
+	strcpy(ab.BulletClass, o->bulletClass->Name);
+	ab.MuzzlePos = Vec2ToNet(o->Pos);
+	ab.MuzzleHeight = o->z;
+	// Inverse of the velocity calculation in BulletAdd
+	struct vec2 vel = o->tileItem.Vel;
+	if (!o->bulletClass->SpeedScale)
+	{
+		vel.y *= (float)TILE_WIDTH / TILE_HEIGHT;
+	}
+	ab.Angle = atan2f(vel.x, -vel.y);
+	ab.Elevation = o->dz;
+	ab.Flags = o->flags;
+	ab.PlayerUID = o->PlayerUID;
+	ab.ActorUID = o->ActorUID;
+	return ab;
+}
+
+// Filter the world snapshot to what the peer can see; entities already
+// sent in the base stay until they are past the margin
+static void FilterSnapshot(
+	NetSnapshot *dst, const NetSnapshot *src, const NetSnapshot *base,
+	const NetPeerData *data)
+{
+	NetSnapshotClear(dst);
+	const float radius = InterestRadius();
+	CA_FOREACH(const NetEntityState, e, src->Entities)
+		const bool known =
+			base != NULL && NetSnapshotGet(base, e->Kind, e->UID) != NULL;
+		const float r = known ? radius + NET_INTEREST_MARGIN : radius;
+		if (PeerCanSee(data, NetEntityStatePos(e), r))
+		{
+			NetSnapshotAdd(dst, e);
+		}
+	CA_FOREACH_END()
+}
+
+static void SendSnapshot(NetServer *n, ENetPeer *peer, const NetDelivery d);
+void NetServerSendSnapshots(NetServer *n, const int ticks)
+{
+	if (n->server == NULL) return;
+	n->snapshotTicks += ticks;
+	if (n->snapshotTicks < NET_SNAPSHOT_INTERVAL) return;
+	n->snapshotTicks = 0;
+
+	bool hasSnapshot = false;
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		const NetPeerData *data = peer->data;
+		if (data == NULL || !data->SnapshotsReady) continue;
+		if (!hasSnapshot)
+		{
+			NetSnapshotFromWorld(&n->snapshot);
+			hasSnapshot = true;
+		}
+		SendSnapshot(
+			n, peer, GameEventGetEntry(GAME_EVENT_SNAPSHOT).Delivery);
+	}
+}
+static void SendSnapshot(NetServer *n, ENetPeer *peer, const NetDelivery d)
+{
+	NetPeerData *data = peer->data;
+	const uint32_t seq = data->SnapshotSeq + 1;
+	// Send a delta against the last acknowledged snapshot if we still have
+	// it, otherwise a full baseline
+	const NetSnapshot *base = NULL;
+	if (seq - data->SnapshotAck < NET_SNAPSHOT_RING_SIZE)
+	{
+		base = NetSnapshotRingGet(&data->Snapshots, data->SnapshotAck);
+	}
+	FilterSnapshot(&n->peerSnapshot, &n->snapshot, base, data);
+	NetSnapshot *sent = NetSnapshotRingSlot(&data->Snapshots, seq);
+	NSnapshot s = NSnapshot_init_default;
+	s.Seq = seq;
+	s.BaseSeq = base != NULL ? base->Seq : 0;
+	size_t size;
+	if (!NetSnapshotDeltaEncode(
+		base, &n->peerSnapshot, seq, s.Data.bytes, NET_SNAPSHOT_MAX_SIZE, &size,
+		sent))
+	{
+		LOG(LM_NET, LL_ERROR, "failed to encode snapshot");
+		NetSnapshotClear(sent);
+		return;
+	}
+	s.Data.size = (pb_size_t)size;
+	data->SnapshotSeq = seq;
+	LOG(LM_NET, LL_TRACE, "send snapshot(%u) base(%u) size(%d) to peerId(%d)",
+		s.Seq, s.BaseSeq, (int)size, data->Id);
+	// Send pending broadcasts first to preserve message order
+	QueueBcastFrame(n, d);
+	SendPeerMsgBy(n, peer, GAME_EVENT_SNAPSHOT, &s, d);
+}
 
-static void SendConfig(
-	Config *config, const char *name, NetServer *n, const int peerId);
 void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 {
+	if (n->server == NULL) return;
+
+	// Start sending snapshots; the first will be a full baseline
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		NetPeerData *data = n->server->peers[i].data;
+		if (data != NULL && (peerId == NET_SERVER_BCAST || data->Id == peerId))
+		{
+			data->SnapshotsReady = true;
+			data->SnapshotAck = 0;
+			UIDMapClear(&data->KnownBullets);
+		}
+	}
+
 	// Send details of all current players
 	CA_FOREACH(const PlayerData, pOther, gPlayerDatas)
 		NPlayerData pd = NMakePlayerData(pOther);
@@ -419,12 +739,11 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 	CA_FOREACH_END()
 
 	// Send all game-specific config values
-	SendConfig(&gConfig, "Game.FriendlyFire", n, peerId);
-	SendConfig(&gConfig, "Game.FPS", n, peerId);
-	SendConfig(&gConfig, "Game.Ammo", n, peerId);
-	SendConfig(&gConfig, "Game.Fog", n, peerId);
-	SendConfig(&gConfig, "Game.SightRange", n, peerId);
-	SendConfig(&gConfig, "Game.AllyCollision", n, peerId);
+	for (const char **name = NetGameConfigs; *name != NULL; name++)
+	{
+		const NConfig c = NMakeConfig(&gConfig, *name);
+		NetServerSendMsg(n, peerId, GAME_EVENT_CONFIG, &c);
+	}
 
 	NetServerSendMsg(n, peerId, GAME_EVENT_NET_GAME_START, NULL);
 
@@ -554,45 +873,33 @@ void NetServerSendGameStartMessages(NetServer *n, const int peerId)
 		NMissionComplete mc = NMakeMissionComplete(&gMission, &gMap);
 		NetServerSendMsg(n, peerId, GAME_EVENT_MISSION_COMPLETE, &mc);
 	}
-}
-static void SendConfig(
-	Config *config, const char *name, NetServer *n, const int peerId)
-{
-	NConfig msg = NConfig_init_default;
-	const Config *c = ConfigGet(config, name);
-	strcpy(msg.Name, name);
-	switch (c->Type)
-	{
-	case CONFIG_TYPE_STRING:
-		CASSERT(false, "unimplemented");
-		break;
-	case CONFIG_TYPE_INT:
-		sprintf(msg.Value, "%d", c->u.Int.Value);
-		break;
-	case CONFIG_TYPE_FLOAT:
-		sprintf(msg.Value, "%f", c->u.Float.Value);
-		break;
-	case CONFIG_TYPE_BOOL:
-		strcpy(msg.Value, c->u.Bool.Value ? "true" : "false");
-		break;
-	case CONFIG_TYPE_ENUM:
-		sprintf(msg.Value, "%d", (int)c->u.Enum.Value);
-		break;
-	case CONFIG_TYPE_GROUP:
-		CASSERT(false, "Cannot send groups over net");
-		break;
-	default:
-		CASSERT(false, "Unknown config type");
-		break;
+
+	// Start from a full baseline of the entities' state, sent reliably after
+	// the entities are added; snapshots after it are deltas against it
+	NetSnapshotFromWorld(&n->snapshot);
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		const NetPeerData *data = peer->data;
+		if (data != NULL && (peerId == NET_SERVER_BCAST || data->Id == peerId))
+		{
+			SendSnapshot(n, peer, NET_DELIVERY_RELIABLE);
+		}
 	}
-	NetServerSendMsg(n, peerId, GAME_EVENT_CONFIG, &msg);
 }
 
+static bool IsInterestManaged(const GameEventType e);
+static void BroadcastByInterest(
+	NetServer *n, const GameEventType e, const void *data);
+static bool DefineStrings(
+	NetServer *n, const GameEventType e, const void *data);
 void NetServerSendMsg(
 	NetServer *n, const int peerId, const GameEventType e, const void *data)
 {
 	if (!n->server) return;
 
+	const NetDelivery d = GameEventGetEntry(e).Delivery;
+
 	if (peerId >= 0)
 	{
 		LOG(LM_NET, LL_TRACE, "send msg(%d) to peers(%d)",
@@ -601,19 +908,135 @@ void NetServerSendMsg(
 		for (int i = 0; i < (int)n->server->peerCount; i++)
 		{
 			ENetPeer *peer = n->server->peers + i;
-			if (peer->data != NULL &&
-				((NetPeerData *)peer->data)->Id == peerId)
+			NetPeerData *pData = peer->data;
+			if (pData != NULL && pData->Id == peerId)
 			{
-				enet_peer_send(peer, 0, NetEncode(e, data));
+				// Send pending broadcasts first to preserve message order
+				QueueBcastFrame(n, d);
+				SendPeerMsg(n, peer, e, data);
 				return;
 			}
 		}
 		CASSERT(false, "Cannot find peer by id");
 	}
+	else if (IsInterestManaged(e))
+	{
+		BroadcastByInterest(n, e, data);
+	}
 	else
 	{
 		LOG(LM_NET, LL_TRACE, "bcast msg(%d) to peers(%d)",
 			(int)e, (int)n->server->connectedPeers);
-		enet_host_broadcast(n->server, 0, NetEncode(e, data));
+		DefineStrings(n, e, data);
+		QueuePeerFrames(n, d);
+		NetFrameAppendMsg(&n->bcastFrames[d], e, data);
+		if (n->bcastFrames[d].size >= NET_FRAME_MAX_SIZE)
+		{
+			QueueBcastFrame(n, d);
+		}
+	}
+}
+static void SendPeerMsg(
+	NetServer *n, ENetPeer *peer, const GameEventType e, const void *data)
+{
+	SendPeerMsgBy(n, peer, e, data, GameEventGetEntry(e).Delivery);
+}
+static void SendPeerMsgBy(
+	NetServer *n, ENetPeer *peer, const GameEventType e, const void *data,
+	const NetDelivery d)
+{
+	if (DefineStrings(n, e, data))
+	{
+		// Definitions are broadcast; make sure they go first
+		QueueBcastFrame(n, NET_DELIVERY_RELIABLE);
+	}
+	NetPeerData *pData = peer->data;
+	NetFrameAppendMsg(&pData->Frames[d], e, data);
+	n->hasPeerFrames[d] = true;
+	if (pData->Frames[d].size >= NET_FRAME_MAX_SIZE)
+	{
+		QueuePeerFrame(peer, d);
+	}
+}
+static bool IsInterestManaged(const GameEventType e)
+{
+	switch (e)
+	{
+	case GAME_EVENT_SOUND_AT:
+	case GAME_EVENT_ADD_BULLET:
+	case GAME_EVENT_REMOVE_BULLET:
+	case GAME_EVENT_BULLET_BOUNCE:
+	case GAME_EVENT_GUN_FIRE:
+		return true;
+	default:
+		return false;
+	}
+}
+static void BroadcastByInterest(
+	NetServer *n, const GameEventType e, const void *data)
+{
+	const float radius = InterestRadius() + NET_INTEREST_MARGIN;
+	for (int i = 0; i < (int)n->server->peerCount; i++)
+	{
+		ENetPeer *peer = n->server->peers + i;
+		NetPeerData *pData = peer->data;
+		if (pData == NULL || !pData->SnapshotsReady) continue;
+		bool relevant = false;
+		switch (e)
+		{
+		case GAME_EVENT_SOUND_AT:
+			relevant = PeerCanSee(
+				pData, NetToVec2(((const NSound *)data)->Pos), radius);
+			break;
+		case GAME_EVENT_ADD_BULLET:
+			// Sent once the bullet is in view; see NetServerUpdateInterest
+			break;
+		case GAME_EVENT_REMOVE_BULLET:
+			{
+				const int uid = (int)((const NRemoveBullet *)data)->UID;
+				relevant = UIDMapGet(&pData->KnownBullets, uid) >= 0;
+				UIDMapRemove(&pData->KnownBullets, uid);
+			}
+			break;
+		case GAME_EVENT_BULLET_BOUNCE:
+			relevant = UIDMapGet(
+				&pData->KnownBullets,
+				(int)((const NBulletBounce *)data)->UID) >= 0;
+			break;
+		case GAME_EVENT_GUN_FIRE:
+			relevant = PeerCanSee(
+				pData, NetToVec2(((const NGunFire *)data)->MuzzlePos), radius);
+			break;
+		default:
+			CASSERT(false, "unexpected interest managed message");
+			break;
+		}
+		if (relevant)
+		{
+			SendPeerMsg(n, peer, e, data);
+		}
+	}
+}
+static bool DefineStrings(
+	NetServer *n, const GameEventType e, const void *data)
+{
+	// Assign ids to names that don't have them yet, and broadcast them so
+	// that every client has the same ids
+	const char *names[NET_MSG_STRINGS_MAX];
+	const int count = NetMsgGetStrings(e, data, names);
+	bool defined = false;
+	for (int i = 0; i < count; i++)
+	{
+		if (strlen(names[i]) == 0 ||
+			NetStringsGetId(&gNetStrings, names[i]) >= 0)
+		{
+			continue;
+		}
+		NStringDef sd = NStringDef_init_default;
+		sd.Id = NetStringsAdd(&gNetStrings, names[i]);
+		strcpy(sd.Name, names[i]);
+		NetServerSendMsg(n, -1, GAME_EVENT_STRING_DEF, &sd);
+		defined = true;
 	}
+	return defined;
 }
@@ -32,6 +32,7 @@
 
 #include "c_array.h"
 #include "net_util.h"
+#include "uid_map.h"
 
 
 #define NET_SERVER_MAX_CLIENTS 32
@@ -47,6 +48,16 @@ typedef struct
 	int PrevCmd;
 	int Cmd;
 	int peerId;	// auto-incrementing id for the next connected peer
+	// Outgoing messages are batched into frames, sent on flush;
+	// one frame per delivery class
+	CArray bcastFrames[NET_DELIVERY_COUNT];	// of uint8_t
+	// Whether any peer frames have messages
+	bool hasPeerFrames[NET_DELIVERY_COUNT];
+	// Current world state, sent to each peer as a delta
+	NetSnapshot snapshot;
+	// World state filtered by what a peer can see
+	NetSnapshot peerSnapshot;
+	int snapshotTicks;
 } NetServer;
 
 extern NetServer gNetServer;
@@ -54,6 +65,18 @@ extern NetServer gNetServer;
 typedef struct
 {
 	int Id;
+	// Messages for this peer only, per delivery class
+	CArray Frames[NET_DELIVERY_COUNT];	// of uint8_t
+	// Snapshots sent to this peer, kept as delta bases
+	NetSnapshotRing Snapshots;
+	bool SnapshotsReady;	// whether the peer has the game start state
+	uint32_t SnapshotSeq;	// last sent
+	uint32_t SnapshotAck;	// last acknowledged; 0 if none
+	// Interest management: where this peer's players can see from, and the
+	// bullets that the peer has been told about
+	struct vec2 Focus[MAX_LOCAL_PLAYERS];
+	int NumFocus;	// 0 if no players alive; the peer sees everything
+	UIDMap KnownBullets;	// UID -> mobobj slot
 } NetPeerData;
 
 void NetServerInit(NetServer *n);
@@ -66,8 +89,15 @@ void NetServerClose(NetServer *n);
 // Service the recv buffer; if data is received then activate this device
 void NetServerPoll(NetServer *n);
 void NetServerFlush(NetServer *n);
+// Update what each peer can see, and tell peers about bullets that come
+// into or go out of view
+void NetServerUpdateInterest(NetServer *n);
+// Send world snapshots to peers, at NET_SNAPSHOT_INTERVAL
+void NetServerSendSnapshots(NetServer *n, const int ticks);
 
-// If peerId is -1, broadcast
+// Queue a message to be sent on the next flush
+// If peerId is -1, broadcast; positional events such as bullets and sounds
+// are only sent to peers that can see them
 void NetServerSendMsg(
 	NetServer *n, const int peerId, const GameEventType e, const void *data);
 
@@ -0,0 +1,388 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_snapshot.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "proto/nanopb/pb_decode.h"
+#include "proto/nanopb/pb_encode.h"
+#include "utils.h"
+
+// Largest encoded record: 3 varints and a 64-bit svarint per field
+#define RECORD_MAX_SIZE (10 * (3 + NET_SNAPSHOT_FIELDS))
+
+// A change to an entity, relative to a base snapshot
+typedef struct
+{
+	NetEntityState State;
+	bool Removed;
+	bool Included;
+} Change;
+
+
+void NetSnapshotInit(NetSnapshot *s)
+{
+	s->Seq = 0;
+	CArrayInit(&s->Entities, sizeof(NetEntityState));
+}
+void NetSnapshotTerminate(NetSnapshot *s)
+{
+	CArrayTerminate(&s->Entities);
+}
+void NetSnapshotClear(NetSnapshot *s)
+{
+	s->Seq = 0;
+	CArrayClear(&s->Entities);
+}
+
+void NetSnapshotAdd(NetSnapshot *s, const NetEntityState *e)
+{
+	CArrayPushBack(&s->Entities, e);
+}
+
+static int CompareKey(
+	const NetSnapshotKind kind1, const int uid1,
+	const NetSnapshotKind kind2, const int uid2)
+{
+	if (kind1 != kind2) return kind1 < kind2 ? -1 : 1;
+	if (uid1 != uid2) return uid1 < uid2 ? -1 : 1;
+	return 0;
+}
+static int CompareEntity(const void *v1, const void *v2)
+{
+	const NetEntityState *e1 = v1;
+	const NetEntityState *e2 = v2;
+	return CompareKey(e1->Kind, e1->UID, e2->Kind, e2->UID);
+}
+void NetSnapshotSort(NetSnapshot *s)
+{
+	qsort(s->Entities.data, s->Entities.size, s->Entities.elemSize,
+		CompareEntity);
+}
+
+const NetEntityState *NetSnapshotGet(
+	const NetSnapshot *s, const NetSnapshotKind kind, const int uid)
+{
+	const NetEntityState key = { kind, uid, { 0 } };
+	return bsearch(&key, s->Entities.data, s->Entities.size,
+		s->Entities.elemSize, CompareEntity);
+}
+
+// Get the entity at index i, or NULL if past the end
+static const NetEntityState *EntityAt(const NetSnapshot *s, const size_t i)
+{
+	if (s == NULL || i >= s->Entities.size) return NULL;
+	return CArrayGet(&s->Entities, i);
+}
+
+static uint32_t FieldMask(const NetEntityState *base, const NetEntityState *e)
+{
+	uint32_t mask = 0;
+	for (int i = 0; i < NET_SNAPSHOT_FIELDS; i++)
+	{
+		const int32_t baseField = base != NULL ? base->Fields[i] : 0;
+		if (e->Fields[i] != baseField)
+		{
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+
+// Merge the changes (sorted) into base to make out; changes that are not
+// included are skipped
+static void ApplyChanges(
+	const NetSnapshot *base, const CArray *changes, NetSnapshot *out)
+{
+	CArrayClear(&out->Entities);
+	size_t bi = 0;
+	size_t ci = 0;
+	for (;;)
+	{
+		const NetEntityState *b = EntityAt(base, bi);
+		const Change *c = ci < changes->size ? CArrayGet(changes, ci) : NULL;
+		if (b == NULL && c == NULL)
+		{
+			break;
+		}
+		const int cmp = b == NULL ? 1 : c == NULL ? -1 :
+			CompareKey(b->Kind, b->UID, c->State.Kind, c->State.UID);
+		if (cmp < 0)
+		{
+			// Unchanged
+			CArrayPushBack(&out->Entities, b);
+			bi++;
+			continue;
+		}
+		if (cmp == 0)
+		{
+			bi++;
+		}
+		ci++;
+		if (!c->Included)
+		{
+			// Keep the base state, if any
+			if (cmp == 0)
+			{
+				CArrayPushBack(&out->Entities, b);
+			}
+		}
+		else if (!c->Removed)
+		{
+			CArrayPushBack(&out->Entities, &c->State);
+		}
+	}
+}
+
+static bool EncodeRecord(
+	pb_ostream_t *stream, const NetEntityState *base, const Change *c)
+{
+	const uint64_t header = ((uint64_t)c->State.Kind << 1) | c->Removed;
+	if (!pb_encode_varint(stream, header) ||
+		!pb_encode_varint(stream, (uint64_t)c->State.UID))
+	{
+		return false;
+	}
+	if (c->Removed)
+	{
+		return true;
+	}
+	const uint32_t mask = FieldMask(base, &c->State);
+	if (!pb_encode_varint(stream, mask))
+	{
+		return false;
+	}
+	for (int i = 0; i < NET_SNAPSHOT_FIELDS; i++)
+	{
+		if (!(mask & (1u << i))) continue;
+		const int64_t baseField = base != NULL ? base->Fields[i] : 0;
+		if (!pb_encode_svarint(stream, c->State.Fields[i] - baseField))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool NetSnapshotDeltaEncode(
+	const NetSnapshot *base, const NetSnapshot *cur, const uint32_t seq,
+	uint8_t *buf, const size_t maxSize, size_t *size, NetSnapshot *out)
+{
+	CASSERT(base != out && cur != out, "cannot encode snapshot in place");
+
+	// Find the changed entities
+	CArray changes;
+	CArrayInit(&changes, sizeof(Change));
+	size_t bi = 0;
+	size_t ci = 0;
+	for (;;)
+	{
+		const NetEntityState *b = EntityAt(base, bi);
+		const NetEntityState *e = EntityAt(cur, ci);
+		if (b == NULL && e == NULL)
+		{
+			break;
+		}
+		const int cmp = b == NULL ? 1 : e == NULL ? -1 :
+			CompareKey(b->Kind, b->UID, e->Kind, e->UID);
+		Change c;
+		memset(&c, 0, sizeof c);
+		if (cmp < 0)
+		{
+			c.State = *b;
+			c.Removed = true;
+			CArrayPushBack(&changes, &c);
+			bi++;
+			continue;
+		}
+		if (cmp > 0 || FieldMask(b, e) != 0)
+		{
+			c.State = *e;
+			CArrayPushBack(&changes, &c);
+		}
+		if (cmp == 0)
+		{
+			bi++;
+		}
+		ci++;
+	}
+
+	// Write as many changes as will fit
+	pb_ostream_t stream = pb_ostream_from_buffer(buf, maxSize);
+	bool ok = true;
+	for (size_t i = 0; i < changes.size; i++)
+	{
+		Change *c = CArrayGet(&changes, (i + seq) % changes.size);
+		const NetEntityState *cb =
+			base != NULL ? NetSnapshotGet(base, c->State.Kind, c->State.UID) :
+			NULL;
+		uint8_t record[RECORD_MAX_SIZE];
+		pb_ostream_t rs = pb_ostream_from_buffer(record, sizeof record);
+		if (!EncodeRecord(&rs, cb, c))
+		{
+			ok = false;
+			break;
+		}
+		if (stream.bytes_written + rs.bytes_written > maxSize)
+		{
+			continue;
+		}
+		if (!pb_write(&stream, record, rs.bytes_written))
+		{
+			ok = false;
+			break;
+		}
+		c->Included = true;
+	}
+	*size = stream.bytes_written;
+
+	ApplyChanges(base, &changes, out);
+	out->Seq = seq;
+	CArrayTerminate(&changes);
+	return ok;
+}
+
+bool NetSnapshotDeltaDecode(
+	const NetSnapshot *base, uint8_t *buf, const size_t size,
+	const uint32_t seq, NetSnapshot *out, CArray *changed)
+{
+	CASSERT(base != out, "cannot decode snapshot in place");
+
+	CArray changes;
+	CArrayInit(&changes, sizeof(Change));
+	pb_istream_t stream = pb_istream_from_buffer(buf, size);
+	bool ok = true;
+	while (stream.bytes_left > 0)
+	{
+		uint64_t header;
+		uint64_t uid;
+		if (!pb_decode_varint(&stream, &header) ||
+			!pb_decode_varint(&stream, &uid))
+		{
+			ok = false;
+			break;
+		}
+		if ((header >> 1) >= NET_SNAPSHOT_KIND_COUNT || uid > INT_MAX)
+		{
+			ok = false;
+			break;
+		}
+		Change c;
+		memset(&c, 0, sizeof c);
+		c.State.Kind = (NetSnapshotKind)(header >> 1);
+		c.State.UID = (int)uid;
+		c.Removed = (header & 1) != 0;
+		c.Included = true;
+		if (!c.Removed)
+		{
+			const NetEntityState *cb = base != NULL ?
+				NetSnapshotGet(base, c.State.Kind, c.State.UID) : NULL;
+			if (cb != NULL)
+			{
+				memcpy(c.State.Fields, cb->Fields, sizeof c.State.Fields);
+			}
+			uint64_t mask;
+			if (!pb_decode_varint(&stream, &mask))
+			{
+				ok = false;
+				break;
+			}
+			for (int i = 0; i < NET_SNAPSHOT_FIELDS && ok; i++)
+			{
+				if (!(mask & (1u << i))) continue;
+				int64_t delta;
+				ok = pb_decode_svarint(&stream, &delta);
+				c.State.Fields[i] = (int32_t)(c.State.Fields[i] + delta);
+			}
+			if (!ok) break;
+		}
+		CArrayPushBack(&changes, &c);
+	}
+
+	if (ok)
+	{
+		qsort(changes.data, changes.size, changes.elemSize, CompareEntity);
+		// Each entity can only change once per delta
+		for (size_t i = 1; i < changes.size && ok; i++)
+		{
+			ok = CompareEntity(
+				CArrayGet(&changes, i - 1), CArrayGet(&changes, i)) != 0;
+		}
+	}
+	if (ok)
+	{
+		ApplyChanges(base, &changes, out);
+		out->Seq = seq;
+		if (changed != NULL)
+		{
+			CArrayClear(changed);
+			CA_FOREACH(const Change, c, changes)
+				if (!c->Removed)
+				{
+					CArrayPushBack(changed, &c->State);
+				}
+			CA_FOREACH_END()
+		}
+	}
+	CArrayTerminate(&changes);
+	return ok;
+}
+
+void NetSnapshotRingInit(NetSnapshotRing *r)
+{
+	for (int i = 0; i < NET_SNAPSHOT_RING_SIZE; i++)
+	{
+		NetSnapshotInit(&r->Snapshots[i]);
+	}
+}
+void NetSnapshotRingTerminate(NetSnapshotRing *r)
+{
+	for (int i = 0; i < NET_SNAPSHOT_RING_SIZE; i++)
+	{
+		NetSnapshotTerminate(&r->Snapshots[i]);
+	}
+}
+void NetSnapshotRingClear(NetSnapshotRing *r)
+{
+	for (int i = 0; i < NET_SNAPSHOT_RING_SIZE; i++)
+	{
+		NetSnapshotClear(&r->Snapshots[i]);
+	}
+}
+
+NetSnapshot *NetSnapshotRingGet(NetSnapshotRing *r, const uint32_t seq)
+{
+	NetSnapshot *s = &r->Snapshots[seq % NET_SNAPSHOT_RING_SIZE];
+	return seq != 0 && s->Seq == seq ? s : NULL;
+}
+NetSnapshot *NetSnapshotRingSlot(NetSnapshotRing *r, const uint32_t seq)
+{
+	NetSnapshot *s = &r->Snapshots[seq % NET_SNAPSHOT_RING_SIZE];
+	NetSnapshotClear(s);
+	return s;
+}
@@ -0,0 +1,103 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "c_array.h"
+
+// Snapshots are the replicated state of the world's entities at a tick.
+// The server keeps the snapshots it has sent to each client, and sends new
+// ones as field-level deltas against the last one the client acknowledged.
+//
+// Delta format: a stream of records, one per changed entity:
+// [varint kind << 1 | removed][varint UID]
+// if not removed: [varint changed field mask][svarint field delta]...
+// Field deltas are against the base state, or 0 if the entity is new.
+
+#define NET_SNAPSHOT_FIELDS 7
+// Snapshots retained for use as delta bases
+#define NET_SNAPSHOT_RING_SIZE 32
+
+typedef enum
+{
+	NET_SNAPSHOT_ACTOR,
+	NET_SNAPSHOT_OBJECT,
+	NET_SNAPSHOT_PICKUP,
+	NET_SNAPSHOT_KIND_COUNT
+} NetSnapshotKind;
+
+typedef struct
+{
+	NetSnapshotKind Kind;
+	int UID;
+	int32_t Fields[NET_SNAPSHOT_FIELDS];
+} NetEntityState;
+
+typedef struct
+{
+	uint32_t Seq;	// 0 if unused
+	CArray Entities;	// of NetEntityState, sorted by kind then UID
+} NetSnapshot;
+
+typedef struct
+{
+	NetSnapshot Snapshots[NET_SNAPSHOT_RING_SIZE];
+} NetSnapshotRing;
+
+void NetSnapshotInit(NetSnapshot *s);
+void NetSnapshotTerminate(NetSnapshot *s);
+void NetSnapshotClear(NetSnapshot *s);
+// Entities can be added in any order; sort before use
+void NetSnapshotAdd(NetSnapshot *s, const NetEntityState *e);
+void NetSnapshotSort(NetSnapshot *s);
+const NetEntityState *NetSnapshotGet(
+	const NetSnapshot *s, const NetSnapshotKind kind, const int uid);
+
+// Encode cur as a delta against base (NULL for a full baseline), into at
+// most maxSize bytes. Changes that don't fit are left out, to be sent in a
+// later delta; the start point rotates with seq so that no entity starves.
+// out is set to the snapshot that the receiver will decode, with seq.
+bool NetSnapshotDeltaEncode(
+	const NetSnapshot *base, const NetSnapshot *cur, const uint32_t seq,
+	uint8_t *buf, const size_t maxSize, size_t *size, NetSnapshot *out);
+// Decode a delta against base (NULL for baseline) into out, with seq.
+// If changed is not NULL, it is filled with the entity states that were
+// added or updated (of NetEntityState).
+// Fails on malformed deltas, including unknown kinds and repeated entities.
+bool NetSnapshotDeltaDecode(
+	const NetSnapshot *base, uint8_t *buf, const size_t size,
+	const uint32_t seq, NetSnapshot *out, CArray *changed);
+
+void NetSnapshotRingInit(NetSnapshotRing *r);
+void NetSnapshotRingTerminate(NetSnapshotRing *r);
+void NetSnapshotRingClear(NetSnapshotRing *r);
+// Returns the snapshot with seq, or NULL if it is not (or no longer) held
+NetSnapshot *NetSnapshotRingGet(NetSnapshotRing *r, const uint32_t seq);
+// Returns the slot to store snapshot seq in, evicting an older one
+NetSnapshot *NetSnapshotRingSlot(NetSnapshotRing *r, const uint32_t seq);
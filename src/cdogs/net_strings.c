@@ -0,0 +1,104 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "net_strings.h"
+
+#include <string.h>
+
+#include "utils.h"
+
+NetStrings gNetStrings;
+
+
+void NetStringsInit(NetStrings *s)
+{
+	CArrayInit(&s->names, sizeof(char *));
+	s->ids = hashmap_new();
+}
+void NetStringsTerminate(NetStrings *s)
+{
+	NetStringsClear(s);
+	CArrayTerminate(&s->names);
+	hashmap_free(s->ids);
+	s->ids = NULL;
+}
+void NetStringsClear(NetStrings *s)
+{
+	CA_FOREACH(char *, name, s->names)
+		CFREE(*name);
+	CA_FOREACH_END()
+	CArrayClear(&s->names);
+	hashmap_free(s->ids);
+	s->ids = hashmap_new();
+}
+
+int NetStringsGetId(const NetStrings *s, const char *name)
+{
+	any_t id;
+	if (hashmap_get(s->ids, name, &id) != MAP_OK)
+	{
+		return -1;
+	}
+	return (int)(intptr_t)id;
+}
+const char *NetStringsGetName(const NetStrings *s, const uint32_t id)
+{
+	if (id >= s->names.size)
+	{
+		return NULL;
+	}
+	return *(char **)CArrayGet(&s->names, id);
+}
+
+uint32_t NetStringsAdd(NetStrings *s, const char *name)
+{
+	const uint32_t id = (uint32_t)s->names.size;
+	NetStringsSet(s, id, name);
+	return id;
+}
+bool NetStringsSet(NetStrings *s, const uint32_t id, const char *name)
+{
+	if (id > NET_STRINGS_MAX_ID)
+	{
+		return false;
+	}
+	// Ids normally arrive in order, but leave gaps undefined otherwise
+	while (s->names.size <= id)
+	{
+		char *empty = NULL;
+		CArrayPushBack(&s->names, &empty);
+	}
+	char **slot = CArrayGet(&s->names, id);
+	if (*slot != NULL)
+	{
+		hashmap_remove(s->ids, *slot);
+		CFREE(*slot);
+	}
+	CSTRDUP(*slot, name);
+	// Replace any other id for the same name
+	hashmap_remove(s->ids, *slot);
+	hashmap_put(s->ids, *slot, (any_t)(intptr_t)id);
+	return true;
+}
@@ -0,0 +1,61 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "c_array.h"
+#include "c_hashmap/hashmap.h"
+
+// Table of strings, such as class names, that are sent over the network as
+// small numeric ids instead of the strings themselves.
+// The server assigns ids as names are first sent, and sends each new
+// definition to clients (GAME_EVENT_STRING_DEF) ahead of its first use;
+// both ends resolve ids and names in constant time.
+typedef struct
+{
+	CArray names;	// of char *, indexed by id
+	map_t ids;	// name -> id
+} NetStrings;
+// Ids from the network above this are rejected, so that a bad id can't make
+// the table grow without bound
+#define NET_STRINGS_MAX_ID 65535
+extern NetStrings gNetStrings;
+
+void NetStringsInit(NetStrings *s);
+void NetStringsTerminate(NetStrings *s);
+void NetStringsClear(NetStrings *s);
+
+// Returns the id of the name, or -1 if it is not in the table
+int NetStringsGetId(const NetStrings *s, const char *name);
+// Returns the name with the id, or NULL if not defined
+const char *NetStringsGetName(const NetStrings *s, const uint32_t id);
+// Add the name with the next id, and return the id
+uint32_t NetStringsAdd(NetStrings *s, const char *name);
+// Define the name for an id, as received from the server.
+// Returns false if the id is out of range
+bool NetStringsSet(NetStrings *s, const uint32_t id, const char *name);
@@ -28,34 +28,145 @@
 */
 #include "net_util.h"
 
-#include "proto/nanopb/pb_decode.h"
-#include "proto/nanopb/pb_encode.h"
+#include <math.h>
+#include <stddef.h>
 
+#include "actors.h"
+#include "log.h"
+#include "objs.h"
+#include "pickup.h"
 
-ENetPacket *NetEncode(const GameEventType e, const void *data)
+
+void NetFrameAppendMsg(CArray *frame, const GameEventType e, const void *data)
 {
-	uint8_t buffer[1024];
-	pb_ostream_t stream = pb_ostream_from_buffer(buffer, sizeof buffer);
-	const pb_field_t *fields = GameEventGetEntry(e).Fields;
-	const bool status =
-		(data && fields) ? pb_encode(&stream, fields, data) : true;
+	GameEvent compact;
+	if (NetMsgCompactStrings(e, data, &compact))
+	{
+		data = &compact.u;
+	}
+	const bool status = NetFrameAppend(
+		frame, (int)e, GameEventGetEntry(e).Fields, data);
 	CASSERT(status, "Failed to encode pb");
-	int msgId = (int)e;
-	ENetPacket *packet = enet_packet_create(
-		&msgId, NET_MSG_SIZE + stream.bytes_written,
-		ENET_PACKET_FLAG_RELIABLE);
-	memcpy(packet->data + NET_MSG_SIZE, buffer, stream.bytes_written);
+}
+
+ENetPacket *NetFrameMakePacket(CArray *frame, const NetDelivery d)
+{
+	enet_uint32 flags = 0;
+	switch (d)
+	{
+	case NET_DELIVERY_RELIABLE:
+		flags = ENET_PACKET_FLAG_RELIABLE;
+		break;
+	case NET_DELIVERY_SEQUENCED:
+		// Unreliable packets are sequenced per channel by default
+		break;
+	case NET_DELIVERY_UNSEQUENCED:
+		flags = ENET_PACKET_FLAG_UNSEQUENCED;
+		break;
+	default:
+		CASSERT(false, "unknown net delivery");
+		break;
+	}
+	ENetPacket *packet = enet_packet_create(frame->data, frame->size, flags);
+	CArrayClear(frame);
 	return packet;
 }
 
-bool NetDecode(
-	ENetPacket *packet, void *dest, const pb_field_t *fields)
+bool NetDecode(const NetMsg *msg, void *dest, const pb_field_t *fields)
+{
+	if (!NetMsgDecode(msg, dest, fields))
+	{
+		LOG(LM_NET, LL_WARN, "failed to decode msg(%d) (%d bytes)",
+			msg->Type, (int)msg->Size);
+		return false;
+	}
+	return true;
+}
+
+// Message string fields that have an optional id field alongside,
+// named <field>Id
+typedef struct
 {
-	pb_istream_t stream = pb_istream_from_buffer(
-		packet->data + NET_MSG_SIZE, packet->dataLength - NET_MSG_SIZE);
-	bool status = pb_decode(&stream, fields, dest);
-	CASSERT(status, "Failed to decode pb");
-	return status;
+	GameEventType Type;
+	size_t MsgSize;
+	size_t Name;
+	size_t HasId;
+	size_t Id;
+} NetStringField;
+#define NET_STRING_FIELD(_e, _msg, _field)\
+	{\
+		_e, sizeof(_msg), offsetof(_msg, _field),\
+		offsetof(_msg, has_##_field##Id), offsetof(_msg, _field##Id)\
+	}
+static const NetStringField sNetStringFields[] =
+{
+	NET_STRING_FIELD(GAME_EVENT_TILE_SET, NTileSet, PicName),
+	NET_STRING_FIELD(GAME_EVENT_TILE_SET, NTileSet, PicAltName),
+	NET_STRING_FIELD(GAME_EVENT_MAP_OBJECT_ADD, NMapObjectAdd, MapObjectClass),
+	NET_STRING_FIELD(GAME_EVENT_SOUND_AT, NSound, Sound),
+	NET_STRING_FIELD(GAME_EVENT_ADD_PICKUP, NAddPickup, PickupClass),
+	NET_STRING_FIELD(GAME_EVENT_GUN_FIRE, NGunFire, Gun),
+	NET_STRING_FIELD(GAME_EVENT_ADD_BULLET, NAddBullet, BulletClass),
+	{ GAME_EVENT_NONE, 0, 0, 0, 0 }
+};
+int NetMsgGetStrings(
+	const GameEventType e, const void *data,
+	const char *names[NET_MSG_STRINGS_MAX])
+{
+	int count = 0;
+	for (const NetStringField *f = sNetStringFields; f->MsgSize > 0; f++)
+	{
+		if (f->Type != e) continue;
+		CASSERT(count < NET_MSG_STRINGS_MAX, "too many net strings");
+		names[count++] = (const char *)data + f->Name;
+	}
+	return count;
+}
+bool NetMsgCompactStrings(
+	const GameEventType e, const void *data, GameEvent *out)
+{
+	bool copied = false;
+	for (const NetStringField *f = sNetStringFields; f->MsgSize > 0; f++)
+	{
+		if (f->Type != e) continue;
+		if (!copied)
+		{
+			memcpy(&out->u, data, f->MsgSize);
+			copied = true;
+		}
+		char *msg = (char *)&out->u;
+		char *name = msg + f->Name;
+		const int id = NetStringsGetId(&gNetStrings, name);
+		// Always set; message structs are not always zero-initialised
+		*(bool *)(msg + f->HasId) = id >= 0;
+		if (id >= 0)
+		{
+			*(uint32_t *)(msg + f->Id) = (uint32_t)id;
+			name[0] = '\0';
+		}
+	}
+	return copied;
+}
+bool NetMsgExpandStrings(const GameEventType e, void *data)
+{
+	for (const NetStringField *f = sNetStringFields; f->MsgSize > 0; f++)
+	{
+		if (f->Type != e) continue;
+		char *msg = data;
+		bool *hasId = (bool *)(msg + f->HasId);
+		if (!*hasId) continue;
+		const uint32_t id = *(const uint32_t *)(msg + f->Id);
+		const char *name = NetStringsGetName(&gNetStrings, id);
+		if (name == NULL)
+		{
+			LOG(LM_NET, LL_WARN, "unknown net string id(%u) in msg(%d)",
+				id, (int)e);
+			return false;
+		}
+		strcpy(msg + f->Name, name);
+		*hasId = false;
+	}
+	return true;
 }
 
 
@@ -79,6 +190,19 @@ NPlayerData NMakePlayerData(const PlayerData *p)
 	d.UID = p->UID;
 	return d;
 }
+const char *NetGameConfigs[] =
+{
+	"Game.FriendlyFire",
+	"Game.FPS",
+	"Game.Ammo",
+	"Game.Fog",
+	"Game.SightRange",
+	"Game.FOV",
+	"Game.AIBudget",
+	"Game.AllyCollision",
+	NULL
+};
+
 NCampaignDef NMakeCampaignDef(const CampaignOptions *co)
 {
 	NCampaignDef def;
@@ -91,6 +215,37 @@ NCampaignDef NMakeCampaignDef(const CampaignOptions *co)
 	def.Mission = co->MissionIndex;
 	return def;
 }
+NConfig NMakeConfig(Config *config, const char *name)
+{
+	NConfig msg = NConfig_init_default;
+	const Config *c = ConfigGet(config, name);
+	strcpy(msg.Name, name);
+	switch (c->Type)
+	{
+	case CONFIG_TYPE_STRING:
+		CASSERT(false, "unimplemented");
+		break;
+	case CONFIG_TYPE_INT:
+		sprintf(msg.Value, "%d", c->u.Int.Value);
+		break;
+	case CONFIG_TYPE_FLOAT:
+		sprintf(msg.Value, "%f", c->u.Float.Value);
+		break;
+	case CONFIG_TYPE_BOOL:
+		strcpy(msg.Value, c->u.Bool.Value ? "true" : "false");
+		break;
+	case CONFIG_TYPE_ENUM:
+		sprintf(msg.Value, "%d", (int)c->u.Enum.Value);
+		break;
+	case CONFIG_TYPE_GROUP:
+		CASSERT(false, "Cannot send groups over net");
+		break;
+	default:
+		CASSERT(false, "Unknown config type");
+		break;
+	}
+	return msg;
+}
 NMissionComplete NMakeMissionComplete(
 	const struct MissionOptions *mo, const Map *map)
 {
@@ -158,3 +313,126 @@ CharColors Net2CharColors(const NCharColors c)
 	co.Hair = Net2Color(c.Hair);
 	return co;
 }
+
+// Snapshot entity fields
+enum
+{
+	SNAPSHOT_POS_X,
+	SNAPSHOT_POS_Y,
+	SNAPSHOT_VEL_X,
+	SNAPSHOT_VEL_Y,
+	SNAPSHOT_DIR,
+	SNAPSHOT_HEALTH,
+	SNAPSHOT_ANIM
+};
+// Positions are sent as fixed point
+#define SNAPSHOT_POS_SCALE 256
+static int32_t PosToSnapshot(const float x)
+{
+	return (int32_t)roundf(x * SNAPSHOT_POS_SCALE);
+}
+static float SnapshotToPos(const int32_t x)
+{
+	return (float)x / SNAPSHOT_POS_SCALE;
+}
+static void SetSnapshotPos(NetEntityState *e, const struct vec2 pos)
+{
+	e->Fields[SNAPSHOT_POS_X] = PosToSnapshot(pos.x);
+	e->Fields[SNAPSHOT_POS_Y] = PosToSnapshot(pos.y);
+}
+void NetSnapshotFromWorld(NetSnapshot *s)
+{
+	NetSnapshotClear(s);
+	NetEntityState e;
+	CA_FOREACH(const TActor, a, gActors)
+		if (!a->isInUse) continue;
+		memset(&e, 0, sizeof e);
+		e.Kind = NET_SNAPSHOT_ACTOR;
+		e.UID = a->uid;
+		SetSnapshotPos(&e, a->Pos);
+		e.Fields[SNAPSHOT_VEL_X] = PosToSnapshot(a->MoveVel.x);
+		e.Fields[SNAPSHOT_VEL_Y] = PosToSnapshot(a->MoveVel.y);
+		e.Fields[SNAPSHOT_DIR] = (int32_t)a->direction;
+		e.Fields[SNAPSHOT_HEALTH] = a->health;
+		e.Fields[SNAPSHOT_ANIM] = (int32_t)a->anim.Type;
+		NetSnapshotAdd(s, &e);
+	CA_FOREACH_END()
+	CA_FOREACH(const TObject, o, gObjs)
+		if (!o->isInUse) continue;
+		memset(&e, 0, sizeof e);
+		e.Kind = NET_SNAPSHOT_OBJECT;
+		e.UID = o->uid;
+		SetSnapshotPos(&e, o->tileItem.Pos);
+		e.Fields[SNAPSHOT_HEALTH] = o->Health;
+		NetSnapshotAdd(s, &e);
+	CA_FOREACH_END()
+	CA_FOREACH(const Pickup, p, gPickups)
+		if (!p->isInUse) continue;
+		memset(&e, 0, sizeof e);
+		e.Kind = NET_SNAPSHOT_PICKUP;
+		e.UID = p->UID;
+		SetSnapshotPos(&e, p->tileItem.Pos);
+		NetSnapshotAdd(s, &e);
+	CA_FOREACH_END()
+	NetSnapshotSort(s);
+}
+
+struct vec2 NetEntityStatePos(const NetEntityState *e)
+{
+	return svec2(
+		SnapshotToPos(e->Fields[SNAPSHOT_POS_X]),
+		SnapshotToPos(e->Fields[SNAPSHOT_POS_Y]));
+}
+
+bool NetSnapshotApplyEntity(const NetEntityState *e)
+{
+	switch (e->Kind)
+	{
+	case NET_SNAPSHOT_ACTOR:
+		{
+			TActor *a = ActorGetByUID(e->UID);
+			if (a == NULL || !a->isInUse) return false;
+			// Local players are owned by us
+			if (ActorIsLocalPlayer(a->uid)) return true;
+			NActorMove am = NActorMove_init_default;
+			am.UID = a->uid;
+			am.Pos.x = SnapshotToPos(e->Fields[SNAPSHOT_POS_X]);
+			am.Pos.y = SnapshotToPos(e->Fields[SNAPSHOT_POS_Y]);
+			am.MoveVel.x = SnapshotToPos(e->Fields[SNAPSHOT_VEL_X]);
+			am.MoveVel.y = SnapshotToPos(e->Fields[SNAPSHOT_VEL_Y]);
+			ActorMove(am);
+			const int32_t dir = e->Fields[SNAPSHOT_DIR];
+			if (dir >= 0 && dir < DIRECTION_COUNT)
+			{
+				a->direction = (direction_e)dir;
+			}
+			a->health = e->Fields[SNAPSHOT_HEALTH];
+			// Restarting the same animation would reset its frame
+			const int32_t anim = e->Fields[SNAPSHOT_ANIM];
+			if ((anim == ACTORANIMATION_IDLE ||
+				anim == ACTORANIMATION_WALKING) &&
+				anim != (int32_t)a->anim.Type)
+			{
+				a->anim = AnimationGetActorAnimation((ActorAnimation)anim);
+			}
+		}
+		return true;
+	case NET_SNAPSHOT_OBJECT:
+		{
+			TObject *o = ObjGetByUID(e->UID);
+			if (o == NULL || !o->isInUse) return false;
+			o->Health = e->Fields[SNAPSHOT_HEALTH];
+		}
+		return true;
+	case NET_SNAPSHOT_PICKUP:
+		{
+			// Pickups don't move; only check that we have it
+			const Pickup *p = PickupGetByUID(e->UID);
+			return p != NULL && p->isInUse;
+		}
+	default:
+		// Kinds are checked when decoding
+		CASSERT(false, "unknown snapshot entity kind");
+		return false;
+	}
+}
@@ -34,25 +34,66 @@
 #include <enet/enet.h>
 
 #include "campaigns.h"
+#include "config.h"
 #include "game_events.h"
 #include "map.h"
+#include "net_frame.h"
+#include "net_snapshot.h"
+#include "net_strings.h"
 #include "player.h"
 
 #define NET_LISTEN_PORT 34219
 
-#define NET_PROTOCOL_VERSION 5
+#define NET_PROTOCOL_VERSION 11
 
-// Messages
+// One channel per delivery class, with the same index
+#define NET_CHANNEL_COUNT NET_DELIVERY_COUNT
 
-// All messages start with 4 bytes message type followed by the message struct
-#define NET_MSG_SIZE sizeof(uint32_t)
+// Messages are sent in frames; see net_frame.h
 
+void NetFrameAppendMsg(CArray *frame, const GameEventType e, const void *data);
+// Make a packet out of the frame's messages, and clear the frame
+ENetPacket *NetFrameMakePacket(CArray *frame, const NetDelivery d);
+// Decode a message from a peer; returns false, and logs, if it is
+// malformed, in which case the message should be dropped
+bool NetDecode(const NetMsg *msg, void *dest, const pb_field_t *fields);
 
-ENetPacket *NetEncode(const GameEventType e, const void *data);
-bool NetDecode(ENetPacket *packet, void *dest, const pb_field_t *fields);
+// Names in messages, e.g. class names, are sent as ids from gNetStrings
+// when the name has one; see net_strings.h
+#define NET_MSG_STRINGS_MAX 2
+// Get the names in a message that can be sent as ids; returns the count
+int NetMsgGetStrings(
+	const GameEventType e, const void *data,
+	const char *names[NET_MSG_STRINGS_MAX]);
+// Copy the message with its names replaced by ids;
+// returns false if the message has no such names
+bool NetMsgCompactStrings(
+	const GameEventType e, const void *data, GameEvent *out);
+// Restore the names of a received message from their ids; returns false
+// if an id is unknown, in which case the message should be dropped
+bool NetMsgExpandStrings(const GameEventType e, void *data);
+
+// Snapshots are sent at this interval, in ticks
+#define NET_SNAPSHOT_INTERVAL 3
+// Upper bound on snapshot delta size, per client per snapshot;
+// same as NSnapshot.Data max_size in msg.options
+#define NET_SNAPSHOT_MAX_SIZE 1024
+// Snapshot of the replicated state of actors, objects and pickups.
+// Actor moves, directions and animation states are only sent in snapshots,
+// not as events.
+void NetSnapshotFromWorld(NetSnapshot *s);
+struct vec2 NetEntityStatePos(const NetEntityState *e);
+// Apply a snapshot entity state to the world;
+// returns false if the entity was not found
+bool NetSnapshotApplyEntity(const NetEntityState *e);
+
+// Config values that affect the game, and must be the same on all machines;
+// NULL-terminated
+extern const char *NetGameConfigs[];
 
 NPlayerData NMakePlayerData(const PlayerData *p);
 NCampaignDef NMakeCampaignDef(const CampaignOptions *co);
+NConfig NMakeConfig(Config *config, const char *name);
 NMissionComplete NMakeMissionComplete(
 	const struct MissionOptions *mo, const Map *map);
 
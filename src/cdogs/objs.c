@@ -51,15 +51,19 @@
 #include <assert.h>
 
 #include "damage.h"
+#include "flow_field.h"
 #include "log.h"
 #include "net_util.h"
 #include "pickup.h"
 #include "gamedata.h"
+#include "uid_map.h"
 
 CArray gObjs;
 CArray gMobObjs;
 static unsigned int sObjUIDs = 0;
 static unsigned int sMobObjUIDs = 0;
+static UIDMap sObjUIDMap;
+static UIDMap sMobObjUIDMap;
 
 
 // Draw functions
@@ -205,11 +209,12 @@ void ObjRemove(const NMapObjectRemove mor)
 	// If wreck is available spawn it in the exact same position
 	PlaceWreck(o->Class->Wreck, &o->tileItem);
 
-	ObjDestroy(o);
-
 	// Update pathfinding cache since this object could have blocked a path
 	// before
+	PathCacheInvalidate(&gPathCache, o->tileItem.Pos, o->tileItem.size);
+	ObjDestroy(o);
 	PathCacheClear(&gPathCache);
+	FlowFieldsClear(&gFlowFields);
 }
 static void PlaceWreck(const char *wreckClass, const TTileItem *ti)
 {
@@ -402,6 +407,7 @@ void ObjsInit(void)
 	CArrayInit(&gObjs, sizeof(TObject));
 	CArrayReserve(&gObjs, 1024);
 	sObjUIDs = 0;
+	UIDMapInit(&sObjUIDMap);
 }
 void ObjsTerminate(void)
 {
@@ -412,6 +418,7 @@ void ObjsTerminate(void)
 		}
 	CA_FOREACH_END()
 	CArrayTerminate(&gObjs);
+	UIDMapTerminate(&sObjUIDMap);
 }
 int ObjsGetNextUID(void)
 {
@@ -449,6 +456,7 @@ void ObjAdd(const NMapObjectAdd amo)
 	}
 	memset(o, 0, sizeof *o);
 	o->uid = amo.UID;
+	UIDMapSet(&sObjUIDMap, amo.UID, i);
 	o->Class = StrMapObject(amo.MapObjectClass);
 	TileItemInit(
 		&o->tileItem, i, KIND_OBJECT, o->Class->Size, amo.TileItemFlags);
@@ -462,7 +470,9 @@ void ObjAdd(const NMapObjectAdd amo)
 		(int)amo.UID, amo.MapObjectClass, amo.Health, amo.Pos.x, amo.Pos.y);
 
 	// Update pathfinding cache since this object could block a path
+	PathCacheInvalidate(&gPathCache, o->tileItem.Pos, o->tileItem.size);
 	PathCacheClear(&gPathCache);
+	FlowFieldsClear(&gFlowFields);
 }
 
 void ObjDestroy(TObject *o)
@@ -522,13 +532,8 @@ void UpdateObjects(const int ticks)
 
 TObject *ObjGetByUID(const int uid)
 {
-	CA_FOREACH(TObject, o, gObjs)
-		if (o->uid == uid)
-		{
-			return o;
-		}
-	CA_FOREACH_END()
-	return NULL;
+	const int id = UIDMapGet(&sObjUIDMap, uid);
+	return id >= 0 ? CArrayGet(&gObjs, id) : NULL;
 }
 
 
@@ -537,6 +542,7 @@ void MobObjsInit(void)
 	CArrayInit(&gMobObjs, sizeof(TMobileObject));
 	CArrayReserve(&gMobObjs, 1024);
 	sMobObjUIDs = 0;
+	UIDMapInit(&sMobObjUIDMap);
 }
 void MobObjsTerminate(void)
 {
@@ -547,20 +553,44 @@ void MobObjsTerminate(void)
 		}
 	CA_FOREACH_END()
 	CArrayTerminate(&gMobObjs);
+	UIDMapTerminate(&sMobObjUIDMap);
 }
 int MobObjsObjsGetNextUID(void)
 {
 	return sMobObjUIDs++;
 }
-TMobileObject *MobObjGetByUID(const int uid)
+TMobileObject *MobObjAdd(const int uid, int *id)
 {
-	CA_FOREACH(TMobileObject, o, gMobObjs)
-		if (o->UID == uid)
+	// Find an empty slot in mobobj list
+	TMobileObject *obj = NULL;
+	int i;
+	for (i = 0; i < (int)gMobObjs.size; i++)
+	{
+		TMobileObject *m = CArrayGet(&gMobObjs, i);
+		if (!m->isInUse)
 		{
-			return o;
+			obj = m;
+			break;
 		}
-	CA_FOREACH_END()
-	return NULL;
+	}
+	if (obj == NULL)
+	{
+		TMobileObject m;
+		memset(&m, 0, sizeof m);
+		CArrayPushBack(&gMobObjs, &m);
+		i = (int)gMobObjs.size - 1;
+		obj = CArrayGet(&gMobObjs, i);
+	}
+	memset(obj, 0, sizeof *obj);
+	obj->UID = uid;
+	UIDMapSet(&sMobObjUIDMap, uid, i);
+	*id = i;
+	return obj;
+}
+TMobileObject *MobObjGetByUID(const int uid)
+{
+	const int id = UIDMapGet(&sMobObjUIDMap, uid);
+	return id >= 0 ? CArrayGet(&gMobObjs, id) : NULL;
 }
 void MobObjDestroy(TMobileObject *m)
 {
@@ -130,5 +130,7 @@ void UpdateMobileObjects(int ticks);
 void MobObjsInit(void);
 void MobObjsTerminate(void);
 int MobObjsObjsGetNextUID(void);
+// Claim a free mobobj slot for UID; returns the zeroed object and its index
+TMobileObject *MobObjAdd(const int uid, int *id);
 TMobileObject *MobObjGetByUID(const int uid);
 void MobObjDestroy(TMobileObject *m);
@@ -67,16 +67,26 @@ static bool CachedPathMatches(
 }
 
 
+static int IsTileWalkableForHPA(int x, int y, void *context);
+static const ASGridSource cHPASource =
+{
+	IsTileWalkableForHPA, TILE_WIDTH, TILE_HEIGHT, TILE_WIDTH * 1.1f
+};
 void PathCacheInit(PathCache *pc, Map *m)
 {
 	CArrayInit(&pc->paths, sizeof(CachedPath));
 	pc->head = 0;
 	pc->map = m;
+	pc->grid = ASGridCreate(m->Size.x, m->Size.y);
+	HPAGraphInit(&pc->hpa, m->Size, &cHPASource, m);
 }
 void PathCacheTerminate(PathCache *pc)
 {
 	PathCacheClear(pc);
 	CArrayTerminate(&pc->paths);
+	ASGridDestroy(pc->grid);
+	pc->grid = NULL;
+	HPAGraphTerminate(&pc->hpa);
 }
 
 void PathCacheClear(PathCache *pc)
@@ -88,17 +98,52 @@ void PathCacheClear(PathCache *pc)
 	pc->head = 0;
 }
 
+void PathCacheInvalidateTile(PathCache *pc, const struct vec2i pos)
+{
+	HPAGraphInvalidate(&pc->hpa, pos);
+}
+void PathCacheInvalidate(
+	PathCache *pc, const struct vec2 pos, const struct vec2i size)
+{
+	// Only the corners are needed; areas are never bigger than a cluster
+	const struct vec2 half = svec2_scale(svec2_assign_vec2i(size), 0.5f);
+	const struct vec2i tl = Vec2ToTile(svec2_subtract(pos, half));
+	const struct vec2i br = Vec2ToTile(svec2_add(pos, half));
+	PathCacheInvalidateTile(pc, tl);
+	PathCacheInvalidateTile(pc, svec2i(br.x, tl.y));
+	PathCacheInvalidateTile(pc, svec2i(tl.x, br.y));
+	PathCacheInvalidateTile(pc, br);
+}
+
+void PathCacheInvalidateDoors(PathCache *pc)
+{
+	struct vec2i v;
+	for (v.y = 0; v.y < pc->map->Size.y; v.y++)
+	{
+		for (v.x = 0; v.x < pc->map->Size.x; v.x++)
+		{
+			const Tile *t = MapGetTile(pc->map, v);
+			if ((t->flags & MAPTILE_OFFSET_PIC) &&
+				MapGetDoorKeycardFlag(pc->map, v))
+			{
+				PathCacheInvalidateTile(pc, v);
+			}
+		}
+	}
+}
+
 typedef struct
 {
 	Map *Map;
 	TileSelectFunc IsTileOk;
 } AStarContext;
-static void AddTileNeighbors(
-	ASNeighborList neighbors, void *node, void *context);
-static float AStarHeuristic(void *fromNode, void *toNode, void *context);
-static ASPathNodeSource cPathNodeSource =
+static int IsTileOkForPath(int x, int y, void *context);
+// Note that there are different horizontal and vertical costs,
+// due to the tiles being non-square
+// Slightly prefer axes instead of diagonals
+static const ASGridSource cPathGridSource =
 {
-	sizeof(struct vec2i), AddTileNeighbors, AStarHeuristic, NULL, NULL
+	IsTileOkForPath, TILE_WIDTH, TILE_HEIGHT, TILE_WIDTH * 1.1f
 };
 CachedPath PathCacheCreate(
 	PathCache *pc, struct vec2i from, struct vec2i to,
@@ -123,7 +168,17 @@ CachedPath PathCacheCreate(
 	AStarContext ac;
 	ac.Map = pc->map;
 	ac.IsTileOk = ignoreObjects ? IsTileWalkable : IsTileWalkableAroundObjects;
-	cp.Path = ASPathCreate(&cPathNodeSource, &ac, &from, &to);
+	// Use the hierarchical graph for long paths
+	if (ignoreObjects &&
+		MAX(abs(from.x - to.x), abs(from.y - to.y)) > HPA_CLUSTER_SIZE)
+	{
+		cp.Path = HPAPathCreate(&pc->hpa, from, to);
+	}
+	else
+	{
+		cp.Path = ASGridPathCreate(
+			pc->grid, &cPathGridSource, &ac, from.x, from.y, to.x, to.y);
+	}
 	CMALLOC(cp.refs, sizeof *cp.refs);
 	(*cp.refs) = 1;
 	cp.from = from;
@@ -158,66 +213,12 @@ CachedPath PathCacheCreate(
 	return cp;
 }
 
-static void AddTileNeighbors(
-	ASNeighborList neighbors, void *node, void *context)
+static int IsTileOkForPath(int x, int y, void *context)
 {
-	struct vec2i *v = node;
-	int y;
 	AStarContext *c = context;
-	for (y = v->y - 1; y <= v->y + 1; y++)
-	{
-		int x;
-		if (y < 0 || y >= c->Map->Size.y)
-		{
-			continue;
-		}
-		for (x = v->x - 1; x <= v->x + 1; x++)
-		{
-			float cost;
-			struct vec2i neighbor;
-			neighbor.x = x;
-			neighbor.y = y;
-			if (x < 0 || x >= c->Map->Size.x)
-			{
-				continue;
-			}
-			if (x == v->x && y == v->y)
-			{
-				continue;
-			}
-			// if we're moving diagonally,
-			// need to check the axis-aligned neighbours are also clear
-			if (!c->IsTileOk(c->Map, svec2i(x, y)) ||
-				!c->IsTileOk(c->Map, svec2i(v->x, y)) ||
-				!c->IsTileOk(c->Map, svec2i(x, v->y)))
-			{
-				continue;
-			}
-			// Calculate cost of direction
-			// Note that there are different horizontal and vertical costs,
-			// due to the tiles being non-square
-			// Slightly prefer axes instead of diagonals
-			if (x != v->x && y != v->y)
-			{
-				cost = TILE_WIDTH * 1.1f;
-			}
-			else if (x != v->x)
-			{
-				cost = TILE_WIDTH;
-			}
-			else
-			{
-				cost = TILE_HEIGHT;
-			}
-			ASNeighborListAdd(neighbors, &neighbor, cost);
-		}
-	}
+	return c->IsTileOk(c->Map, svec2i(x, y));
 }
-static float AStarHeuristic(void *fromNode, void *toNode, void *context)
+static int IsTileWalkableForHPA(int x, int y, void *context)
 {
-	const struct vec2i *v1 = fromNode;
-	const struct vec2i *v2 = toNode;
-	UNUSED(context);
-	return CHEBYSHEV_DISTANCE(
-		(float)v1->x, (float)v1->y, (float)v2->x, (float)v2->y);
+	return IsTileWalkable(context, svec2i(x, y));
 }
@@ -29,6 +29,7 @@
 
 #include "AStar.h"
 #include "c_array.h"
+#include "hpa.h"
 #include "map.h"
 #include "vector.h"
 
@@ -47,6 +48,9 @@ typedef struct
 	CArray paths;	// of CachedPath
 	size_t head;
 	Map *map;
+	ASGrid grid;	// search state, reused between searches
+	// For long paths; only for AI that ignore objects
+	HPAGraph hpa;
 } PathCache;
 
 // Cache of A* paths so similar paths don't need to be recalculated
@@ -63,6 +67,14 @@ void PathCacheTerminate(PathCache *pc);
 // This is done when the underlying map changes, changing paths
 // e.g. keys
 void PathCacheClear(PathCache *pc);
+// Mark a tile as changed, so that the pathfinding graph around it is
+// rebuilt
+void PathCacheInvalidateTile(PathCache *pc, const struct vec2i pos);
+// Same for the tiles in an area
+void PathCacheInvalidate(
+	PathCache *pc, const struct vec2 pos, const struct vec2i size);
+// Mark locked doors as changed, since picking up keys can unlock them
+void PathCacheInvalidateDoors(PathCache *pc);
 
 CachedPath PathCacheCreate(
 	PathCache *pc, struct vec2i from, struct vec2i to,
@@ -32,7 +32,7 @@
 #include "grafx.h"
 #include "utils.h"
 
-Pic picNone = { { 0, 0 }, { 0, 0 }, NULL };
+Pic picNone = { { 0, 0 }, { 0, 0 }, NULL, 0 };
 
 
 color_t PixelToColor(
@@ -58,6 +58,7 @@ void PicLoad(
 {
 	p->size = size;
 	p->offset = svec2i_zero();
+	p->Stride = 0;
 	CMALLOC(p->Data, size.x * size.y * sizeof *((Pic *)0)->Data);
 	// Manually copy the pixels and replace the alpha component,
 	// since our gfx device format has no alpha
@@ -87,9 +88,14 @@ void PicLoad(
 Pic PicCopy(const Pic *src)
 {
 	Pic p = *src;
-	const size_t size = p.size.x * p.size.y * sizeof *p.Data;
-	CMALLOC(p.Data, size);
-	memcpy(p.Data, src->Data, size);
+	const size_t rowSize = p.size.x * sizeof *p.Data;
+	CMALLOC(p.Data, rowSize * p.size.y);
+	p.Stride = 0;
+	const int srcStride = PIC_STRIDE(src);
+	for (int y = 0; y < p.size.y; y++)
+	{
+		memcpy(p.Data + y * p.size.x, src->Data + y * srcStride, rowSize);
+	}
 	return p;
 }
 
@@ -105,6 +111,7 @@ bool PicIsNone(const Pic *pic)
 
 void PicTrim(Pic *pic, const bool xTrim, const bool yTrim)
 {
+	const int stride = PIC_STRIDE(pic);
 	// Scan all pixels looking for the min/max of x and y
 	struct vec2i min = pic->size;
 	struct vec2i max = svec2i_zero();
@@ -112,7 +119,7 @@ void PicTrim(Pic *pic, const bool xTrim, const bool yTrim)
 	{
 		for (pos.x = 0; pos.x < pic->size.x; pos.x++)
 		{
-			const Uint32 pixel = *(pic->Data + pos.x + pos.y * pic->size.x);
+			const Uint32 pixel = *(pic->Data + pos.x + pos.y * stride);
 			if (pixel > 0)
 			{
 				min.x = MIN(min.x, pos.x);
@@ -147,7 +154,7 @@ void PicTrim(Pic *pic, const bool xTrim, const bool yTrim)
 		{
 			Uint32 *target = newData + pos.x + pos.y * newSize.x;
 			const int srcIdx =
-				pos.x + offset.x + (pos.y + offset.y) * pic->size.x;
+				pos.x + offset.x + (pos.y + offset.y) * stride;
 			*target = *(pic->Data + srcIdx);
 		}
 	}
@@ -156,24 +163,26 @@ void PicTrim(Pic *pic, const bool xTrim, const bool yTrim)
 	pic->Data = newData;
 	pic->size = newSize;
 	pic->offset = svec2i_zero();
+	pic->Stride = 0;
 }
 
 bool PicPxIsEdge(const Pic *pic, const struct vec2i pos, const bool isPixel)
 {
+	const int stride = PIC_STRIDE(pic);
 	const bool isTopOrBottomEdge = pos.y == -1 || pos.y == pic->size.y;
 	const bool isLeftOrRightEdge = pos.x == -1 || pos.x == pic->size.x;
 	const bool isLeft =
 		pos.x > 0 && !isTopOrBottomEdge &&
-		PIXEL2COLOR(*(pic->Data + pos.x - 1 + pos.y * pic->size.x)).a;
+		PIXEL2COLOR(*(pic->Data + pos.x - 1 + pos.y * stride)).a;
 	const bool isRight =
 		pos.x < pic->size.x - 1 && !isTopOrBottomEdge &&
-		PIXEL2COLOR(*(pic->Data + pos.x + 1 + pos.y * pic->size.x)).a;
+		PIXEL2COLOR(*(pic->Data + pos.x + 1 + pos.y * stride)).a;
 	const bool isAbove =
 		pos.y > 0 && !isLeftOrRightEdge &&
-		PIXEL2COLOR(*(pic->Data + pos.x + (pos.y - 1) * pic->size.x)).a;
+		PIXEL2COLOR(*(pic->Data + pos.x + (pos.y - 1) * stride)).a;
 	const bool isBelow =
 		pos.y < pic->size.y - 1 && !isLeftOrRightEdge &&
-		PIXEL2COLOR(*(pic->Data + pos.x + (pos.y + 1) * pic->size.x)).a;
+		PIXEL2COLOR(*(pic->Data + pos.x + (pos.y + 1) * stride)).a;
 	if (isPixel)
 	{
 		return !(isLeft && isRight && isAbove && isBelow);
@@ -34,10 +34,15 @@ typedef struct
 	struct vec2i size;
 	struct vec2i offset;
 	Uint32 *Data;
+	// Pixels between rows of Data, if it views into a larger image such as
+	// an atlas page; 0 if the rows are contiguous. Use PIC_STRIDE.
+	int Stride;
 } Pic;
 
 extern Pic picNone;
 
+#define PIC_STRIDE(_p) ((_p)->Stride > 0 ? (_p)->Stride : (_p)->size.x)
+
 color_t PixelToColor(
 	const SDL_PixelFormat *f, const Uint8 aShift, const Uint32 pixel);
 Uint32 ColorToPixel(
@@ -49,6 +54,7 @@ Uint32 ColorToPixel(
 
 void PicLoad(
 	Pic *p, const struct vec2i size, const struct vec2i offset, const SDL_Surface *image);
+// Copy into newly allocated, contiguous data
 Pic PicCopy(const Pic *src);
 void PicFree(Pic *pic);
 bool PicIsNone(const Pic *pic);
@@ -0,0 +1,269 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "pic_atlas.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+PicAtlas gPicAtlas;
+
+// Segment of a page's skyline; the segments cover the page's width
+typedef struct
+{
+	int X;
+	int Y;
+	int W;
+} Skyline;
+// Where a pic is to be packed
+typedef struct
+{
+	Pic *Pic;
+	int Page;
+	struct vec2i Pos;
+} Placement;
+
+
+void PicAtlasInit(PicAtlas *a, const struct vec2i pageSize)
+{
+	memset(a, 0, sizeof *a);
+	a->PageSize = pageSize;
+	CArrayInit(&a->pages, sizeof(PicAtlasPage));
+}
+void PicAtlasTerminate(PicAtlas *a)
+{
+	CA_FOREACH(PicAtlasPage, p, a->pages)
+		CFREE(p->Data);
+	CA_FOREACH_END()
+	CArrayTerminate(&a->pages);
+}
+
+static int ComparePlacements(const void *v1, const void *v2);
+static void Place(
+	const PicAtlas *a, CArray *skylines, Placement *placement);
+int PicAtlasAdd(PicAtlas *a, const CArray *pics)
+{
+	CArray placements;	// of Placement
+	CArrayInit(&placements, sizeof(Placement));
+	CA_FOREACH(Pic *, pic, *pics)
+		if ((*pic)->Data == NULL || PicAtlasHasData(a, (*pic)->Data) ||
+			(*pic)->size.x > a->PageSize.x || (*pic)->size.y > a->PageSize.y)
+		{
+			continue;
+		}
+		const Placement p = { *pic, -1, { 0, 0 } };
+		CArrayPushBack(&placements, &p);
+	CA_FOREACH_END()
+	// Tallest first keeps the skylines flat
+	if (placements.size > 0)
+	{
+		qsort(
+			placements.data, placements.size, placements.elemSize,
+			ComparePlacements);
+	}
+
+	// Decide where everything goes, then size the pages to fit
+	CArray skylines;	// of CArray of Skyline, for each new page
+	CArrayInit(&skylines, sizeof(CArray));
+	CA_FOREACH(Placement, p, placements)
+		Place(a, &skylines, p);
+	CA_FOREACH_END()
+	const int firstPage = (int)a->pages.size;
+	CA_FOREACH(CArray, skyline, skylines)
+		PicAtlasPage page;
+		page.Size = svec2i(a->PageSize.x, 0);
+		for (int i = 0; i < (int)skyline->size; i++)
+		{
+			const Skyline *s = CArrayGet(skyline, i);
+			page.Size.y = MAX(page.Size.y, s->Y);
+		}
+		CCALLOC(page.Data, page.Size.x * page.Size.y * sizeof *page.Data);
+		CArrayPushBack(&a->pages, &page);
+		CArrayTerminate(skyline);
+	CA_FOREACH_END()
+	CArrayTerminate(&skylines);
+
+	// Copy the pixels and point the pics at them
+	CA_FOREACH(const Placement, p, placements)
+		const PicAtlasPage *page = CArrayGet(&a->pages, firstPage + p->Page);
+		Pic *pic = p->Pic;
+		Uint32 *data = page->Data + p->Pos.y * page->Size.x + p->Pos.x;
+		const int stride = PIC_STRIDE(pic);
+		for (int y = 0; y < pic->size.y; y++)
+		{
+			memcpy(
+				data + y * page->Size.x, pic->Data + y * stride,
+				pic->size.x * sizeof *data);
+		}
+		pic->Data = data;
+		pic->Stride = page->Size.x;
+	CA_FOREACH_END()
+	const int numPacked = (int)placements.size;
+	CArrayTerminate(&placements);
+	return numPacked;
+}
+static int ComparePlacements(const void *v1, const void *v2)
+{
+	const Pic *p1 = ((const Placement *)v1)->Pic;
+	const Pic *p2 = ((const Placement *)v2)->Pic;
+	if (p1->size.y != p2->size.y)
+	{
+		return p2->size.y - p1->size.y;
+	}
+	return p2->size.x - p1->size.x;
+}
+static int SkylineFit(
+	const CArray *skyline, const int i, const struct vec2i size,
+	const struct vec2i pageSize);
+static void SkylineAdd(
+	CArray *skyline, const int i, const struct vec2i pos,
+	const struct vec2i size);
+static void Place(
+	const PicAtlas *a, CArray *skylines, Placement *placement)
+{
+	const struct vec2i size = placement->Pic->size;
+	// Find where the pic's top would be lowest, on any page
+	int bestTop = a->PageSize.y + 1;
+	int bestIndex = -1;
+	CA_FOREACH(const CArray, skyline, *skylines)
+		for (int i = 0; i < (int)skyline->size; i++)
+		{
+			const int y = SkylineFit(skyline, i, size, a->PageSize);
+			if (y >= 0 && y + size.y < bestTop)
+			{
+				bestTop = y + size.y;
+				bestIndex = i;
+				placement->Page = _ca_index;
+				const Skyline *s = CArrayGet(skyline, i);
+				placement->Pos = svec2i(s->X, y);
+			}
+		}
+	CA_FOREACH_END()
+	if (bestIndex < 0)
+	{
+		// Start a new page
+		CArray skyline;
+		CArrayInit(&skyline, sizeof(Skyline));
+		const Skyline s = { 0, 0, a->PageSize.x };
+		CArrayPushBack(&skyline, &s);
+		CArrayPushBack(skylines, &skyline);
+		bestIndex = 0;
+		placement->Page = (int)skylines->size - 1;
+		placement->Pos = svec2i_zero();
+	}
+	SkylineAdd(
+		CArrayGet(skylines, placement->Page), bestIndex, placement->Pos,
+		size);
+}
+// The lowest y that a pic can be placed at, with its left edge at the
+// start of segment i; -1 if it doesn't fit
+static int SkylineFit(
+	const CArray *skyline, const int i, const struct vec2i size,
+	const struct vec2i pageSize)
+{
+	const Skyline *s = CArrayGet(skyline, i);
+	if (s->X + size.x > pageSize.x)
+	{
+		return -1;
+	}
+	int y = 0;
+	int remaining = size.x;
+	// The segments cover the page, so they cover the pic's width too
+	for (int j = i; remaining > 0; j++)
+	{
+		const Skyline *sj = CArrayGet(skyline, j);
+		y = MAX(y, sj->Y);
+		if (y + size.y > pageSize.y)
+		{
+			return -1;
+		}
+		remaining -= sj->W;
+	}
+	return y;
+}
+static void SkylineAdd(
+	CArray *skyline, const int i, const struct vec2i pos,
+	const struct vec2i size)
+{
+	const Skyline s = { pos.x, pos.y + size.y, size.x };
+	CArrayInsert(skyline, i, &s);
+	// Shrink or remove the segments now under the pic
+	const int right = pos.x + size.x;
+	while (i + 1 < (int)skyline->size)
+	{
+		Skyline *next = CArrayGet(skyline, i + 1);
+		const int nextRight = next->X + next->W;
+		if (nextRight <= right)
+		{
+			CArrayDelete(skyline, i + 1);
+			continue;
+		}
+		if (next->X < right)
+		{
+			next->W = nextRight - right;
+			next->X = right;
+		}
+		break;
+	}
+	// Merge segments at the same height
+	for (int j = 0; j + 1 < (int)skyline->size;)
+	{
+		Skyline *s1 = CArrayGet(skyline, j);
+		const Skyline *s2 = CArrayGet(skyline, j + 1);
+		if (s1->Y == s2->Y)
+		{
+			s1->W += s2->W;
+			CArrayDelete(skyline, j + 1);
+		}
+		else
+		{
+			j++;
+		}
+	}
+}
+
+const PicAtlasPage *PicAtlasFind(
+	const PicAtlas *a, const void *data, struct vec2i *pos)
+{
+	const Uint32 *d = data;
+	CA_FOREACH(const PicAtlasPage, p, a->pages)
+		if (d >= p->Data && d < p->Data + p->Size.x * p->Size.y)
+		{
+			if (pos != NULL)
+			{
+				const int offset = (int)(d - p->Data);
+				*pos = svec2i(offset % p->Size.x, offset / p->Size.x);
+			}
+			return p;
+		}
+	CA_FOREACH_END()
+	return NULL;
+}
+bool PicAtlasHasData(const PicAtlas *a, const void *data)
+{
+	return PicAtlasFind(a, data, NULL) != NULL;
+}
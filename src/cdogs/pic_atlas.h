@@ -0,0 +1,68 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "c_array.h"
+#include "pic.h"
+
+// Atlas of pics, packed into a few large pages.
+// Pics added to the atlas have their pixels copied into a page, and are
+// rewritten to view into it with the page's stride; drawing them reads
+// from a few large blocks instead of thousands of small allocations, and
+// a texture renderer can upload each page as one texture.
+// Pics are packed tallest first along a skyline: the top edge of the
+// pics placed so far, each pic going where its top would be lowest.
+// Atlas data is owned by the atlas; pics viewing into it must not be
+// freed or modified.
+
+// Width and maximum height of pages, in pixels
+#define PIC_ATLAS_PAGE_SIZE 1024
+
+typedef struct
+{
+	struct vec2i Size;
+	Uint32 *Data;
+} PicAtlasPage;
+typedef struct
+{
+	struct vec2i PageSize;
+	CArray pages;	// of PicAtlasPage
+} PicAtlas;
+extern PicAtlas gPicAtlas;
+
+void PicAtlasInit(PicAtlas *a, const struct vec2i pageSize);
+void PicAtlasTerminate(PicAtlas *a);
+// Pack pics (of Pic *) into new pages, and rewrite them to view into the
+// pages. The pics' old data is not freed. Pics already in the atlas, or
+// too big for a page, are left as they are.
+// Returns the number of pics packed.
+int PicAtlasAdd(PicAtlas *a, const CArray *pics);
+// Find the page that pixel data is in, and the position of the data in it
+const PicAtlasPage *PicAtlasFind(
+	const PicAtlas *a, const void *data, struct vec2i *pos);
+bool PicAtlasHasData(const PicAtlas *a, const void *data);
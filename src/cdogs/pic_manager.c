@@ -35,12 +35,16 @@
 
 #include <tinydir/tinydir.h>
 
+#include "asset_loader.h"
+#include "char_pic_cache.h"
 #include "files.h"
 #include "log.h"
+#include "pic_atlas.h"
 
 PicManager gPicManager;
 
 
+static void OnCharPicFree(const Pic *pic);
 void PicManagerInit(PicManager *pm)
 {
 	memset(pm, 0, sizeof *pm);
@@ -53,13 +57,22 @@ void PicManagerInit(PicManager *pm)
 	CArrayInit(&pm->exitStyleNames, sizeof(char *));
 	CArrayInit(&pm->doorStyleNames, sizeof(char *));
 	CArrayInit(&pm->keyStyleNames, sizeof(char *));
+	CharPicCacheInit(&gCharPicCache, CHAR_PIC_CACHE_MAX_PIXELS);
+	gCharPicCache.PicFreeFunc = OnCharPicFree;
+	PicAtlasInit(
+		&gPicAtlas, svec2i(PIC_ATLAS_PAGE_SIZE, PIC_ATLAS_PAGE_SIZE));
+}
+static void OnCharPicFree(const Pic *pic)
+{
+	RenderBatchRemovePic(&gGraphicsDevice.batch, pic);
 }
 
 static NamedPic *AddNamedPic(map_t pics, const char *name, const Pic *p);
 static NamedSprites *AddNamedSprites(map_t sprites, const char *name);
 static void AfterAdd(PicManager *pm);
+// Add pics from a 32-bit image, which is then freed
 static void PicManagerAdd(
-	map_t pics, map_t sprites, const char *name, SDL_Surface *imageIn)
+	map_t pics, map_t sprites, const char *name, SDL_Surface *image)
 {
 	char buf[CDOGS_FILENAME_MAX];
 	const char *dot = strrchr(name, '.');
@@ -76,7 +89,7 @@ static void PicManagerAdd(
 	// Special case: if the file name is in the form foobar_WxH.ext,
 	// this is a spritesheet where each sprite is W wide by H high
 	// Load multiple images from this single sheet
-	struct vec2i size = svec2i(imageIn->w, imageIn->h);
+	struct vec2i size = svec2i(image->w, image->h);
 	bool isSpritesheet = false;
 	char *underscore = strrchr(buf, '_');
 	const char *x = strrchr(buf, 'x');
@@ -85,7 +98,7 @@ static void PicManagerAdd(
 	{
 		if (sscanf(underscore, "_%dx%d", &size.x, &size.y) != 2)
 		{
-			size = svec2i(imageIn->w, imageIn->h);
+			size = svec2i(image->w, image->h);
 		}
 		else
 		{
@@ -103,10 +116,6 @@ static void PicManagerAdd(
 	{
 		np = AddNamedPic(pics, buf, NULL);
 	}
-	// Use 32-bit image
-	SDL_Surface *image = SDL_ConvertSurfaceFormat(
-		imageIn, SDL_PIXELFORMAT_RGBA8888, 0);
-	SDL_FreeSurface(imageIn);
 	SDL_LockSurface(image);
 	struct vec2i offset;
 	for (offset.y = 0; offset.y < image->h; offset.y += size.y)
@@ -183,13 +192,28 @@ static void PicManagerAdd(
 	}
 	SDL_UnlockSurface(image);
 	SDL_FreeSurface(image);
-
-	AfterAdd(&gPicManager);
 }
 
+static void FindPics(AssetLoader *al, const char *path, const char *prefix);
+static void *LoadPic(const char *path, const char *name);
 void PicManagerLoadDir(
 	PicManager *pm, const char *path, const char *prefix,
 	map_t pics, map_t sprites)
+{
+	// Decode the images in parallel, then add them in order
+	AssetLoader al;
+	AssetLoaderInit(&al);
+	FindPics(&al, path, prefix);
+	AssetLoaderRun(&al, LoadPic);
+	CA_FOREACH(const AssetLoaderJob, job, al.jobs)
+		if (job->Result == NULL) continue;
+		PicManagerAdd(pics, sprites, job->Name, job->Result);
+	CA_FOREACH_END()
+	AfterAdd(pm);
+	AssetLoaderLogTimes(&al, "pics");
+	AssetLoaderTerminate(&al);
+}
+static void FindPics(AssetLoader *al, const char *path, const char *prefix)
 {
 	tinydir_dir dir;
 	if (tinydir_open(&dir, path) == -1)
@@ -213,33 +237,18 @@ void PicManagerLoadDir(
 		}
 		if (file.is_reg)
 		{
-			SDL_RWops *rwops = SDL_RWFromFile(file.path, "rb");
-			const bool isPng = IMG_isPNG(rwops);
-			if (isPng)
+			char buf[CDOGS_PATH_MAX];
+			if (prefix)
 			{
-				SDL_Surface *data = IMG_Load_RW(rwops, 0);
-				if (!data)
-				{
-					LOG(LM_MAIN, LL_ERROR, "Cannot load image IMG_Load: %s",
-						IMG_GetError());
-				}
-				else
-				{
-					char buf[CDOGS_PATH_MAX];
-					if (prefix)
-					{
-						char buf1[CDOGS_PATH_MAX];
-						sprintf(buf1, "%s/%s", prefix, file.name);
-						PathGetWithoutExtension(buf, buf1);
-					}
-					else
-					{
-						PathGetBasenameWithoutExtension(buf, file.name);
-					}
-					PicManagerAdd(pics, sprites, buf, data);
-				}
+				char buf1[CDOGS_PATH_MAX];
+				sprintf(buf1, "%s/%s", prefix, file.name);
+				PathGetWithoutExtension(buf, buf1);
 			}
-			rwops->close(rwops);
+			else
+			{
+				PathGetBasenameWithoutExtension(buf, file.name);
+			}
+			AssetLoaderAdd(al, file.path, buf);
 		}
 		else if (file.is_dir && file.name[0] != '.')
 		{
@@ -247,12 +256,11 @@ void PicManagerLoadDir(
 			{
 				char buf[CDOGS_PATH_MAX];
 				sprintf(buf, "%s/%s", prefix, file.name);
-				PicManagerLoadDir(pm, file.path, buf, pics, sprites);
+				FindPics(al, file.path, buf);
 			}
 			else
 			{
-				PicManagerLoadDir(
-					pm, file.path, file.name, pics, sprites);
+				FindPics(al, file.path, file.name);
 			}
 		}
 	}
@@ -260,6 +268,37 @@ void PicManagerLoadDir(
 bail:
 	tinydir_close(&dir);
 }
+static void *LoadPic(const char *path, const char *name)
+{
+	UNUSED(name);
+	SDL_RWops *rwops = SDL_RWFromFile(path, "rb");
+	if (rwops == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Cannot open image %s: %s",
+			path, SDL_GetError());
+		return NULL;
+	}
+	SDL_Surface *image = NULL;
+	if (IMG_isPNG(rwops))
+	{
+		SDL_Surface *data = IMG_Load_RW(rwops, 0);
+		if (!data)
+		{
+			LOG(LM_MAIN, LL_ERROR, "Cannot load image IMG_Load: %s",
+				IMG_GetError());
+		}
+		else
+		{
+			// Use 32-bit image
+			image = SDL_ConvertSurfaceFormat(
+				data, SDL_PIXELFORMAT_RGBA8888, 0);
+			SDL_FreeSurface(data);
+		}
+	}
+	rwops->close(rwops);
+	return image;
+}
+static void BuildAtlas(PicManager *pm);
 void PicManagerLoad(PicManager *pm, const char *path)
 {
 	if (!IMG_Init(IMG_INIT_PNG))
@@ -269,7 +308,96 @@ void PicManagerLoad(PicManager *pm, const char *path)
 	}
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, path);
+	char packPath[CDOGS_PATH_MAX];
+	sprintf(packPath, "%s%s", buf, PIC_PACK_EXT);
+	if (PicPackLoad(
+		&pm->pack, packPath, pm->pics, pm->sprites,
+		gGraphicsDevice.Format->format))
+	{
+		LOG(LM_MAIN, LL_INFO,
+			"using pic pack %s; re-bake it after changing %s",
+			packPath, path);
+		AfterAdd(pm);
+		BuildAtlas(pm);
+		return;
+	}
 	PicManagerLoadDir(pm, buf, NULL, pm->pics, pm->sprites);
+	BuildAtlas(pm);
+}
+static int CollectPic(any_t data, any_t item);
+static int CollectSprites(any_t data, any_t item);
+static bool IsSharedData(const PicManager *pm, const void *data);
+// Pack the built-in pics into the atlas; custom pics come and go with
+// campaigns so they keep their own data.
+// Pics from the pic pack are left in its mapping; copying them into
+// atlas pages would undo the pack's shared, near instant loading.
+static void BuildAtlas(PicManager *pm)
+{
+	CArray all;	// of Pic *
+	CArrayInit(&all, sizeof(Pic *));
+	hashmap_iterate(pm->pics, CollectPic, &all);
+	hashmap_iterate(pm->sprites, CollectSprites, &all);
+	CArray pics;	// of Pic *
+	CArrayInit(&pics, sizeof(Pic *));
+	CArray data;	// of Uint32 *, the pics' data before packing
+	CArrayInit(&data, sizeof(Uint32 *));
+	CA_FOREACH(Pic *, pic, all)
+		if (PicPackHasData(&pm->pack, (*pic)->Data))
+		{
+			continue;
+		}
+		CArrayPushBack(&pics, pic);
+		CArrayPushBack(&data, &(*pic)->Data);
+	CA_FOREACH_END()
+	CArrayTerminate(&all);
+	const int numPacked = PicAtlasAdd(&gPicAtlas, &pics);
+	CA_FOREACH(Pic *, pic, pics)
+		Uint32 *d = *(Uint32 **)CArrayGet(&data, _ca_index);
+		if ((*pic)->Data != d && !IsSharedData(pm, d))
+		{
+			CFREE(d);
+		}
+	CA_FOREACH_END()
+	LOG(LM_GFX, LL_INFO, "packed %d/%d pics into %d atlas pages",
+		numPacked, (int)pics.size, (int)gPicAtlas.pages.size);
+	CArrayTerminate(&pics);
+	CArrayTerminate(&data);
+}
+static int CollectPic(any_t data, any_t item)
+{
+	NamedPic *n = item;
+	Pic *pic = &n->pic;
+	CArrayPushBack(data, &pic);
+	return MAP_OK;
+}
+static int CollectSprites(any_t data, any_t item)
+{
+	NamedSprites *n = item;
+	CA_FOREACH(Pic, pic, n->pics)
+		CArrayPushBack(data, &pic);
+	CA_FOREACH_END()
+	return MAP_OK;
+}
+// Whether pic data is in the pack or atlas, and must not be freed
+static bool IsSharedData(const PicManager *pm, const void *data)
+{
+	return PicPackHasData(&pm->pack, data) ||
+		PicAtlasHasData(&gPicAtlas, data);
+}
+bool PicManagerBake(PicManager *pm, const char *path)
+{
+	if (!IMG_Init(IMG_INIT_PNG))
+	{
+		perror("Cannot initialise SDL_Image");
+		return false;
+	}
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, path);
+	PicManagerLoadDir(pm, buf, NULL, pm->pics, pm->sprites);
+	char packPath[CDOGS_PATH_MAX];
+	sprintf(packPath, "%s%s", buf, PIC_PACK_EXT);
+	return PicPackWrite(
+		packPath, pm->pics, pm->sprites, gGraphicsDevice.Format->format);
 }
 
 
@@ -396,6 +524,9 @@ static void NamedPicDestroy(any_t data);
 static void NamedSpritesDestroy(any_t data);
 void PicManagerClearCustom(PicManager *pm)
 {
+	// Cached pics and textures may be from the custom pics
+	CharPicCacheClear(&gCharPicCache);
+	RenderBatchClearTextures(&gGraphicsDevice.batch);
 	hashmap_destroy(pm->customPics, NamedPicDestroy);
 	hashmap_destroy(pm->customSprites, NamedSpritesDestroy);
 	pm->customPics = hashmap_new();
@@ -403,8 +534,15 @@ void PicManagerClearCustom(PicManager *pm)
 	AfterAdd(pm);
 }
 static void StylesTerminate(CArray *styles);
+static int DetachSharedPic(any_t data, any_t item);
+static int DetachSharedSprites(any_t data, any_t item);
 void PicManagerTerminate(PicManager *pm)
 {
+	CharPicCacheTerminate(&gCharPicCache);
+	RenderBatchClearTextures(&gGraphicsDevice.batch);
+	// Pack and atlas data is owned by them; don't free it with the pics
+	hashmap_iterate(pm->pics, DetachSharedPic, pm);
+	hashmap_iterate(pm->sprites, DetachSharedSprites, pm);
 	hashmap_destroy(pm->pics, NamedPicDestroy);
 	hashmap_destroy(pm->sprites, NamedSpritesDestroy);
 	hashmap_destroy(pm->customPics, NamedPicDestroy);
@@ -414,8 +552,30 @@ void PicManagerTerminate(PicManager *pm)
 	StylesTerminate(&pm->exitStyleNames);
 	StylesTerminate(&pm->doorStyleNames);
 	StylesTerminate(&pm->keyStyleNames);
+	PicPackTerminate(&pm->pack);
+	PicAtlasTerminate(&gPicAtlas);
 	IMG_Quit();
 }
+static int DetachSharedPic(any_t data, any_t item)
+{
+	NamedPic *n = item;
+	if (IsSharedData(data, n->pic.Data))
+	{
+		n->pic.Data = NULL;
+	}
+	return MAP_OK;
+}
+static int DetachSharedSprites(any_t data, any_t item)
+{
+	NamedSprites *n = item;
+	CA_FOREACH(Pic, p, n->pics)
+		if (IsSharedData(data, p->Data))
+		{
+			p->Data = NULL;
+		}
+	CA_FOREACH_END()
+	return MAP_OK;
+}
 static void StylesTerminate(CArray *styles)
 {
 	CA_FOREACH(char *, styleName, *styles)
@@ -516,7 +676,7 @@ void PicManagerGenerateMaskedPic(
 	Pic p = PicCopy(original);
 	for (int i = 0; i < p.size.x * p.size.y; i++)
 	{
-		color_t c = PIXEL2COLOR(original->Data[i]);
+		color_t c = PIXEL2COLOR(p.Data[i]);
 		// Apply mask based on which channel each pixel is
 		if (c.g <= 2 && c.b <= 2)
 		{
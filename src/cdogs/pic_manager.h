@@ -29,6 +29,7 @@
 
 #include "c_hashmap/hashmap.h"
 #include "cpic.h"
+#include "pic_pack.h"
 #include "pics.h"
 
 typedef struct
@@ -43,12 +44,18 @@ typedef struct
 	CArray exitStyleNames;	// of char *
 	CArray doorStyleNames;	// of char *
 	CArray keyStyleNames;	// of char *
+
+	PicPack pack;	// pre-baked pics and sprites, if loaded
 } PicManager;
 
 extern PicManager gPicManager;
 
 void PicManagerInit(PicManager *pm);
+// Load pics from the pre-baked pack next to the dir if there is one,
+// otherwise from the images in the dir
 void PicManagerLoad(PicManager *pm, const char *path);
+// Load pics from the images in the dir and write them to its pack
+bool PicManagerBake(PicManager *pm, const char *path);
 void PicManagerLoadDir(
 	PicManager *pm, const char *path, const char *prefix,
 	map_t pics, map_t sprites);
@@ -0,0 +1,418 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "pic_pack.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "c_array.h"
+#include "cpic.h"
+#include "log.h"
+#include "utils.h"
+
+
+typedef struct
+{
+	const char *Name;
+	bool IsSprites;
+	const Pic *Pics;
+	int NumPics;
+} PackItem;
+static int AddPicItem(any_t data, any_t item);
+static int AddSpritesItem(any_t data, any_t item);
+static int ComparePackItems(const void *v1, const void *v2);
+static size_t Align(const size_t offset);
+bool PicPackWrite(
+	const char *filename, map_t pics, map_t sprites, const Uint32 pixelFormat)
+{
+	bool res = false;
+	uint8_t *buf = NULL;
+	FILE *f = NULL;
+	CArray items;
+	CArrayInit(&items, sizeof(PackItem));
+	hashmap_iterate(pics, AddPicItem, &items);
+	hashmap_iterate(sprites, AddSpritesItem, &items);
+	// Sort so that the pack is reproducible
+	qsort(items.data, items.size, items.elemSize, ComparePackItems);
+
+	// Lay out the file
+	size_t numPics = 0;
+	size_t namesSize = 0;
+	size_t dataSize = 0;
+	CA_FOREACH(const PackItem, pi, items)
+		numPics += pi->NumPics;
+		namesSize += strlen(pi->Name) + 1;
+		for (int i = 0; i < pi->NumPics; i++)
+		{
+			const Pic *p = &pi->Pics[i];
+			dataSize += Align(p->size.x * p->size.y * sizeof *p->Data);
+		}
+	CA_FOREACH_END()
+	const size_t entriesOffset = sizeof(PicPackHeader);
+	const size_t picsOffset =
+		entriesOffset + items.size * sizeof(PicPackEntry);
+	const size_t namesOffset = picsOffset + numPics * sizeof(PicPackPic);
+	const size_t dataOffset = Align(namesOffset + namesSize);
+	const size_t size = dataOffset + dataSize;
+	if (size > UINT32_MAX)
+	{
+		LOG(LM_MAIN, LL_ERROR, "pic pack too large: %u bytes", (unsigned)size);
+		goto bail;
+	}
+	CCALLOC(buf, size);
+
+	PicPackHeader *h = (PicPackHeader *)buf;
+	h->Magic = PIC_PACK_MAGIC;
+	h->Version = PIC_PACK_VERSION;
+	h->PixelFormat = pixelFormat;
+	h->NumEntries = (uint32_t)items.size;
+	PicPackEntry *e = (PicPackEntry *)(buf + entriesOffset);
+	PicPackPic *pp = (PicPackPic *)(buf + picsOffset);
+	size_t nameOffset = namesOffset;
+	size_t picDataOffset = dataOffset;
+	CA_FOREACH(const PackItem, pi, items)
+		e->NameOffset = (uint32_t)nameOffset;
+		e->IsSprites = pi->IsSprites;
+		e->NumPics = pi->NumPics;
+		e->PicsOffset = (uint32_t)((uint8_t *)pp - buf);
+		strcpy((char *)buf + nameOffset, pi->Name);
+		nameOffset += strlen(pi->Name) + 1;
+		for (int i = 0; i < pi->NumPics; i++, pp++)
+		{
+			const Pic *p = &pi->Pics[i];
+			pp->W = p->size.x;
+			pp->H = p->size.y;
+			pp->OffsetX = p->offset.x;
+			pp->OffsetY = p->offset.y;
+			pp->DataOffset = (uint32_t)picDataOffset;
+			const size_t rowSize = p->size.x * sizeof *p->Data;
+			const size_t picSize = rowSize * p->size.y;
+			// Rows are written contiguously even if the pic is strided
+			for (int y = 0; y < p->size.y && rowSize > 0; y++)
+			{
+				memcpy(
+					buf + picDataOffset + y * rowSize,
+					p->Data + y * PIC_STRIDE(p), rowSize);
+			}
+			picDataOffset += Align(picSize);
+		}
+		e++;
+	CA_FOREACH_END()
+
+	f = fopen(filename, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot open pic pack %s for writing",
+			filename);
+		goto bail;
+	}
+	if (fwrite(buf, 1, size, f) != size)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to write pic pack %s", filename);
+		goto bail;
+	}
+	LOG(LM_MAIN, LL_INFO, "wrote pic pack %s: %d entries, %d pics, %u bytes",
+		filename, (int)items.size, (int)numPics, (unsigned)size);
+	res = true;
+
+bail:
+	if (f != NULL)
+	{
+		fclose(f);
+	}
+	CFREE(buf);
+	CArrayTerminate(&items);
+	return res;
+}
+static int AddPicItem(any_t data, any_t item)
+{
+	const NamedPic *np = item;
+	const PackItem pi = { np->name, false, &np->pic, 1 };
+	CArrayPushBack(data, &pi);
+	return MAP_OK;
+}
+static int AddSpritesItem(any_t data, any_t item)
+{
+	const NamedSprites *ns = item;
+	const PackItem pi = {
+		ns->name, true, ns->pics.data, (int)ns->pics.size
+	};
+	CArrayPushBack(data, &pi);
+	return MAP_OK;
+}
+static int ComparePackItems(const void *v1, const void *v2)
+{
+	const PackItem *p1 = v1;
+	const PackItem *p2 = v2;
+	if (p1->IsSprites != p2->IsSprites)
+	{
+		return p1->IsSprites ? 1 : -1;
+	}
+	return strcmp(p1->Name, p2->Name);
+}
+static size_t Align(const size_t offset)
+{
+	return (offset + PIC_PACK_ALIGN - 1) / PIC_PACK_ALIGN * PIC_PACK_ALIGN;
+}
+
+static bool Map(PicPack *pack, const char *filename);
+static bool Validate(const PicPack *pack, const Uint32 pixelFormat);
+static bool LoadEntry(
+	const PicPack *pack, const PicPackEntry *e, map_t pics, map_t sprites);
+bool PicPackLoad(
+	PicPack *pack, const char *filename, map_t pics, map_t sprites,
+	const Uint32 pixelFormat)
+{
+	memset(pack, 0, sizeof *pack);
+	if (!Map(pack, filename))
+	{
+		return false;
+	}
+	if (!Validate(pack, pixelFormat))
+	{
+		LOG(LM_MAIN, LL_WARN, "ignoring invalid or old pic pack %s",
+			filename);
+		PicPackTerminate(pack);
+		return false;
+	}
+	const PicPackHeader *h = (const PicPackHeader *)pack->data;
+	const PicPackEntry *e =
+		(const PicPackEntry *)(pack->data + sizeof *h);
+	for (int i = 0; i < (int)h->NumEntries; i++, e++)
+	{
+		if (!LoadEntry(pack, e, pics, sprites))
+		{
+			LOG(LM_MAIN, LL_ERROR, "failed to load pic pack entry %d", i);
+		}
+	}
+	LOG(LM_MAIN, LL_INFO, "loaded pic pack %s: %d entries, %u bytes",
+		filename, (int)h->NumEntries, (unsigned)pack->size);
+	return true;
+}
+static bool Map(PicPack *pack, const char *filename)
+{
+#ifdef _WIN32
+	pack->file = CreateFileA(
+		filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, NULL);
+	if (pack->file == INVALID_HANDLE_VALUE)
+	{
+		pack->file = NULL;
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(pack->file, &size) || size.QuadPart == 0)
+	{
+		goto bail;
+	}
+	pack->size = (size_t)size.QuadPart;
+	pack->mapping = CreateFileMappingA(
+		pack->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (pack->mapping == NULL)
+	{
+		goto bail;
+	}
+	pack->data = MapViewOfFile(pack->mapping, FILE_MAP_READ, 0, 0, 0);
+	if (pack->data == NULL)
+	{
+		goto bail;
+	}
+	return true;
+
+bail:
+	LOG(LM_MAIN, LL_ERROR, "cannot map pic pack %s: %lu",
+		filename, GetLastError());
+	PicPackTerminate(pack);
+	return false;
+#else
+	const int fd = open(filename, O_RDONLY);
+	if (fd == -1)
+	{
+		return false;
+	}
+	bool res = false;
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size == 0)
+	{
+		goto bail;
+	}
+	void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (data == MAP_FAILED)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot map pic pack %s: %s",
+			filename, strerror(errno));
+		goto bail;
+	}
+	pack->data = data;
+	pack->size = (size_t)st.st_size;
+	res = true;
+
+bail:
+	// The mapping stays valid after closing
+	close(fd);
+	return res;
+#endif
+}
+static bool InRange(const PicPack *pack, const size_t offset, const size_t size)
+{
+	return offset <= pack->size && size <= pack->size - offset;
+}
+static bool Validate(const PicPack *pack, const Uint32 pixelFormat)
+{
+	if (pack->size < sizeof(PicPackHeader))
+	{
+		return false;
+	}
+	const PicPackHeader *h = (const PicPackHeader *)pack->data;
+	if (h->Magic != PIC_PACK_MAGIC || h->Version != PIC_PACK_VERSION ||
+		h->PixelFormat != pixelFormat)
+	{
+		return false;
+	}
+	return InRange(
+		pack, sizeof *h, (size_t)h->NumEntries * sizeof(PicPackEntry));
+}
+static bool LoadEntry(
+	const PicPack *pack, const PicPackEntry *e, map_t pics, map_t sprites)
+{
+	// Check everything is within the pack before using it
+	if (!InRange(pack, e->NameOffset, 1) ||
+		memchr(
+			pack->data + e->NameOffset, '\0', pack->size - e->NameOffset) ==
+			NULL ||
+		!InRange(pack, e->PicsOffset, (size_t)e->NumPics * sizeof(PicPackPic)))
+	{
+		return false;
+	}
+	const PicPackPic *pp = (const PicPackPic *)(pack->data + e->PicsOffset);
+	for (int i = 0; i < (int)e->NumPics; i++)
+	{
+		if (pp[i].W < 0 || pp[i].H < 0 ||
+			pp[i].DataOffset % PIC_PACK_ALIGN != 0 ||
+			!InRange(
+				pack, pp[i].DataOffset,
+				(size_t)pp[i].W * pp[i].H * sizeof(Uint32)))
+		{
+			return false;
+		}
+	}
+
+	const char *name = (const char *)pack->data + e->NameOffset;
+	NamedPic *np = NULL;
+	NamedSprites *ns = NULL;
+	if (e->IsSprites)
+	{
+		CMALLOC(ns, sizeof *ns);
+		NamedSpritesInit(ns, name);
+	}
+	else
+	{
+		if (e->NumPics != 1)
+		{
+			return false;
+		}
+		CMALLOC(np, sizeof *np);
+		CSTRDUP(np->name, name);
+	}
+	for (int i = 0; i < (int)e->NumPics; i++, pp++)
+	{
+		Pic p;
+		p.size = svec2i(pp->W, pp->H);
+		p.offset = svec2i(pp->OffsetX, pp->OffsetY);
+		p.Data = (Uint32 *)(pack->data + pp->DataOffset);
+		p.Stride = 0;
+		if (ns != NULL)
+		{
+			CArrayPushBack(&ns->pics, &p);
+		}
+		else
+		{
+			np->pic = p;
+		}
+	}
+	const int error = ns != NULL ?
+		hashmap_put(sprites, name, ns) : hashmap_put(pics, name, np);
+	if (error != MAP_OK)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to add packed pic %s: %d",
+			name, error);
+		if (ns != NULL)
+		{
+			CArrayTerminate(&ns->pics);
+			CFREE(ns->name);
+			CFREE(ns);
+		}
+		else
+		{
+			CFREE(np->name);
+			CFREE(np);
+		}
+		return false;
+	}
+	return true;
+}
+
+void PicPackTerminate(PicPack *pack)
+{
+#ifdef _WIN32
+	if (pack->data != NULL)
+	{
+		UnmapViewOfFile(pack->data);
+	}
+	if (pack->mapping != NULL)
+	{
+		CloseHandle(pack->mapping);
+	}
+	if (pack->file != NULL)
+	{
+		CloseHandle(pack->file);
+	}
+#else
+	if (pack->data != NULL)
+	{
+		munmap(pack->data, pack->size);
+	}
+#endif
+	memset(pack, 0, sizeof *pack);
+}
+
+bool PicPackHasData(const PicPack *pack, const void *data)
+{
+	const uint8_t *d = data;
+	return pack->data != NULL && d >= pack->data &&
+		d < pack->data + pack->size;
+}
@@ -0,0 +1,101 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <SDL_stdinc.h>
+
+#include "c_hashmap/hashmap.h"
+
+// Pre-baked pics and sprites, converted to the graphics device's pixel
+// format and memory-mapped read-only, so that loading them is near instant
+// and the pages are shared between processes.
+// Pics loaded from a pack point into the mapping; their data must not be
+// modified or freed.
+//
+// Layout; all offsets are from the start of the file, in native byte order:
+// - PicPackHeader
+// - PicPackEntry[NumEntries], sorted by name
+// - PicPackPic[], NumPics for each entry
+// - names, null terminated
+// - pixel data, PIC_PACK_ALIGN aligned
+
+#define PIC_PACK_MAGIC 0x4b504443	// "CDPK"
+// Bump when the layout or pixel conversion changes
+#define PIC_PACK_VERSION 1
+#define PIC_PACK_ALIGN 16
+// Pack file name, relative to the graphics dir's parent
+#define PIC_PACK_EXT ".pak"
+
+typedef struct
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t PixelFormat;
+	uint32_t NumEntries;
+} PicPackHeader;
+typedef struct
+{
+	uint32_t NameOffset;
+	uint32_t IsSprites;
+	uint32_t NumPics;
+	uint32_t PicsOffset;
+} PicPackEntry;
+typedef struct
+{
+	int32_t W;
+	int32_t H;
+	int32_t OffsetX;
+	int32_t OffsetY;
+	uint32_t DataOffset;
+	uint32_t Pad;
+} PicPackPic;
+
+typedef struct
+{
+	// The mapping is read-only, but pics point into it with non-const Data
+	uint8_t *data;
+	size_t size;
+#ifdef _WIN32
+	void *file;
+	void *mapping;
+#endif
+} PicPack;
+
+// Write pics (of NamedPic) and sprites (of NamedSprites) to a pack file
+bool PicPackWrite(
+	const char *filename, map_t pics, map_t sprites, const Uint32 pixelFormat);
+// Map a pack file and add its pics and sprites; fails if the pack is
+// missing, invalid, or for a different version or pixel format
+bool PicPackLoad(
+	PicPack *pack, const char *filename, map_t pics, map_t sprites,
+	const Uint32 pixelFormat);
+void PicPackTerminate(PicPack *pack);
+// Whether pic data is in the pack's mapping, and must not be freed
+bool PicPackHasData(const PicPack *pack, const void *data);
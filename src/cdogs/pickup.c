@@ -33,10 +33,12 @@
 #include "json_utils.h"
 #include "net_util.h"
 #include "map.h"
+#include "uid_map.h"
 
 
 CArray gPickups;
 static unsigned int sPickupUIDs;
+static UIDMap sPickupUIDMap;
 
 
 void PickupsInit(void)
@@ -44,6 +46,7 @@ void PickupsInit(void)
 	CArrayInit(&gPickups, sizeof(Pickup));
 	CArrayReserve(&gPickups, 128);
 	sPickupUIDs = 0;
+	UIDMapInit(&sPickupUIDMap);
 }
 void PickupsTerminate(void)
 {
@@ -54,6 +57,7 @@ void PickupsTerminate(void)
 		}
 	CA_FOREACH_END()
 	CArrayTerminate(&gPickups);
+	UIDMapTerminate(&sPickupUIDMap);
 }
 int PickupsGetNextUID(void)
 {
@@ -90,6 +94,7 @@ void PickupAdd(const NAddPickup ap)
 	}
 	memset(p, 0, sizeof *p);
 	p->UID = ap.UID;
+	UIDMapSet(&sPickupUIDMap, ap.UID, i);
 	p->class = StrPickupClass(ap.PickupClass);
 	TileItemInit(
 		&p->tileItem, i, KIND_PICKUP, p->class->Pic->size, ap.TileItemFlags);
@@ -300,11 +305,6 @@ static const Pic *GetPickupPic(const int id, struct vec2i *offset)
 
 Pickup *PickupGetByUID(const int uid)
 {
-	CA_FOREACH(Pickup, p, gPickups)
-		if (p->UID == uid)
-		{
-			return p;
-		}
-	CA_FOREACH_END()
-	return NULL;
+	const int id = UIDMapGet(&sPickupUIDMap, uid);
+	return id >= 0 ? CArrayGet(&gPickups, id) : NULL;
 }
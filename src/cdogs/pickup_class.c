@@ -28,6 +28,7 @@
 #include "pickup.h"
 
 #include "ammo.h"
+#include "class_index.h"
 #include "game_events.h"
 #include "json_utils.h"
 #include "log.h"
@@ -54,24 +55,17 @@ PickupClass *StrPickupClass(const char *s)
 	{
 		return NULL;
 	}
-	CA_FOREACH(PickupClass, c, gPickupClasses.CustomClasses)
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
-	CA_FOREACH_END()
-	CA_FOREACH(PickupClass, c, gPickupClasses.Classes)
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
-	CA_FOREACH_END()
-	CA_FOREACH(PickupClass, c, gPickupClasses.KeyClasses)
-		if (strcmp(s, c->Name) == 0)
-		{
-			return c;
-		}
-	CA_FOREACH_END()
+	const CArray *arrays[] =
+	{
+		&gPickupClasses.CustomClasses, &gPickupClasses.Classes,
+		&gPickupClasses.KeyClasses, NULL
+	};
+	PickupClass *c = ClassIndexGet(
+		&gPickupClasses.index, arrays, offsetof(PickupClass, Name), s);
+	if (c != NULL)
+	{
+		return c;
+	}
 	CASSERT(false, "cannot parse pickup class");
 	return NULL;
 }
@@ -172,6 +166,7 @@ void PickupClassesInit(
 	CArrayInit(&classes->Classes, sizeof(PickupClass));
 	CArrayInit(&classes->CustomClasses, sizeof(PickupClass));
 	CArrayInit(&classes->KeyClasses, sizeof(PickupClass));
+	classes->index = NULL;
 
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, filename);
@@ -203,6 +198,7 @@ bail:
 static bool TryLoadPickupclass(PickupClass *c, json_t *node);
 void PickupClassesLoadJSON(CArray *classes, json_t *root)
 {
+	ClassIndexReset(&gPickupClasses.index);
 	int version = -1;
 	LoadInt(&version, root, "Version");
 	if (version > VERSION || version <= 0)
@@ -262,6 +258,7 @@ static bool TryLoadPickupclass(PickupClass *c, json_t *node)
 
 void PickupClassesLoadAmmo(CArray *classes, const CArray *ammoClasses)
 {
+	ClassIndexReset(&gPickupClasses.index);
 	for (int i = 0; i < (int)ammoClasses->size; i++)
 	{
 		const Ammo *a = CArrayGet(ammoClasses, i);
@@ -279,6 +276,7 @@ void PickupClassesLoadAmmo(CArray *classes, const CArray *ammoClasses)
 
 void PickupClassesLoadGuns(CArray *classes, const CArray *gunClasses)
 {
+	ClassIndexReset(&gPickupClasses.index);
 	for (int i = 0; i < (int)gunClasses->size; i++)
 	{
 		const GunDescription *g = CArrayGet(gunClasses, i);
@@ -295,6 +293,7 @@ void PickupClassesLoadGuns(CArray *classes, const CArray *gunClasses)
 
 void PickupClassesLoadKeys(CArray *classes)
 {
+	ClassIndexReset(&gPickupClasses.index);
 	CA_FOREACH(const char *, keyStyleName, gPicManager.keyStyleNames)
 		for (int i = 0; i < KEY_COUNT; i++)
 		{
@@ -313,6 +312,7 @@ void PickupClassesLoadKeys(CArray *classes)
 
 void PickupClassesClear(CArray *classes)
 {
+	ClassIndexReset(&gPickupClasses.index);
 	CA_FOREACH(PickupClass, c, *classes)
 		CFREE(c->Name);
 	CA_FOREACH_END()
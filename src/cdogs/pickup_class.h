@@ -64,6 +64,7 @@ typedef struct
 	CArray Classes;			// of PickupClass
 	CArray CustomClasses;	// of PickupClass
 	CArray KeyClasses;		// of PickupClass
+	map_t index;	// name -> PickupClass *; built on demand
 } PickupClasses;
 extern PickupClasses gPickupClasses;
 
@@ -1,5 +1,5 @@
 /* Automatically generated nanopb header */
-/* Generated by nanopb-0.3.9 at Mon Nov 20 23:36:16 2017. */
+/* Generated by nanopb-0.3.9 at Sat Oct 17 00:02:44 2026. */
 
 #ifndef PB_MSG_PB_H_INCLUDED
 #define PB_MSG_PB_H_INCLUDED
@@ -174,6 +174,32 @@ typedef struct _NRemovePickup {
 /* @@protoc_insertion_point(struct:NRemovePickup) */
 } NRemovePickup;
 
+typedef struct _NReplayCmd {
+    uint32_t Ticks;
+    uint32_t Idx;
+    int32_t Cmd;
+/* @@protoc_insertion_point(struct:NReplayCmd) */
+} NReplayCmd;
+
+typedef struct _NReplayHash {
+    uint32_t Ticks;
+    uint32_t Hash;
+/* @@protoc_insertion_point(struct:NReplayHash) */
+} NReplayHash;
+
+typedef struct _NReplayMission {
+    uint32_t Version;
+    int32_t RandomSeed;
+    uint32_t Seed;
+/* @@protoc_insertion_point(struct:NReplayMission) */
+} NReplayMission;
+
+typedef struct _NReplayPlayer {
+    uint32_t UID;
+    int32_t InputDevice;
+/* @@protoc_insertion_point(struct:NReplayPlayer) */
+} NReplayPlayer;
+
 typedef struct _NRescueCharacter {
     uint32_t UID;
 /* @@protoc_insertion_point(struct:NRescueCharacter) */
@@ -197,6 +223,25 @@ typedef struct _NServerInfo {
 /* @@protoc_insertion_point(struct:NServerInfo) */
 } NServerInfo;
 
+typedef PB_BYTES_ARRAY_T(1024) NSnapshot_Data_t;
+typedef struct _NSnapshot {
+    uint32_t Seq;
+    uint32_t BaseSeq;
+    NSnapshot_Data_t Data;
+/* @@protoc_insertion_point(struct:NSnapshot) */
+} NSnapshot;
+
+typedef struct _NSnapshotAck {
+    uint32_t Seq;
+/* @@protoc_insertion_point(struct:NSnapshotAck) */
+} NSnapshotAck;
+
+typedef struct _NStringDef {
+    uint32_t Id;
+    char Name[128];
+/* @@protoc_insertion_point(struct:NStringDef) */
+} NStringDef;
+
 typedef struct _NVec2 {
     float x;
     float y;
@@ -242,9 +287,17 @@ typedef struct _NActorMove {
     uint32_t UID;
     NVec2 Pos;
     NVec2 MoveVel;
+    uint32_t Seq;
 /* @@protoc_insertion_point(struct:NActorMove) */
 } NActorMove;
 
+typedef struct _NActorMoveAck {
+    uint32_t UID;
+    uint32_t Seq;
+    NVec2 Pos;
+/* @@protoc_insertion_point(struct:NActorMoveAck) */
+} NActorMoveAck;
+
 typedef struct _NActorSlide {
     uint32_t UID;
     NVec2 Vel;
@@ -261,6 +314,8 @@ typedef struct _NAddBullet {
     uint32_t Flags;
     int32_t PlayerUID;
     int32_t ActorUID;
+    bool has_BulletClassId;
+    uint32_t BulletClassId;
 /* @@protoc_insertion_point(struct:NAddBullet) */
 } NAddBullet;
 
@@ -277,6 +332,8 @@ typedef struct _NAddPickup {
     int32_t SpawnerUID;
     uint32_t TileItemFlags;
     NVec2 Pos;
+    bool has_PickupClassId;
+    uint32_t PickupClassId;
 /* @@protoc_insertion_point(struct:NAddPickup) */
 } NAddPickup;
 
@@ -316,6 +373,8 @@ typedef struct _NGunFire {
     bool Sound;
     uint32_t Flags;
     bool IsGun;
+    bool has_GunId;
+    uint32_t GunId;
 /* @@protoc_insertion_point(struct:NGunFire) */
 } NGunFire;
 
@@ -333,6 +392,8 @@ typedef struct _NMapObjectAdd {
     NVec2 Pos;
     uint32_t TileItemFlags;
     int32_t Health;
+    bool has_MapObjectClassId;
+    uint32_t MapObjectClassId;
 /* @@protoc_insertion_point(struct:NMapObjectAdd) */
 } NMapObjectAdd;
 
@@ -347,6 +408,8 @@ typedef struct _NSound {
     char Sound[128];
     NVec2 Pos;
     bool IsHit;
+    bool has_SoundId;
+    uint32_t SoundId;
 /* @@protoc_insertion_point(struct:NSound) */
 } NSound;
 
@@ -356,6 +419,10 @@ typedef struct _NTileSet {
     char PicName[128];
     char PicAltName[128];
     int32_t RunLength;
+    bool has_PicNameId;
+    uint32_t PicNameId;
+    bool has_PicAltNameId;
+    uint32_t PicAltNameId;
 /* @@protoc_insertion_point(struct:NTileSet) */
 } NTileSet;
 
@@ -412,46 +479,54 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NPlayerData_init_default                 {"", "", NCharColors_init_default, 0, {"", "", ""}, 0, NPlayerStats_init_default, NPlayerStats_init_default, 0, 0, 0}
 #define NPlayerRemove_init_default               {0}
 #define NConfig_init_default                     {"", ""}
-#define NTileSet_init_default                    {NVec2i_init_default, 0, "", "", 0}
-#define NMapObjectAdd_init_default               {0, "", Nsvec2_init_default, 0, 0}
+#define NTileSet_init_default                    {NVec2i_init_default, 0, "", "", 0, false, 0, false, 0}
+#define NMapObjectAdd_init_default               {0, "", NVec2_init_default, 0, 0, false, 0}
 #define NMapObjectDamage_init_default            {0, 0, 0, 0, 0}
 #define NMapObjectRemove_init_default            {0, 0, 0, 0}
 #define NScore_init_default                      {0, 0}
-#define NSound_init_default                      {"", Nsvec2_init_default, 0}
+#define NSound_init_default                      {"", NVec2_init_default, 0, false, 0}
 #define NVec2i_init_default                      {0, 0}
-#define Nsvec2_init_default                       {0, 0}
+#define NVec2_init_default                       {0, 0}
 #define NGameBegin_init_default                  {0}
-#define NActorAdd_init_default                   {0, 0, 4, 0, -1, 0, Nsvec2_init_default}
-#define NActorMove_init_default                  {0, Nsvec2_init_default, Nsvec2_init_default}
+#define NActorAdd_init_default                   {0, 0, 4, 0, -1, 0, NVec2_init_default}
+#define NActorMove_init_default                  {0, NVec2_init_default, NVec2_init_default, 0}
 #define NActorState_init_default                 {0, 0}
 #define NActorDir_init_default                   {0, 0}
-#define NActorSlide_init_default                 {0, Nsvec2_init_default}
-#define NActorImpulse_init_default               {0, Nsvec2_init_default, Nsvec2_init_default}
+#define NActorSlide_init_default                 {0, NVec2_init_default}
+#define NActorImpulse_init_default               {0, NVec2_init_default, NVec2_init_default}
 #define NActorSwitchGun_init_default             {0, 0}
 #define NActorPickupAll_init_default             {0, 0}
 #define NActorReplaceGun_init_default            {0, 0, ""}
 #define NActorHeal_init_default                  {0, -1, 0, 0}
-#define NActorHit_init_default                   {0, -1, -1, 0, 0, Nsvec2_init_default, 0}
+#define NActorHit_init_default                   {0, -1, -1, 0, 0, NVec2_init_default, 0}
 #define NActorAddAmmo_init_default               {0, -1, 0, 0, 0}
 #define NActorUseAmmo_init_default               {0, -1, 0, 0}
 #define NActorDie_init_default                   {0}
 #define NActorMelee_init_default                 {0, "", 0, 0, 0}
-#define NAddPickup_init_default                  {0, "", 0, -1, 0, Nsvec2_init_default}
+#define NAddPickup_init_default                  {0, "", 0, -1, 0, NVec2_init_default, false, 0}
 #define NRemovePickup_init_default               {0, -1}
-#define NBulletBounce_init_default               {0, 0, 0, Nsvec2_init_default, Nsvec2_init_default, Nsvec2_init_default, 0}
+#define NBulletBounce_init_default               {0, 0, 0, NVec2_init_default, NVec2_init_default, NVec2_init_default, 0}
 #define NRemoveBullet_init_default               {0}
-#define NGunReload_init_default                  {-1, "", Nsvec2_init_default, 0}
-#define NGunFire_init_default                    {-1, -1, "", Nsvec2_init_default, 0, 0, 0, 0, 0}
+#define NGunReload_init_default                  {-1, "", NVec2_init_default, 0}
+#define NGunFire_init_default                    {-1, -1, "", NVec2_init_default, 0, 0, 0, 0, 0, false, 0}
 #define NGunState_init_default                   {0, 0}
-#define NAddBullet_init_default                  {0, "", Nsvec2_init_default, 0, 0, 0, 0, -1, -1}
+#define NAddBullet_init_default                  {0, "", NVec2_init_default, 0, 0, 0, 0, -1, -1, false, 0}
 #define NTrigger_init_default                    {0, NVec2i_init_default}
 #define NExploreTiles_init_default               {0, {NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default, NExploreTiles_Run_init_default}}
 #define NExploreTiles_Run_init_default           {NVec2i_init_default, 0}
 #define NRescueCharacter_init_default            {0}
 #define NObjectiveUpdate_init_default            {0, 0}
-#define NAddKeys_init_default                    {0, Nsvec2_init_default}
+#define NAddKeys_init_default                    {0, NVec2_init_default}
 #define NMissionComplete_init_default            {0, NVec2i_init_default, NVec2i_init_default}
 #define NMissionEnd_init_default                 {0, 0, ""}
+#define NSnapshot_init_default                   {0, 0, {0, {0}}}
+#define NSnapshotAck_init_default                {0}
+#define NStringDef_init_default                  {0, ""}
+#define NActorMoveAck_init_default               {0, 0, NVec2_init_default}
+#define NReplayMission_init_default              {0, 0, 0}
+#define NReplayPlayer_init_default               {0, 0}
+#define NReplayCmd_init_default                  {0, 0, 0}
+#define NReplayHash_init_default                 {0, 0}
 #define NServerInfo_init_zero                    {0, 0, "", 0, "", 0, 0, 0}
 #define NClientId_init_zero                      {0, 0}
 #define NCampaignDef_init_zero                   {"", 0, 0}
@@ -461,46 +536,54 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NPlayerData_init_zero                    {"", "", NCharColors_init_zero, 0, {"", "", ""}, 0, NPlayerStats_init_zero, NPlayerStats_init_zero, 0, 0, 0}
 #define NPlayerRemove_init_zero                  {0}
 #define NConfig_init_zero                        {"", ""}
-#define NTileSet_init_zero                       {NVec2i_init_zero, 0, "", "", 0}
-#define NMapObjectAdd_init_zero                  {0, "", Nsvec2_init_zero, 0, 0}
+#define NTileSet_init_zero                       {NVec2i_init_zero, 0, "", "", 0, false, 0, false, 0}
+#define NMapObjectAdd_init_zero                  {0, "", NVec2_init_zero, 0, 0, false, 0}
 #define NMapObjectDamage_init_zero               {0, 0, 0, 0, 0}
 #define NMapObjectRemove_init_zero               {0, 0, 0, 0}
 #define NScore_init_zero                         {0, 0}
-#define NSound_init_zero                         {"", Nsvec2_init_zero, 0}
+#define NSound_init_zero                         {"", NVec2_init_zero, 0, false, 0}
 #define NVec2i_init_zero                         {0, 0}
-#define Nsvec2_init_zero                          {0, 0}
+#define NVec2_init_zero                          {0, 0}
 #define NGameBegin_init_zero                     {0}
-#define NActorAdd_init_zero                      {0, 0, 0, 0, 0, 0, Nsvec2_init_zero}
-#define NActorMove_init_zero                     {0, Nsvec2_init_zero, Nsvec2_init_zero}
+#define NActorAdd_init_zero                      {0, 0, 0, 0, 0, 0, NVec2_init_zero}
+#define NActorMove_init_zero                     {0, NVec2_init_zero, NVec2_init_zero, 0}
 #define NActorState_init_zero                    {0, 0}
 #define NActorDir_init_zero                      {0, 0}
-#define NActorSlide_init_zero                    {0, Nsvec2_init_zero}
-#define NActorImpulse_init_zero                  {0, Nsvec2_init_zero, Nsvec2_init_zero}
+#define NActorSlide_init_zero                    {0, NVec2_init_zero}
+#define NActorImpulse_init_zero                  {0, NVec2_init_zero, NVec2_init_zero}
 #define NActorSwitchGun_init_zero                {0, 0}
 #define NActorPickupAll_init_zero                {0, 0}
 #define NActorReplaceGun_init_zero               {0, 0, ""}
 #define NActorHeal_init_zero                     {0, 0, 0, 0}
-#define NActorHit_init_zero                      {0, 0, 0, 0, 0, Nsvec2_init_zero, 0}
+#define NActorHit_init_zero                      {0, 0, 0, 0, 0, NVec2_init_zero, 0}
 #define NActorAddAmmo_init_zero                  {0, 0, 0, 0, 0}
 #define NActorUseAmmo_init_zero                  {0, 0, 0, 0}
 #define NActorDie_init_zero                      {0}
 #define NActorMelee_init_zero                    {0, "", 0, 0, 0}
-#define NAddPickup_init_zero                     {0, "", 0, 0, 0, Nsvec2_init_zero}
+#define NAddPickup_init_zero                     {0, "", 0, 0, 0, NVec2_init_zero, false, 0}
 #define NRemovePickup_init_zero                  {0, 0}
-#define NBulletBounce_init_zero                  {0, 0, 0, Nsvec2_init_zero, Nsvec2_init_zero, Nsvec2_init_zero, 0}
+#define NBulletBounce_init_zero                  {0, 0, 0, NVec2_init_zero, NVec2_init_zero, NVec2_init_zero, 0}
 #define NRemoveBullet_init_zero                  {0}
-#define NGunReload_init_zero                     {0, "", Nsvec2_init_zero, 0}
-#define NGunFire_init_zero                       {0, 0, "", Nsvec2_init_zero, 0, 0, 0, 0, 0}
+#define NGunReload_init_zero                     {0, "", NVec2_init_zero, 0}
+#define NGunFire_init_zero                       {0, 0, "", NVec2_init_zero, 0, 0, 0, 0, 0, false, 0}
 #define NGunState_init_zero                      {0, 0}
-#define NAddBullet_init_zero                     {0, "", Nsvec2_init_zero, 0, 0, 0, 0, 0, 0}
+#define NAddBullet_init_zero                     {0, "", NVec2_init_zero, 0, 0, 0, 0, 0, 0, false, 0}
 #define NTrigger_init_zero                       {0, NVec2i_init_zero}
 #define NExploreTiles_init_zero                  {0, {NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero, NExploreTiles_Run_init_zero}}
 #define NExploreTiles_Run_init_zero              {NVec2i_init_zero, 0}
 #define NRescueCharacter_init_zero               {0}
 #define NObjectiveUpdate_init_zero               {0, 0}
-#define NAddKeys_init_zero                       {0, Nsvec2_init_zero}
+#define NAddKeys_init_zero                       {0, NVec2_init_zero}
 #define NMissionComplete_init_zero               {0, NVec2i_init_zero, NVec2i_init_zero}
 #define NMissionEnd_init_zero                    {0, 0, ""}
+#define NSnapshot_init_zero                      {0, 0, {0, {0}}}
+#define NSnapshotAck_init_zero                   {0}
+#define NStringDef_init_zero                     {0, ""}
+#define NActorMoveAck_init_zero                  {0, 0, NVec2_init_zero}
+#define NReplayMission_init_zero                 {0, 0, 0}
+#define NReplayPlayer_init_zero                  {0, 0}
+#define NReplayCmd_init_zero                     {0, 0, 0}
+#define NReplayHash_init_zero                    {0, 0}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define NActorAddAmmo_UID_tag                    1
@@ -566,6 +649,16 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NRemoveBullet_UID_tag                    1
 #define NRemovePickup_UID_tag                    1
 #define NRemovePickup_SpawnerUID_tag             2
+#define NReplayCmd_Ticks_tag                     1
+#define NReplayCmd_Idx_tag                       2
+#define NReplayCmd_Cmd_tag                       3
+#define NReplayHash_Ticks_tag                    1
+#define NReplayHash_Hash_tag                     2
+#define NReplayMission_Version_tag               1
+#define NReplayMission_RandomSeed_tag            2
+#define NReplayMission_Seed_tag                  3
+#define NReplayPlayer_UID_tag                    1
+#define NReplayPlayer_InputDevice_tag            2
 #define NRescueCharacter_UID_tag                 1
 #define NScore_PlayerUID_tag                     1
 #define NScore_Score_tag                         2
@@ -577,8 +670,14 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NServerInfo_MissionNumber_tag            6
 #define NServerInfo_NumPlayers_tag               7
 #define NServerInfo_MaxPlayers_tag               8
-#define Nsvec2_x_tag                              1
-#define Nsvec2_y_tag                              2
+#define NSnapshot_Seq_tag                        1
+#define NSnapshot_BaseSeq_tag                    2
+#define NSnapshot_Data_tag                       3
+#define NSnapshotAck_Seq_tag                     1
+#define NStringDef_Id_tag                        1
+#define NStringDef_Name_tag                      2
+#define NVec2_x_tag                              1
+#define NVec2_y_tag                              2
 #define NVec2i_x_tag                             1
 #define NVec2i_y_tag                             2
 #define NActorAdd_UID_tag                        1
@@ -601,6 +700,10 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NActorMove_UID_tag                       1
 #define NActorMove_Pos_tag                       2
 #define NActorMove_MoveVel_tag                   3
+#define NActorMove_Seq_tag                       4
+#define NActorMoveAck_UID_tag                    1
+#define NActorMoveAck_Seq_tag                    2
+#define NActorMoveAck_Pos_tag                    3
 #define NActorSlide_UID_tag                      1
 #define NActorSlide_Vel_tag                      2
 #define NAddBullet_UID_tag                       1
@@ -612,6 +715,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NAddBullet_Flags_tag                     7
 #define NAddBullet_PlayerUID_tag                 8
 #define NAddBullet_ActorUID_tag                  9
+#define NAddBullet_BulletClassId_tag             10
 #define NAddKeys_KeyFlags_tag                    1
 #define NAddKeys_Pos_tag                         2
 #define NAddPickup_UID_tag                       1
@@ -620,6 +724,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NAddPickup_SpawnerUID_tag                4
 #define NAddPickup_TileItemFlags_tag             5
 #define NAddPickup_Pos_tag                       6
+#define NAddPickup_PickupClassId_tag             7
 #define NBulletBounce_UID_tag                    1
 #define NBulletBounce_HitType_tag                2
 #define NBulletBounce_Spark_tag                  3
@@ -643,6 +748,7 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NGunFire_Sound_tag                       7
 #define NGunFire_Flags_tag                       8
 #define NGunFire_IsGun_tag                       9
+#define NGunFire_GunId_tag                       10
 #define NGunReload_PlayerUID_tag                 1
 #define NGunReload_Gun_tag                       2
 #define NGunReload_Pos_tag                       3
@@ -652,17 +758,21 @@ extern const int32_t NAddBullet_ActorUID_default;
 #define NMapObjectAdd_Pos_tag                    3
 #define NMapObjectAdd_TileItemFlags_tag          4
 #define NMapObjectAdd_Health_tag                 5
+#define NMapObjectAdd_MapObjectClassId_tag       6
 #define NMissionComplete_ShowMsg_tag             1
 #define NMissionComplete_ExitStart_tag           2
 #define NMissionComplete_ExitEnd_tag             3
 #define NSound_Sound_tag                         1
 #define NSound_Pos_tag                           2
 #define NSound_IsHit_tag                         3
+#define NSound_SoundId_tag                       4
 #define NTileSet_Pos_tag                         1
 #define NTileSet_Flags_tag                       2
 #define NTileSet_PicName_tag                     3
 #define NTileSet_PicAltName_tag                  4
 #define NTileSet_RunLength_tag                   5
+#define NTileSet_PicNameId_tag                   6
+#define NTileSet_PicAltNameId_tag                7
 #define NTrigger_ID_tag                          1
 #define NTrigger_Tile_tag                        2
 #define NExploreTiles_Runs_tag                   1
@@ -687,17 +797,17 @@ extern const pb_field_t NPlayerStats_fields[5];
 extern const pb_field_t NPlayerData_fields[11];
 extern const pb_field_t NPlayerRemove_fields[2];
 extern const pb_field_t NConfig_fields[3];
-extern const pb_field_t NTileSet_fields[6];
-extern const pb_field_t NMapObjectAdd_fields[6];
+extern const pb_field_t NTileSet_fields[8];
+extern const pb_field_t NMapObjectAdd_fields[7];
 extern const pb_field_t NMapObjectDamage_fields[6];
 extern const pb_field_t NMapObjectRemove_fields[5];
 extern const pb_field_t NScore_fields[3];
-extern const pb_field_t NSound_fields[4];
+extern const pb_field_t NSound_fields[5];
 extern const pb_field_t NVec2i_fields[3];
-extern const pb_field_t Nsvec2_fields[3];
+extern const pb_field_t NVec2_fields[3];
 extern const pb_field_t NGameBegin_fields[2];
 extern const pb_field_t NActorAdd_fields[8];
-extern const pb_field_t NActorMove_fields[4];
+extern const pb_field_t NActorMove_fields[5];
 extern const pb_field_t NActorState_fields[3];
 extern const pb_field_t NActorDir_fields[3];
 extern const pb_field_t NActorSlide_fields[3];
@@ -711,14 +821,14 @@ extern const pb_field_t NActorAddAmmo_fields[6];
 extern const pb_field_t NActorUseAmmo_fields[5];
 extern const pb_field_t NActorDie_fields[2];
 extern const pb_field_t NActorMelee_fields[6];
-extern const pb_field_t NAddPickup_fields[7];
+extern const pb_field_t NAddPickup_fields[8];
 extern const pb_field_t NRemovePickup_fields[3];
 extern const pb_field_t NBulletBounce_fields[8];
 extern const pb_field_t NRemoveBullet_fields[2];
 extern const pb_field_t NGunReload_fields[5];
-extern const pb_field_t NGunFire_fields[10];
+extern const pb_field_t NGunFire_fields[11];
 extern const pb_field_t NGunState_fields[3];
-extern const pb_field_t NAddBullet_fields[10];
+extern const pb_field_t NAddBullet_fields[11];
 extern const pb_field_t NTrigger_fields[3];
 extern const pb_field_t NExploreTiles_fields[2];
 extern const pb_field_t NExploreTiles_Run_fields[3];
@@ -727,6 +837,14 @@ extern const pb_field_t NObjectiveUpdate_fields[3];
 extern const pb_field_t NAddKeys_fields[3];
 extern const pb_field_t NMissionComplete_fields[4];
 extern const pb_field_t NMissionEnd_fields[4];
+extern const pb_field_t NSnapshot_fields[4];
+extern const pb_field_t NSnapshotAck_fields[2];
+extern const pb_field_t NStringDef_fields[3];
+extern const pb_field_t NActorMoveAck_fields[4];
+extern const pb_field_t NReplayMission_fields[4];
+extern const pb_field_t NReplayPlayer_fields[3];
+extern const pb_field_t NReplayCmd_fields[4];
+extern const pb_field_t NReplayHash_fields[3];
 
 /* Maximum encoded size of messages (where known) */
 #define NServerInfo_size                         97
@@ -738,17 +856,17 @@ extern const pb_field_t NMissionEnd_fields[4];
 #define NPlayerData_size                         729
 #define NPlayerRemove_size                       6
 #define NConfig_size                             262
-#define NTileSet_size                            303
-#define NMapObjectAdd_size                       166
+#define NTileSet_size                            315
+#define NMapObjectAdd_size                       172
 #define NMapObjectDamage_size                    45
 #define NMapObjectRemove_size                    34
 #define NScore_size                              17
-#define NSound_size                              145
+#define NSound_size                              151
 #define NVec2i_size                              22
-#define Nsvec2_size                               10
+#define NVec2_size                               10
 #define NGameBegin_size                          11
 #define NActorAdd_size                           63
-#define NActorMove_size                          30
+#define NActorMove_size                          36
 #define NActorState_size                         17
 #define NActorDir_size                           17
 #define NActorSlide_size                         18
@@ -762,14 +880,14 @@ extern const pb_field_t NMissionEnd_fields[4];
 #define NActorUseAmmo_size                       29
 #define NActorDie_size                           6
 #define NActorMelee_size                         165
-#define NAddPickup_size                          168
+#define NAddPickup_size                          174
 #define NRemovePickup_size                       17
 #define NBulletBounce_size                       57
 #define NRemoveBullet_size                       6
 #define NGunReload_size                          165
-#define NGunFire_size                            191
+#define NGunFire_size                            197
 #define NGunState_size                           17
-#define NAddBullet_size                          204
+#define NAddBullet_size                          210
 #define NTrigger_size                            30
 #define NExploreTiles_size                       592
 #define NExploreTiles_Run_size                   35
@@ -778,6 +896,14 @@ extern const pb_field_t NMissionEnd_fields[4];
 #define NAddKeys_size                            18
 #define NMissionComplete_size                    50
 #define NMissionEnd_size                         144
+#define NSnapshot_size                           1039
+#define NSnapshotAck_size                        6
+#define NStringDef_size                          137
+#define NActorMoveAck_size                       24
+#define NReplayMission_size                      23
+#define NReplayPlayer_size                       17
+#define NReplayCmd_size                          23
+#define NReplayHash_size                         12
 
 /* Message IDs (where set with "msgid" option) */
 #ifdef PB_MSGID
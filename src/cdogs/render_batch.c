@@ -0,0 +1,340 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "render_batch.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "log.h"
+#include "pic_atlas.h"
+#include "texture.h"
+#include "utils.h"
+
+
+bool RenderBatchInit(
+	RenderBatch *b, SDL_Renderer *r, Uint32 *buf, const struct vec2i size)
+{
+	memset(b, 0, sizeof *b);
+	if (!SDL_RenderTargetSupported(r))
+	{
+		LOG(LM_GFX, LL_WARN, "render targets not supported");
+		return false;
+	}
+	b->canvas = TextureCreate(
+		r, SDL_TEXTUREACCESS_TARGET, size, SDL_BLENDMODE_NONE, 255);
+	if (b->canvas == NULL)
+	{
+		return false;
+	}
+	b->renderer = r;
+	b->buf = buf;
+	b->size = size;
+	b->textures = hashmap_new();
+	b->pics = hashmap_new();
+	CArrayInit(&b->cmds, sizeof(RenderCmd));
+	CArrayInit(&b->freed, sizeof(SDL_Texture *));
+	return true;
+}
+static void TextureDestroy(any_t data);
+static void GeneratedPicDestroy(any_t data);
+static void DestroyFreed(RenderBatch *b);
+void RenderBatchTerminate(RenderBatch *b)
+{
+	if (!RenderBatchIsEnabled(b))
+	{
+		return;
+	}
+	hashmap_destroy(b->textures, TextureDestroy);
+	hashmap_destroy(b->pics, GeneratedPicDestroy);
+	DestroyFreed(b);
+	CArrayTerminate(&b->freed);
+	CArrayTerminate(&b->cmds);
+	SDL_DestroyTexture(b->canvas);
+	memset(b, 0, sizeof *b);
+}
+static void TextureDestroy(any_t data)
+{
+	SDL_DestroyTexture(data);
+}
+static void GeneratedPicDestroy(any_t data)
+{
+	Pic *p = data;
+	CFREE(p->Data);
+	CFREE(p);
+}
+static void DestroyFreed(RenderBatch *b)
+{
+	CA_FOREACH(SDL_Texture *, t, b->freed)
+		SDL_DestroyTexture(*t);
+	CA_FOREACH_END()
+	CArrayClear(&b->freed);
+}
+
+bool RenderBatchIsEnabled(const RenderBatch *b)
+{
+	return b->renderer != NULL;
+}
+
+void RenderBatchClearTextures(RenderBatch *b)
+{
+	if (!RenderBatchIsEnabled(b))
+	{
+		return;
+	}
+	// Keep what has been drawn so far
+	if (b->cmds.size > 0)
+	{
+		RenderBatchSoftware(b);
+	}
+	hashmap_clear(b->textures, TextureDestroy);
+	hashmap_clear(b->pics, GeneratedPicDestroy);
+	DestroyFreed(b);
+}
+
+static void GetTextureKey(char *key, const void *data);
+void RenderBatchRemovePic(RenderBatch *b, const Pic *pic)
+{
+	if (!RenderBatchIsEnabled(b))
+	{
+		return;
+	}
+	char key[32];
+	GetTextureKey(key, pic->Data);
+	SDL_Texture *t;
+	if (hashmap_get(b->textures, key, (any_t *)&t) != MAP_OK)
+	{
+		return;
+	}
+	hashmap_remove(b->textures, key);
+	// Queued commands may still use it
+	CArrayPushBack(&b->freed, &t);
+}
+static void GetTextureKey(char *key, const void *data)
+{
+	sprintf(key, "%p", data);
+}
+
+const Pic *RenderBatchGetPic(const RenderBatch *b, const char *key)
+{
+	Pic *p;
+	if (hashmap_get(b->pics, key, (any_t *)&p) != MAP_OK)
+	{
+		return NULL;
+	}
+	return p;
+}
+const Pic *RenderBatchAddPic(RenderBatch *b, const char *key, const Pic *pic)
+{
+	Pic *p;
+	CMALLOC(p, sizeof *p);
+	*p = *pic;
+	if (hashmap_put(b->pics, key, p) != MAP_OK)
+	{
+		GeneratedPicDestroy(p);
+		return NULL;
+	}
+	return p;
+}
+
+static SDL_Texture *GetTexture(
+	RenderBatch *b, const Pic *pic, struct vec2i *offset);
+bool RenderBatchPic(
+	RenderBatch *b, const Pic *pic, const SDL_Rect src, const SDL_Rect dst,
+	const color_t mod, const SDL_BlendMode blend)
+{
+	if (!RenderBatchIsEnabled(b) || b->isSoftware)
+	{
+		return false;
+	}
+	struct vec2i offset;
+	SDL_Texture *t = GetTexture(b, pic, &offset);
+	if (t == NULL)
+	{
+		RenderBatchSoftware(b);
+		return false;
+	}
+	const SDL_Rect texSrc = {
+		src.x + offset.x, src.y + offset.y, src.w, src.h
+	};
+	const RenderCmd c = { RENDER_CMD_PIC, t, texSrc, dst, mod, blend };
+	CArrayPushBack(&b->cmds, &c);
+	return true;
+}
+static SDL_Texture *GetDataTexture(
+	RenderBatch *b, const Uint32 *data, const struct vec2i size,
+	const int stride);
+// Get the texture for a pic, and the pic's position in it
+static SDL_Texture *GetTexture(
+	RenderBatch *b, const Pic *pic, struct vec2i *offset)
+{
+	// Pics in the atlas share their page's texture
+	const PicAtlasPage *page = PicAtlasFind(&gPicAtlas, pic->Data, offset);
+	if (page != NULL)
+	{
+		return GetDataTexture(b, page->Data, page->Size, page->Size.x);
+	}
+	*offset = svec2i_zero();
+	return GetDataTexture(b, pic->Data, pic->size, PIC_STRIDE(pic));
+}
+static SDL_Texture *GetDataTexture(
+	RenderBatch *b, const Uint32 *data, const struct vec2i size,
+	const int stride)
+{
+	char key[32];
+	GetTextureKey(key, data);
+	SDL_Texture *t;
+	if (hashmap_get(b->textures, key, (any_t *)&t) == MAP_OK)
+	{
+		return t;
+	}
+	// Upload the pixels once
+	t = TextureCreate(
+		b->renderer, SDL_TEXTUREACCESS_STATIC, size, SDL_BLENDMODE_BLEND, 255);
+	if (t == NULL)
+	{
+		return NULL;
+	}
+	if (SDL_UpdateTexture(t, NULL, data, stride * sizeof(Uint32)) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot upload pic texture: %s",
+			SDL_GetError());
+		SDL_DestroyTexture(t);
+		return NULL;
+	}
+	if (hashmap_put(b->textures, key, t) != MAP_OK)
+	{
+		SDL_DestroyTexture(t);
+		return NULL;
+	}
+	return t;
+}
+
+bool RenderBatchRect(
+	RenderBatch *b, const SDL_Rect dst, const color_t c,
+	const SDL_BlendMode blend)
+{
+	if (!RenderBatchIsEnabled(b) || b->isSoftware)
+	{
+		return false;
+	}
+	const RenderCmd cmd = { RENDER_CMD_RECT, NULL, dst, dst, c, blend };
+	CArrayPushBack(&b->cmds, &cmd);
+	return true;
+}
+
+static bool Render(RenderBatch *b, SDL_Texture *t);
+void RenderBatchSoftware(RenderBatch *b)
+{
+	if (!RenderBatchIsEnabled(b) || b->isSoftware)
+	{
+		return;
+	}
+	b->isSoftware = true;
+	const int pitch = b->size.x * sizeof(Uint32);
+	if (b->cmds.size == 0)
+	{
+		memset(b->buf, 0, pitch * b->size.y);
+		return;
+	}
+	if (!Render(b, b->canvas) ||
+		SDL_RenderReadPixels(
+			b->renderer, NULL, SDL_PIXELFORMAT_ARGB8888, b->buf, pitch) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot read back layer: %s", SDL_GetError());
+		memset(b->buf, 0, pitch * b->size.y);
+	}
+	SDL_SetRenderTarget(b->renderer, NULL);
+	CArrayClear(&b->cmds);
+}
+
+void RenderBatchClear(RenderBatch *b)
+{
+	if (!RenderBatchIsEnabled(b))
+	{
+		return;
+	}
+	CArrayClear(&b->cmds);
+	DestroyFreed(b);
+	b->isSoftware = false;
+}
+
+void RenderBatchFlush(RenderBatch *b, SDL_Texture *t)
+{
+	if (b->isSoftware)
+	{
+		if (SDL_UpdateTexture(
+				t, NULL, b->buf, b->size.x * sizeof(Uint32)) != 0)
+		{
+			LOG(LM_GFX, LL_ERROR, "cannot update layer: %s", SDL_GetError());
+		}
+		return;
+	}
+	Render(b, t);
+	SDL_SetRenderTarget(b->renderer, NULL);
+}
+
+// Replay the commands into a target texture, leaving it as the target
+static bool Render(RenderBatch *b, SDL_Texture *t)
+{
+	if (SDL_SetRenderTarget(b->renderer, t) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
+		return false;
+	}
+	// Restore the renderer's draw state afterwards; it is used to clear
+	// the window
+	Uint8 r, g, bl, a;
+	SDL_GetRenderDrawColor(b->renderer, &r, &g, &bl, &a);
+	SDL_BlendMode blend;
+	SDL_GetRenderDrawBlendMode(b->renderer, &blend);
+
+	SDL_SetRenderDrawColor(b->renderer, 0, 0, 0, 0);
+	SDL_RenderClear(b->renderer);
+	CA_FOREACH(const RenderCmd, c, b->cmds)
+		switch (c->Type)
+		{
+		case RENDER_CMD_PIC:
+			SDL_SetTextureColorMod(c->Texture, c->Color.r, c->Color.g, c->Color.b);
+			SDL_SetTextureAlphaMod(c->Texture, c->Color.a);
+			SDL_SetTextureBlendMode(c->Texture, c->Blend);
+			SDL_RenderCopy(b->renderer, c->Texture, &c->Src, &c->Dst);
+			break;
+		case RENDER_CMD_RECT:
+			SDL_SetRenderDrawBlendMode(b->renderer, c->Blend);
+			SDL_SetRenderDrawColor(
+				b->renderer, c->Color.r, c->Color.g, c->Color.b, c->Color.a);
+			SDL_RenderFillRect(b->renderer, &c->Dst);
+			break;
+		default:
+			CASSERT(false, "unknown render command");
+			break;
+		}
+	CA_FOREACH_END()
+
+	SDL_SetRenderDrawColor(b->renderer, r, g, bl, a);
+	SDL_SetRenderDrawBlendMode(b->renderer, blend);
+	return true;
+}
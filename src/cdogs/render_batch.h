@@ -0,0 +1,108 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL.h>
+
+#include "c_array.h"
+#include "c_hashmap/hashmap.h"
+#include "color.h"
+#include "pic.h"
+
+// Texture renderer: instead of blitting pics to the software buffer, pics
+// are uploaded once as textures and drawn by the SDL renderer. Pics in the
+// atlas (see pic_atlas.h) are drawn from their page's texture.
+// Drawing commands are queued per layer (between BlitClearBuf and
+// BlitUpdateFromBuf) and replayed, in order, into the layer's texture.
+// Drawing that has no texture equivalent (such as tinting what has already
+// been drawn) switches the rest of the layer to the software buffer; the
+// queued commands are rendered and read back into the buffer first.
+
+typedef enum
+{
+	RENDER_CMD_PIC,
+	RENDER_CMD_RECT
+} RenderCmdType;
+
+typedef struct
+{
+	RenderCmdType Type;
+	SDL_Texture *Texture;	// for pics
+	SDL_Rect Src;	// for pics
+	SDL_Rect Dst;
+	// Colour and alpha modulation for pics, or fill colour for rects
+	color_t Color;
+	SDL_BlendMode Blend;
+} RenderCmd;
+
+typedef struct
+{
+	SDL_Renderer *renderer;	// NULL if not using the texture renderer
+	// For reading back the layer, when falling back to software
+	SDL_Texture *canvas;
+	Uint32 *buf;
+	struct vec2i size;
+	map_t textures;	// of SDL_Texture *, by pic data or atlas page data
+	// Pics generated for drawing, e.g. shadows and highlights
+	map_t pics;	// of Pic *
+	CArray cmds;	// of RenderCmd
+	// Textures of freed pics, destroyed once no commands use them
+	CArray freed;	// of SDL_Texture *
+	bool isSoftware;	// rest of the layer is drawn to the buffer
+} RenderBatch;
+
+// Returns false if the texture renderer cannot be used with this renderer
+bool RenderBatchInit(
+	RenderBatch *b, SDL_Renderer *r, Uint32 *buf, const struct vec2i size);
+void RenderBatchTerminate(RenderBatch *b);
+bool RenderBatchIsEnabled(const RenderBatch *b);
+// Release all textures, e.g. when pics are freed
+void RenderBatchClearTextures(RenderBatch *b);
+// Release the texture for a pic that is about to be freed
+void RenderBatchRemovePic(RenderBatch *b, const Pic *pic);
+
+const Pic *RenderBatchGetPic(const RenderBatch *b, const char *key);
+// Add a generated pic; takes ownership of its data
+const Pic *RenderBatchAddPic(RenderBatch *b, const char *key, const Pic *pic);
+
+// Queue drawing; returns false if the layer is being drawn in software,
+// in which case the caller should draw to the buffer instead
+bool RenderBatchPic(
+	RenderBatch *b, const Pic *pic, const SDL_Rect src, const SDL_Rect dst,
+	const color_t mod, const SDL_BlendMode blend);
+bool RenderBatchRect(
+	RenderBatch *b, const SDL_Rect dst, const color_t c,
+	const SDL_BlendMode blend);
+// Switch the rest of the layer to software, for drawing that reads the
+// buffer
+void RenderBatchSoftware(RenderBatch *b);
+
+// Start a new layer
+void RenderBatchClear(RenderBatch *b);
+// Draw the layer into a (target) texture
+void RenderBatchFlush(RenderBatch *b, SDL_Texture *t);
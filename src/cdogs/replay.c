@@ -0,0 +1,289 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "replay.h"
+
+#include <string.h>
+
+#include "log.h"
+#include "proto/msg.pb.h"
+
+// Write to file once this much has been recorded
+#define REPLAY_WRITE_SIZE 4096
+
+Replay gReplay;
+
+const char *ReplayGameConfigs[] =
+{
+	"Game.Difficulty",
+	"Game.FriendlyFire",
+	"Game.FPS",
+	"Game.EnemyDensity",
+	"Game.NonPlayerHP",
+	"Game.PlayerHP",
+	"Game.Lives",
+	"Game.HealthPickups",
+	"Game.Ammo",
+	"Game.Fog",
+	"Game.SightRange",
+	"Game.FOV",
+	"Game.AIBudget",
+	"Game.FireMoveStyle",
+	"Game.SwitchMoveStyle",
+	"Game.AllyCollision",
+	"Deathmatch.Lives",
+	"Dogfight.PlayerHP",
+	"Dogfight.FirstTo",
+	NULL
+};
+
+void ReplayInit(Replay *r)
+{
+	memset(r, 0, sizeof *r);
+	CArrayInit(&r->data, sizeof(uint8_t));
+	CArrayInit(&r->cmds, sizeof(int));
+}
+static void Flush(Replay *r);
+void ReplayTerminate(Replay *r)
+{
+	if (r->f != NULL)
+	{
+		Flush(r);
+		fclose(r->f);
+	}
+	CArrayTerminate(&r->data);
+	CArrayTerminate(&r->cmds);
+	ReplayInit(r);
+}
+static void Flush(Replay *r)
+{
+	if (r->data.size == 0) return;
+	if (fwrite(r->data.data, 1, r->data.size, r->f) != r->data.size)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to write replay");
+	}
+	CArrayClear(&r->data);
+}
+
+bool ReplayRecordOpen(Replay *r, const char *filename)
+{
+	r->f = fopen(filename, "wb");
+	if (r->f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot open replay file %s for writing",
+			filename);
+		return false;
+	}
+	r->Mode = REPLAY_MODE_RECORD;
+	LOG(LM_MAIN, LL_INFO, "recording replay to %s", filename);
+	return true;
+}
+
+bool ReplayPlayOpen(Replay *r, const char *filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot open replay file %s", filename);
+		return false;
+	}
+	bool res = true;
+	uint8_t buf[REPLAY_WRITE_SIZE];
+	size_t read;
+	while ((read = fread(buf, 1, sizeof buf, f)) > 0)
+	{
+		const size_t size = r->data.size;
+		CArrayResize(&r->data, size + read, NULL);
+		memcpy((uint8_t *)r->data.data + size, buf, read);
+	}
+	if (ferror(f))
+	{
+		LOG(LM_MAIN, LL_ERROR, "error reading replay file %s", filename);
+		res = false;
+	}
+	fclose(f);
+	if (res)
+	{
+		r->Mode = REPLAY_MODE_PLAY;
+		LOG(LM_MAIN, LL_INFO, "playing replay %s (%d bytes)",
+			filename, (int)r->data.size);
+	}
+	return res;
+}
+
+void ReplayWrite(
+	Replay *r, const ReplayMsgType type, const pb_field_t *fields,
+	const void *data)
+{
+	if (!NetFrameAppend(&r->data, (int)type, fields, data))
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to encode replay msg(%d)", (int)type);
+	}
+	if (r->data.size >= REPLAY_WRITE_SIZE)
+	{
+		Flush(r);
+	}
+}
+
+void ReplayRecordMission(Replay *r, const int randomSeed)
+{
+	CArrayClear(&r->cmds);
+	NReplayMission m = NReplayMission_init_default;
+	m.Version = REPLAY_VERSION;
+	m.RandomSeed = randomSeed;
+	m.Seed = r->Seed;
+	ReplayWrite(r, REPLAY_MSG_MISSION, NReplayMission_fields, &m);
+}
+
+bool ReplayHashDue(const int ticks)
+{
+	return ticks % REPLAY_HASH_INTERVAL == 0;
+}
+
+static void ResizeCmds(CArray *cmds, const int numCmds);
+void ReplayRecordTick(
+	Replay *r, const int ticks, const int *cmds, const int numCmds,
+	const uint32_t hash)
+{
+	if (ReplayHashDue(ticks))
+	{
+		const NReplayHash h = { (uint32_t)ticks, hash };
+		ReplayWrite(r, REPLAY_MSG_HASH, NReplayHash_fields, &h);
+	}
+	ResizeCmds(&r->cmds, numCmds);
+	for (int i = 0; i < numCmds; i++)
+	{
+		int *last = CArrayGet(&r->cmds, i);
+		if (*last == cmds[i]) continue;
+		const NReplayCmd c = { (uint32_t)ticks, (uint32_t)i, cmds[i] };
+		ReplayWrite(r, REPLAY_MSG_CMD, NReplayCmd_fields, &c);
+		*last = cmds[i];
+	}
+	r->Ticks++;
+}
+static void ResizeCmds(CArray *cmds, const int numCmds)
+{
+	if ((int)cmds->size < numCmds)
+	{
+		const int zero = 0;
+		CArrayResize(cmds, numCmds, &zero);
+	}
+}
+
+void ReplayRecordMissionEnd(Replay *r, const int ticks, const uint32_t hash)
+{
+	const NReplayHash h = { (uint32_t)ticks, hash };
+	ReplayWrite(r, REPLAY_MSG_MISSION_END, NReplayHash_fields, &h);
+	Flush(r);
+}
+
+bool ReplayRead(Replay *r, NetMsg *msg)
+{
+	return NetFrameRead(r->data.data, r->data.size, &r->offset, msg);
+}
+bool ReplayPeek(const Replay *r, NetMsg *msg)
+{
+	size_t offset = r->offset;
+	return NetFrameRead(r->data.data, r->data.size, &offset, msg);
+}
+
+static void CheckHash(
+	Replay *r, const NetMsg *msg, const int ticks, const uint32_t hash);
+bool ReplayPlayTick(
+	Replay *r, const int ticks, int *cmds, const int numCmds,
+	const uint32_t hash)
+{
+	ResizeCmds(&r->cmds, numCmds);
+	NetMsg msg;
+	while (ReplayPeek(r, &msg))
+	{
+		if (msg.Type == REPLAY_MSG_MISSION_END)
+		{
+			NReplayHash h;
+			NetMsgDecode(&msg, &h, NReplayHash_fields);
+			if ((int)h.Ticks <= ticks)
+			{
+				return false;
+			}
+			break;
+		}
+		else if (msg.Type == REPLAY_MSG_HASH)
+		{
+			NReplayHash h;
+			NetMsgDecode(&msg, &h, NReplayHash_fields);
+			if ((int)h.Ticks > ticks) break;
+			CheckHash(r, &msg, ticks, hash);
+		}
+		else if (msg.Type == REPLAY_MSG_CMD)
+		{
+			NReplayCmd c;
+			NetMsgDecode(&msg, &c, NReplayCmd_fields);
+			if ((int)c.Ticks > ticks) break;
+			if ((int)c.Idx < (int)r->cmds.size)
+			{
+				*(int *)CArrayGet(&r->cmds, c.Idx) = c.Cmd;
+			}
+		}
+		else
+		{
+			LOG(LM_MAIN, LL_ERROR, "unexpected replay msg(%d) at tick %d",
+				msg.Type, ticks);
+		}
+		ReplayRead(r, &msg);
+	}
+	for (int i = 0; i < numCmds; i++)
+	{
+		cmds[i] = *(int *)CArrayGet(&r->cmds, i);
+	}
+	r->Ticks++;
+	return true;
+}
+static void CheckHash(
+	Replay *r, const NetMsg *msg, const int ticks, const uint32_t hash)
+{
+	NReplayHash h;
+	NetMsgDecode(msg, &h, NReplayHash_fields);
+	if ((int)h.Ticks != ticks || h.Hash != hash)
+	{
+		LOG(LM_MAIN, LL_ERROR,
+			"replay out of sync at tick %d: expected %u at tick %u, got %u",
+			ticks, h.Hash, h.Ticks, hash);
+		r->Desyncs++;
+	}
+}
+
+void ReplayPlayMissionEnd(Replay *r, const int ticks, const uint32_t hash)
+{
+	NetMsg msg;
+	while (ReplayRead(r, &msg))
+	{
+		if (msg.Type == REPLAY_MSG_MISSION_END)
+		{
+			CheckHash(r, &msg, ticks, hash);
+			break;
+		}
+	}
+	CArrayClear(&r->cmds);
+}
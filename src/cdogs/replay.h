@@ -0,0 +1,123 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "c_array.h"
+#include "net_frame.h"
+
+// Recording and playback of games.
+// The simulation is deterministic given the random seed, the game config,
+// the players and their commands each tick, so that is all that is
+// recorded. A replay file is a stream of messages in the net frame format
+// (see net_frame.h); each mission is recorded as:
+// - REPLAY_MSG_CAMPAIGN, REPLAY_MSG_MISSION
+// - REPLAY_MSG_CONFIG for each game config value
+// - REPLAY_MSG_PLAYER_DATA and REPLAY_MSG_PLAYER for each local player
+// - REPLAY_MSG_CMD whenever a player's command changes, and REPLAY_MSG_HASH
+//   periodically, to detect playback going out of sync
+// - REPLAY_MSG_MISSION_END
+// Only local players are recorded; net games cannot be replayed.
+
+// Bump when the simulation changes in a way that breaks old replays
+#define REPLAY_VERSION 4
+// Ticks between state hashes
+#define REPLAY_HASH_INTERVAL 70
+
+typedef enum
+{
+	REPLAY_MSG_CAMPAIGN,	// NCampaignDef
+	REPLAY_MSG_MISSION,		// NReplayMission
+	REPLAY_MSG_CONFIG,		// NConfig
+	REPLAY_MSG_PLAYER_DATA,	// NPlayerData
+	REPLAY_MSG_PLAYER,		// NReplayPlayer
+	REPLAY_MSG_CMD,			// NReplayCmd
+	REPLAY_MSG_HASH,		// NReplayHash
+	REPLAY_MSG_MISSION_END	// NReplayHash
+} ReplayMsgType;
+
+typedef enum
+{
+	REPLAY_MODE_NONE,
+	REPLAY_MODE_RECORD,
+	REPLAY_MODE_PLAY
+} ReplayMode;
+
+typedef struct
+{
+	ReplayMode Mode;
+	// Recording: messages not yet written; playback: the whole file
+	CArray data;	// of uint8_t
+	size_t offset;	// playback read position
+	FILE *f;	// recording file
+	// Seed for PVP missions, which are otherwise seeded by time
+	unsigned int Seed;
+	// Last recorded or played commands, by local player index
+	CArray cmds;	// of int
+	int Desyncs;
+	int Ticks;	// total ticks played
+} Replay;
+extern Replay gReplay;
+
+// Every config that affects the simulation, recorded with each mission
+extern const char *ReplayGameConfigs[];
+
+void ReplayInit(Replay *r);
+// Finish writing a recording, or stop playback
+void ReplayTerminate(Replay *r);
+bool ReplayRecordOpen(Replay *r, const char *filename);
+bool ReplayPlayOpen(Replay *r, const char *filename);
+
+// Recording
+void ReplayWrite(
+	Replay *r, const ReplayMsgType type, const pb_field_t *fields,
+	const void *data);
+// Start a new mission; resets the recorded commands
+void ReplayRecordMission(Replay *r, const int randomSeed);
+// Whether a state hash is recorded and checked at this tick; the hash
+// passed for other ticks is ignored, so it need not be computed
+bool ReplayHashDue(const int ticks);
+// Record the commands for a tick, and the state hash if it is due
+void ReplayRecordTick(
+	Replay *r, const int ticks, const int *cmds, const int numCmds,
+	const uint32_t hash);
+void ReplayRecordMissionEnd(Replay *r, const int ticks, const uint32_t hash);
+
+// Playback
+// Read the next message, or return false at the end
+bool ReplayRead(Replay *r, NetMsg *msg);
+bool ReplayPeek(const Replay *r, NetMsg *msg);
+// Get the commands for a tick, and check the state hash if one was
+// recorded. Returns false once the mission has ended in the recording.
+bool ReplayPlayTick(
+	Replay *r, const int ticks, int *cmds, const int numCmds,
+	const uint32_t hash);
+// Skip to the end of the current mission, and check that it ended at the
+// same tick and state as the recording
+void ReplayPlayMissionEnd(Replay *r, const int ticks, const uint32_t hash);
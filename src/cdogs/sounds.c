@@ -61,6 +61,7 @@
 #include <tinydir/tinydir.h>
 
 #include "algorithms.h"
+#include "asset_loader.h"
 #include "files.h"
 #include "log.h"
 #include "map.h"
@@ -95,33 +96,14 @@ int OpenAudio(int frequency, Uint16 format, int channels, int chunkSize)
 	return 0;
 }
 
+static bool IsRandomSound(const char *name, int *n);
 static Mix_Chunk *LoadSound(const char *path);
-static void AddSound(map_t sounds, const char *name, SoundData *sound);
-static void SoundLoad(map_t sounds, const char *name, const char *path)
+static void *SoundLoad(const char *path, const char *name)
 {
 	// If the sound basename is a number, it is part of a group of random sounds
-	char basename[CDOGS_FILENAME_MAX];
-	PathGetBasenameWithoutExtension(basename, name);
-	char nameNoExt[CDOGS_PATH_MAX];
-	PathGetWithoutExtension(nameNoExt, name);
-	bool isNumber = true;
-	for (const char *c = basename; *c != '\0'; c++)
-	{
-		if (!isdigit(*c))
-		{
-			isNumber = false;
-			break;
-		}
-	}
-	if (isNumber)
+	if (IsRandomSound(name, NULL))
 	{
 		// Sound is random
-		// Only add the 0 number
-		const int n = atoi(basename);
-		if (n != 0)
-		{
-			return;
-		}
 		SoundData *sound;
 		CCALLOC(sound, sizeof *sound);
 		sound->Type = SOUND_RANDOM;
@@ -141,22 +123,35 @@ static void SoundLoad(map_t sounds, const char *name, const char *path)
 			if (data == NULL) break;
 			CArrayPushBack(&sound->u.random.sounds, &data);
 		}
-		// Remove "/0" from name and add
-		*strrchr(nameNoExt, '/') = '\0';
-		AddSound(sounds, nameNoExt, sound);
+		return sound;
 	}
-	else
+	Mix_Chunk *data = LoadSound(path);
+	if (data == NULL)
 	{
-		Mix_Chunk *data = LoadSound(path);
-		if (data != NULL)
+		return NULL;
+	}
+	SoundData *sound;
+	CMALLOC(sound, sizeof *sound);
+	sound->Type = SOUND_NORMAL;
+	sound->u.normal = data;
+	return sound;
+}
+static bool IsRandomSound(const char *name, int *n)
+{
+	char basename[CDOGS_FILENAME_MAX];
+	PathGetBasenameWithoutExtension(basename, name);
+	for (const char *c = basename; *c != '\0'; c++)
+	{
+		if (!isdigit(*c))
 		{
-			SoundData *sound;
-			CMALLOC(sound, sizeof *sound);
-			sound->Type = SOUND_NORMAL;
-			sound->u.normal = data;
-			AddSound(sounds, nameNoExt, sound);
+			return false;
 		}
 	}
+	if (n != NULL)
+	{
+		*n = atoi(basename);
+	}
+	return true;
 }
 static Mix_Chunk *LoadSound(const char *path)
 {
@@ -199,7 +194,29 @@ void SoundInitialize(SoundDevice *device, const char *path)
 	GetDataFilePath(buf, path);
 	SoundLoadDir(device->sounds, buf, NULL);
 }
+static void FindSounds(AssetLoader *al, const char *path, const char *prefix);
 void SoundLoadDir(map_t sounds, const char *path, const char *prefix)
+{
+	// Decode the sounds in parallel, then add them in order
+	AssetLoader al;
+	AssetLoaderInit(&al);
+	FindSounds(&al, path, prefix);
+	AssetLoaderRun(&al, SoundLoad);
+	CA_FOREACH(const AssetLoaderJob, job, al.jobs)
+		if (job->Result == NULL) continue;
+		char nameNoExt[CDOGS_PATH_MAX];
+		PathGetWithoutExtension(nameNoExt, job->Name);
+		if (IsRandomSound(job->Name, NULL))
+		{
+			// Remove "/0" from name
+			*strrchr(nameNoExt, '/') = '\0';
+		}
+		AddSound(sounds, nameNoExt, job->Result);
+	CA_FOREACH_END()
+	AssetLoaderLogTimes(&al, "sounds");
+	AssetLoaderTerminate(&al);
+}
+static void FindSounds(AssetLoader *al, const char *path, const char *prefix)
 {
 	tinydir_dir dir;
 	if (tinydir_open(&dir, path) == -1)
@@ -234,11 +251,17 @@ void SoundLoadDir(map_t sounds, const char *path, const char *prefix)
 		}
 		if (file.is_reg)
 		{
-			SoundLoad(sounds, buf, file.path);
+			// Random sounds are loaded as a group with the 0 number
+			int n;
+			if (IsRandomSound(buf, &n) && n != 0)
+			{
+				continue;
+			}
+			AssetLoaderAdd(al, file.path, buf);
 		}
 		else if (file.is_dir)
 		{
-			SoundLoadDir(sounds, file.path, buf);
+			FindSounds(al, file.path, buf);
 		}
 	}
 
@@ -512,6 +535,12 @@ void SoundPlayAtPlusDistance(
 	SoundDevice *device, Mix_Chunk *data,
 	const struct vec2 pos, const int plusDistance)
 {
+	// Skip the raytrace if there's nothing to play
+	if (!device->isInitialised || data == NULL)
+	{
+		return;
+	}
+
 	struct vec2 closestLeftEar, closestRightEar;
 
 	// Find closest set of ears to the sound
@@ -571,6 +600,19 @@ Mix_Chunk *StrSound(const char *s)
 	}
 	return NULL;
 }
+// Sound has its own generator so that picking random sounds never consumes
+// the game's rand() stream; replays and headless servers run without sound
+static uint32_t sSoundRandState = 2463534242u;
+static int SoundRand(void)
+{
+	// xorshift32
+	uint32_t x = sSoundRandState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	sSoundRandState = x;
+	return (int)(x & 0x7fffffff);
+}
 static Mix_Chunk *SoundDataGet(SoundData *s)
 {
 	switch (s->Type)
@@ -589,7 +631,7 @@ static Mix_Chunk *SoundDataGet(SoundData *s)
 				while ((int)s->u.random.sounds.size > 1 &&
 					idx == s->u.random.lastPlayed)
 				{
-					idx = rand() % s->u.random.sounds.size;
+					idx = SoundRand() % (int)s->u.random.sounds.size;
 				}
 				Mix_Chunk **sound = CArrayGet(&s->u.random.sounds, idx);
 				s->u.random.lastPlayed = idx;
@@ -0,0 +1,129 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "thread_pool.h"
+
+#include <string.h>
+
+#include <SDL_cpuinfo.h>
+
+#include "log.h"
+#include "utils.h"
+
+ThreadPool gThreadPool;
+
+
+static int Work(void *data);
+void ThreadPoolInit(ThreadPool *tp, const char *name)
+{
+	memset(tp, 0, sizeof *tp);
+#ifdef __EMSCRIPTEN__
+	// No threads
+	UNUSED(name);
+	UNUSED(Work);
+#else
+	tp->start = SDL_CreateSemaphore(0);
+	tp->done = SDL_CreateSemaphore(0);
+	if (tp->start == NULL || tp->done == NULL)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot create thread pool semaphores: %s",
+			SDL_GetError());
+		return;
+	}
+	// The calling thread works too, so start one fewer worker
+	const int numWorkers =
+		MIN(SDL_GetCPUCount(), THREAD_POOL_MAX_THREADS) - 1;
+	for (int i = 0; i < numWorkers; i++)
+	{
+		tp->threads[i] = SDL_CreateThread(Work, name, tp);
+		if (tp->threads[i] == NULL)
+		{
+			LOG(LM_MAIN, LL_WARN, "cannot create thread pool thread: %s",
+				SDL_GetError());
+			break;
+		}
+		tp->NumWorkers++;
+	}
+	LOG(LM_MAIN, LL_INFO, "started %s pool with %d workers",
+		name, tp->NumWorkers);
+#endif
+}
+void ThreadPoolTerminate(ThreadPool *tp)
+{
+	tp->quit = true;
+	for (int i = 0; i < tp->NumWorkers; i++)
+	{
+		SDL_SemPost(tp->start);
+	}
+	for (int i = 0; i < tp->NumWorkers; i++)
+	{
+		SDL_WaitThread(tp->threads[i], NULL);
+	}
+	if (tp->start != NULL) SDL_DestroySemaphore(tp->start);
+	if (tp->done != NULL) SDL_DestroySemaphore(tp->done);
+	memset(tp, 0, sizeof *tp);
+}
+
+static void RunJobs(ThreadPool *tp);
+void ThreadPoolRun(
+	ThreadPool *tp, ThreadPoolFunc func, void *data, const int count)
+{
+	tp->func = func;
+	tp->data = data;
+	tp->count = count;
+	SDL_AtomicSet(&tp->next, 0);
+	// Don't wake more workers than there are jobs for
+	const int numWorkers = MIN(tp->NumWorkers, count - 1);
+	for (int i = 0; i < numWorkers; i++)
+	{
+		SDL_SemPost(tp->start);
+	}
+	RunJobs(tp);
+	for (int i = 0; i < numWorkers; i++)
+	{
+		SDL_SemWait(tp->done);
+	}
+}
+static int Work(void *data)
+{
+	ThreadPool *tp = data;
+	for (;;)
+	{
+		SDL_SemWait(tp->start);
+		if (tp->quit) break;
+		RunJobs(tp);
+		SDL_SemPost(tp->done);
+	}
+	return 0;
+}
+static void RunJobs(ThreadPool *tp)
+{
+	for (;;)
+	{
+		const int i = SDL_AtomicAdd(&tp->next, 1);
+		if (i >= tp->count) break;
+		tp->func(tp->data, i);
+	}
+}
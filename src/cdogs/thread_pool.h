@@ -0,0 +1,64 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_atomic.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
+// A pool of worker threads that stay alive between runs, for work that is
+// repeated every frame and too small to pay for creating threads each time.
+// ThreadPoolRun calls the job function once for each index, spread over the
+// workers and the calling thread, and returns once all have finished.
+// Jobs may run in any order, so they must only write to their own data.
+
+#define THREAD_POOL_MAX_THREADS 16
+
+typedef void (*ThreadPoolFunc)(void *data, const int index);
+
+typedef struct
+{
+	SDL_Thread *threads[THREAD_POOL_MAX_THREADS];
+	int NumWorkers;
+	SDL_sem *start;
+	SDL_sem *done;
+	bool quit;
+	// Current run
+	ThreadPoolFunc func;
+	void *data;
+	int count;
+	SDL_atomic_t next;	// index of the next job to run
+} ThreadPool;
+
+extern ThreadPool gThreadPool;
+
+// Start the workers; with no workers, runs happen on the calling thread
+void ThreadPoolInit(ThreadPool *tp, const char *name);
+void ThreadPoolTerminate(ThreadPool *tp);
+void ThreadPoolRun(
+	ThreadPool *tp, ThreadPoolFunc func, void *data, const int count);
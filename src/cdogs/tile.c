@@ -144,6 +144,38 @@ void TileItemUpdate(TTileItem *t, const int ticks)
 }
 
 
+void TileAddThing(Tile *t, TTileItem *ti)
+{
+	ThingId tid;
+	tid.Id = ti->id;
+	tid.Kind = ti->kind;
+	CASSERT(tid.Id >= 0, "invalid ThingId");
+	CASSERT(tid.Kind >= 0 && tid.Kind <= KIND_PICKUP, "unknown thing kind");
+	ti->tileThingIdx = (int)t->things.size;
+	CArrayPushBack(&t->things, &tid);
+}
+void TileRemoveThing(Tile *t, TTileItem *ti)
+{
+	const int idx = ti->tileThingIdx;
+	CASSERT(
+		idx >= 0 && idx < (int)t->things.size,
+		"Did not find element to delete");
+	const ThingId *tid = CArrayGet(&t->things, idx);
+	CASSERT(
+		tid->Id == ti->id && tid->Kind == ti->kind,
+		"Did not find element to delete");
+	// Swap with the last thing in the tile, so removal doesn't shift
+	const int lastIdx = (int)t->things.size - 1;
+	if (idx != lastIdx)
+	{
+		const ThingId *last = CArrayGet(&t->things, lastIdx);
+		ThingIdGetTileItem(last)->tileThingIdx = idx;
+		memcpy(CArrayGet(&t->things, idx), last, sizeof *last);
+	}
+	CArrayDelete(&t->things, lastIdx);
+	ti->tileThingIdx = -1;
+}
+
 TTileItem *ThingIdGetTileItem(const ThingId *tid)
 {
 	TTileItem *ti = NULL;
@@ -123,6 +123,8 @@ typedef struct TileItem
 	TileItemKind kind;
 	int id;	// Id of item (actor, mobobj or obj)
 	int flags;
+	// Index of this item in its tile's things, for constant-time removal
+	int tileThingIdx;
 	TileItemGetPicFunc getPicFunc;
 	TileItemDrawFunc drawFunc;
 	TileItemDrawFuncData drawData;
@@ -167,5 +169,9 @@ void TileItemInit(
 	const int flags);
 void TileItemUpdate(TTileItem *t, const int ticks);
 
+// Things are stored in the tile of their centre, and know their index in
+// the tile's things; removal swaps the last thing into the hole
+void TileAddThing(Tile *t, TTileItem *ti);
+void TileRemoveThing(Tile *t, TTileItem *ti);
 TTileItem *ThingIdGetTileItem(const ThingId *tid);
 bool TileItemDrawLast(const TTileItem *t);
@@ -0,0 +1,209 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "uid_map.h"
+
+#include "utils.h"
+
+#define UID_MAP_INITIAL_SIZE 64
+#define UID_MAP_EMPTY -1
+
+
+void UIDMapInit(UIDMap *m)
+{
+	m->table = NULL;
+	m->tableSize = 0;
+	m->count = 0;
+	CArrayInit(&m->slots, sizeof(UIDMapSlot));
+}
+void UIDMapTerminate(UIDMap *m)
+{
+	CFREE(m->table);
+	m->table = NULL;
+	m->tableSize = 0;
+	m->count = 0;
+	CArrayTerminate(&m->slots);
+}
+void UIDMapClear(UIDMap *m)
+{
+	for (size_t i = 0; i < m->tableSize; i++)
+	{
+		m->table[i].UID = UID_MAP_EMPTY;
+	}
+	m->count = 0;
+	// Keep slot generations so old handles stay stale
+	CA_FOREACH(UIDMapSlot, s, m->slots)
+		if (s->UID != UID_MAP_EMPTY)
+		{
+			s->UID = UID_MAP_EMPTY;
+			s->Gen++;
+		}
+	CA_FOREACH_END()
+}
+
+// UIDs are mostly sequential so scramble them to avoid probe clustering
+static size_t Hash(const UIDMap *m, const int uid)
+{
+	return ((unsigned)uid * 2654435761u) & (m->tableSize - 1);
+}
+
+static size_t FindIndex(const UIDMap *m, const int uid)
+{
+	size_t i = Hash(m, uid);
+	while (m->table[i].UID != UID_MAP_EMPTY && m->table[i].UID != uid)
+	{
+		i = (i + 1) & (m->tableSize - 1);
+	}
+	return i;
+}
+
+static void Grow(UIDMap *m)
+{
+	UIDMapEntry *oldTable = m->table;
+	const size_t oldSize = m->tableSize;
+	m->tableSize = oldSize == 0 ? UID_MAP_INITIAL_SIZE : oldSize * 2;
+	CMALLOC(m->table, m->tableSize * sizeof *m->table);
+	for (size_t i = 0; i < m->tableSize; i++)
+	{
+		m->table[i].UID = UID_MAP_EMPTY;
+	}
+	for (size_t i = 0; i < oldSize; i++)
+	{
+		if (oldTable[i].UID != UID_MAP_EMPTY)
+		{
+			m->table[FindIndex(m, oldTable[i].UID)] = oldTable[i];
+		}
+	}
+	CFREE(oldTable);
+}
+
+static UIDMapSlot *GetSlot(UIDMap *m, const int slot)
+{
+	while (slot >= (int)m->slots.size)
+	{
+		const UIDMapSlot s = { UID_MAP_EMPTY, 0 };
+		CArrayPushBack(&m->slots, &s);
+	}
+	return CArrayGet(&m->slots, slot);
+}
+
+static void RemoveAt(UIDMap *m, size_t i);
+void UIDMapSet(UIDMap *m, const int uid, const int slot)
+{
+	CASSERT(uid >= 0, "invalid UID");
+	CASSERT(slot >= 0, "invalid slot");
+	// Evict the UID if it was elsewhere, and whatever was in this slot
+	UIDMapRemove(m, uid);
+	UIDMapSlot *s = GetSlot(m, slot);
+	if (s->UID != UID_MAP_EMPTY)
+	{
+		UIDMapRemove(m, s->UID);
+	}
+
+	// Keep load factor under 1/2
+	if ((m->count + 1) * 2 > m->tableSize)
+	{
+		Grow(m);
+	}
+	const size_t i = FindIndex(m, uid);
+	m->table[i].UID = uid;
+	m->table[i].Slot = slot;
+	m->count++;
+	s->UID = uid;
+	s->Gen++;
+}
+
+void UIDMapRemove(UIDMap *m, const int uid)
+{
+	if (m->count == 0)
+	{
+		return;
+	}
+	const size_t i = FindIndex(m, uid);
+	if (m->table[i].UID == UID_MAP_EMPTY)
+	{
+		return;
+	}
+	UIDMapSlot *s = CArrayGet(&m->slots, m->table[i].Slot);
+	s->UID = UID_MAP_EMPTY;
+	s->Gen++;
+	RemoveAt(m, i);
+}
+static void RemoveAt(UIDMap *m, size_t i)
+{
+	// Backward-shift deletion; keeps probe chains intact without tombstones
+	const size_t mask = m->tableSize - 1;
+	size_t j = i;
+	for (;;)
+	{
+		j = (j + 1) & mask;
+		if (m->table[j].UID == UID_MAP_EMPTY)
+		{
+			break;
+		}
+		const size_t k = Hash(m, m->table[j].UID);
+		// Move j into the hole at i unless its home k lies in (i, j]
+		const bool inRange = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+		if (!inRange)
+		{
+			m->table[i] = m->table[j];
+			i = j;
+		}
+	}
+	m->table[i].UID = UID_MAP_EMPTY;
+	m->count--;
+}
+
+int UIDMapGet(const UIDMap *m, const int uid)
+{
+	if (m->count == 0 || uid < 0)
+	{
+		return -1;
+	}
+	const UIDMapEntry *e = &m->table[FindIndex(m, uid)];
+	return e->UID == UID_MAP_EMPTY ? -1 : e->Slot;
+}
+
+UIDHandle UIDMapGetHandle(const UIDMap *m, const int uid)
+{
+	UIDHandle h;
+	h.Slot = UIDMapGet(m, uid);
+	h.Gen = 0;
+	if (h.Slot >= 0)
+	{
+		const UIDMapSlot *s = CArrayGet(&m->slots, h.Slot);
+		h.Gen = s->Gen;
+	}
+	return h;
+}
+int UIDMapHandleGetSlot(const UIDMap *m, const UIDHandle h)
+{
+	if (h.Slot < 0 || h.Slot >= (int)m->slots.size)
+	{
+		return -1;
+	}
+	const UIDMapSlot *s = CArrayGet(&m->slots, h.Slot);
+	return s->Gen == h.Gen ? h.Slot : -1;
+}
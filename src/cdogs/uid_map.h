@@ -0,0 +1,75 @@
+/*
+    Copyright (c) 2018 Cong Xu
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    Redistributions of source code must retain the above copyright notice, this
+    list of conditions and the following disclaimer.
+    Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stddef.h>
+
+#include "c_array.h"
+
+// Maps entity UIDs to their slot index in an entity store (e.g. gActors),
+// so that lookup by UID is constant time instead of a scan of the store.
+// Each slot holds at most one UID; assigning a new UID to a slot evicts the
+// previous one and bumps the slot's generation, so that handles taken before
+// the slot was reused can be detected as stale.
+typedef struct
+{
+	int UID;
+	int Slot;
+} UIDMapEntry;
+typedef struct
+{
+	int UID;	// -1 if slot has never been assigned
+	unsigned Gen;
+} UIDMapSlot;
+typedef struct
+{
+	// Open-addressed hash table, UID -> slot, linear probing
+	UIDMapEntry *table;
+	size_t tableSize;	// always a power of 2, or 0
+	size_t count;
+	CArray slots;	// of UIDMapSlot; reverse lookup slot -> UID
+} UIDMap;
+
+// Reference to a slot that can be checked for staleness
+typedef struct
+{
+	int Slot;	// -1 if invalid
+	unsigned Gen;
+} UIDHandle;
+
+void UIDMapInit(UIDMap *m);
+void UIDMapTerminate(UIDMap *m);
+void UIDMapClear(UIDMap *m);
+
+// Assign UID to slot; any UID previously in the slot is evicted
+void UIDMapSet(UIDMap *m, const int uid, const int slot);
+void UIDMapRemove(UIDMap *m, const int uid);
+// Returns the slot that the UID is in, or -1 if not found
+int UIDMapGet(const UIDMap *m, const int uid);
+
+UIDHandle UIDMapGetHandle(const UIDMap *m, const int uid);
+// Returns the slot of the handle, or -1 if the slot has since been reused
+int UIDMapHandleGetSlot(const UIDMap *m, const UIDHandle h);
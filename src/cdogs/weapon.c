@@ -54,8 +54,10 @@
 #include <json/json.h>
 
 #include "ammo.h"
+#include "class_index.h"
 #include "config.h"
 #include "game_events.h"
+#include "json_stream.h"
 #include "json_utils.h"
 #include "log.h"
 #include "mathc/mathc.h"
@@ -77,80 +79,113 @@ static void LoadGunDescription(
 	GunDescription *g, json_t *node, const GunDescription *defaultGun,
 	const int version);
 static void GunDescriptionTerminate(GunDescription *g);
-void WeaponLoadJSON(GunClasses *g, CArray *classes, json_t *root)
+typedef struct
 {
-	LOG(LM_MAP, LL_DEBUG, "loading weapons");
-	int version;
-	LoadInt(&version, root, "Version");
-	if (version > VERSION || version <= 0)
+	GunClasses *g;
+	CArray *classes;
+	int version;	// 0 until the header is loaded
+} GunsStream;
+static bool LoadGunElement(json_t *root, json_t **node, void *data);
+static bool LoadPseudoGunElement(json_t *root, json_t **node, void *data);
+static bool LoadGunsHeader(GunsStream *gs, json_t *root);
+bool WeaponLoadJSON(GunClasses *g, CArray *classes, const char *filename)
+{
+	LOG(LM_MAP, LL_DEBUG, "loading weapons %s", filename);
+	ClassIndexReset(&gGunDescriptions.index);
+	GunsStream gs = { g, classes, 0 };
+	JSONStream s;
+	JSONStreamInit(&s);
+	JSONStreamAddArray(&s, "Guns", LoadGunElement, &gs);
+	JSONStreamAddArray(&s, "PseudoGuns", LoadPseudoGunElement, &gs);
+	bool res = JSONStreamParseFile(&s, filename);
+	if (res && gs.version == 0)
+	{
+		// No guns
+		res = LoadGunsHeader(&gs, s.root);
+	}
+	JSONStreamTerminate(&s);
+	return res;
+}
+static bool LoadGunElement(json_t *root, json_t **node, void *data)
+{
+	GunsStream *gs = data;
+	if (gs->version == 0 && !LoadGunsHeader(gs, root))
+	{
+		return false;
+	}
+	GunDescription gd;
+	LoadGunDescription(&gd, *node, &gs->g->Default, gs->version);
+	int idx = -1;
+	// Only allow index for non-custom guns
+	if (gs->classes == &gs->g->Guns)
+	{
+		LoadInt(&idx, *node, "Index");
+	}
+	if (idx >= 0 && idx < GUN_COUNT)
+	{
+		GunDescription *gExisting = CArrayGet(&gs->g->Guns, idx);
+		GunDescriptionTerminate(gExisting);
+		memcpy(gExisting, &gd, sizeof gd);
+	}
+	else
+	{
+		CArrayPushBack(gs->classes, &gd);
+	}
+	return true;
+}
+static bool LoadPseudoGunElement(json_t *root, json_t **node, void *data)
+{
+	GunsStream *gs = data;
+	if (gs->version == 0 && !LoadGunsHeader(gs, root))
+	{
+		return false;
+	}
+	GunDescription gd;
+	LoadGunDescription(&gd, *node, &gs->g->Default, gs->version);
+	gd.IsRealGun = false;
+	CArrayPushBack(gs->classes, &gd);
+	return true;
+}
+static bool LoadGunsHeader(GunsStream *gs, json_t *root)
+{
+	LoadInt(&gs->version, root, "Version");
+	if (gs->version > VERSION || gs->version <= 0)
 	{
 		CASSERT(false, "cannot read guns file version");
-		return;
+		gs->version = 0;
+		return false;
 	}
 
-	GunDescription *defaultDesc = &g->Default;
+	GunDescription *defaultDesc = &gs->g->Default;
 	// Only load default gun from main game data
-	if (classes == &g->Guns)
+	if (gs->classes == &gs->g->Guns)
 	{
 		json_t *defaultNode = json_find_first_label(root, "DefaultGun");
 		if (defaultNode != NULL)
 		{
-			LoadGunDescription(defaultDesc, defaultNode->child, NULL, version);
+			LoadGunDescription(
+				defaultDesc, defaultNode->child, NULL, gs->version);
 		}
 		else
 		{
 			memset(defaultDesc, 0, sizeof *defaultDesc);
 		}
-		CASSERT(g->Guns.size == 0, "guns not empty");
+		CASSERT(gs->g->Guns.size == 0, "guns not empty");
 		for (int i = 0; i < GUN_COUNT; i++)
 		{
 			GunDescription gd;
 			if (defaultNode != NULL)
 			{
-				LoadGunDescription(&gd, defaultNode->child, NULL, version);
+				LoadGunDescription(&gd, defaultNode->child, NULL, gs->version);
 			}
 			else
 			{
 				memset(&gd, 0, sizeof gd);
 			}
-			CArrayPushBack(&g->Guns, &gd);
-		}
-	}
-	json_t *gunsNode = json_find_first_label(root, "Guns")->child;
-	for (json_t *child = gunsNode->child; child; child = child->next)
-	{
-		GunDescription gd;
-		LoadGunDescription(&gd, child, defaultDesc, version);
-		int idx = -1;
-		// Only allow index for non-custom guns
-		if (classes == &g->Guns)
-		{
-			LoadInt(&idx, child, "Index");
-		}
-		if (idx >= 0 && idx < GUN_COUNT)
-		{
-			GunDescription *gExisting = CArrayGet(&g->Guns, idx);
-			GunDescriptionTerminate(gExisting);
-			memcpy(gExisting, &gd, sizeof gd);
-		}
-		else
-		{
-			CArrayPushBack(classes, &gd);
-		}
-	}
-	json_t *pseudoGunsNode = json_find_first_label(root, "PseudoGuns");
-	if (pseudoGunsNode != NULL)
-	{
-		for (json_t *child = pseudoGunsNode->child->child;
-			child;
-			child = child->next)
-		{
-			GunDescription gd;
-			LoadGunDescription(&gd, child, defaultDesc, version);
-			gd.IsRealGun = false;
-			CArrayPushBack(classes, &gd);
+			CArrayPushBack(&gs->g->Guns, &gd);
 		}
 	}
+	return true;
 }
 static void LoadGunDescription(
 	GunDescription *g, json_t *node, const GunDescription *defaultGun,
@@ -315,6 +350,7 @@ void WeaponTerminate(GunClasses *g)
 }
 void WeaponClassesClear(CArray *classes)
 {
+	ClassIndexReset(&gGunDescriptions.index);
 	CA_FOREACH(GunDescription, g, *classes)
 		GunDescriptionTerminate(g);
 	CA_FOREACH_END()
@@ -344,21 +380,19 @@ Weapon WeaponCreate(const GunDescription *gun)
 	return w;
 }
 
-// TODO: use map structure?
 const GunDescription *StrGunDescription(const char *s)
 {
-	CA_FOREACH(const GunDescription, gd, gGunDescriptions.CustomGuns)
-		if (strcmp(s, gd->name) == 0)
-		{
-			return gd;
-		}
-	CA_FOREACH_END()
-	CA_FOREACH(const GunDescription, gd, gGunDescriptions.Guns)
-		if (strcmp(s, gd->name) == 0)
-		{
-			return gd;
-		}
-	CA_FOREACH_END()
+	// Custom guns take precedence
+	const CArray *arrays[] =
+	{
+		&gGunDescriptions.CustomGuns, &gGunDescriptions.Guns, NULL
+	};
+	const GunDescription *gd = ClassIndexGet(
+		&gGunDescriptions.index, arrays, offsetof(GunDescription, name), s);
+	if (gd != NULL)
+	{
+		return gd;
+	}
 	fprintf(stderr, "Cannot parse gun name: %s\n", s);
 	return NULL;
 }
@@ -601,63 +635,20 @@ void BulletAndWeaponInitialize(
 {
 	BulletInitialize(b);
 
-	FILE *bf = NULL;
-	FILE *gf = NULL;
-	json_t *broot = NULL;
-	json_t *groot = NULL;
-	enum json_error e;
-
-	// 2-pass bullet loading will free root for us
-	bool freeBRoot = true;
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, bpath);
-	bf = fopen(buf, "r");
-	if (bf == NULL)
+	if (!BulletLoadJSON(b, &b->Classes, buf))
 	{
 		LOG(LM_MAP, LL_ERROR, "Error: cannot load bullets file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(bf, &broot);
-	if (e != JSON_OK)
-	{
-		LOG(LM_MAP, LL_ERROR, "Error parsing bullets file %s [error %d]",
-			buf, (int)e);
-		goto bail;
+		return;
 	}
-	BulletLoadJSON(b, &b->Classes, broot);
 
 	WeaponInitialize(g);
 	GetDataFilePath(buf, gpath);
-	gf = fopen(buf, "r");
-	if (gf == NULL)
+	if (!WeaponLoadJSON(g, &g->Guns, buf))
 	{
 		LOG(LM_MAP, LL_ERROR, "Error: cannot load guns file %s", buf);
-		goto bail;
-	}
-	e = json_stream_parse(gf, &groot);
-	if (e != JSON_OK)
-	{
-		LOG(LM_MAP, LL_ERROR, "Error parsing guns file %s [error %d]",
-			buf, (int)e);
-		goto bail;
 	}
-	WeaponLoadJSON(g, &g->Guns, groot);
 
 	BulletLoadWeapons(b);
-	freeBRoot = false;
-
-bail:
-	if (bf)
-	{
-		fclose(bf);
-	}
-	if (gf)
-	{
-		fclose(gf);
-	}
-	if (freeBRoot)
-	{
-		json_free_value(&broot);
-	}
-	json_free_value(&groot);
 }
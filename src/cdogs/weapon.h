@@ -128,6 +128,7 @@ typedef struct
 	CArray Guns;	// of GunDescription
 	GunDescription Default;
 	CArray CustomGuns;	// of GunDescription
+	map_t index;	// name -> GunDescription *; built on demand
 } GunClasses;
 
 typedef struct
@@ -143,7 +144,8 @@ typedef struct
 extern GunClasses gGunDescriptions;
 
 void WeaponInitialize(GunClasses *g);
-void WeaponLoadJSON(GunClasses *g, CArray *classes, json_t *root);
+// Stream the guns in a file into classes
+bool WeaponLoadJSON(GunClasses *g, CArray *classes, const char *filename);
 void WeaponClassesClear(CArray *classes);
 void WeaponTerminate(GunClasses *g);
 int GunGetNumClasses(const GunClasses *g);
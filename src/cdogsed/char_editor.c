@@ -791,9 +791,11 @@ static void DrawFlag(
 static void LoadTexFromPic(const GLuint texid, const Pic *pic)
 {
 	glBindTexture(GL_TEXTURE_2D, texid);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, PIC_STRIDE(pic));
 	glTexImage2D(
 		GL_TEXTURE_2D, 0, GL_RGBA, pic->size.x, pic->size.y, 0, GL_BGRA,
 		GL_UNSIGNED_BYTE, pic->Data);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 }
 static void LoadMultiChannelTexFromPic(
 	const GLuint texid, const Pic *pic, const CharColors *colors)
@@ -803,7 +805,8 @@ static void LoadMultiChannelTexFromPic(
 	CMALLOC(data, pic->size.x * pic->size.y * sizeof *data);
 	for (int i = 0; i < pic->size.x * pic->size.y; i++)
 	{
-		const Uint32 pixel = pic->Data[i];
+		const Uint32 pixel =
+			pic->Data[i % pic->size.x + i / pic->size.x * PIC_STRIDE(pic)];
 		const color_t color = PIXEL2COLOR(pixel);
 		if (pixel == 0)
 		{
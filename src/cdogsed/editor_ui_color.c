@@ -105,7 +105,7 @@ UIObject *CreateColorPicker(
 		for (v.x = 0; v.x < palette->size.x; v.x++)
 		{
 			const color_t colour = PIXEL2COLOR(
-				palette->Data[v.x + v.y * palette->size.x]);
+				palette->Data[v.x + v.y * PIC_STRIDE(palette)]);
 			if (colour.a == 0)
 			{
 				continue;
@@ -31,6 +31,7 @@
 
 #include <cdogs/config.h>
 #include <cdogs/log.h>
+#include <cdogs/replay.h>
 #include <cdogs/sys_config.h>
 #include <cdogs/utils.h>
 
@@ -89,6 +90,14 @@ void PrintHelp(void)
 	printf("%s\n",
 		"Other:\n"
 		"    --connect=host   (Experimental) connect to a game server\n"
+		"    --dedicated      (Experimental) run a headless game server for\n"
+		"                       the campaign given on the command line\n"
+		"    --record=F       Record the games played to replay file F\n"
+		"    --replay=F       Play replay file F without video or sound, as\n"
+		"                       fast as possible, and check that it plays\n"
+		"                       the same as when recorded\n"
+		"    --bake           Pre-bake the graphics into a pack file, which\n"
+		"                       is loaded at startup instead of the images\n"
 		);
 }
 
@@ -113,7 +122,8 @@ void ProcessCommandLine(char *buf, const int argc, char *argv[])
 static void PrintConfig(const Config *c, const int indent);
 bool ParseArgs(
 	const int argc, char *argv[],
-	ENetAddress *connectAddr, const char **loadCampaign)
+	ENetAddress *connectAddr, const char **loadCampaign, bool *isDedicated,
+	bool *isBake)
 {
 	struct option longopts[] =
 	{
@@ -121,15 +131,19 @@ bool ParseArgs(
 		{ "scale",		required_argument,	NULL,	's' },
 		{ "screen",		required_argument,	NULL,	'c' },
 		{ "connect",	required_argument,	NULL,	'x' },
+		{ "dedicated",	no_argument,		NULL,	'd' },
 		{ "config",		optional_argument,	NULL,	'C' },
 		{ "log",		required_argument,	NULL,	1000 },
 		{ "logfile",	required_argument,	NULL,	1001 },
+		{ "record",		required_argument,	NULL,	1002 },
+		{ "replay",		required_argument,	NULL,	1003 },
+		{ "bake",		no_argument,		NULL,	1004 },
 		{ "help",		no_argument,		NULL,	'h' },
 		{ 0,			0,					NULL,	0 }
 	};
 	int opt = 0;
 	int idx = 0;
-	while ((opt = getopt_long(argc, argv, "fs:c:x:C::\0:\0:h", longopts, &idx)) != -1)
+	while ((opt = getopt_long(argc, argv, "fs:c:x:dC::\0:\0:h", longopts, &idx)) != -1)
 	{
 		switch (opt)
 		{
@@ -185,12 +199,40 @@ bool ParseArgs(
 		case 1001:
 			LogOpenFile(optarg);
 			break;
+		case 1002:
+			if (gReplay.Mode != REPLAY_MODE_NONE)
+			{
+				printf("Error: can only record or play one replay\n");
+				return false;
+			}
+			if (!ReplayRecordOpen(&gReplay, optarg))
+			{
+				return false;
+			}
+			break;
+		case 1003:
+			if (gReplay.Mode != REPLAY_MODE_NONE)
+			{
+				printf("Error: can only record or play one replay\n");
+				return false;
+			}
+			if (!ReplayPlayOpen(&gReplay, optarg))
+			{
+				return false;
+			}
+			break;
+		case 1004:
+			*isBake = true;
+			break;
 		case 'x':
 			if (enet_address_set_host(connectAddr, optarg) != 0)
 			{
 				printf("Error: unknown host %s\n", optarg);
 			}
 			break;
+		case 'd':
+			*isDedicated = true;
+			break;
 		case 'C':
 			if (optarg == NULL)
 			{
@@ -66,6 +66,7 @@
 #include <cdogs/net_client.h>
 #include <cdogs/net_server.h>
 #include <cdogs/objs.h>
+#include <cdogs/replay.h>
 
 #include "briefing_screens.h"
 #include "hiscores.h"
@@ -157,7 +158,7 @@ typedef struct
 	bool isMap;
 	int cmds[MAX_LOCAL_PLAYERS];
 	int lastCmds[MAX_LOCAL_PLAYERS];
-	// Only update AI every 4 ticks
+	// Only update AI every AI_UPDATE_TICKS
 	int aiUpdateCounter;
 	PowerupSpawner healthSpawner;
 	CArray ammoSpawners;	// of PowerupSpawner
@@ -189,6 +190,7 @@ static void RunGameTerminate(GameLoopData *data)
 
 	CFREE(rData);
 }
+static void RecordMission(const CampaignOptions *co);
 static void RunGameOnEnter(GameLoopData *data)
 {
 	RunGameData *rData = data->Data;
@@ -199,13 +201,28 @@ static void RunGameOnEnter(GameLoopData *data)
 		colorBlack, 0);
 	BlitUpdateFromBuf(&gGraphicsDevice, gGraphicsDevice.bkg);
 
+	// Replays need the same random numbers as when recorded, regardless of
+	// any used in the menus beforehand
+	if (gReplay.Mode != REPLAY_MODE_NONE)
+	{
+		CampaignSeedRandom(rData->co);
+	}
+
 	MapLoad(rData->map, rData->m, rData->co);
 
 	// Seed random if PVP mode (otherwise players will always spawn in same
 	// position)
 	if (IsPVP(rData->co->Entry.Mode))
 	{
-		srand((unsigned int)time(NULL));
+		if (gReplay.Mode != REPLAY_MODE_PLAY)
+		{
+			gReplay.Seed = (unsigned int)time(NULL);
+		}
+		srand(gReplay.Seed);
+	}
+	if (gReplay.Mode == REPLAY_MODE_RECORD)
+	{
+		RecordMission(rData->co);
 	}
 
 	if (!rData->co->IsClient)
@@ -276,6 +293,57 @@ static void RunGameOnEnter(GameLoopData *data)
 	GameEvent start = GameEventNew(GAME_EVENT_GAME_START);
 	GameEventsEnqueue(&gGameEvents, start);
 }
+static void RecordMission(const CampaignOptions *co)
+{
+	const NCampaignDef def = NMakeCampaignDef(co);
+	ReplayWrite(&gReplay, REPLAY_MSG_CAMPAIGN, NCampaignDef_fields, &def);
+	ReplayRecordMission(&gReplay, ConfigGetInt(&gConfig, "Game.RandomSeed"));
+	for (const char **name = ReplayGameConfigs; *name != NULL; name++)
+	{
+		const NConfig c = NMakeConfig(&gConfig, *name);
+		ReplayWrite(&gReplay, REPLAY_MSG_CONFIG, NConfig_fields, &c);
+	}
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+		if (!p->IsLocal)
+		{
+			LOG(LM_MAIN, LL_WARN,
+				"recording net game; remote players will not be replayed");
+			continue;
+		}
+		const NPlayerData pd = NMakePlayerData(p);
+		ReplayWrite(&gReplay, REPLAY_MSG_PLAYER_DATA, NPlayerData_fields, &pd);
+		const NReplayPlayer rp = { (uint32_t)p->UID, (int32_t)p->inputDevice };
+		ReplayWrite(&gReplay, REPLAY_MSG_PLAYER, NReplayPlayer_fields, &rp);
+	CA_FOREACH_END()
+}
+// Hash the state that replays must reproduce, to detect desyncs
+static uint32_t HashBytes(uint32_t hash, const void *data, const size_t size)
+{
+	// FNV-1a
+	const uint8_t *b = data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ b[i]) * 16777619u;
+	}
+	return hash;
+}
+static uint32_t HashGameState(void)
+{
+	uint32_t hash = 2166136261u;
+	hash = HashBytes(hash, &gMission.time, sizeof gMission.time);
+	CA_FOREACH(const TActor, a, gActors)
+		if (!a->isInUse) continue;
+		const int values[] = { a->uid, a->health, a->dead, (int)a->direction };
+		hash = HashBytes(hash, values, sizeof values);
+		hash = HashBytes(hash, &a->Pos, sizeof a->Pos);
+	CA_FOREACH_END()
+	CA_FOREACH(const TObject, o, gObjs)
+		if (!o->isInUse) continue;
+		const int values[] = { o->uid, o->Health };
+		hash = HashBytes(hash, values, sizeof values);
+	CA_FOREACH_END()
+	return hash;
+}
 static void RunGameOnExit(GameLoopData *data)
 {
 	RunGameData *rData = data->Data;
@@ -285,6 +353,18 @@ static void RunGameOnExit(GameLoopData *data)
 	// Flush events
 	HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
 
+	switch (gReplay.Mode)
+	{
+	case REPLAY_MODE_RECORD:
+		ReplayRecordMissionEnd(&gReplay, gMission.time, HashGameState());
+		break;
+	case REPLAY_MODE_PLAY:
+		ReplayPlayMissionEnd(&gReplay, gMission.time, HashGameState());
+		break;
+	default:
+		break;
+	}
+
 	PowerupSpawnerTerminate(&rData->healthSpawner);
 	CA_FOREACH(PowerupSpawner, a, rData->ammoSpawners)
 		PowerupSpawnerTerminate(a);
@@ -324,6 +404,12 @@ static void RunGameInput(GameLoopData *data)
 {
 	RunGameData *rData = data->Data;
 
+	// Commands come from the replay instead; see RunGameUpdate
+	if (gReplay.Mode == REPLAY_MODE_PLAY)
+	{
+		return;
+	}
+
 	if (gEventHandlers.HasQuit)
 	{
 		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
@@ -500,6 +586,26 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 	// Update all the things in the game
 	const int ticksPerFrame = 1;
 
+	const int numLocalPlayers = GetNumPlayers(PLAYER_ANY, false, true);
+	const uint32_t hash =
+		gReplay.Mode != REPLAY_MODE_NONE && ReplayHashDue(gMission.time) ?
+		HashGameState() : 0;
+	if (gReplay.Mode == REPLAY_MODE_RECORD)
+	{
+		ReplayRecordTick(
+			&gReplay, gMission.time, rData->cmds, numLocalPlayers, hash);
+	}
+	else if (gReplay.Mode == REPLAY_MODE_PLAY &&
+		!ReplayPlayTick(
+			&gReplay, gMission.time, rData->cmds, numLocalPlayers, hash))
+	{
+		// The recording ended here without the mission ending, so it must
+		// have been quit
+		GameEvent e = GameEventNew(GAME_EVENT_MISSION_END);
+		e.u.MissionEnd.IsQuit = true;
+		GameEventsEnqueue(&gGameEvents, e);
+	}
+
 	if (gPlayerDatas.size > 0)
 	{
 		LOSReset(&gMap.LOS);
@@ -510,8 +616,9 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 			TActor *player = ActorGetByUID(p->ActorUID);
 			if (player->dead > DEATH_MAX) continue;
 			// Calculate LOS for all players alive or dying
-			LOSCalcFrom(
-				&gMap, Vec2ToTile(player->tileItem.Pos), !gCampaign.IsClient);
+			LOSCalcFromCached(
+				&gMap, p->UID, Vec2ToTile(player->tileItem.Pos),
+				!gCampaign.IsClient);
 
 			if (player->dead) continue;
 
@@ -537,7 +644,7 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 		{
 			const int enemies = AICommand(ticksPerFrame);
 			AIAddRandomEnemies(enemies, rData->m->missionData);
-			rData->aiUpdateCounter = 4;
+			rData->aiUpdateCounter = AI_UPDATE_TICKS;
 		}
 		else
 		{
@@ -624,6 +731,9 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 		&gGameEvents, &rData->Camera,
 		&rData->healthSpawner, &rData->ammoSpawners);
 
+	NetServerUpdateInterest(&gNetServer);
+	NetServerSendSnapshots(&gNetServer, ticksPerFrame);
+
 	rData->m->time += ticksPerFrame;
 
 	CameraUpdate(&rData->Camera, ticksPerFrame, 1000 / data->FPS);
@@ -632,6 +742,13 @@ static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
 }
 static void NextLoop(RunGameData *rData, LoopRunner *l)
 {
+	// Replays go straight to the next recorded mission
+	if (gReplay.Mode == REPLAY_MODE_PLAY)
+	{
+		LoopRunnerPop(l);
+		return;
+	}
+
 	// Find the next screen to switch to
 	const bool hasLocalPlayers = GetNumPlayers(PLAYER_ANY, false, true) > 0;
 	const int survivingPlayers =
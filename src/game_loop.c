@@ -34,6 +34,7 @@
 #include "events.h"
 #include "net_client.h"
 #include "net_server.h"
+#include "replay.h"
 #include "sounds.h"
 
 #ifdef __EMSCRIPTEN__
@@ -252,6 +253,12 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
     }
 #endif
 
+    // Headless servers only run updates, at the fixed tick rate
+    if (gGraphicsDevice.cachedConfig.IsHeadless)
+    {
+        return true;
+    }
+
     // Draw
     if (draw)
     {
@@ -323,6 +330,12 @@ static bool LoopRunParamsShouldSleep(LoopRunParams *p)
 	const Uint32 ticksThen = p->TicksNow;
 	p->TicksNow = SDL_GetTicks();
 	p->TicksElapsed += p->TicksNow - ticksThen;
+	// Replays run as fast as possible, one frame per loop
+	if (gReplay.Mode == REPLAY_MODE_PLAY)
+	{
+		p->TicksElapsed = p->FrameDurationMs;
+		return false;
+	}
 	return (int)p->TicksElapsed < p->FrameDurationMs;
 }
 static bool LoopRunParamsShouldSkip(LoopRunParams *p)
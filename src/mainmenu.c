@@ -556,6 +556,7 @@ menu_t *MenuCreateOptionsGraphics(const char *name, MenuSystem *ms)
 			MENU_OPTION_DISPLAY_STYLE_STR_FUNC,
 			GrafxGetModeStr));
 	MenuAddConfigOptionsItem(menu, ConfigGet(&gConfig, "Graphics.ScaleMode"));
+	MenuAddConfigOptionsItem(menu, ConfigGet(&gConfig, "Graphics.Renderer"));
 #endif	// GCWZERO
 	MenuAddConfigOptionsItem(menu, ConfigGet(&gConfig, "Graphics.Shadows"));
 	MenuAddConfigOptionsItem(menu, ConfigGet(&gConfig, "Graphics.Gore"));
@@ -216,8 +216,8 @@ static menu_t *CreateColorMenu(
 	{
 		for (v.x = 0; v.x < data->palette->size.x; v.x++)
 		{
-			const color_t colour = PIXEL2COLOR(
-				data->palette->Data[v.x + v.y * data->palette->size.x]);
+			const color_t colour = PIXEL2COLOR(data->palette->Data[
+				v.x + v.y * PIC_STRIDE(data->palette)]);
 			if (colour.a == 0)
 			{
 				continue;
@@ -251,7 +251,7 @@ static void DrawColorMenu(
 		for (v.x = 0; v.x < d->palette->size.x; v.x++)
 		{
 			const color_t colour = PIXEL2COLOR(
-				d->palette->Data[v.x + v.y * d->palette->size.x]);
+				d->palette->Data[v.x + v.y * PIC_STRIDE(d->palette)]);
 			if (colour.a == 0)
 			{
 				continue;
@@ -291,8 +291,8 @@ static int HandleInputColorMenu(int cmd, void *data)
 	if (selected.x >= 0 && selected.x < d->palette->size.x &&
 		selected.y >= 0 && selected.y < d->palette->size.y)
 	{
-		const color_t colour = PIXEL2COLOR(
-			d->palette->Data[selected.x + selected.y * d->palette->size.x]);
+		const color_t colour = PIXEL2COLOR(d->palette->Data[
+			selected.x + selected.y * PIC_STRIDE(d->palette)]);
 		if (colour.a != 0)
 		{
 			d->selectedColor = selected;
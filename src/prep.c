@@ -70,6 +70,7 @@
 #include <cdogs/net_client.h>
 #include <cdogs/net_server.h>
 #include <cdogs/pic_manager.h>
+#include <cdogs/replay.h>
 #include <cdogs/sounds.h>
 #include <cdogs/utils.h>
 
@@ -940,3 +941,181 @@ bail:
 	}
 	return UPDATE_RESULT_OK;
 }
+
+static GameLoopResult DedicatedServerUpdate(GameLoopData *data, LoopRunner *l);
+GameLoopData *ScreenDedicatedServer(void)
+{
+	return GameLoopDataNew(
+		NULL, NULL, NULL, NULL, NULL, DedicatedServerUpdate, NULL);
+}
+static GameLoopResult DedicatedServerUpdate(GameLoopData *data, LoopRunner *l)
+{
+	UNUSED(data);
+	// Run until the campaign is over or we are told to quit
+	if (!gCampaign.IsLoaded || gCampaign.IsComplete || gMission.IsQuit ||
+		gEventHandlers.HasQuit ||
+		gCampaign.MissionIndex >= (int)gCampaign.Setting.Missions.size)
+	{
+		LOG(LM_MAIN, LL_INFO, "Dedicated server finished");
+		MissionOptionsTerminate(&gMission);
+		CampaignUnload(&gCampaign);
+		LoopRunnerPop(l);
+		return UPDATE_RESULT_OK;
+	}
+
+	// Skip the menus and go straight into the next mission;
+	// remote players join the game as they connect
+	MissionOptionsTerminate(&gMission);
+	CampaignAndMissionSetup(&gCampaign, &gMission);
+	gCampaign.OptionsSet = true;
+	NetServerOpen(&gNetServer);
+	LoopRunnerPush(l, RunGame(&gCampaign, &gMission, &gMap));
+	return UPDATE_RESULT_OK;
+}
+
+typedef struct
+{
+	char CampaignPath[CDOGS_PATH_MAX];
+	Uint32 StartTicks;
+} ReplayData;
+static void ReplayDataTerminate(GameLoopData *data);
+static GameLoopResult ReplayUpdate(GameLoopData *data, LoopRunner *l);
+GameLoopData *ScreenReplay(void)
+{
+	ReplayData *rData;
+	CCALLOC(rData, sizeof *rData);
+	rData->StartTicks = SDL_GetTicks();
+	return GameLoopDataNew(
+		rData, ReplayDataTerminate, NULL, NULL, NULL, ReplayUpdate, NULL);
+}
+static void ReplayDataTerminate(GameLoopData *data)
+{
+	CFREE(data->Data);
+}
+static bool ReplayLoadCampaign(ReplayData *rData, const NetMsg *msg);
+static void ReplayHandleMsg(const NetMsg *msg);
+static GameLoopResult ReplayUpdate(GameLoopData *data, LoopRunner *l)
+{
+	ReplayData *rData = data->Data;
+	// Read the next mission's header, up to its first tick
+	NetMsg msg;
+	bool hasMission = false;
+	while (!gEventHandlers.HasQuit && ReplayPeek(&gReplay, &msg))
+	{
+		if (msg.Type == REPLAY_MSG_CMD || msg.Type == REPLAY_MSG_HASH ||
+			msg.Type == REPLAY_MSG_MISSION_END)
+		{
+			hasMission = true;
+			break;
+		}
+		ReplayRead(&gReplay, &msg);
+		if (msg.Type == REPLAY_MSG_CAMPAIGN)
+		{
+			if (!ReplayLoadCampaign(rData, &msg))
+			{
+				gReplay.Desyncs++;
+				break;
+			}
+		}
+		else
+		{
+			ReplayHandleMsg(&msg);
+		}
+	}
+	if (!hasMission || !gCampaign.IsLoaded)
+	{
+		LOG(LM_MAIN, LL_INFO, "Replay finished: %d ticks in %dms, %d desyncs",
+			gReplay.Ticks, (int)(SDL_GetTicks() - rData->StartTicks),
+			gReplay.Desyncs);
+		MissionOptionsTerminate(&gMission);
+		CampaignUnload(&gCampaign);
+		LoopRunnerPop(l);
+		return UPDATE_RESULT_OK;
+	}
+
+	MissionOptionsTerminate(&gMission);
+	CampaignAndMissionSetup(&gCampaign, &gMission);
+	gCampaign.OptionsSet = true;
+	LoopRunnerPush(l, RunGame(&gCampaign, &gMission, &gMap));
+	return UPDATE_RESULT_OK;
+}
+static bool ReplayLoadCampaign(ReplayData *rData, const NetMsg *msg)
+{
+	NCampaignDef def;
+	NetMsgDecode(msg, &def, NCampaignDef_fields);
+	// Consecutive missions are usually from the same campaign
+	if (!gCampaign.IsLoaded || gCampaign.Entry.Mode != (GameMode)def.GameMode ||
+		strcmp(rData->CampaignPath, def.Path) != 0)
+	{
+		CampaignUnload(&gCampaign);
+		gCampaign.Entry.Mode = (GameMode)def.GameMode;
+		char buf[CDOGS_PATH_MAX];
+		GetDataFilePath(buf, def.Path);
+		CampaignEntry entry;
+		if (!CampaignEntryTryLoad(&entry, buf, GAME_MODE_NORMAL) ||
+			!CampaignLoad(&gCampaign, &entry))
+		{
+			LOG(LM_MAIN, LL_ERROR, "failed to load replay campaign %s",
+				def.Path);
+			return false;
+		}
+		strcpy(rData->CampaignPath, def.Path);
+	}
+	gCampaign.MissionIndex = def.Mission;
+	return true;
+}
+static void ReplayHandleMsg(const NetMsg *msg)
+{
+	switch ((ReplayMsgType)msg->Type)
+	{
+	case REPLAY_MSG_MISSION:
+		{
+			NReplayMission m;
+			NetMsgDecode(msg, &m, NReplayMission_fields);
+			if (m.Version != REPLAY_VERSION)
+			{
+				LOG(LM_MAIN, LL_WARN, "replay version %u, expected %d",
+					m.Version, REPLAY_VERSION);
+			}
+			ConfigGet(&gConfig, "Game.RandomSeed")->u.Int.Value = m.RandomSeed;
+			gReplay.Seed = m.Seed;
+		}
+		break;
+	case REPLAY_MSG_CONFIG:
+		{
+			GameEvent e = GameEventNew(GAME_EVENT_CONFIG);
+			NetMsgDecode(msg, &e.u.Config, NConfig_fields);
+			GameEventsEnqueue(&gGameEvents, e);
+			HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
+		}
+		break;
+	case REPLAY_MSG_PLAYER_DATA:
+		{
+			GameEvent e = GameEventNew(GAME_EVENT_PLAYER_DATA);
+			NetMsgDecode(msg, &e.u.PlayerData, NPlayerData_fields);
+			GameEventsEnqueue(&gGameEvents, e);
+			HandleGameEvents(&gGameEvents, NULL, NULL, NULL);
+		}
+		break;
+	case REPLAY_MSG_PLAYER:
+		{
+			NReplayPlayer rp;
+			NetMsgDecode(msg, &rp, NReplayPlayer_fields);
+			PlayerData *p = PlayerDataGetByUID((int)rp.UID);
+			if (p == NULL)
+			{
+				LOG(LM_MAIN, LL_ERROR, "replay player UID(%u) not found",
+					rp.UID);
+				break;
+			}
+			// Commands come from the replay, except for AI players which
+			// recompute theirs
+			p->IsLocal = true;
+			p->inputDevice = (input_device_e)rp.InputDevice;
+		}
+		break;
+	default:
+		LOG(LM_MAIN, LL_ERROR, "unexpected replay msg(%d)", msg->Type);
+		break;
+	}
+}
@@ -72,3 +72,9 @@ GameLoopData *PlayerEquip(void);
 
 // Wait for the game to start
 GameLoopData *ScreenWaitForGameStart(void);
+
+// Headless server: run the loaded campaign's missions back to back
+GameLoopData *ScreenDedicatedServer(void);
+
+// Headless replay: play the missions recorded in gReplay
+GameLoopData *ScreenReplay(void);
@@ -0,0 +1,150 @@
+#include <cbehave/cbehave.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <AStar.h>
+
+#define SIZE 64
+#define COST_X 16.0f
+#define COST_Y 12.0f
+#define COST_DIAGONAL (16.0f * 1.1f)
+
+typedef struct
+{
+	int x, y;
+} Tile;
+static bool walls[SIZE * SIZE];
+static int isWalkableCalls;
+
+static int IsWalkable(int x, int y, void *context)
+{
+	(void)context;
+	isWalkableCalls++;
+	if (x < 0 || x >= SIZE || y < 0 || y >= SIZE) return 0;
+	return !walls[y * SIZE + x];
+}
+
+// Reference search using the generic A*
+static void AddNeighbors(ASNeighborList neighbors, void *node, void *context)
+{
+	const Tile *t = node;
+	for (int y = t->y - 1; y <= t->y + 1; y++)
+	{
+		for (int x = t->x - 1; x <= t->x + 1; x++)
+		{
+			if ((x == t->x && y == t->y) ||
+				!IsWalkable(x, y, context) ||
+				!IsWalkable(t->x, y, context) ||
+				!IsWalkable(x, t->y, context))
+			{
+				continue;
+			}
+			Tile n = { x, y };
+			float cost = COST_DIAGONAL;
+			if (y == t->y) cost = COST_X;
+			else if (x == t->x) cost = COST_Y;
+			ASNeighborListAdd(neighbors, &n, cost);
+		}
+	}
+}
+static const ASPathNodeSource cNodeSource =
+{
+	sizeof(Tile), AddNeighbors, NULL, NULL, NULL
+};
+static const ASGridSource cGridSource =
+{
+	IsWalkable, COST_X, COST_Y, COST_DIAGONAL
+};
+
+static float PathCost(ASPath path)
+{
+	float cost = 0;
+	for (size_t i = 1; i < ASPathGetCount(path); i++)
+	{
+		const Tile *a = ASPathGetNode(path, i - 1);
+		const Tile *b = ASPathGetNode(path, i);
+		if (a->x != b->x && a->y != b->y) cost += COST_DIAGONAL;
+		else if (a->x != b->x) cost += COST_X;
+		else cost += COST_Y;
+	}
+	return cost;
+}
+
+FEATURE(ASGridPathCreate, "Grid pathfinding")
+	SCENARIO("Find the same paths as the generic A*")
+		GIVEN("a map with random walls")
+			srand(42);
+			for (int i = 0; i < SIZE * SIZE; i++)
+			{
+				walls[i] = rand() % 100 < 25;
+			}
+			ASGrid grid = ASGridCreate(SIZE, SIZE);
+
+		WHEN("I find paths between random tiles with both")
+			int found = 0;
+			int sameFound = 0;
+			int sameCost = 0;
+			int searches;
+			for (searches = 0; searches < 100; searches++)
+			{
+				Tile start = { rand() % SIZE, rand() % SIZE };
+				Tile goal = { rand() % SIZE, rand() % SIZE };
+				walls[start.y * SIZE + start.x] = false;
+				walls[goal.y * SIZE + goal.x] = false;
+				ASPath ref = ASPathCreate(&cNodeSource, NULL, &start, &goal);
+				ASPath path = ASGridPathCreate(
+					grid, &cGridSource, NULL, start.x, start.y, goal.x, goal.y);
+				if ((ref == NULL) == (path == NULL)) sameFound++;
+				if (path != NULL)
+				{
+					found++;
+					const Tile *first = ASPathGetNode(path, 0);
+					const Tile *last =
+						ASPathGetNode(path, ASPathGetCount(path) - 1);
+					if (ref != NULL &&
+						fabsf(PathCost(ref) - PathCost(path)) < 0.01f &&
+						first->x == start.x && first->y == start.y &&
+						last->x == goal.x && last->y == goal.y)
+					{
+						sameCost++;
+					}
+				}
+				ASPathDestroy(ref);
+				ASPathDestroy(path);
+			}
+
+		THEN("they should agree on which paths exist")
+			SHOULD_INT_EQUAL(sameFound, searches);
+			SHOULD_INT_GT(found, 0);
+		AND("the paths should be as short")
+			SHOULD_INT_EQUAL(sameCost, found);
+			ASGridDestroy(grid);
+	SCENARIO_END
+	SCENARIO("Check each tile once per search")
+		GIVEN("an open map")
+			memset(walls, 0, sizeof walls);
+			ASGrid grid = ASGridCreate(SIZE, SIZE);
+
+		WHEN("I find a path across it twice")
+			isWalkableCalls = 0;
+			ASPath path = ASGridPathCreate(
+				grid, &cGridSource, NULL, 0, 0, SIZE - 1, SIZE - 1);
+			const int firstCalls = isWalkableCalls;
+			ASPathDestroy(path);
+			path = ASGridPathCreate(
+				grid, &cGridSource, NULL, 0, 0, SIZE - 1, SIZE - 1);
+
+		THEN("the path should be a diagonal")
+			SHOULD_INT_EQUAL((int)ASPathGetCount(path), SIZE);
+		AND("no tile should be checked twice")
+			SHOULD_INT_LE(firstCalls, SIZE * SIZE);
+		AND("the second search should check tiles again")
+			SHOULD_INT_EQUAL(isWalkableCalls, firstCalls * 2);
+			ASPathDestroy(path);
+			ASGridDestroy(grid);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("A* features are:", TEST_FEATURE(ASGridPathCreate))
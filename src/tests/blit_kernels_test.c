@@ -0,0 +1,131 @@
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+
+#include <blit_kernels.h>
+
+#define SPAN_MAX 37
+#define AMASK 0xFF000000
+#define ASHIFT 24
+
+
+// Reference versions of the blits, per pixel
+static Uint32 RefMult(const Uint32 p, const Uint32 m)
+{
+	Uint32 out = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		out |= (((p >> shift) & 0xFF) * ((m >> shift) & 0xFF) / 0xFF) << shift;
+	}
+	return out;
+}
+static Uint32 RefCopy(const Uint32 d, const Uint32 s, const BlitSpanParams *p)
+{
+	return (s & p->Amask) ? s : d;
+}
+static Uint32 RefMasked(const Uint32 d, const Uint32 s, const BlitSpanParams *p)
+{
+	if (p->IsTransparent && ((s & p->Amask) >> p->Ashift) < 3) return d;
+	return RefMult(s, p->Mask) | p->Amask;
+}
+static Uint32 RefMultichannel(
+	const Uint32 d, const Uint32 s, const BlitSpanParams *p)
+{
+	if (s == 0) return d;
+	const Uint32 a = (s & p->Amask) >> p->Ashift;
+	return RefMult(s, a >= 250 ? p->ChannelMasks[255 - a] : 0xFFFFFFFF);
+}
+static Uint32 RefBlend(const Uint32 d, const Uint32 s, const BlitSpanParams *p)
+{
+	if (s == 0) return d;
+	const Uint32 m = RefMult(s, p->Mask);
+	const Uint32 a = (p->Mask & p->Amask) >> p->Ashift;
+	Uint32 out = p->Amask;
+	for (int shift = 0; shift < 24; shift += 8)
+	{
+		const Uint32 c =
+			(((d >> shift) & 0xFF) * (255 - a) + ((m >> shift) & 0xFF) * a) /
+			255;
+		out |= c << shift;
+	}
+	return out;
+}
+
+static Uint32 RandPixel(void)
+{
+	// Mostly interesting alphas: empty, nearly transparent and channels
+	static const Uint32 alphas[] = { 0, 1, 2, 3, 128, 250, 251, 252, 253, 254, 255 };
+	const Uint32 a = alphas[rand() % (sizeof alphas / sizeof alphas[0])];
+	if (rand() % 8 == 0) return 0;
+	return (a << ASHIFT) | ((Uint32)rand() & 0xFFFFFF);
+}
+static void RandParams(BlitSpanParams *p)
+{
+	p->Amask = AMASK;
+	p->Ashift = ASHIFT;
+	p->Mask = ((Uint32)rand() << 16) ^ (Uint32)rand();
+	p->IsTransparent = rand() % 2;
+	for (int i = 0; i < 6; i++)
+	{
+		p->ChannelMasks[i] = ((Uint32)rand() << 16) ^ (Uint32)rand();
+	}
+}
+
+typedef Uint32 (*RefFunc)(const Uint32, const Uint32, const BlitSpanParams *);
+// Returns number of mismatched pixels
+static int TestKernel(const BlitSpanFunc f, const RefFunc ref)
+{
+	int mismatches = 0;
+	for (int run = 0; run < 200; run++)
+	{
+		Uint32 src[SPAN_MAX + 1], dst[SPAN_MAX + 1], expected[SPAN_MAX + 1];
+		BlitSpanParams p;
+		RandParams(&p);
+		// Vary length and alignment
+		const int n = rand() % SPAN_MAX;
+		const int offset = rand() % 2;
+		for (int i = 0; i < SPAN_MAX + 1; i++)
+		{
+			src[i] = RandPixel();
+			dst[i] = expected[i] = RandPixel();
+		}
+		for (int i = 0; i < n; i++)
+		{
+			expected[i + offset] = ref(dst[i + offset], src[i + offset], &p);
+		}
+		f(dst + offset, src + offset, n, &p);
+		for (int i = 0; i < SPAN_MAX + 1; i++)
+		{
+			if (dst[i] != expected[i]) mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+FEATURE(BlitKernels, "Blit kernels")
+	SCENARIO("All kernels match the reference blits exactly")
+		GIVEN("the kernels supported on this machine")
+			srand(42);
+			int numKernels = 0;
+			int mismatches = 0;
+
+		WHEN("I blit random spans with each kernel")
+			for (int t = 0; t < BLIT_KERNELS_COUNT; t++)
+			{
+				const BlitKernels *k = BlitKernelsGet((BlitKernelsType)t);
+				if (k == NULL) continue;
+				numKernels++;
+				mismatches += TestKernel(k->Copy, RefCopy);
+				mismatches += TestKernel(k->Masked, RefMasked);
+				mismatches += TestKernel(k->Multichannel, RefMultichannel);
+				mismatches += TestKernel(k->Blend, RefBlend);
+			}
+
+		THEN("at least the scalar kernels should be available")
+			SHOULD_BE_TRUE(numKernels >= 1);
+		AND("every pixel should match")
+			SHOULD_INT_EQUAL(mismatches, 0);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Blit kernels features are:", TEST_FEATURE(BlitKernels))
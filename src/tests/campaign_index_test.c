@@ -0,0 +1,101 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+
+#include <campaign_index.h>
+#include <json_utils.h>
+#include <pic_manager.h>
+#include <weapon.h>
+
+#define INDEX_TEST_FILE "campaign_index_test.json"
+
+
+// Stubs
+Mix_Chunk *StrSound(const char *s)
+{
+	UNUSED(s);
+	return NULL;
+}
+Pic *PicManagerGetPic(const PicManager *pm, const char *name)
+{
+	UNUSED(pm);
+	UNUSED(name);
+	return NULL;
+}
+const GunDescription *StrGunDescription(const char *s)
+{
+	UNUSED(s);
+	return NULL;
+}
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+PicManager gPicManager;
+
+
+FEATURE(CampaignIndexGet, "Get cached campaign scans")
+	SCENARIO("Get a saved scan")
+		GIVEN("an index with a campaign and a non-campaign")
+			CampaignIndex ci;
+			CampaignIndexInit(&ci);
+			CampaignIndexSet(&ci, "missions/a.cdogscpn", 100, 200, "\"A\"", 3);
+			CampaignIndexSet(&ci, "missions/readme.txt", 10, 20, NULL, -1);
+		AND("I save and reload it")
+			CampaignIndexSave(&ci, INDEX_TEST_FILE);
+			CampaignIndexTerminate(&ci);
+			CampaignIndexInit(&ci);
+			CampaignIndexLoad(&ci, INDEX_TEST_FILE);
+
+		WHEN("I get the scans with the same mtime and size")
+			const CampaignIndexEntry *a =
+				CampaignIndexGet(&ci, "missions/a.cdogscpn", 100, 200);
+			const CampaignIndexEntry *readme =
+				CampaignIndexGet(&ci, "missions/readme.txt", 10, 20);
+
+		THEN("the campaign should have its title and missions")
+			SHOULD_BE_TRUE(a != NULL);
+			SHOULD_STR_EQUAL(a->Title, "\"A\"");
+			SHOULD_INT_EQUAL(a->NumMissions, 3);
+		AND("the non-campaign should be cached as such")
+			SHOULD_BE_TRUE(readme != NULL);
+			SHOULD_INT_EQUAL(readme->NumMissions, -1);
+			CampaignIndexTerminate(&ci);
+			remove(INDEX_TEST_FILE);
+	SCENARIO_END
+
+	SCENARIO("Get a changed or removed campaign")
+		GIVEN("a saved index with two campaigns")
+			CampaignIndex ci;
+			CampaignIndexInit(&ci);
+			CampaignIndexSet(&ci, "a", 100, 200, "A", 1);
+			CampaignIndexSet(&ci, "b", 100, 200, "B", 2);
+			CampaignIndexSave(&ci, INDEX_TEST_FILE);
+			CampaignIndexTerminate(&ci);
+			CampaignIndexInit(&ci);
+			CampaignIndexLoad(&ci, INDEX_TEST_FILE);
+
+		WHEN("I get the first campaign with a different mtime")
+			const CampaignIndexEntry *a = CampaignIndexGet(&ci, "a", 101, 200);
+		AND("I save without getting the second campaign")
+			CampaignIndexSave(&ci, INDEX_TEST_FILE);
+			CampaignIndexTerminate(&ci);
+			CampaignIndexInit(&ci);
+			CampaignIndexLoad(&ci, INDEX_TEST_FILE);
+
+		THEN("the changed campaign should need scanning")
+			SHOULD_BE_TRUE(a == NULL);
+		AND("the removed campaign should be pruned")
+			SHOULD_BE_TRUE(CampaignIndexGet(&ci, "b", 100, 200) == NULL);
+			SHOULD_BE_TRUE(CampaignIndexGet(&ci, "a", 100, 200) != NULL);
+			CampaignIndexTerminate(&ci);
+			remove(INDEX_TEST_FILE);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Campaign index features are:",
+	TEST_FEATURE(CampaignIndexGet)
+)
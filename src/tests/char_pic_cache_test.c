@@ -0,0 +1,127 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <char_pic_cache.h>
+
+#define AMASK 0xFF000000
+#define ASHIFT 24
+
+
+static void InitParams(BlitSpanParams *p, const Uint32 bodyMask)
+{
+	memset(p, 0, sizeof *p);
+	p->Amask = AMASK;
+	p->Ashift = ASHIFT;
+	for (int i = 0; i < 6; i++)
+	{
+		p->ChannelMasks[i] = 0xFFFFFFFF;
+	}
+	// Body channel, for alpha 252
+	p->ChannelMasks[3] = bodyMask;
+}
+
+FEATURE(CharPicCacheGet, "Get coloured pics")
+	SCENARIO("Colour a pic")
+		GIVEN("a pic with body pixels and empty pixels")
+			Uint32 data[4] = { 0, 0xFC808080, 0xFC404040, 0 };
+			Pic pic = { svec2i(2, 2), svec2i(-1, -1), data, 0 };
+			CharPicCache c;
+			CharPicCacheInit(&c, 100);
+		AND("a red body colour")
+			BlitSpanParams p;
+			InitParams(&p, 0xFFFF0000);
+
+		WHEN("I get the pic twice")
+			const Pic *coloured = CharPicCacheGet(&c, &pic, &p);
+			const Pic *coloured2 = CharPicCacheGet(&c, &pic, &p);
+
+		THEN("the pic should be coloured with the same size and offset")
+			SHOULD_BE_TRUE(coloured != NULL);
+			SHOULD_INT_EQUAL(coloured->size.x, 2);
+			SHOULD_INT_EQUAL(coloured->offset.y, -1);
+			SHOULD_INT_EQUAL(coloured->Data[0], 0);
+			SHOULD_INT_EQUAL(coloured->Data[1], 0xFC800000);
+			SHOULD_INT_EQUAL(coloured->Data[2], 0xFC400000);
+			SHOULD_INT_EQUAL(coloured->Data[3], 0);
+		AND("the second get should be cached")
+			SHOULD_BE_TRUE(coloured == coloured2);
+			SHOULD_INT_EQUAL(c.Hits, 1);
+			SHOULD_INT_EQUAL(c.NumPixels, 4);
+			CharPicCacheTerminate(&c);
+	SCENARIO_END
+	SCENARIO("Change colours")
+		GIVEN("a cached pic")
+			Uint32 data[4] = { 0xFC808080, 0xFC808080, 0xFC808080, 0 };
+			Pic pic = { svec2i(2, 2), svec2i_zero(), data, 0 };
+			CharPicCache c;
+			CharPicCacheInit(&c, 100);
+			BlitSpanParams p;
+			InitParams(&p, 0xFFFF0000);
+			CharPicCacheGet(&c, &pic, &p);
+
+		WHEN("I get it with a different colour")
+			InitParams(&p, 0xFF0000FF);
+			const Pic *coloured = CharPicCacheGet(&c, &pic, &p);
+
+		THEN("it should have the new colour")
+			SHOULD_INT_EQUAL(coloured->Data[0], 0xFC000080);
+			SHOULD_INT_EQUAL(c.NumPixels, 8);
+			CharPicCacheTerminate(&c);
+	SCENARIO_END
+	SCENARIO("Evict least recently used pics")
+		GIVEN("a cache with room for two pics")
+			Uint32 data[4] = { 0xFC808080, 0xFC808080, 0xFC808080, 0 };
+			Pic pics[3] =
+			{
+				{ svec2i(2, 2), svec2i_zero(), data, 0 },
+				{ svec2i(2, 2), svec2i_zero(), data, 0 },
+				{ svec2i(2, 2), svec2i_zero(), data, 0 }
+			};
+			CharPicCache c;
+			CharPicCacheInit(&c, 8);
+			BlitSpanParams p;
+			InitParams(&p, 0xFFFF0000);
+		AND("two cached pics, the first most recently used")
+			CharPicCacheGet(&c, &pics[0], &p);
+			CharPicCacheGet(&c, &pics[1], &p);
+			CharPicCacheGet(&c, &pics[0], &p);
+
+		WHEN("I get a third pic")
+			CharPicCacheGet(&c, &pics[2], &p);
+
+		THEN("the cache should stay within its size")
+			SHOULD_INT_EQUAL(c.NumPixels, 8);
+		AND("the first pic should still be cached")
+			const int hits = c.Hits;
+			CharPicCacheGet(&c, &pics[0], &p);
+			SHOULD_INT_EQUAL(c.Hits, hits + 1);
+		AND("the second pic should have been evicted")
+			const int misses = c.Misses;
+			CharPicCacheGet(&c, &pics[1], &p);
+			SHOULD_INT_EQUAL(c.Misses, misses + 1);
+			CharPicCacheTerminate(&c);
+	SCENARIO_END
+	SCENARIO("Don't cache pics that are too big")
+		GIVEN("a cache smaller than a pic")
+			Uint32 data[4] = { 0xFC808080, 0xFC808080, 0xFC808080, 0 };
+			Pic pic = { svec2i(2, 2), svec2i_zero(), data, 0 };
+			CharPicCache c;
+			CharPicCacheInit(&c, 3);
+			BlitSpanParams p;
+			InitParams(&p, 0xFFFF0000);
+
+		WHEN("I get the pic")
+			const Pic *coloured = CharPicCacheGet(&c, &pic, &p);
+
+		THEN("it should not be cached")
+			SHOULD_BE_TRUE(coloured == NULL);
+			SHOULD_INT_EQUAL(c.NumPixels, 0);
+			CharPicCacheTerminate(&c);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Char pic cache features are:",
+	TEST_FEATURE(CharPicCacheGet)
+)
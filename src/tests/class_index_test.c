@@ -0,0 +1,54 @@
+#include <cbehave/cbehave.h>
+
+#include <stddef.h>
+
+#include <class_index.h>
+
+typedef struct
+{
+	int Id;
+	char *Name;
+} TestClass;
+
+
+FEATURE(ClassIndexGet, "Find classes by name")
+	SCENARIO("Find classes in several arrays")
+		GIVEN("a custom and a default array with a shared name")
+			CArray custom, classes;
+			CArrayInit(&custom, sizeof(TestClass));
+			CArrayInit(&classes, sizeof(TestClass));
+			TestClass c = { 1, "shared" };
+			CArrayPushBack(&custom, &c);
+			c.Id = 2;
+			CArrayPushBack(&classes, &c);
+			c.Id = 3;
+			c.Name = "default";
+			CArrayPushBack(&classes, &c);
+			const CArray *arrays[] = { &custom, &classes, NULL };
+			map_t index = NULL;
+
+		WHEN("I find the classes by name")
+			const TestClass *shared = ClassIndexGet(
+				&index, arrays, offsetof(TestClass, Name), "shared");
+			const TestClass *def = ClassIndexGet(
+				&index, arrays, offsetof(TestClass, Name), "default");
+			const TestClass *missing = ClassIndexGet(
+				&index, arrays, offsetof(TestClass, Name), "missing");
+
+		THEN("the earlier array should take precedence")
+			SHOULD_INT_EQUAL(shared->Id, 1);
+		AND("the other classes should be found")
+			SHOULD_INT_EQUAL(def->Id, 3);
+			SHOULD_BE_TRUE(missing == NULL);
+		AND("the index should be dropped on reset")
+			ClassIndexReset(&index);
+			SHOULD_BE_TRUE(index == NULL);
+			CArrayTerminate(&custom);
+			CArrayTerminate(&classes);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"ClassIndex features are:",
+	TEST_FEATURE(ClassIndexGet)
+)
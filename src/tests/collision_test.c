@@ -0,0 +1,311 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <collision/collision.h>
+#include <objs.h>
+#include <pickup.h>
+
+#define MAP_SIZE 16
+#define MAX_THINGS 8
+#define THINGS_PER_TILE 5
+
+// Stubs
+Map gMap;
+CArray gActors;
+CArray gMobObjs;
+CArray gObjs;
+CArray gParticles;
+CArray gPickups;
+CampaignOptions gCampaign;
+Config gConfig;
+Tile *MapGetTile(const Map *map, const struct vec2i pos)
+{
+	if (pos.x < 0 || pos.x >= map->Size.x || pos.y < 0 || pos.y >= map->Size.y)
+	{
+		return NULL;
+	}
+	return CArrayGet(&map->Tiles, pos.y * map->Size.x + pos.x);
+}
+int ConfigGetEnum(Config *c, const char *name)
+{
+	UNUSED(c);
+	UNUSED(name);
+	return ALLYCOLLISION_NORMAL;
+}
+bool IsPVP(const GameMode mode)
+{
+	UNUSED(mode);
+	return false;
+}
+void CPicUpdate(CPic *p, const int ticks)
+{
+	UNUSED(p);
+	UNUSED(ticks);
+}
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+
+static void TestMapInit(void)
+{
+	memset(&gMap, 0, sizeof gMap);
+	gMap.Size = svec2i(MAP_SIZE, MAP_SIZE);
+	CArrayInit(&gMap.Tiles, sizeof(Tile));
+	for (int i = 0; i < MAP_SIZE * MAP_SIZE; i++)
+	{
+		Tile t;
+		TileInit(&t);
+		CArrayPushBack(&gMap.Tiles, &t);
+	}
+	CArrayInit(&gObjs, sizeof(TObject));
+}
+static void TestMapTerminate(void)
+{
+	CA_FOREACH(Tile, t, gMap.Tiles)
+		TileDestroy(t);
+	CA_FOREACH_END()
+	CArrayTerminate(&gMap.Tiles);
+	CArrayTerminate(&gObjs);
+}
+// Add an object to the tile of its centre, returning its id
+static int AddThing(const struct vec2 pos, const struct vec2i size)
+{
+	const int id = (int)gObjs.size;
+	TObject o;
+	memset(&o, 0, sizeof o);
+	CArrayPushBack(&gObjs, &o);
+	TTileItem *ti = &((TObject *)CArrayGet(&gObjs, id))->tileItem;
+	TileItemInit(ti, id, KIND_OBJECT, size, 0);
+	ti->Pos = pos;
+	TileAddThing(MapGetTile(&gMap, Vec2ToTile(pos)), ti);
+	return id;
+}
+static TTileItem *GetThing(const int id)
+{
+	return &((TObject *)CArrayGet(&gObjs, id))->tileItem;
+}
+static const ThingId *GetTileThing(const struct vec2i tile, const int idx)
+{
+	return CArrayGet(&MapGetTile(&gMap, tile)->things, idx);
+}
+static void AddThingsToTile(const struct vec2i tile, int *ids)
+{
+	for (int i = 0; i < THINGS_PER_TILE; i++)
+	{
+		ids[i] = AddThing(Vec2CenterOfTile(tile), svec2i(4, 4));
+	}
+}
+// Count the things in a tile whose stored index is not their index
+static int CountBadIndexes(const struct vec2i tile)
+{
+	int bad = 0;
+	const CArray *things = &MapGetTile(&gMap, tile)->things;
+	for (int i = 0; i < (int)things->size; i++)
+	{
+		const ThingId *tid = CArrayGet(things, i);
+		if (ThingIdGetTileItem(tid)->tileThingIdx != i) bad++;
+	}
+	return bad;
+}
+
+typedef struct
+{
+	int Ids[MAX_THINGS];
+	int Count;
+} Overlaps;
+static bool AddOverlap(
+	TTileItem *ti, void *data, const struct vec2 colA, const struct vec2 colB,
+	const struct vec2 normal)
+{
+	UNUSED(colA);
+	UNUSED(colB);
+	UNUSED(normal);
+	Overlaps *o = data;
+	o->Ids[o->Count++] = ti->id;
+	return true;
+}
+static Overlaps Overlap(
+	const struct vec2 pos, const struct vec2 vel, const struct vec2i size)
+{
+	TTileItem item;
+	TileItemInit(&item, 0, KIND_MOBILEOBJECT, size, 0);
+	item.Pos = pos;
+	item.Vel = vel;
+	const CollisionParams params = { 0, COLLISIONTEAM_NONE, false };
+	Overlaps o;
+	memset(&o, 0, sizeof o);
+	OverlapTileItems(
+		&item, pos, size, params, AddOverlap, &o, NULL, NULL, NULL);
+	return o;
+}
+static bool HasOverlap(const Overlaps *o, const int id)
+{
+	for (int i = 0; i < o->Count; i++)
+	{
+		if (o->Ids[i] == id) return true;
+	}
+	return false;
+}
+
+
+FEATURE(OverlapTileItems, "Overlap tile items")
+	SCENARIO("Fast mover crossing several tiles")
+		GIVEN("things in a row of tiles, and things off the path")
+			TestMapInit();
+			const int row = 5;
+			int path[5];
+			for (int i = 0; i < 5; i++)
+			{
+				path[i] = AddThing(
+					Vec2CenterOfTile(svec2i(3 + i, row)), svec2i(8, 8));
+			}
+			// In the tile margin past the end of the path
+			const int pastEnd = AddThing(
+				Vec2CenterOfTile(svec2i(9, row)), svec2i(8, 8));
+			const int offPath = AddThing(
+				Vec2CenterOfTile(svec2i(5, row + 3)), svec2i(8, 8));
+
+		WHEN("a bullet moves across them in one tick")
+			const struct vec2 pos = Vec2CenterOfTile(svec2i(2, row));
+			const struct vec2 vel = svec2(6 * TILE_WIDTH, 0);
+			const Overlaps o = Overlap(pos, vel, svec2i(2, 2));
+
+		THEN("every thing on the path should overlap, in tile order")
+			SHOULD_INT_EQUAL(o.Count, 5);
+			for (int i = 0; i < o.Count; i++)
+			{
+				SHOULD_INT_EQUAL(o.Ids[i], path[i]);
+			}
+		AND("things past the end or off the path should not")
+			SHOULD_BE_FALSE(HasOverlap(&o, pastEnd));
+			SHOULD_BE_FALSE(HasOverlap(&o, offPath));
+			TestMapTerminate();
+	SCENARIO_END
+
+	SCENARIO("Thing stored by its centre at the edge of the margin")
+		GIVEN("a wide thing whose centre is a tile away from an item")
+			TestMapInit();
+			const struct vec2i tile = svec2i(5, 5);
+			const struct vec2 pos = Vec2CenterOfTile(tile);
+			// Centre at the far edge of the next tile, reaching into the
+			// item's tile
+			const int wide = AddThing(
+				svec2((tile.x - 1) * TILE_WIDTH + 1, pos.y),
+				svec2i(TILE_WIDTH * 2 + 12, 8));
+			// Centre just outside the margin
+			const int outside = AddThing(
+				svec2((tile.x - 1) * TILE_WIDTH - 1, pos.y), svec2i(8, 8));
+
+		WHEN("I check the overlaps of the item")
+			struct vec2i tMin, tMax;
+			SweptAABBToTiles(
+				&gMap, pos, svec2_zero(), svec2i(8, 8), &tMin, &tMax);
+			const Overlaps o = Overlap(pos, svec2_zero(), svec2i(8, 8));
+
+		THEN("the tile range should include a margin of one tile")
+			SHOULD_INT_EQUAL(tMin.x, tile.x - 1);
+			SHOULD_INT_EQUAL(tMin.y, tile.y - 1);
+			SHOULD_INT_EQUAL(tMax.x, tile.x + 1);
+			SHOULD_INT_EQUAL(tMax.y, tile.y + 1);
+		AND("the wide thing should overlap")
+			SHOULD_BE_TRUE(HasOverlap(&o, wide));
+		AND("the thing outside the margin should not")
+			SHOULD_BE_FALSE(HasOverlap(&o, outside));
+			TestMapTerminate();
+	SCENARIO_END
+
+	SCENARIO("Tile range at the edge of the map")
+		GIVEN("a map")
+			TestMapInit();
+
+		WHEN("an item moves off the corner of the map")
+			struct vec2i tMin, tMax;
+			SweptAABBToTiles(
+				&gMap, Vec2CenterOfTile(svec2i(0, 0)), svec2(-40, -40),
+				svec2i(8, 8), &tMin, &tMax);
+
+		THEN("the tile range should be clamped to the map")
+			SHOULD_INT_EQUAL(tMin.x, 0);
+			SHOULD_INT_EQUAL(tMin.y, 0);
+			SHOULD_INT_EQUAL(tMax.x, 1);
+			SHOULD_INT_EQUAL(tMax.y, 1);
+			TestMapTerminate();
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(TileRemoveThing, "Remove things from tiles")
+	SCENARIO("Remove the first thing")
+		GIVEN("a tile with some things")
+			TestMapInit();
+			const struct vec2i tile = svec2i(3, 3);
+			int ids[THINGS_PER_TILE];
+			AddThingsToTile(tile, ids);
+			Tile *t = MapGetTile(&gMap, tile);
+
+		WHEN("I remove the first thing")
+			TileRemoveThing(t, GetThing(ids[0]));
+
+		THEN("the last thing should take its place")
+			SHOULD_INT_EQUAL((int)t->things.size, THINGS_PER_TILE - 1);
+			SHOULD_INT_EQUAL(GetTileThing(tile, 0)->Id, ids[4]);
+			SHOULD_INT_EQUAL(GetThing(ids[4])->tileThingIdx, 0);
+		AND("the stored indexes should match the tile")
+			SHOULD_INT_EQUAL(GetThing(ids[0])->tileThingIdx, -1);
+			SHOULD_INT_EQUAL(CountBadIndexes(tile), 0);
+			TestMapTerminate();
+	SCENARIO_END
+
+	SCENARIO("Remove a middle thing")
+		GIVEN("a tile with some things")
+			TestMapInit();
+			const struct vec2i tile = svec2i(3, 3);
+			int ids[THINGS_PER_TILE];
+			AddThingsToTile(tile, ids);
+			Tile *t = MapGetTile(&gMap, tile);
+
+		WHEN("I remove a middle thing")
+			TileRemoveThing(t, GetThing(ids[2]));
+
+		THEN("the last thing should take its place")
+			SHOULD_INT_EQUAL((int)t->things.size, THINGS_PER_TILE - 1);
+			SHOULD_INT_EQUAL(GetTileThing(tile, 2)->Id, ids[4]);
+			SHOULD_INT_EQUAL(GetThing(ids[4])->tileThingIdx, 2);
+		AND("the stored indexes should match the tile")
+			SHOULD_INT_EQUAL(GetThing(ids[2])->tileThingIdx, -1);
+			SHOULD_INT_EQUAL(CountBadIndexes(tile), 0);
+			TestMapTerminate();
+	SCENARIO_END
+
+	SCENARIO("Remove the last thing")
+		GIVEN("a tile with some things")
+			TestMapInit();
+			const struct vec2i tile = svec2i(3, 3);
+			int ids[THINGS_PER_TILE];
+			AddThingsToTile(tile, ids);
+			Tile *t = MapGetTile(&gMap, tile);
+
+		WHEN("I remove the last thing")
+			TileRemoveThing(t, GetThing(ids[4]));
+
+		THEN("the other things should keep their places")
+			SHOULD_INT_EQUAL((int)t->things.size, THINGS_PER_TILE - 1);
+			for (int i = 0; i < THINGS_PER_TILE - 1; i++)
+			{
+				SHOULD_INT_EQUAL(GetTileThing(tile, i)->Id, ids[i]);
+			}
+		AND("the stored indexes should match the tile")
+			SHOULD_INT_EQUAL(GetThing(ids[4])->tileThingIdx, -1);
+			SHOULD_INT_EQUAL(CountBadIndexes(tile), 0);
+			TestMapTerminate();
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Collision features are:",
+	TEST_FEATURE(OverlapTileItems),
+	TEST_FEATURE(TileRemoveThing)
+)
@@ -0,0 +1,73 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <flow_field.h>
+
+#define SIZE 16
+
+// Walls every 4th column, with a gap alternating between top and bottom
+static bool IsTileOk(Map *map, struct vec2i pos)
+{
+	UNUSED(map);
+	if (pos.x % 4 != 2) return true;
+	return (pos.x / 4) % 2 == 0 ? pos.y == 0 : pos.y == SIZE - 1;
+}
+
+static int WalkTo(
+	const FlowField *f, const Map *m, struct vec2i from, const int maxSteps)
+{
+	int steps = 0;
+	struct vec2i next;
+	while (steps < maxSteps && FlowFieldNextTile(f, m, from, &next))
+	{
+		if (!IsTileOk(NULL, next)) return -1;
+		from = next;
+		steps++;
+	}
+	return svec2i_is_equal(from, f->Goal) ? steps : -1;
+}
+
+FEATURE(FlowFieldNextTile, "Follow a flow field")
+	SCENARIO("Walk to the goal around walls")
+		GIVEN("a map with winding walls")
+			Map m;
+			memset(&m, 0, sizeof m);
+			m.Size = svec2i(SIZE, SIZE);
+			FlowFields ff;
+			FlowFieldsInit(&ff, &m, IsTileOk);
+
+		WHEN("I get the field towards the far corner")
+			const FlowField *f = FlowFieldsGet(&ff, 1, svec2i(SIZE - 1, 0));
+
+		THEN("I should reach the goal from the other corner")
+			SHOULD_INT_GT(WalkTo(f, &m, svec2i(0, SIZE - 1), 1000), 0);
+		AND("I should reach it from between the walls")
+			SHOULD_INT_GT(WalkTo(f, &m, svec2i(5, 7), 1000), 0);
+		AND("the walls should be unreachable")
+			SHOULD_INT_EQUAL(
+				*(uint16_t *)CArrayGet(&f->Dist, 7 * SIZE + 6),
+				FLOW_FIELD_UNREACHABLE);
+			FlowFieldsTerminate(&ff);
+	SCENARIO_END
+	SCENARIO("Follow a moving goal")
+		GIVEN("a field towards a goal")
+			Map m;
+			memset(&m, 0, sizeof m);
+			m.Size = svec2i(SIZE, SIZE);
+			FlowFields ff;
+			FlowFieldsInit(&ff, &m, IsTileOk);
+			FlowFieldsGet(&ff, 1, svec2i(0, 0));
+
+		WHEN("the goal moves")
+			const FlowField *f = FlowFieldsGet(&ff, 1, svec2i(1, 5));
+
+		THEN("the field should head to the new goal")
+			SHOULD_INT_EQUAL(WalkTo(f, &m, svec2i(1, 0), 1000), 5);
+		AND("there should still be one field for the actor")
+			SHOULD_INT_EQUAL((int)ff.fields.size, 1);
+			FlowFieldsTerminate(&ff);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Flow field features are:", TEST_FEATURE(FlowFieldNextTile))
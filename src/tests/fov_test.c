@@ -0,0 +1,286 @@
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <fov.h>
+
+#define SIZE 64
+#define RANGE 15
+// Size of the map checked for symmetry; every pair of tiles is compared
+#define SYM_SIZE 40
+// Least share of the floor tiles seen by either algorithm that both see, in
+// percent; measured at about 88% on the rooms map
+#define AGREE_PERCENT_MIN 85
+
+
+typedef struct
+{
+	bool Visible[SIZE * SIZE];
+	int Calls;
+} FOVResult;
+static void SetVisible(void *data, const struct vec2i pos)
+{
+	FOVResult *r = data;
+	r->Visible[pos.y * SIZE + pos.x] = true;
+	r->Calls++;
+}
+static void Calc(
+	FOVResult *r, const FOVType type, const FOVMap *m, const struct vec2i pos)
+{
+	memset(r, 0, sizeof *r);
+	FOVCalc(type, m, pos, RANGE, SetVisible, r);
+}
+static int CountVisible(const FOVResult *r)
+{
+	int count = 0;
+	for (int i = 0; i < SIZE * SIZE; i++)
+	{
+		if (r->Visible[i]) count++;
+	}
+	return count;
+}
+// Calculate the shadowcast field of view of a layout, and count the tiles
+// whose visibility differs from what the layout expects
+static int CountLayoutErrors(const char **rows)
+{
+	struct vec2i size = svec2i((int)strlen(rows[0]), 0);
+	while (rows[size.y] != NULL) size.y++;
+	FOVMap m;
+	FOVMapInit(&m, size);
+	struct vec2i pos = svec2i_zero();
+	struct vec2i v;
+	for (v.y = 0; v.y < size.y; v.y++)
+	{
+		for (v.x = 0; v.x < size.x; v.x++)
+		{
+			const char c = rows[v.y][v.x];
+			FOVMapSet(&m, v, c == '#' || c == '+');
+			if (c == '@') pos = v;
+		}
+	}
+	FOVResult r;
+	Calc(&r, FOV_SHADOWCAST, &m, pos);
+	int errors = 0;
+	for (v.y = 0; v.y < size.y; v.y++)
+	{
+		for (v.x = 0; v.x < size.x; v.x++)
+		{
+			const char c = rows[v.y][v.x];
+			const bool expected = c == '.' || c == '#';
+			if (r.Visible[v.y * SIZE + v.x] != expected) errors++;
+		}
+	}
+	FOVMapTerminate(&m);
+	return errors;
+}
+
+// Rooms of 16x16 tiles joined by doorways, with pillars scattered about
+static void InitRoomsMap(FOVMap *m)
+{
+	FOVMapInit(m, svec2i(SYM_SIZE, SYM_SIZE));
+	srand(42);
+	struct vec2i v;
+	for (v.y = 0; v.y < SYM_SIZE; v.y++)
+	{
+		for (v.x = 0; v.x < SYM_SIZE; v.x++)
+		{
+			const bool isRoomWall =
+				(v.x % 16 == 0 && v.y % 16 != 8) ||
+				(v.y % 16 == 0 && v.x % 16 != 8);
+			FOVMapSet(m, v, isRoomWall || rand() % 100 < 8);
+		}
+	}
+}
+
+FEATURE(FOVCalc, "Field of view")
+	SCENARIO("See everything in range in an open map")
+		GIVEN("an open map")
+			FOVMap m;
+			FOVMapInit(&m, svec2i(SIZE, SIZE));
+
+		WHEN("I calculate the field of view with both algorithms")
+			const struct vec2i pos = svec2i(SIZE / 2, SIZE / 2);
+			FOVResult ray, shadow;
+			Calc(&ray, FOV_RAYCAST, &m, pos);
+			Calc(&shadow, FOV_SHADOWCAST, &m, pos);
+
+		THEN("they should see every tile in range except the centre")
+			int inRange = 0;
+			struct vec2i v;
+			for (v.y = 0; v.y < SIZE; v.y++)
+			{
+				for (v.x = 0; v.x < SIZE; v.x++)
+				{
+					if (!svec2i_is_equal(v, pos) &&
+						svec2i_distance_squared(v, pos) < RANGE * RANGE)
+					{
+						inRange++;
+					}
+				}
+			}
+			SHOULD_INT_EQUAL(CountVisible(&ray), inRange);
+			SHOULD_INT_EQUAL(CountVisible(&shadow), inRange);
+		AND("shadowcasting should visit fewer tiles")
+			SHOULD_INT_LT(shadow.Calls, ray.Calls);
+			FOVMapTerminate(&m);
+	SCENARIO_END
+	SCENARIO("Walls block sight")
+		GIVEN("a map with a wall across it")
+			FOVMap m;
+			FOVMapInit(&m, svec2i(SIZE, SIZE));
+			for (int x = 0; x < SIZE; x++)
+			{
+				FOVMapSet(&m, svec2i(x, SIZE / 2 + 2), true);
+			}
+
+		WHEN("I calculate the field of view next to the wall")
+			const struct vec2i pos = svec2i(SIZE / 2, SIZE / 2);
+			FOVResult ray, shadow;
+			Calc(&ray, FOV_RAYCAST, &m, pos);
+			Calc(&shadow, FOV_SHADOWCAST, &m, pos);
+
+		THEN("the wall should be visible")
+			const int wallIdx = (SIZE / 2 + 2) * SIZE + SIZE / 2;
+			SHOULD_BE_TRUE(ray.Visible[wallIdx]);
+			SHOULD_BE_TRUE(shadow.Visible[wallIdx]);
+		AND("nothing behind the wall should be visible")
+			int behind = 0;
+			for (int i = (SIZE / 2 + 3) * SIZE; i < SIZE * SIZE; i++)
+			{
+				if (ray.Visible[i] || shadow.Visible[i]) behind++;
+			}
+			SHOULD_INT_EQUAL(behind, 0);
+			FOVMapTerminate(&m);
+	SCENARIO_END
+	SCENARIO("Cast exact shadows")
+		GIVEN("hand-checked layouts")
+			// '@' the viewer, '.' and ',' visible and hidden floor,
+			// '#' and '+' visible and hidden walls
+			const char *pillar[] = {
+				"...,,,...",
+				"....,....",
+				"....#....",
+				".........",
+				"....@....",
+				NULL
+			};
+			// The gap is in line with the wall, so its centre is hidden
+			const char *wallGap[] = {
+				",,,,+,,,,",
+				",,,,+,,,,",
+				",,,,+,,,,",
+				"#######,#",
+				"....@....",
+				NULL
+			};
+			const char *doorways[] = {
+				".,,,,,,,,,.",
+				",.,,,,,,,.,",
+				",,.,,,,,.,,",
+				"###.###.###",
+				"...........",
+				".....@.....",
+				NULL
+			};
+			const char *corridor[] = {
+				"#########",
+				"@........",
+				"#########",
+				NULL
+			};
+
+		WHEN("I calculate the field of view with shadowcasting")
+		THEN("exactly the expected tiles should be visible")
+			SHOULD_INT_EQUAL(CountLayoutErrors(pillar), 0);
+			SHOULD_INT_EQUAL(CountLayoutErrors(wallGap), 0);
+			SHOULD_INT_EQUAL(CountLayoutErrors(doorways), 0);
+			SHOULD_INT_EQUAL(CountLayoutErrors(corridor), 0);
+	SCENARIO_END
+	SCENARIO("Sight is symmetric")
+		GIVEN("a map of rooms and pillars")
+			FOVMap m;
+			InitRoomsMap(&m);
+			struct vec2i v;
+
+		WHEN("I calculate the field of view from every floor tile")
+			FOVResult *shadows = calloc(SYM_SIZE * SYM_SIZE, sizeof *shadows);
+			int shadowCalls = 0;
+			int rayCalls = 0;
+			for (int i = 0; i < SYM_SIZE * SYM_SIZE; i++)
+			{
+				v = svec2i(i % SYM_SIZE, i / SYM_SIZE);
+				if (FOVMapIsBlocked(&m, v)) continue;
+				FOVResult ray;
+				Calc(&ray, FOV_RAYCAST, &m, v);
+				Calc(&shadows[i], FOV_SHADOWCAST, &m, v);
+				rayCalls += ray.Calls;
+				shadowCalls += shadows[i].Calls;
+			}
+
+		THEN("every floor tile seen should see the viewer back")
+			int asymmetric = 0;
+			for (int i = 0; i < SYM_SIZE * SYM_SIZE; i++)
+			{
+				const struct vec2i a = svec2i(i % SYM_SIZE, i / SYM_SIZE);
+				if (FOVMapIsBlocked(&m, a)) continue;
+				for (int j = 0; j < SYM_SIZE * SYM_SIZE; j++)
+				{
+					const struct vec2i b = svec2i(j % SYM_SIZE, j / SYM_SIZE);
+					if (j == i || FOVMapIsBlocked(&m, b)) continue;
+					if (shadows[i].Visible[b.y * SIZE + b.x] !=
+						shadows[j].Visible[a.y * SIZE + a.x])
+					{
+						asymmetric++;
+					}
+				}
+			}
+			SHOULD_INT_EQUAL(asymmetric, 0);
+		AND("shadowcasting should visit fewer tiles than raycasting")
+			SHOULD_INT_LT(shadowCalls, rayCalls);
+			free(shadows);
+			FOVMapTerminate(&m);
+	SCENARIO_END
+	SCENARIO("Mostly agree with the raycaster")
+		GIVEN("a map of rooms and pillars")
+			FOVMap m;
+			InitRoomsMap(&m);
+
+		WHEN("I calculate the field of view from every floor tile")
+			// Known differences: rays passing the corner of a pillar or
+			// doorway see some tiles just past it that shadowcasting
+			// hides, and less often, shadowcasting sees a tile between
+			// the rays cast to the edge of the sight range
+			int either = 0;
+			int both = 0;
+			int rayOnly = 0;
+			int shadowOnly = 0;
+			for (int i = 0; i < SYM_SIZE * SYM_SIZE; i++)
+			{
+				const struct vec2i a = svec2i(i % SYM_SIZE, i / SYM_SIZE);
+				if (FOVMapIsBlocked(&m, a)) continue;
+				FOVResult ray, shadow;
+				Calc(&ray, FOV_RAYCAST, &m, a);
+				Calc(&shadow, FOV_SHADOWCAST, &m, a);
+				for (int j = 0; j < SYM_SIZE * SYM_SIZE; j++)
+				{
+					const struct vec2i b = svec2i(j % SYM_SIZE, j / SYM_SIZE);
+					if (j == i || FOVMapIsBlocked(&m, b)) continue;
+					const bool r = ray.Visible[b.y * SIZE + b.x];
+					const bool sh = shadow.Visible[b.y * SIZE + b.x];
+					if (r || sh) either++;
+					if (r && sh) both++;
+					if (r && !sh) rayOnly++;
+					if (!r && sh) shadowOnly++;
+				}
+			}
+
+		THEN("most floor tiles seen by either should be seen by both")
+			SHOULD_INT_GE(both * 100, either * AGREE_PERCENT_MIN);
+		AND("the raycaster should be the more permissive")
+			SHOULD_INT_GT(rayOnly, shadowOnly);
+			FOVMapTerminate(&m);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("FOV features are:", TEST_FEATURE(FOVCalc))
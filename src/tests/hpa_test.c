@@ -0,0 +1,151 @@
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hpa.h>
+
+#define SIZE 64
+#define COST_X 16.0f
+#define COST_Y 12.0f
+#define COST_DIAGONAL (16.0f * 1.1f)
+
+static bool walls[SIZE * SIZE];
+
+static int IsWalkable(int x, int y, void *context)
+{
+	(void)context;
+	if (x < 0 || x >= SIZE || y < 0 || y >= SIZE) return 0;
+	return !walls[y * SIZE + x];
+}
+static const ASGridSource cSource =
+{
+	IsWalkable, COST_X, COST_Y, COST_DIAGONAL
+};
+
+// Rooms, with doorways, and some random pillars
+static void MakeMap(void)
+{
+	srand(42);
+	for (int y = 0; y < SIZE; y++)
+	{
+		for (int x = 0; x < SIZE; x++)
+		{
+			const bool isRoomWall =
+				(x % 10 == 0 && y % 10 != 5) || (y % 10 == 0 && x % 10 != 5);
+			walls[y * SIZE + x] = isRoomWall || rand() % 100 < 10;
+		}
+	}
+}
+
+// Check that each step is to a walkable neighbour, without cutting corners
+static bool IsPathValid(
+	ASPath path, const struct vec2i from, const struct vec2i to)
+{
+	const size_t count = ASPathGetCount(path);
+	const struct vec2i *first = ASPathGetNode(path, 0);
+	const struct vec2i *last = ASPathGetNode(path, count - 1);
+	if (!svec2i_is_equal(*first, from) || !svec2i_is_equal(*last, to))
+	{
+		return false;
+	}
+	for (size_t i = 1; i < count; i++)
+	{
+		const struct vec2i *a = ASPathGetNode(path, i - 1);
+		const struct vec2i *b = ASPathGetNode(path, i);
+		if (abs(a->x - b->x) > 1 || abs(a->y - b->y) > 1 ||
+			!IsWalkable(b->x, b->y, NULL) ||
+			!IsWalkable(a->x, b->y, NULL) || !IsWalkable(b->x, a->y, NULL))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FEATURE(HPAPathCreate, "Hierarchical pathfinding")
+	SCENARIO("Find paths like the grid search")
+		GIVEN("a map of rooms")
+			MakeMap();
+			HPAGraph g;
+			HPAGraphInit(&g, svec2i(SIZE, SIZE), &cSource, NULL);
+			ASGrid grid = ASGridCreate(SIZE, SIZE);
+
+		WHEN("I find paths between random tiles with both")
+			int sameFound = 0;
+			int found = 0;
+			int valid = 0;
+			float cost = 0;
+			float refCost = 0;
+			int searches;
+			for (searches = 0; searches < 200; searches++)
+			{
+				const struct vec2i from = svec2i(rand() % SIZE, rand() % SIZE);
+				const struct vec2i to = svec2i(rand() % SIZE, rand() % SIZE);
+				if (walls[from.y * SIZE + from.x] || walls[to.y * SIZE + to.x])
+				{
+					searches--;
+					continue;
+				}
+				ASPath ref = ASGridPathCreate(
+					grid, &cSource, NULL, from.x, from.y, to.x, to.y);
+				ASPath path = HPAPathCreate(&g, from, to);
+				if ((ref == NULL) == (path == NULL)) sameFound++;
+				if (path != NULL && ref != NULL)
+				{
+					found++;
+					if (IsPathValid(path, from, to)) valid++;
+					cost += ASPathGetCost(path);
+					refCost += ASPathGetCost(ref);
+				}
+				ASPathDestroy(ref);
+				ASPathDestroy(path);
+			}
+
+		THEN("they should agree on which paths exist")
+			SHOULD_INT_EQUAL(sameFound, searches);
+			SHOULD_INT_GT(found, 0);
+		AND("the paths should be valid")
+			SHOULD_INT_EQUAL(valid, found);
+		AND("the paths should be nearly as short on average")
+			SHOULD_INT_LE((int)(cost * 100 / refCost), 110);
+			ASGridDestroy(grid);
+			HPAGraphTerminate(&g);
+	SCENARIO_END
+	SCENARIO("Repair the graph when tiles change")
+		GIVEN("an open map with a path across it")
+			memset(walls, 0, sizeof walls);
+			HPAGraph g;
+			HPAGraphInit(&g, svec2i(SIZE, SIZE), &cSource, NULL);
+			const struct vec2i from = svec2i(5, 5);
+			const struct vec2i to = svec2i(SIZE - 5, 5);
+			ASPath path = HPAPathCreate(&g, from, to);
+			const bool foundBefore = path != NULL;
+			ASPathDestroy(path);
+
+		WHEN("I wall off the goal and invalidate the changed tiles")
+			for (int y = 0; y < SIZE; y++)
+			{
+				walls[y * SIZE + SIZE / 2] = true;
+				HPAGraphInvalidate(&g, svec2i(SIZE / 2, y));
+			}
+			path = HPAPathCreate(&g, from, to);
+			const bool foundWalled = path != NULL;
+			ASPathDestroy(path);
+		AND("I make a doorway")
+			walls[40 * SIZE + SIZE / 2] = false;
+			HPAGraphInvalidate(&g, svec2i(SIZE / 2, 40));
+			path = HPAPathCreate(&g, from, to);
+
+		THEN("there should be a path at first")
+			SHOULD_BE_TRUE(foundBefore);
+		AND("there should be no path when walled off")
+			SHOULD_BE_FALSE(foundWalled);
+		AND("the path should go through the doorway")
+			SHOULD_BE_TRUE(path != NULL && IsPathValid(path, from, to));
+			ASPathDestroy(path);
+			HPAGraphTerminate(&g);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("HPA* features are:", TEST_FEATURE(HPAPathCreate))
@@ -1,6 +1,7 @@
 #define SDL_MAIN_HANDLED
 #include <cbehave/cbehave.h>
 
+#include <json_stream.h>
 #include <json_utils.h>
 
 #include <config.h>
@@ -54,4 +55,84 @@ FEATURE(json_format_string, "String format")
 	SCENARIO_END
 FEATURE_END
 
-CBEHAVE_RUN("JSON features are:", TEST_FEATURE(json_format_string))
+static bool CountElement(json_t *root, json_t **node, void *data)
+{
+	UNUSED(root);
+	CArray *names = data;
+	char *name = GetString(*node, "Name");
+	CArrayPushBack(names, &name);
+	return true;
+}
+static void SumTiles(const char *text, size_t len, void *data)
+{
+	int *sum = data;
+	for (size_t i = 0; i < len; i++)
+	{
+		if (text[i] >= '0' && text[i] <= '9') *sum += text[i] - '0';
+	}
+}
+FEATURE(JSONStreamParse, "Streaming parse")
+	SCENARIO("Stream array elements and values")
+		GIVEN("a document with a header, an array and tiles in its elements")
+			const char *doc =
+				"{\"Version\": 3, \"Title\": \"a \\\"b\\\"\","
+				" \"Missions\": ["
+				"  {\"Name\": \"one\", \"Tiles\": \"1,2,3\"},"
+				"  {\"Name\": \"two\", \"Tiles\": [4, [5]], \"X\": {}}"
+				" ], \"Characters\": [1, 2]}";
+		AND("a stream for the missions and their tiles")
+			CArray names;
+			CArrayInit(&names, sizeof(char *));
+			int sum = 0;
+			JSONStream s;
+			JSONStreamInit(&s);
+			JSONStreamAddArray(&s, "Missions", CountElement, &names);
+			JSONStreamAddValue(&s, "Tiles", SumTiles, &sum);
+
+		WHEN("I parse the document")
+			const bool res = JSONStreamParse(&s, doc, strlen(doc));
+
+		THEN("parsing should succeed")
+			SHOULD_BE_TRUE(res);
+		AND("each element should be streamed in order")
+			SHOULD_INT_EQUAL((int)names.size, 2);
+			SHOULD_STR_EQUAL(*(char **)CArrayGet(&names, 0), "one");
+			SHOULD_STR_EQUAL(*(char **)CArrayGet(&names, 1), "two");
+		AND("the tiles should be passed to the value handler")
+			SHOULD_INT_EQUAL(sum, 15);
+		AND("the other values should be in the root")
+			int version = 0;
+			LoadInt(&version, s.root, "Version");
+			SHOULD_INT_EQUAL(version, 3);
+			char *title = GetString(s.root, "Title");
+			SHOULD_STR_EQUAL(title, "a \"b\"");
+			SHOULD_BE_TRUE(json_find_first_label(s.root, "Missions") == NULL);
+			json_t *chars = json_find_first_label(s.root, "Characters");
+			SHOULD_BE_TRUE(chars != NULL && chars->child->child != NULL);
+		CFREE(title);
+		CA_FOREACH(char *, name, names)
+			CFREE(*name);
+		CA_FOREACH_END()
+		CArrayTerminate(&names);
+		JSONStreamTerminate(&s);
+	SCENARIO_END
+	SCENARIO("Invalid document")
+		GIVEN("a truncated document")
+			const char *doc = "{\"Version\": 3, \"Missions\": [{\"Name\"";
+			JSONStream s;
+			JSONStreamInit(&s);
+			JSONStreamAddArray(&s, "Missions", CountElement, NULL);
+
+		WHEN("I parse the document")
+			const bool res = JSONStreamParse(&s, doc, strlen(doc));
+
+		THEN("parsing should fail")
+			SHOULD_BE_FALSE(res);
+		JSONStreamTerminate(&s);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"JSON features are:",
+	TEST_FEATURE(json_format_string),
+	TEST_FEATURE(JSONStreamParse))
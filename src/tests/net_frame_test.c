@@ -0,0 +1,84 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <net_frame.h>
+#include <proto/msg.pb.h>
+
+
+FEATURE(NetFrameRead, "Read messages from frame")
+	SCENARIO("Read back batched messages")
+		GIVEN("a frame with some messages")
+			CArray f;
+			NetFrameInit(&f);
+			for (int i = 0; i < 100; i++)
+			{
+				NActorMove am = NActorMove_init_default;
+				am.UID = i;
+				am.Pos.x = i * 2;
+				am.Pos.y = -i;
+				NetFrameAppend(&f, 7, NActorMove_fields, &am);
+			}
+		AND("a message without data")
+			NetFrameAppend(&f, 3, NULL, NULL);
+
+		WHEN("I read the messages")
+			size_t offset = 0;
+			NetMsg msg;
+			int count = 0;
+			bool decoded = true;
+			for (int i = 0; i < 100; i++)
+			{
+				if (!NetFrameRead(f.data, f.size, &offset, &msg) ||
+					msg.Type != 7)
+				{
+					break;
+				}
+				NActorMove am = NActorMove_init_default;
+				decoded = decoded && NetMsgDecode(&msg, &am, NActorMove_fields);
+				if ((int)am.UID != i || am.Pos.x != i * 2 || am.Pos.y != -i)
+				{
+					break;
+				}
+				count++;
+			}
+
+		THEN("all the messages should be read in order")
+			SHOULD_INT_EQUAL(count, 100);
+			SHOULD_BE_TRUE(decoded);
+		AND("the empty message should be last")
+			SHOULD_BE_TRUE(NetFrameRead(f.data, f.size, &offset, &msg));
+			SHOULD_INT_EQUAL(msg.Type, 3);
+			SHOULD_INT_EQUAL((int)msg.Size, 0);
+			SHOULD_BE_FALSE(NetFrameRead(f.data, f.size, &offset, &msg));
+			SHOULD_INT_EQUAL((int)offset, (int)f.size);
+			CArrayTerminate(&f);
+	SCENARIO_END
+
+	SCENARIO("Read truncated frame")
+		GIVEN("a frame with a message")
+			CArray f;
+			NetFrameInit(&f);
+			NActorMove am = NActorMove_init_default;
+			am.UID = 12345;
+			NetFrameAppend(&f, 7, NActorMove_fields, &am);
+
+		WHEN("I read the frame without its last byte")
+			size_t offset = 0;
+			NetMsg msg;
+			const bool read = NetFrameRead(f.data, f.size - 1, &offset, &msg);
+
+		THEN("the message should not be read")
+			SHOULD_BE_FALSE(read);
+			SHOULD_INT_EQUAL((int)offset, 0);
+		AND("only the whole frame should be valid")
+			SHOULD_BE_FALSE(NetFrameIsValid(f.data, f.size - 1));
+			SHOULD_BE_TRUE(NetFrameIsValid(f.data, f.size));
+			CArrayTerminate(&f);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"NetFrame features are:",
+	TEST_FEATURE(NetFrameRead)
+)
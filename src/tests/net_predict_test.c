@@ -0,0 +1,109 @@
+#include <cbehave/cbehave.h>
+
+#include <net_predict.h>
+
+
+FEATURE(NetPredictionAck, "Acknowledge moves")
+	SCENARIO("Acknowledge a move")
+		GIVEN("a prediction with two moves and some ticks")
+			NetPrediction p;
+			NetPredictionReset(&p, 1);
+			NetPredictionAddMove(&p, 1, svec2(10, 10));
+			NetPredictionAddTick(&p, 1, svec2(1, 0));
+			NetPredictionAddTick(&p, 1, svec2(1, 0));
+			NetPredictionAddMove(&p, 2, svec2(12, 10));
+			NetPredictionAddTick(&p, 2, svec2(0, 1));
+
+		WHEN("I acknowledge the second move")
+			struct vec2 sentPos;
+			const bool ok = NetPredictionAck(&p, 2, &sentPos);
+
+		THEN("the ack should succeed with the sent position")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_INT_EQUAL((int)sentPos.x, 12);
+			SHOULD_INT_EQUAL((int)sentPos.y, 10);
+		AND("only the ticks since that move should remain")
+			SHOULD_INT_EQUAL(NetPredictionNumTicks(&p), 1);
+			SHOULD_INT_EQUAL((int)NetPredictionGetTick(&p, 0)->Delta.y, 1);
+	SCENARIO_END
+	SCENARIO("Acknowledge a move whose ticks were overwritten")
+		GIVEN("a prediction with more ticks than it can keep")
+			NetPrediction p;
+			NetPredictionReset(&p, 1);
+			NetPredictionAddMove(&p, 1, svec2(0, 0));
+			NetPredictionAddTick(&p, 1, svec2(1, 0));
+			NetPredictionAddMove(&p, 2, svec2(1, 0));
+			for (int i = 0; i < NET_PREDICT_TICKS; i++)
+			{
+				NetPredictionAddTick(&p, 2, svec2(1, 0));
+			}
+			NetPredictionAddMove(&p, 3, svec2(0, 0));
+			NetPredictionAddTick(&p, 3, svec2(1, 0));
+
+		WHEN("I acknowledge the first and second moves")
+			struct vec2 sentPos;
+			const bool ok1 = NetPredictionAck(&p, 1, &sentPos);
+			const bool ok2 = NetPredictionAck(&p, 2, &sentPos);
+
+		THEN("the first ack should fail")
+			SHOULD_BE_FALSE(ok1);
+		AND("the second ack should fail")
+			SHOULD_BE_FALSE(ok2);
+	SCENARIO_END
+	SCENARIO("Acknowledge an unknown move")
+		GIVEN("a prediction with a move")
+			NetPrediction p;
+			NetPredictionReset(&p, 1);
+			NetPredictionAddMove(&p, 5, svec2(0, 0));
+
+		WHEN("I acknowledge an older move")
+			struct vec2 sentPos;
+			const bool ok = NetPredictionAck(&p, 4, &sentPos);
+
+		THEN("the ack should fail")
+			SHOULD_BE_FALSE(ok);
+		AND("the move should still be kept")
+			SHOULD_BE_TRUE(NetPredictionAck(&p, 5, &sentPos));
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(NetInterpGet, "Interpolate positions")
+	SCENARIO("Get positions between and outside samples")
+		GIVEN("an interpolator with two samples")
+			NetInterp n;
+			NetInterpReset(&n);
+			NetInterpAdd(&n, 10, svec2(0, 0));
+			NetInterpAdd(&n, 20, svec2(100, 50));
+
+		WHEN("I get positions")
+			struct vec2 before, mid, after;
+			NetInterpGet(&n, 0, &before);
+			NetInterpGet(&n, 15, &mid);
+			NetInterpGet(&n, 30, &after);
+
+		THEN("the position between samples should be interpolated")
+			SHOULD_INT_EQUAL((int)mid.x, 50);
+			SHOULD_INT_EQUAL((int)mid.y, 25);
+		AND("positions outside should be clamped")
+			SHOULD_INT_EQUAL((int)before.x, 0);
+			SHOULD_INT_EQUAL((int)after.x, 100);
+	SCENARIO_END
+	SCENARIO("Get position with no samples")
+		GIVEN("an empty interpolator")
+			NetInterp n;
+			NetInterpReset(&n);
+
+		WHEN("I get a position")
+			struct vec2 pos;
+			const bool ok = NetInterpGet(&n, 0, &pos);
+
+		THEN("it should fail")
+			SHOULD_BE_FALSE(ok);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"NetPredict features are:",
+	TEST_FEATURE(NetPredictionAck),
+	TEST_FEATURE(NetInterpGet)
+)
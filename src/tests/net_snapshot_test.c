@@ -0,0 +1,176 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <net_snapshot.h>
+
+
+static void AddEntity(
+	NetSnapshot *s, const NetSnapshotKind kind, const int uid, const int32_t x)
+{
+	NetEntityState e;
+	memset(&e, 0, sizeof e);
+	e.Kind = kind;
+	e.UID = uid;
+	e.Fields[0] = x;
+	e.Fields[1] = -x;
+	NetSnapshotAdd(s, &e);
+}
+static bool SnapshotsEqual(const NetSnapshot *s1, const NetSnapshot *s2)
+{
+	return s1->Entities.size == s2->Entities.size &&
+		memcmp(s1->Entities.data, s2->Entities.data,
+			s1->Entities.size * s1->Entities.elemSize) == 0;
+}
+
+FEATURE(NetSnapshotDelta, "Snapshot deltas")
+	SCENARIO("Delta against a base")
+		GIVEN("a base snapshot")
+			NetSnapshot base;
+			NetSnapshotInit(&base);
+			for (int i = 0; i < 50; i++)
+			{
+				AddEntity(&base, NET_SNAPSHOT_ACTOR, i, i * 100);
+			}
+			NetSnapshotSort(&base);
+		AND("a snapshot with changed, added and removed entities")
+			NetSnapshot cur;
+			NetSnapshotInit(&cur);
+			for (int i = 10; i < 60; i++)
+			{
+				AddEntity(&cur, NET_SNAPSHOT_ACTOR, i, i < 20 ? i : i * 100);
+			}
+			AddEntity(&cur, NET_SNAPSHOT_PICKUP, 3, 7);
+			NetSnapshotSort(&cur);
+
+		WHEN("I encode and decode the delta")
+			uint8_t buf[1024];
+			size_t size;
+			NetSnapshot sent;
+			NetSnapshotInit(&sent);
+			const bool encoded = NetSnapshotDeltaEncode(
+				&base, &cur, 2, buf, sizeof buf, &size, &sent);
+			NetSnapshot recv;
+			NetSnapshotInit(&recv);
+			CArray changed;
+			CArrayInit(&changed, sizeof(NetEntityState));
+			const bool decoded = NetSnapshotDeltaDecode(
+				&base, buf, size, 2, &recv, &changed);
+
+		THEN("the decoded snapshot should match")
+			SHOULD_BE_TRUE(encoded);
+			SHOULD_BE_TRUE(decoded);
+			SHOULD_BE_TRUE(SnapshotsEqual(&sent, &cur));
+			SHOULD_BE_TRUE(SnapshotsEqual(&recv, &cur));
+			SHOULD_INT_EQUAL((int)recv.Seq, 2);
+		AND("only the changed and added entities should be listed")
+			SHOULD_INT_EQUAL((int)changed.size, 10 + 10 + 1);
+		AND("unchanged entities should not be sent")
+			SHOULD_BE_TRUE(size < 21 * 8 + 10 * 2);
+			CArrayTerminate(&changed);
+			NetSnapshotTerminate(&base);
+			NetSnapshotTerminate(&cur);
+			NetSnapshotTerminate(&sent);
+			NetSnapshotTerminate(&recv);
+	SCENARIO_END
+
+	SCENARIO("Deltas over budget")
+		GIVEN("a snapshot with many entities")
+			NetSnapshot cur;
+			NetSnapshotInit(&cur);
+			for (int i = 0; i < 500; i++)
+			{
+				AddEntity(&cur, NET_SNAPSHOT_OBJECT, i * 7, 100000 + i);
+			}
+			NetSnapshotSort(&cur);
+
+		WHEN("I send baselines with a small budget, acknowledging each")
+			NetSnapshot s[2];
+			NetSnapshotInit(&s[0]);
+			NetSnapshotInit(&s[1]);
+			uint8_t buf[256];
+			size_t size;
+			bool withinBudget = true;
+			bool matches = true;
+			uint32_t seq;
+			for (seq = 1; seq < 100; seq++)
+			{
+				NetSnapshot *base = seq == 1 ? NULL : &s[(seq - 1) % 2];
+				NetSnapshot *sent = &s[seq % 2];
+				NetSnapshotDeltaEncode(
+					base, &cur, seq, buf, sizeof buf, &size, sent);
+				withinBudget = withinBudget && size <= sizeof buf;
+				NetSnapshot recv;
+				NetSnapshotInit(&recv);
+				NetSnapshotDeltaDecode(base, buf, size, seq, &recv, NULL);
+				matches = matches && SnapshotsEqual(&recv, sent);
+				NetSnapshotTerminate(&recv);
+				if (SnapshotsEqual(sent, &cur))
+				{
+					break;
+				}
+			}
+
+		THEN("each delta should be within budget")
+			SHOULD_BE_TRUE(withinBudget);
+		AND("the receiver should reconstruct what the sender sent")
+			SHOULD_BE_TRUE(matches);
+		AND("the snapshots should converge over several deltas")
+			SHOULD_BE_TRUE(seq > 1 && seq < 100);
+			NetSnapshotTerminate(&cur);
+			NetSnapshotTerminate(&s[0]);
+			NetSnapshotTerminate(&s[1]);
+	SCENARIO_END
+
+	SCENARIO("Malformed deltas")
+		GIVEN("a delta with an unknown entity kind")
+			// header: kind << 1 | removed, then UID
+			uint8_t badKind[] = { NET_SNAPSHOT_KIND_COUNT << 1 | 1, 1 };
+		AND("a delta that removes the same entity twice")
+			uint8_t duplicate[] = {
+				NET_SNAPSHOT_ACTOR << 1 | 1, 5, NET_SNAPSHOT_ACTOR << 1 | 1, 5
+			};
+
+		WHEN("I decode them")
+			NetSnapshot recv;
+			NetSnapshotInit(&recv);
+			const bool badKindDecoded = NetSnapshotDeltaDecode(
+				NULL, badKind, sizeof badKind, 1, &recv, NULL);
+			const bool duplicateDecoded = NetSnapshotDeltaDecode(
+				NULL, duplicate, sizeof duplicate, 1, &recv, NULL);
+
+		THEN("they should be rejected")
+			SHOULD_BE_FALSE(badKindDecoded);
+			SHOULD_BE_FALSE(duplicateDecoded);
+			NetSnapshotTerminate(&recv);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(NetSnapshotRing, "Snapshot ring")
+	SCENARIO("Old snapshots are evicted")
+		GIVEN("a ring")
+			NetSnapshotRing r;
+			NetSnapshotRingInit(&r);
+
+		WHEN("I store more snapshots than the ring holds")
+			for (uint32_t seq = 1; seq <= NET_SNAPSHOT_RING_SIZE + 5; seq++)
+			{
+				NetSnapshotRingSlot(&r, seq)->Seq = seq;
+			}
+
+		THEN("recent snapshots should be found")
+			SHOULD_BE_TRUE(
+				NetSnapshotRingGet(&r, NET_SNAPSHOT_RING_SIZE + 5) != NULL);
+			SHOULD_BE_TRUE(NetSnapshotRingGet(&r, 6) != NULL);
+		AND("old snapshots should not")
+			SHOULD_BE_TRUE(NetSnapshotRingGet(&r, 5) == NULL);
+			SHOULD_BE_TRUE(NetSnapshotRingGet(&r, 0) == NULL);
+			NetSnapshotRingTerminate(&r);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"NetSnapshot features are:",
+	TEST_FEATURE(NetSnapshotDelta),
+	TEST_FEATURE(NetSnapshotRing)
+)
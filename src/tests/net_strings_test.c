@@ -0,0 +1,109 @@
+#include <cbehave/cbehave.h>
+
+#include <net_strings.h>
+
+
+FEATURE(NetStringsAdd, "Add strings")
+	SCENARIO("Add some names")
+		GIVEN("an empty table")
+			NetStrings s;
+			NetStringsInit(&s);
+
+		WHEN("I add some names")
+			const uint32_t a = NetStringsAdd(&s, "pistol");
+			const uint32_t b = NetStringsAdd(&s, "shotgun");
+
+		THEN("they should have sequential ids")
+			SHOULD_INT_EQUAL((int)a, 0);
+			SHOULD_INT_EQUAL((int)b, 1);
+		AND("the ids should be found by name")
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "pistol"), 0);
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "shotgun"), 1);
+		AND("the names should be found by id")
+			SHOULD_STR_EQUAL(NetStringsGetName(&s, 0), "pistol");
+			SHOULD_STR_EQUAL(NetStringsGetName(&s, 1), "shotgun");
+		AND("unknown names and ids should not be found")
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "knife"), -1);
+			SHOULD_BE_TRUE(NetStringsGetName(&s, 2) == NULL);
+			NetStringsTerminate(&s);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(NetStringsSet, "Set strings received from server")
+	SCENARIO("Set names out of order")
+		GIVEN("an empty table")
+			NetStrings s;
+			NetStringsInit(&s);
+
+		WHEN("I set a name with a later id")
+			NetStringsSet(&s, 2, "hits/flesh");
+
+		THEN("the name should be found")
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "hits/flesh"), 2);
+			SHOULD_STR_EQUAL(NetStringsGetName(&s, 2), "hits/flesh");
+		AND("the earlier ids should be undefined")
+			SHOULD_BE_TRUE(NetStringsGetName(&s, 0) == NULL);
+			SHOULD_BE_TRUE(NetStringsGetName(&s, 1) == NULL);
+			NetStringsTerminate(&s);
+	SCENARIO_END
+
+	SCENARIO("Set a name with an id out of range")
+		GIVEN("an empty table")
+			NetStrings s;
+			NetStringsInit(&s);
+
+		WHEN("I set a name with a huge id")
+			const bool set = NetStringsSet(&s, 0xFFFFFFF0u, "hits/flesh");
+
+		THEN("the name should be rejected")
+			SHOULD_BE_FALSE(set);
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "hits/flesh"), -1);
+		AND("the table should not have grown")
+			SHOULD_INT_EQUAL((int)s.names.size, 0);
+			NetStringsTerminate(&s);
+	SCENARIO_END
+
+	SCENARIO("Redefine an id")
+		GIVEN("a table with a name")
+			NetStrings s;
+			NetStringsInit(&s);
+			NetStringsSet(&s, 0, "old");
+
+		WHEN("I set another name with the same id")
+			NetStringsSet(&s, 0, "new");
+
+		THEN("the id should have the new name")
+			SHOULD_STR_EQUAL(NetStringsGetName(&s, 0), "new");
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "new"), 0);
+		AND("the old name should not be found")
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "old"), -1);
+			NetStringsTerminate(&s);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(NetStringsClear, "Clear strings")
+	SCENARIO("Clear a table")
+		GIVEN("a table with some names")
+			NetStrings s;
+			NetStringsInit(&s);
+			NetStringsAdd(&s, "pistol");
+			NetStringsAdd(&s, "shotgun");
+
+		WHEN("I clear it")
+			NetStringsClear(&s);
+
+		THEN("the names should not be found")
+			SHOULD_INT_EQUAL(NetStringsGetId(&s, "pistol"), -1);
+			SHOULD_BE_TRUE(NetStringsGetName(&s, 0) == NULL);
+		AND("new names should start from id 0")
+			SHOULD_INT_EQUAL((int)NetStringsAdd(&s, "knife"), 0);
+			NetStringsTerminate(&s);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"NetStrings features are:",
+	TEST_FEATURE(NetStringsAdd),
+	TEST_FEATURE(NetStringsSet),
+	TEST_FEATURE(NetStringsClear)
+)
@@ -0,0 +1,132 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <pic_atlas.h>
+
+
+// Make a pic filled with a value unique to it
+static Pic MakePic(const struct vec2i size, const Uint32 value)
+{
+	Pic p;
+	memset(&p, 0, sizeof p);
+	p.size = size;
+	CMALLOC(p.Data, size.x * size.y * sizeof *p.Data);
+	for (int i = 0; i < size.x * size.y; i++)
+	{
+		p.Data[i] = value;
+	}
+	return p;
+}
+static bool PicHasValue(const Pic *p, const Uint32 value)
+{
+	for (int y = 0; y < p->size.y; y++)
+	{
+		for (int x = 0; x < p->size.x; x++)
+		{
+			if (p->Data[x + y * PIC_STRIDE(p)] != value) return false;
+		}
+	}
+	return true;
+}
+
+FEATURE(PicAtlasAdd, "Pack pics")
+	SCENARIO("Pack pics of different sizes")
+		GIVEN("an atlas")
+			PicAtlas a;
+			PicAtlasInit(&a, svec2i(32, 32));
+		AND("pics of different sizes")
+			Pic pics[20];
+			Uint32 *data[20];
+			CArray picPtrs;
+			CArrayInit(&picPtrs, sizeof(Pic *));
+			for (int i = 0; i < 20; i++)
+			{
+				pics[i] = MakePic(svec2i(1 + i % 7, 1 + i % 5), (Uint32)i + 1);
+				data[i] = pics[i].Data;
+				Pic *p = &pics[i];
+				CArrayPushBack(&picPtrs, &p);
+			}
+
+		WHEN("I add them to the atlas")
+			const int numPacked = PicAtlasAdd(&a, &picPtrs);
+
+		THEN("they should all be packed into one page")
+			SHOULD_INT_EQUAL(numPacked, 20);
+			SHOULD_INT_EQUAL((int)a.pages.size, 1);
+		AND("they should view into the page with its stride")
+			const PicAtlasPage *page = CArrayGet(&a.pages, 0);
+			int numInPage = 0;
+			for (int i = 0; i < 20; i++)
+			{
+				struct vec2i pos;
+				if (PicAtlasFind(&a, pics[i].Data, &pos) == page &&
+					pos.x + pics[i].size.x <= page->Size.x &&
+					pos.y + pics[i].size.y <= page->Size.y &&
+					PIC_STRIDE(&pics[i]) == page->Size.x)
+				{
+					numInPage++;
+				}
+			}
+			SHOULD_INT_EQUAL(numInPage, 20);
+		AND("their pixels should be the same, without overlapping")
+			int numSame = 0;
+			for (int i = 0; i < 20; i++)
+			{
+				if (PicHasValue(&pics[i], (Uint32)i + 1)) numSame++;
+			}
+			SHOULD_INT_EQUAL(numSame, 20);
+		AND("their old data should be left alone")
+			SHOULD_BE_FALSE(PicAtlasHasData(&a, data[0]));
+			for (int i = 0; i < 20; i++)
+			{
+				CFREE(data[i]);
+			}
+			CArrayTerminate(&picPtrs);
+			PicAtlasTerminate(&a);
+	SCENARIO_END
+	SCENARIO("Pack pics that don't fit one page")
+		GIVEN("an atlas")
+			PicAtlas a;
+			PicAtlasInit(&a, svec2i(16, 16));
+		AND("pics that fill more than a page, and one that is too big")
+			Pic pics[6];
+			CArray picPtrs;
+			CArrayInit(&picPtrs, sizeof(Pic *));
+			for (int i = 0; i < 5; i++)
+			{
+				pics[i] = MakePic(svec2i(8, 8), (Uint32)i + 1);
+			}
+			pics[5] = MakePic(svec2i(17, 1), 6);
+			Uint32 *bigData = pics[5].Data;
+			for (int i = 0; i < 6; i++)
+			{
+				Pic *p = &pics[i];
+				CArrayPushBack(&picPtrs, &p);
+			}
+
+		WHEN("I add them to the atlas")
+			const int numPacked = PicAtlasAdd(&a, &picPtrs);
+
+		THEN("the pics that fit should be packed into two pages")
+			SHOULD_INT_EQUAL(numPacked, 5);
+			SHOULD_INT_EQUAL((int)a.pages.size, 2);
+		AND("the second page should only be as tall as its pics")
+			const PicAtlasPage *page = CArrayGet(&a.pages, 1);
+			SHOULD_INT_EQUAL(page->Size.y, 8);
+		AND("the pics should keep their pixels")
+			int numSame = 0;
+			for (int i = 0; i < 6; i++)
+			{
+				if (PicHasValue(&pics[i], (Uint32)i + 1)) numSame++;
+			}
+			SHOULD_INT_EQUAL(numSame, 6);
+		AND("the big pic should keep its own data")
+			SHOULD_BE_TRUE(pics[5].Data == bigData);
+			CFREE(bigData);
+			CArrayTerminate(&picPtrs);
+			PicAtlasTerminate(&a);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Pic atlas features are:", TEST_FEATURE(PicAtlasAdd))
@@ -0,0 +1,112 @@
+#include <cbehave/cbehave.h>
+
+#include <SDL.h>
+
+#include <render_batch.h>
+#include <texture.h>
+#include <utils.h>
+
+#define SIZE 8
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+
+// Read a layer texture back
+static void ReadLayer(SDL_Renderer *r, SDL_Texture *t, Uint32 *out)
+{
+	SDL_SetRenderTarget(r, t);
+	SDL_RenderReadPixels(
+		r, NULL, SDL_PIXELFORMAT_ARGB8888, out, SIZE * sizeof(Uint32));
+	SDL_SetRenderTarget(r, NULL);
+}
+
+FEATURE(RenderBatchFlush, "Draw a layer with the texture renderer")
+	SCENARIO("Draw pics and rects")
+		GIVEN("a software renderer and a layer texture")
+			SDL_Surface *s = SDL_CreateRGBSurface(
+				0, SIZE, SIZE, 32,
+				0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+			SDL_Renderer *r = SDL_CreateSoftwareRenderer(s);
+			Uint32 buf[SIZE * SIZE];
+			RenderBatch b;
+			const bool ok = RenderBatchInit(&b, r, buf, svec2i(SIZE, SIZE));
+			SDL_Texture *t = TextureCreate(
+				r, SDL_TEXTUREACCESS_TARGET, svec2i(SIZE, SIZE),
+				SDL_BLENDMODE_BLEND, 255);
+		AND("a red pic")
+			Uint32 data[4] = { 0xFFFF0000, 0xFFFF0000, 0xFFFF0000, 0 };
+			Pic pic = { svec2i(2, 2), svec2i_zero(), data, 0 };
+
+		WHEN("I draw the pic and a blue rect, and flush the layer")
+			RenderBatchClear(&b);
+			const SDL_Rect src = { 0, 0, 2, 2 };
+			const SDL_Rect dst = { 1, 1, 2, 2 };
+			const bool picOK = RenderBatchPic(
+				&b, &pic, src, dst, colorWhite, SDL_BLENDMODE_BLEND);
+			const SDL_Rect rect = { 5, 5, 1, 1 };
+			const color_t blue = { 0, 0, 255, 255 };
+			const bool rectOK =
+				RenderBatchRect(&b, rect, blue, SDL_BLENDMODE_NONE);
+			RenderBatchFlush(&b, t);
+			Uint32 out[SIZE * SIZE];
+			ReadLayer(r, t, out);
+
+		THEN("the drawing should be batched")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_BE_TRUE(picOK);
+			SHOULD_BE_TRUE(rectOK);
+		AND("the layer should have the pic and the rect")
+			SHOULD_INT_EQUAL(out[1 + 1 * SIZE], 0xFFFF0000);
+			SHOULD_INT_EQUAL(out[2 + 2 * SIZE], 0);
+			SHOULD_INT_EQUAL(out[5 + 5 * SIZE], 0xFF0000FF);
+		AND("the rest should be clear")
+			SHOULD_INT_EQUAL(out[0], 0);
+			RenderBatchTerminate(&b);
+			SDL_DestroyTexture(t);
+			SDL_DestroyRenderer(r);
+			SDL_FreeSurface(s);
+	SCENARIO_END
+	SCENARIO("Fall back to software")
+		GIVEN("a layer with a pic drawn")
+			SDL_Surface *s = SDL_CreateRGBSurface(
+				0, SIZE, SIZE, 32,
+				0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+			SDL_Renderer *r = SDL_CreateSoftwareRenderer(s);
+			Uint32 buf[SIZE * SIZE];
+			RenderBatch b;
+			RenderBatchInit(&b, r, buf, svec2i(SIZE, SIZE));
+			Uint32 data[1] = { 0xFF00FF00 };
+			Pic pic = { svec2i(1, 1), svec2i_zero(), data, 0 };
+			RenderBatchClear(&b);
+			const SDL_Rect src = { 0, 0, 1, 1 };
+			const SDL_Rect dst = { 3, 2, 1, 1 };
+			RenderBatchPic(&b, &pic, src, dst, colorWhite, SDL_BLENDMODE_BLEND);
+
+		WHEN("I switch the layer to software")
+			RenderBatchSoftware(&b);
+
+		THEN("the buffer should have the pic")
+			SHOULD_INT_EQUAL(buf[3 + 2 * SIZE], 0xFF00FF00);
+			SHOULD_INT_EQUAL(buf[0], 0);
+		AND("further drawing should not be batched")
+			SHOULD_BE_FALSE(RenderBatchPic(
+				&b, &pic, src, dst, colorWhite, SDL_BLENDMODE_BLEND));
+		AND("a new layer should be batched again")
+			RenderBatchClear(&b);
+			SHOULD_BE_TRUE(RenderBatchPic(
+				&b, &pic, src, dst, colorWhite, SDL_BLENDMODE_BLEND));
+			RenderBatchTerminate(&b);
+			SDL_DestroyRenderer(r);
+			SDL_FreeSurface(s);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Render batch features are:",
+	TEST_FEATURE(RenderBatchFlush)
+)
@@ -0,0 +1,90 @@
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+
+#include <replay.h>
+
+#define REPLAY_TEST_FILE "replay_test.rpl"
+
+
+static void RecordTestMission(const int numTicks, const uint32_t endHash)
+{
+	Replay r;
+	ReplayInit(&r);
+	ReplayRecordOpen(&r, REPLAY_TEST_FILE);
+	ReplayRecordMission(&r, 42);
+	for (int t = 0; t < numTicks; t++)
+	{
+		// Change commands every 10 ticks
+		const int cmds[2] = { t / 10, 7 };
+		ReplayRecordTick(&r, t, cmds, 2, (uint32_t)t * 3);
+	}
+	ReplayRecordMissionEnd(&r, numTicks, endHash);
+	ReplayTerminate(&r);
+}
+
+FEATURE(ReplayPlayTick, "Play back recorded commands")
+	SCENARIO("Play back a recording in sync")
+		GIVEN("a recorded mission")
+			RecordTestMission(200, 1234);
+			Replay r;
+			ReplayInit(&r);
+			const bool opened = ReplayPlayOpen(&r, REPLAY_TEST_FILE);
+		AND("I have read the mission header")
+			NetMsg msg;
+			ReplayRead(&r, &msg);
+
+		WHEN("I play back the same ticks and hashes")
+			int cmdsOK = 0;
+			int t;
+			for (t = 0; ; t++)
+			{
+				int cmds[2];
+				if (!ReplayPlayTick(&r, t, cmds, 2, (uint32_t)t * 3)) break;
+				if (cmds[0] == t / 10 && cmds[1] == 7) cmdsOK++;
+			}
+			ReplayPlayMissionEnd(&r, t, 1234);
+
+		THEN("the replay should open and the mission start with its header")
+			SHOULD_BE_TRUE(opened);
+			SHOULD_INT_EQUAL(msg.Type, (int)REPLAY_MSG_MISSION);
+		AND("every tick should have the recorded commands")
+			SHOULD_INT_EQUAL(t, 200);
+			SHOULD_INT_EQUAL(cmdsOK, 200);
+		AND("there should be no desyncs")
+			SHOULD_INT_EQUAL(r.Desyncs, 0);
+		AND("there should be nothing left")
+			SHOULD_BE_FALSE(ReplayRead(&r, &msg));
+			ReplayTerminate(&r);
+			remove(REPLAY_TEST_FILE);
+	SCENARIO_END
+	SCENARIO("Play back a recording out of sync")
+		GIVEN("a recorded mission")
+			RecordTestMission(200, 1234);
+			Replay r;
+			ReplayInit(&r);
+			ReplayPlayOpen(&r, REPLAY_TEST_FILE);
+			NetMsg msg;
+			ReplayRead(&r, &msg);
+
+		WHEN("I play back with a different state from tick 100")
+			int t;
+			for (t = 0; ; t++)
+			{
+				int cmds[2];
+				const uint32_t hash = (uint32_t)t * 3 + (t >= 100 ? 1 : 0);
+				if (!ReplayPlayTick(&r, t, cmds, 2, hash)) break;
+			}
+			ReplayPlayMissionEnd(&r, t, 4321);
+
+		THEN("the hash at tick 140 and the end hash should be desyncs")
+			SHOULD_INT_EQUAL(r.Desyncs, 2);
+			ReplayTerminate(&r);
+			remove(REPLAY_TEST_FILE);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Replay features are:",
+	TEST_FEATURE(ReplayPlayTick)
+)
@@ -0,0 +1,62 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <thread_pool.h>
+
+#define NUM_JOBS 1000
+
+
+static void CountJob(void *data, const int index)
+{
+	int *counts = data;
+	counts[index]++;
+}
+
+FEATURE(ThreadPoolRun, "Run jobs on the pool")
+	SCENARIO("Run every job exactly once")
+		GIVEN("a thread pool")
+			ThreadPool tp;
+			ThreadPoolInit(&tp, "Test");
+			int counts[NUM_JOBS] = { 0 };
+
+		WHEN("I run the same jobs many times")
+			for (int i = 0; i < 100; i++)
+			{
+				ThreadPoolRun(&tp, CountJob, counts, NUM_JOBS);
+			}
+		AND("I run fewer jobs than there are threads")
+			ThreadPoolRun(&tp, CountJob, counts, 1);
+			ThreadPoolTerminate(&tp);
+
+		THEN("each job should have run once per run")
+			int wrong = 0;
+			for (int i = 0; i < NUM_JOBS; i++)
+			{
+				if (counts[i] != (i == 0 ? 101 : 100)) wrong++;
+			}
+			SHOULD_INT_EQUAL(wrong, 0);
+	SCENARIO_END
+	SCENARIO("Run without workers")
+		GIVEN("a pool that was never started")
+			ThreadPool tp;
+			memset(&tp, 0, sizeof tp);
+			int counts[NUM_JOBS] = { 0 };
+
+		WHEN("I run some jobs")
+			ThreadPoolRun(&tp, CountJob, counts, NUM_JOBS);
+
+		THEN("they should all run on the calling thread")
+			int wrong = 0;
+			for (int i = 0; i < NUM_JOBS; i++)
+			{
+				if (counts[i] != 1) wrong++;
+			}
+			SHOULD_INT_EQUAL(wrong, 0);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Thread pool features are:",
+	TEST_FEATURE(ThreadPoolRun)
+)
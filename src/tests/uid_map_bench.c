@@ -0,0 +1,108 @@
+// Microbenchmark: UID lookup using UIDMap vs linear scan of an entity store
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <c_array.h>
+#include <uid_map.h>
+#include <utils.h>
+
+// Stand-in for an entity; roughly the size of a mobile object
+typedef struct
+{
+	int UID;
+	char padding[124];
+	bool isInUse;
+} Entity;
+
+#define LOOKUPS 2000000
+
+static Entity *ScanGetByUID(const CArray *store, const int uid)
+{
+	CA_FOREACH(Entity, e, *store)
+		if (e->UID == uid)
+		{
+			return e;
+		}
+	CA_FOREACH_END()
+	return NULL;
+}
+
+static Entity *MapGetByUID(const CArray *store, const UIDMap *m, const int uid)
+{
+	const int id = UIDMapGet(m, uid);
+	return id >= 0 ? CArrayGet(store, id) : NULL;
+}
+
+static void Bench(const int n)
+{
+	CArray store;
+	CArrayInit(&store, sizeof(Entity));
+	UIDMap m;
+	UIDMapInit(&m);
+	// Fill the store, then churn it like bullets do, so UIDs are not in
+	// slot order
+	int nextUID = 0;
+	for (int i = 0; i < n; i++)
+	{
+		Entity e;
+		memset(&e, 0, sizeof e);
+		e.UID = nextUID++;
+		e.isInUse = true;
+		CArrayPushBack(&store, &e);
+		UIDMapSet(&m, e.UID, i);
+	}
+	for (int i = 0; i < n * 4; i++)
+	{
+		const int slot = rand() % n;
+		Entity *e = CArrayGet(&store, slot);
+		e->UID = nextUID++;
+		UIDMapSet(&m, e->UID, slot);
+	}
+	int *uids;
+	CMALLOC(uids, LOOKUPS * sizeof *uids);
+	for (int i = 0; i < LOOKUPS; i++)
+	{
+		const Entity *e = CArrayGet(&store, rand() % n);
+		uids[i] = e->UID;
+	}
+
+	// Scans are slow; do proportionally fewer of them
+	const int scanLookups = MIN(LOOKUPS, LOOKUPS * 64 / n);
+	size_t found = 0;
+	clock_t start = clock();
+	for (int i = 0; i < scanLookups; i++)
+	{
+		found += ScanGetByUID(&store, uids[i]) != NULL;
+	}
+	const double scanNs =
+		(double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / scanLookups;
+
+	start = clock();
+	for (int i = 0; i < LOOKUPS; i++)
+	{
+		found += MapGetByUID(&store, &m, uids[i]) != NULL;
+	}
+	const double mapNs =
+		(double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / LOOKUPS;
+
+	printf(
+		"%6d entities: scan %10.1f ns/lookup, map %6.1f ns/lookup (%zu)\n",
+		n, scanNs, mapNs, found);
+
+	CFREE(uids);
+	UIDMapTerminate(&m);
+	CArrayTerminate(&store);
+}
+
+int main(void)
+{
+	srand(0);
+	const int sizes[] = { 16, 64, 256, 1024, 4096, 16384 };
+	for (int i = 0; i < (int)(sizeof sizes / sizeof sizes[0]); i++)
+	{
+		Bench(sizes[i]);
+	}
+	return 0;
+}
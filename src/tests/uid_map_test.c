@@ -0,0 +1,90 @@
+#include <cbehave/cbehave.h>
+
+#include <uid_map.h>
+
+
+FEATURE(UIDMapGet, "Get slot by UID")
+	SCENARIO("Get assigned and unassigned UIDs")
+		GIVEN("a map with some UIDs assigned to slots")
+			UIDMap m;
+			UIDMapInit(&m);
+			for (int i = 0; i < 200; i++)
+			{
+				UIDMapSet(&m, i * 3, i);
+			}
+
+		WHEN("I get the slots of the UIDs")
+		THEN("the slots should be the ones assigned")
+			for (int i = 0; i < 200; i++)
+			{
+				SHOULD_INT_EQUAL(UIDMapGet(&m, i * 3), i);
+			}
+		AND("unassigned UIDs should not be found")
+			SHOULD_INT_EQUAL(UIDMapGet(&m, 1), -1);
+			SHOULD_INT_EQUAL(UIDMapGet(&m, 1000), -1);
+			SHOULD_INT_EQUAL(UIDMapGet(&m, -1), -1);
+			UIDMapTerminate(&m);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(UIDMapReuse, "Reusing slots")
+	SCENARIO("Assign a new UID to a used slot")
+		GIVEN("a map with a UID in a slot")
+			UIDMap m;
+			UIDMapInit(&m);
+			UIDMapSet(&m, 5, 2);
+			const UIDHandle h = UIDMapGetHandle(&m, 5);
+
+		WHEN("I assign another UID to the same slot")
+			UIDMapSet(&m, 6, 2);
+
+		THEN("the old UID should not be found")
+			SHOULD_INT_EQUAL(UIDMapGet(&m, 5), -1);
+		AND("the new UID should be in the slot")
+			SHOULD_INT_EQUAL(UIDMapGet(&m, 6), 2);
+		AND("the old handle should be stale")
+			SHOULD_INT_EQUAL(UIDMapHandleGetSlot(&m, h), -1);
+		AND("a new handle should be valid")
+			SHOULD_INT_EQUAL(
+				UIDMapHandleGetSlot(&m, UIDMapGetHandle(&m, 6)), 2);
+			UIDMapTerminate(&m);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(UIDMapRemove, "Removing UIDs")
+	SCENARIO("Remove many UIDs")
+		GIVEN("a map with many UIDs")
+			UIDMap m;
+			UIDMapInit(&m);
+			for (int i = 0; i < 1000; i++)
+			{
+				UIDMapSet(&m, i, i);
+			}
+
+		WHEN("I remove every other UID")
+			for (int i = 0; i < 1000; i += 2)
+			{
+				UIDMapRemove(&m, i);
+			}
+
+		THEN("the removed UIDs should not be found")
+			for (int i = 0; i < 1000; i += 2)
+			{
+				SHOULD_INT_EQUAL(UIDMapGet(&m, i), -1);
+			}
+		AND("the remaining UIDs should still be found")
+			for (int i = 1; i < 1000; i += 2)
+			{
+				SHOULD_INT_EQUAL(UIDMapGet(&m, i), i);
+			}
+			SHOULD_INT_EQUAL((int)m.count, 500);
+			UIDMapTerminate(&m);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"UIDMap features are:",
+	TEST_FEATURE(UIDMapGet),
+	TEST_FEATURE(UIDMapReuse),
+	TEST_FEATURE(UIDMapRemove)
+)